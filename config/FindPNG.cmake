@@ -3,3 +3,12 @@
 #  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 #
 oglplus_common_find_module(PNG png png.h png)
+
+# the PNG writer uses zlib directly
+if(PNG_FOUND)
+	find_package(ZLIB)
+	if(ZLIB_FOUND)
+		set(PNG_INCLUDE_DIRS ${PNG_INCLUDE_DIRS} ${ZLIB_INCLUDE_DIRS})
+		set(PNG_LIBRARIES ${PNG_LIBRARIES} ${ZLIB_LIBRARIES})
+	endif()
+endif()
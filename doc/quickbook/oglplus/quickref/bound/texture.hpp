@@ -155,6 +155,16 @@ public:
 		GLint border = 0
 	) const;
 
+	const BoundObjOps& Image3D(
+		const images::ImageView & image,
+		GLint level = 0,
+		GLint border = 0
+	) const;
+
+	const BoundObjOps& Image3D(
+		const images::TextureContainer & container
+	) const;
+
 	const BoundObjOps& SubImage3D(
 		GLint level,
 		GLint xoffs,
@@ -176,6 +186,33 @@ public:
 		GLint level = 0
 	) const;
 
+	const BoundObjOps& SubImage3D(
+		const images::ImageView & image,
+		GLint xoffs,
+		GLint yoffs,
+		GLint zoffs,
+		GLint level = 0
+	) const;
+
+	const BoundObjOps& SubImage3D(
+		images::ImageTileCache & cache,
+		GLint level,
+		GLint xoffs,
+		GLint yoffs,
+		GLint zoffs,
+		__SizeType width,
+		__SizeType height,
+		__SizeType depth
+	) const;
+
+	const BoundObjOps& SubImage3D(
+		const images::SparseImage & image,
+		GLint xoffs,
+		GLint yoffs,
+		GLint zoffs,
+		GLint level = 0
+	) const;
+
 	const BoundObjOps& Image2D(
 		GLint level,
 		__PixelDataInternalFormat internal_format,
@@ -193,6 +230,25 @@ public:
 		GLint border = 0
 	) const;
 
+	const BoundObjOps& Image2D(
+		const images::ImageView & image,
+		GLint level = 0,
+		GLint border = 0
+	) const;
+
+	const BoundObjOps& Image2D(
+		const images::MipmapChain & chain,
+		GLint border = 0
+	) const;
+
+	const BoundObjOps& Image2D(
+		const images::PrefilteredCubeMap & cube_map
+	) const;
+
+	const BoundObjOps& Image2D(
+		const images::TextureContainer & container
+	) const;
+
 	const BoundObjOps& SubImage2D(
 		GLint level,
 		GLint xoffs,
@@ -211,6 +267,22 @@ public:
 		GLint level = 0
 	) const;
 
+	const BoundObjOps& SubImage2D(
+		const images::ImageView & image,
+		GLint xoffs,
+		GLint yoffs,
+		GLint level = 0
+	) const;
+
+	const BoundObjOps& SubImage2D(
+		images::ImageTileCache & cache,
+		GLint level,
+		GLint xoffs,
+		GLint yoffs,
+		__SizeType width,
+		__SizeType height
+	) const;
+
 	const BoundObjOps& Image1D(
 		GLint level,
 		__PixelDataInternalFormat internal_format,
@@ -323,6 +395,12 @@ public:
 		const void * data
 	) const;
 
+	const BoundObjOps& CompressedImage2D(
+		const images::CompressedImage & image,
+		GLint level = 0,
+		GLint border = 0
+	) const;
+
 	const BoundObjOps& CompressedImage1D(
 		GLint level,
 		__PixelDataInternalFormat internal_format,
@@ -301,7 +301,9 @@ bool AppData::ParseArgs(int argc, char** argv)
 	// output file suffix
 	parser.AddArg("-s", "--output-suffix", output_suffix)
 		.AddDesc(
-		"The suffix for the cube map image output files."
+		"The suffix for the cube map image output files. "
+		"If the suffix is 'png' the images are saved in the PNG format "
+		"(if supported), otherwise the raw RGBA pixel data is saved."
 		);
 
 	// the X+ face id
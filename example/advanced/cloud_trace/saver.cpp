@@ -12,6 +12,9 @@
 #include "raytracer.hpp"
 
 #include <oglplus/framebuffer.hpp>
+#if OGLPLUS_PNG_FOUND
+#include <oglplus/images/save_png.hpp>
+#endif
 
 #include <string>
 #include <vector>
@@ -60,6 +63,23 @@ void Saver::SaveFrame(
 	path.append(".");
 	path.append(app_data.output_suffix);
 
+#if OGLPLUS_PNG_FOUND
+	if(app_data.output_suffix == "png")
+	{
+		images::SavePNG(
+			images::ImageView(
+				app_data.render_width,
+				app_data.render_height,
+				1, 4,
+				reinterpret_cast<const GLubyte*>(pixels.data()),
+				PixelDataFormat::RGBA,
+				PixelDataInternalFormat::RGBA8
+			),
+			path.c_str()
+		);
+		return;
+	}
+#endif
 	std::ofstream output(path.c_str());
 	output.write(pixels.data(), pixels.size());
 }
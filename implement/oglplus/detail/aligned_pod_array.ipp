@@ -0,0 +1,162 @@
+/**
+ *  .file oglplus/detail/aligned_pod_array.ipp
+ *  .brief Implementation of the mmap-based AlignedPODArray storage
+ *
+ *  @author Matus Chochlik
+ *
+ *  Copyright 2010-2015 Matus Chochlik. Distributed under the Boost
+ *  Software License, Version 1.0. (See accompanying file
+ *  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include <stdexcept>
+#include <string>
+
+#if !OGLPLUS_NO_MMAP
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#endif
+
+namespace oglplus {
+namespace aux {
+
+#if !OGLPLUS_NO_MMAP
+OGLPLUS_LIB_FUNC
+std::size_t MMapPageSize(void)
+{
+	return std::size_t(::sysconf(_SC_PAGESIZE));
+}
+
+OGLPLUS_LIB_FUNC
+void* MMapPODArrayAllocate(std::size_t size, std::size_t align, void*)
+{
+	assert(align <= MMapPageSize());
+	OGLPLUS_FAKE_USE(align);
+	if(size == 0) size = 1;
+
+	void* result = ::mmap(
+		nullptr,
+		size,
+		PROT_READ | PROT_WRITE,
+		MAP_PRIVATE | MAP_ANONYMOUS,
+		-1, 0
+	);
+	if(result == MAP_FAILED) throw std::bad_alloc();
+#ifdef MADV_HUGEPAGE
+	if(size >= (std::size_t(2) << 20))
+	{
+		::madvise(result, size, MADV_HUGEPAGE);
+	}
+#endif
+	return result;
+}
+
+OGLPLUS_LIB_FUNC
+void MMapPODArrayDeallocate(void* ptr, std::size_t size, void*)
+{
+	if(!ptr) return;
+	if(size == 0) size = 1;
+
+	const std::uintptr_t page = MMapPageSize();
+	const std::uintptr_t addr = reinterpret_cast<std::uintptr_t>(ptr);
+	const std::uintptr_t base = addr - addr % page;
+	::munmap(reinterpret_cast<void*>(base), size+(addr-base));
+}
+
+OGLPLUS_LIB_FUNC
+PODArrayAllocator MMapPODArrayAllocator(void)
+{
+	PODArrayAllocator result = {
+		&MMapPODArrayAllocate,
+		&MMapPODArrayDeallocate,
+		nullptr
+	};
+	return result;
+}
+#endif
+
+OGLPLUS_LIB_FUNC
+AlignedPODArray AlignedPODArray::_map_file(
+	const char* path,
+	std::size_t offset,
+	std::size_t count,
+	std::size_t elem_size,
+	std::size_t elem_align
+)
+{
+	assert(path != nullptr);
+	const std::size_t size = count*elem_size;
+	AlignedPODArray result;
+	result._sizeof = elem_size;
+#if !OGLPLUS_NO_MMAP
+	result._align = elem_align;
+	result._alloc = MMapPODArrayAllocator();
+
+	int fd = ::open(path, O_RDONLY);
+	if(fd < 0)
+	{
+		throw std::runtime_error(
+			std::string("Unable to open file '")+path+"'"
+		);
+	}
+	struct ::stat st;
+	if((::fstat(fd, &st) != 0) || (std::size_t(st.st_size) < offset+size))
+	{
+		::close(fd);
+		throw std::runtime_error(
+			std::string("File '")+path+"' is too short"
+		);
+	}
+	const std::size_t page = MMapPageSize();
+	const std::size_t skip = offset % page;
+	void* base = ::mmap(
+		nullptr,
+		(size+skip > 0)?size+skip:1,
+		PROT_READ | PROT_WRITE,
+		MAP_PRIVATE,
+		fd,
+		off_t(offset-skip)
+	);
+	::close(fd);
+	if(base == MAP_FAILED)
+	{
+		throw std::runtime_error(
+			std::string("Unable to map file '")+path+"'"
+		);
+	}
+	result._data = static_cast<unsigned char*>(base)+skip;
+	result._count = count;
+	assert((skip % elem_align) == 0);
+	return result;
+#else
+	if(result._align < elem_align) result._align = elem_align;
+	result._alloc = HeapPODArrayAllocator();
+	result._count = count;
+	result._init(nullptr);
+
+	std::ifstream file(path, std::ios::in | std::ios::binary);
+	if(!file.good())
+	{
+		throw std::runtime_error(
+			std::string("Unable to open file '")+path+"'"
+		);
+	}
+	file.seekg(std::streamoff(offset));
+	file.read(static_cast<char*>(result.begin()), std::streamsize(size));
+	if(std::size_t(file.gcount()) != size)
+	{
+		throw std::runtime_error(
+			std::string("File '")+path+"' is too short"
+		);
+	}
+	return result;
+#endif
+}
+
+} // namespace aux
+} // namespace oglplus
+
@@ -12,6 +12,8 @@
 #include <oglplus/lib/incl_begin.ipp>
 #include <oglplus/images/image_spec.hpp>
 #include <oglplus/images/image.hpp>
+#include <oglplus/images/view.hpp>
+#include <oglplus/detail/unpack_params.hpp>
 #include <oglplus/lib/incl_end.ipp>
 
 namespace oglplus {
@@ -228,6 +230,56 @@ SubImage2D(
 	return *this;
 }
 
+OGLPLUS_LIB_FUNC
+ObjectOps<tag::DirectState, tag::Texture>&
+ObjectOps<tag::DirectState, tag::Texture>::
+SubImage3D(
+	const images::ImageView& image,
+	GLint xoffs,
+	GLint yoffs,
+	GLint zoffs,
+	GLint level
+)
+{
+	aux::ImageViewUnpackParams unpack(image, true);
+	return SubImage3D(
+		level,
+		xoffs,
+		yoffs,
+		zoffs,
+		image.Width(),
+		image.Height(),
+		image.Depth(),
+		image.Format(),
+		image.Type(),
+		image.RawData()
+	);
+}
+
+OGLPLUS_LIB_FUNC
+ObjectOps<tag::DirectState, tag::Texture>&
+ObjectOps<tag::DirectState, tag::Texture>::
+SubImage2D(
+	const images::ImageView& image,
+	GLint xoffs,
+	GLint yoffs,
+	GLint level
+)
+{
+	assert(image.Depth() == 1);
+	aux::ImageViewUnpackParams unpack(image, false);
+	return SubImage2D(
+		level,
+		xoffs,
+		yoffs,
+		image.Width(),
+		image.Height(),
+		image.Format(),
+		image.Type(),
+		image.RawData()
+	);
+}
+
 OGLPLUS_LIB_FUNC
 ObjectOps<tag::DirectState, tag::Texture>&
 ObjectOps<tag::DirectState, tag::Texture>::
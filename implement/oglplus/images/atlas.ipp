@@ -0,0 +1,354 @@
+/**
+ *  @file oglplus/images/atlas.ipp
+ *  @brief Implementation of images::ImageAtlas
+ *
+ *  @author Matus Chochlik
+ *
+ *  Copyright 2010-2015 Matus Chochlik. Distributed under the Boost
+ *  Software License, Version 1.0. (See accompanying file
+ *  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include <oglplus/lib/incl_begin.ipp>
+#include <oglplus/images/convert.hpp>
+#include <oglplus/lib/incl_end.ipp>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace oglplus {
+namespace images {
+
+OGLPLUS_LIB_FUNC
+void ImageAtlas::_init(void)
+{
+	assert(_width > 0 && _height > 0);
+	assert(_params.padding >= 0);
+	assert(_params.alignment > 0);
+	if(ImageView::ComponentSize(_type) == 0)
+	{
+		throw std::runtime_error(
+			"Unsupported pixel data type for image atlases"
+		);
+	}
+}
+
+OGLPLUS_LIB_FUNC
+oglplus::aux::AlignedPODArray ImageAtlas::_new_page(void) const
+{
+	oglplus::aux::AlignedPODArray page = aux::ConvertAllocate(
+		_type,
+		std::size_t(_width*_height*_channels)
+	);
+	page.fill(0x00);
+	return page;
+}
+
+OGLPLUS_LIB_FUNC
+bool ImageAtlas::_find(
+	const _skyline& skyline,
+	GLsizei w,
+	GLsizei h,
+	GLsizei& x,
+	GLsizei& y
+) const
+{
+	bool found = false;
+	GLsizei best_top = _height+1;
+	for(std::size_t i=0; i!=skyline.size(); ++i)
+	{
+		const GLsizei l = skyline[i].x;
+		if(l+w > _width) break;
+
+		// the cell rests on the highest segment below it
+		GLsizei t = 0;
+		for(
+			std::size_t j=i;
+			(j != skyline.size()) && (skyline[j].x < l+w);
+			++j
+		)
+		{
+			t = std::max(t, skyline[j].y);
+		}
+		if((t+h <= _height) && (t+h < best_top))
+		{
+			best_top = t+h;
+			x = l;
+			y = t;
+			found = true;
+		}
+	}
+	return found;
+}
+
+OGLPLUS_LIB_FUNC
+void ImageAtlas::_place(
+	_skyline& skyline,
+	GLsizei x,
+	GLsizei y,
+	GLsizei w,
+	GLsizei h
+)
+{
+	auto i = skyline.begin();
+	while(i->x != x) ++i;
+
+	_segment segment = {x, y+h, w};
+	i = skyline.insert(i, segment)+1;
+
+	// cut off the segments below the new one
+	while((i != skyline.end()) && (i->x < x+w))
+	{
+		if(i->x+i->width <= x+w)
+		{
+			i = skyline.erase(i);
+		}
+		else
+		{
+			i->width -= x+w-i->x;
+			i->x = x+w;
+			break;
+		}
+	}
+
+	// merge the neighboring segments of the same height
+	for(i = skyline.begin(); i+1 != skyline.end();)
+	{
+		if(i->y == (i+1)->y)
+		{
+			i->width += (i+1)->width;
+			skyline.erase(i+1);
+		}
+		else ++i;
+	}
+}
+
+OGLPLUS_LIB_FUNC
+bool ImageAtlas::_allocate(
+	std::vector<oglplus::aux::AlignedPODArray>& pages,
+	std::vector<_skyline>& skylines,
+	GLsizei w,
+	GLsizei h,
+	GLint& page,
+	GLsizei& x,
+	GLsizei& y
+) const
+{
+	for(std::size_t p=0; p!=skylines.size(); ++p)
+	{
+		if(_find(skylines[p], w, h, x, y))
+		{
+			_place(skylines[p], x, y, w, h);
+			page = GLint(p);
+			return true;
+		}
+	}
+	if(_params.max_pages && (pages.size() >= _params.max_pages))
+	{
+		return false;
+	}
+	_segment segment = {0, 0, _width};
+	skylines.push_back(_skyline(1, segment));
+	pages.push_back(_new_page());
+
+	x = y = 0;
+	_place(skylines.back(), x, y, w, h);
+	page = GLint(pages.size()-1);
+	return true;
+}
+
+OGLPLUS_LIB_FUNC
+std::size_t ImageAtlas::Insert(const ImageView& image)
+{
+	if(image.Depth() != 1)
+	{
+		throw std::runtime_error(
+			"Only 2D images can be inserted into an image atlas"
+		);
+	}
+	if((image.Type() != _type) || (image.Format() != _format))
+	{
+		return Insert(Convert(image, _type, _format, _internal));
+	}
+	assert(image.Channels() == _channels);
+
+	const GLsizei w = image.Width();
+	const GLsizei h = image.Height();
+	const GLsizei cw = _cell_size(w);
+	const GLsizei ch = _cell_size(h);
+	if((w <= 0) || (h <= 0) || (cw > _width) || (ch > _height))
+	{
+		throw std::runtime_error(
+			"Image does not fit into the pages of the image atlas"
+		);
+	}
+
+	ImageAtlasEntry entry;
+	GLsizei cx, cy;
+	if(!_allocate(_pages, _skylines, cw, ch, entry.page, cx, cy))
+	{
+		throw std::runtime_error("The image atlas is full");
+	}
+	_modified.resize(_pages.size(), 0);
+	_modified[std::size_t(entry.page)] = 1;
+
+	// copy the image and fill the padding with its edge texels
+	const GLsizei p = _params.padding;
+	const oglplus::aux::AlignedPODArray& page = _pages[entry.page];
+	for(GLsizei y=0; y!=ch; ++y)
+	{
+		const GLsizei sy = std::min(std::max(y-p, 0), h-1);
+		const unsigned char* src = static_cast<const unsigned char*>(
+			image.RawPixel(0, sy, 0)
+		);
+		unsigned char* dst = _texel(page, cx, cy+y);
+		for(GLsizei x=0; x!=p; ++x)
+		{
+			std::memcpy(dst, src, _pixel_size);
+			dst += _pixel_size;
+		}
+		std::memcpy(dst, src, std::size_t(w)*_pixel_size);
+		dst += std::size_t(w)*_pixel_size;
+		src += std::size_t(w-1)*_pixel_size;
+		for(GLsizei x=p+w; x!=cw; ++x)
+		{
+			std::memcpy(dst, src, _pixel_size);
+			dst += _pixel_size;
+		}
+	}
+
+	entry.x = cx+p;
+	entry.y = cy+p;
+	entry.width = w;
+	entry.height = h;
+	_entries.push_back(entry);
+	_used_area += std::size_t(cw*ch);
+	return _entries.size()-1;
+}
+
+OGLPLUS_LIB_FUNC
+void ImageAtlas::Remove(std::size_t id)
+{
+	assert(id < _entries.size());
+	ImageAtlasEntry& entry = _entries[id];
+	if(entry.page >= 0)
+	{
+		_removed_area += std::size_t(
+			_cell_size(entry.width)*
+			_cell_size(entry.height)
+		);
+		entry.page = -1;
+	}
+}
+
+OGLPLUS_LIB_FUNC
+std::size_t ImageAtlas::Defragment(void)
+{
+	// place the tallest (and then the widest) cells first
+	std::vector<std::size_t> order;
+	for(std::size_t id=0; id!=_entries.size(); ++id)
+	{
+		if(_entries[id].page >= 0) order.push_back(id);
+	}
+	std::stable_sort(
+		order.begin(),
+		order.end(),
+		[this](std::size_t a, std::size_t b) -> bool
+		{
+			const ImageAtlasEntry& ea = _entries[a];
+			const ImageAtlasEntry& eb = _entries[b];
+			if(ea.height != eb.height)
+			{
+				return ea.height > eb.height;
+			}
+			return ea.width > eb.width;
+		}
+	);
+
+	// the atlas is modified only if all the cells fit
+	std::vector<oglplus::aux::AlignedPODArray> pages;
+	std::vector<_skyline> skylines;
+	std::vector<ImageAtlasEntry> entries(_entries);
+	std::size_t used_area = 0;
+
+	const GLsizei p = _params.padding;
+	for(std::size_t id : order)
+	{
+		const ImageAtlasEntry& old_entry = _entries[id];
+		ImageAtlasEntry& new_entry = entries[id];
+		const GLsizei cw = _cell_size(old_entry.width);
+		const GLsizei ch = _cell_size(old_entry.height);
+		GLsizei cx, cy;
+		if(!_allocate(pages, skylines, cw, ch, new_entry.page, cx, cy))
+		{
+			throw std::runtime_error(
+				"The images do not fit into the image atlas"
+			);
+		}
+		new_entry.x = cx+p;
+		new_entry.y = cy+p;
+		used_area += std::size_t(cw*ch);
+
+		// the cells (including the padding) are copied as they are
+		const oglplus::aux::AlignedPODArray& src_page =
+			_pages[old_entry.page];
+		const oglplus::aux::AlignedPODArray& dst_page =
+			pages[new_entry.page];
+		for(GLsizei y=0; y!=ch; ++y)
+		{
+			std::memcpy(
+				_texel(dst_page, cx, cy+y),
+				_texel(src_page, old_entry.x-p, old_entry.y-p+y),
+				std::size_t(cw)*_pixel_size
+			);
+		}
+	}
+
+	_pages.swap(pages);
+	_skylines.swap(skylines);
+	_entries.swap(entries);
+	_modified.assign(_pages.size(), 1);
+	_removed_area = 0;
+	_used_area = used_area;
+	return _pages.size();
+}
+
+OGLPLUS_LIB_FUNC
+std::vector<Vec4f> ImageAtlas::UVTable(void) const
+{
+	std::vector<Vec4f> result;
+	result.reserve(_entries.size());
+	for(std::size_t id=0; id!=_entries.size(); ++id)
+	{
+		result.push_back(UVRect(id));
+	}
+	return result;
+}
+
+OGLPLUS_LIB_FUNC
+Image ImageAtlas::PageImage(std::size_t page) const
+{
+	assert(page < _pages.size());
+	const std::size_t count = std::size_t(_width*_height*_channels);
+	oglplus::aux::AlignedPODArray storage = aux::ConvertAllocate(
+		_type,
+		count
+	);
+	std::memcpy(
+		storage.begin(),
+		_pages[page].begin(),
+		std::size_t(_width*_height)*_pixel_size
+	);
+	return Image(
+		_width, _height, 1, _channels,
+		_type,
+		std::move(storage),
+		_format,
+		_internal
+	);
+}
+
+} // namespace images
+} // namespace oglplus
+
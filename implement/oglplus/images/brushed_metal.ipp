@@ -9,9 +9,15 @@
  *  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
  */
 
+#include <oglplus/lib/incl_begin.ipp>
+#include <oglplus/detail/parallel_for.hpp>
+#include <oglplus/lib/incl_end.ipp>
+
+#include <algorithm>
 #include <cassert>
 #include <cstdlib>
 #include <cmath>
+#include <vector>
 
 namespace oglplus {
 namespace images {
@@ -26,13 +32,16 @@ void BrushedMetalUByte::_make_pixel(
 	GLint y,
 	double /*c*/,
 	GLubyte r,
-	GLubyte g
+	GLubyte g,
+	GLint y_begin,
+	GLint y_end
 )
 {
 	while(x < 0) x += w;
 	while(y < 0) y += h;
 	if(x >= w) x %= w;
 	if(y >= h) y %= h;
+	if((y < y_begin) || (y >= y_end)) return;
 	GLubyte* p = b + (y*w + x)*3;
 	GLubyte* pr = p;
 	GLubyte* pg = p+1;
@@ -55,7 +64,9 @@ void BrushedMetalUByte::_make_scratch(
 	GLint x,
 	GLint y,
 	GLint dx,
-	GLint dy
+	GLint dy,
+	GLint y_begin,
+	GLint y_end
 )
 {
 	if((dx == 0) && (dy == 0)) return;
@@ -73,7 +84,7 @@ void BrushedMetalUByte::_make_scratch(
 			{
 				double c = double(i)/dx;
 				GLint j = GLint(dy*c);
-				_make_pixel(b,e,w,h,x+i,y+j,c,r,g);
+				_make_pixel(b,e,w,h,x+i,y+j,c,r,g,y_begin,y_end);
 			}
 		}
 		else
@@ -82,7 +93,7 @@ void BrushedMetalUByte::_make_scratch(
 			{
 				double c = double(i)/dx;
 				GLint j = GLint(dy*c);
-				_make_pixel(b,e,w,h,x+i,y+j,c,r,g);
+				_make_pixel(b,e,w,h,x+i,y+j,c,r,g,y_begin,y_end);
 			}
 		}
 	}
@@ -94,7 +105,7 @@ void BrushedMetalUByte::_make_scratch(
 			{
 				double c = double(j)/dy;
 				GLint i = GLint(dx*c);
-				_make_pixel(b,e,w,h,x+i,y+j,c,r,g);
+				_make_pixel(b,e,w,h,x+i,y+j,c,r,g,y_begin,y_end);
 			}
 		}
 		else
@@ -103,7 +114,7 @@ void BrushedMetalUByte::_make_scratch(
 			{
 				double c = double(j)/dy;
 				GLint i = GLint(dx*c);
-				_make_pixel(b,e,w,h,x+i,y+j,c,r,g);
+				_make_pixel(b,e,w,h,x+i,y+j,c,r,g,y_begin,y_end);
 			}
 		}
 	}
@@ -142,12 +153,146 @@ BrushedMetalUByte::BrushedMetalUByte(
 				width,
 				height,
 				x, y,
-				dx, dy
+				dx, dy,
+				0, height
+			);
+			x += dx;
+			y += dy;
+		}
+	}
+}
+
+OGLPLUS_LIB_FUNC
+BrushedMetalUByte::BrushedMetalUByte(
+	SizeType width,
+	SizeType height,
+	unsigned n_scratches,
+	int s_disp_min,
+	int s_disp_max,
+	int t_disp_min,
+	int t_disp_max,
+	RandomSeed seed
+): Image(width, height, 1, 3, &TypeTag<GLubyte>())
+{
+	this->_bzero();
+
+	GLubyte *p = this->_begin_ub(), *e = this->_end_ub();
+	const CounterRNG rng(seed);
+	const std::uint32_t s_range = std::uint32_t(s_disp_max-s_disp_min+1);
+	const std::uint32_t t_range = std::uint32_t(t_disp_max-t_disp_min+1);
+	const GLsizei h = height;
+	const GLsizei bands = (h+15)/16;
+
+	struct segment { GLint x, y, dx, dy; };
+
+	// the segments of the scratches and the first segment of each
+	std::vector<segment> segments;
+	std::vector<std::size_t> firsts;
+	segments.reserve(std::size_t(n_scratches)*2);
+	firsts.reserve(std::size_t(n_scratches)+1);
+
+	// the scratches touching the rows of each band, in their order
+	std::vector<std::vector<unsigned>> band_scratches(bands);
+
+	std::vector<GLsizei> row_band(h);
+	for(GLsizei b=0; b!=bands; ++b)
+	{
+		for(GLint y=GLint(b)*h/bands; y!=GLint(b+1)*h/bands; ++y)
+		{
+			row_band[y] = b;
+		}
+	}
+
+	for(unsigned s=0; s!=n_scratches; ++s)
+	{
+		const CounterRNG scratch_rng = rng.Branch(s);
+		const GLuint n_segments = 1+scratch_rng.Below(0, 4);
+		GLint x = GLint(scratch_rng.Below(1, width));
+		GLint y = GLint(scratch_rng.Below(2, height));
+		GLint y_min = y, y_max = y;
+
+		firsts.push_back(segments.size());
+		for(GLuint seg=0; seg<n_segments; ++seg)
+		{
+			GLint dx = s_disp_min + GLint(
+				scratch_rng.Below(3+2*seg, s_range)
+			);
+			GLint dy = t_disp_min + GLint(
+				scratch_rng.Below(4+2*seg, t_range)
 			);
+			segment sg = {x, y, dx, dy};
+			segments.push_back(sg);
+
+			y_min = std::min(y_min, y+std::min(dy, 0));
+			y_max = std::max(y_max, y+std::max(dy, 0));
 			x += dx;
 			y += dy;
 		}
+
+		// the (wrapped) rows y_min ... y_max may be touched
+		GLsizei b_first = 0, b_last = bands-1, b_wrap = -1;
+		if(y_max-y_min+1 < h)
+		{
+			const GLint r_first = ((y_min%h)+h)%h;
+			const GLint r_last = r_first+y_max-y_min;
+			if(r_last < h)
+			{
+				b_first = row_band[r_first];
+				b_last = row_band[r_last];
+			}
+			else if(row_band[r_last-h]+1 < row_band[r_first])
+			{
+				b_first = row_band[r_first];
+				b_wrap = row_band[r_last-h];
+			}
+		}
+		for(GLsizei b=0; b<=b_wrap; ++b)
+		{
+			band_scratches[b].push_back(s);
+		}
+		for(GLsizei b=b_first; b<=b_last; ++b)
+		{
+			band_scratches[b].push_back(s);
+		}
 	}
+	firsts.push_back(segments.size());
+
+	oglplus::aux::ParallelFor(
+		std::size_t(bands),
+		1,
+		[&](std::size_t begin, std::size_t end)
+		{
+			const GLint y_begin = GLint(begin)*h/bands;
+			const GLint y_end = GLint(end)*h/bands;
+
+			// each scratch touching the chunk is made once, in order
+			std::vector<char> in_chunk(n_scratches, 0);
+			for(std::size_t b=begin; b!=end; ++b)
+			{
+				for(unsigned s : band_scratches[b])
+				{
+					in_chunk[s] = 1;
+				}
+			}
+
+			for(unsigned s=0; s!=n_scratches; ++s)
+			{
+				if(!in_chunk[s]) continue;
+				for(std::size_t i=firsts[s]; i!=firsts[s+1]; ++i)
+				{
+					const segment& sg = segments[i];
+					_make_scratch(
+						p, e,
+						width,
+						height,
+						sg.x, sg.y,
+						sg.dx, sg.dy,
+						y_begin, y_end
+					);
+				}
+			}
+		}
+	);
 }
 
 } // images
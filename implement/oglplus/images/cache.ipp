@@ -0,0 +1,350 @@
+/**
+ *  @file oglplus/images/cache.ipp
+ *  @brief Implementation of the on-disk cache of generated images
+ *
+ *  @author Matus Chochlik
+ *
+ *  Copyright 2010-2015 Matus Chochlik. Distributed under the Boost
+ *  Software License, Version 1.0. (See accompanying file
+ *  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include <oglplus/lib/incl_begin.ipp>
+#include <oglplus/utils/filesystem.hpp>
+#include <oglplus/lib/incl_end.ipp>
+
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#if defined(WIN32) || defined(_WIN32) || defined(WIN64) || defined(_WIN64)
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace oglplus {
+namespace images {
+namespace aux {
+
+// The header of the files stored in the ImageCache,
+// followed by the tightly packed pixel data
+struct ImageCacheHeader
+{
+	char magic[8];
+	std::uint64_t key;
+	std::uint64_t version;
+	std::uint32_t type;
+	std::uint32_t format;
+	std::uint32_t internal;
+	std::uint32_t width;
+	std::uint32_t height;
+	std::uint32_t depth;
+	std::uint32_t channels;
+	std::uint32_t comp_size;
+	std::uint64_t data_size;
+};
+
+static_assert(
+	sizeof(ImageCacheHeader) == 64,
+	"Unexpected size of the image cache file header"
+);
+
+inline const char* ImageCacheMagic(void)
+{
+	return "OGLPIMG1";
+}
+
+// Returns a suffix of the temporary files which is unique for each call
+// in this process and which does not collide with other processes
+inline std::string ImageCacheTempSuffix(void)
+{
+	static std::atomic<unsigned long> counter(0);
+	std::stringstream suffix;
+	suffix << ".tmp-";
+#if defined(WIN32) || defined(_WIN32) || defined(WIN64) || defined(_WIN64)
+	suffix << ::_getpid();
+#else
+	suffix << ::getpid();
+#endif
+	suffix << "-" << counter++;
+	return suffix.str();
+}
+
+template <typename T>
+Image ImageCacheMap(
+	const std::string& path,
+	const ImageCacheHeader& header,
+	std::size_t count
+)
+{
+	return Image(
+		SizeType(GLsizei(header.width)),
+		SizeType(GLsizei(header.height)),
+		SizeType(GLsizei(header.depth)),
+		SizeType(GLsizei(header.channels)),
+		PixelDataType(header.type),
+		oglplus::aux::AlignedPODArray::MapFile<T>(
+			path.c_str(),
+			sizeof(ImageCacheHeader),
+			count
+		),
+		PixelDataFormat(header.format),
+		PixelDataInternalFormat(header.internal)
+	);
+}
+
+// Returns true if the images of the specified type can be cached
+inline bool ImageCacheSupported(PixelDataType type)
+{
+	switch(GLenum(type))
+	{
+		case GL_UNSIGNED_BYTE:
+		case GL_BYTE:
+		case GL_UNSIGNED_SHORT:
+		case GL_SHORT:
+		case GL_UNSIGNED_INT:
+		case GL_INT:
+		case GL_FLOAT:
+		case GL_HALF_FLOAT:
+		case GL_UNSIGNED_INT_10F_11F_11F_REV:
+		case GL_UNSIGNED_INT_5_9_9_9_REV:
+		case GL_UNSIGNED_INT_2_10_10_10_REV:
+			return true;
+		default:;
+	}
+	return false;
+}
+
+} // namespace aux
+
+OGLPLUS_LIB_FUNC
+ImageCacheKey& ImageCacheKey::Add(const ImageView& image)
+{
+	Add(GLsizei(image.Width()));
+	Add(GLsizei(image.Height()));
+	Add(GLsizei(image.Depth()));
+	Add(GLsizei(image.Channels()));
+	Add(GLenum(image.Type()));
+	Add(GLenum(image.Format()));
+	Add(GLenum(image.InternalFormat()));
+
+	const std::size_t row_size = std::size_t(
+		GLsizei(image.Width())*GLsizei(image.Channels())
+	)*image.ComponentSize();
+
+	for(GLsizei z=0, d=GLsizei(image.Depth()); z!=d; ++z)
+	{
+		for(GLsizei y=0, h=GLsizei(image.Height()); y!=h; ++y)
+		{
+			_add_bytes(image.RawPixel(0, y, z), row_size);
+		}
+	}
+	return *this;
+}
+
+OGLPLUS_LIB_FUNC
+ImageCache::ImageCache(
+	const std::string& directory,
+	const std::string& version
+): _directory(directory)
+ , _version(ImageCacheKey(version).Hash())
+{ }
+
+OGLPLUS_LIB_FUNC
+std::uint64_t ImageCache::_file_hash(const ImageCacheKey& key) const
+{
+	return CounterRNG::Mix(key.Hash() ^ CounterRNG::Mix(_version));
+}
+
+OGLPLUS_LIB_FUNC
+std::string ImageCache::_file_path(std::uint64_t hash) const
+{
+	const char* digits = "0123456789abcdef";
+	std::string name(16, '0');
+	for(std::size_t i=0; i!=16; ++i)
+	{
+		name[15-i] = digits[(hash >> (i*4)) & 0xF];
+	}
+	return _directory+oglplus::aux::FilesysPathSep()+name+".oglimg";
+}
+
+OGLPLUS_LIB_FUNC
+std::string ImageCache::FilePath(const ImageCacheKey& key) const
+{
+	return _file_path(_file_hash(key));
+}
+
+OGLPLUS_LIB_FUNC
+bool ImageCache::_load(const ImageCacheKey& key, Image& image) const
+{
+	const std::string path = FilePath(key);
+	std::ifstream file(path, std::ios::in | std::ios::binary);
+	if(!file.good()) return false;
+
+	aux::ImageCacheHeader header;
+	file.read(reinterpret_cast<char*>(&header), sizeof(header));
+	if(!file.good()) return false;
+	file.seekg(0, std::ios::end);
+	const std::size_t file_size = std::size_t(file.tellg());
+	file.close();
+
+	const PixelDataType type = PixelDataType(header.type);
+	const std::size_t comp_size = ImageView::ComponentSize(type);
+	const std::size_t count =
+		std::size_t(header.width)*
+		std::size_t(header.height)*
+		std::size_t(header.depth)*
+		std::size_t(header.channels);
+
+	if(	(std::memcmp(header.magic, aux::ImageCacheMagic(), 8) != 0) ||
+		(header.key != key.Hash()) ||
+		(header.version != _version) ||
+		(header.comp_size != comp_size) ||
+		!aux::ImageCacheSupported(type) ||
+		(header.data_size != count*comp_size) ||
+		(file_size != sizeof(header)+count*comp_size) ||
+		(count == 0)
+	) return false;
+
+	try
+	{
+		switch(GLenum(type))
+		{
+			case GL_UNSIGNED_BYTE:
+				image = aux::ImageCacheMap<GLubyte>(
+					path, header, count
+				);
+				return true;
+			case GL_BYTE:
+				image = aux::ImageCacheMap<GLbyte>(
+					path, header, count
+				);
+				return true;
+			case GL_UNSIGNED_SHORT:
+			case GL_HALF_FLOAT:
+				image = aux::ImageCacheMap<GLushort>(
+					path, header, count
+				);
+				return true;
+			case GL_SHORT:
+				image = aux::ImageCacheMap<GLshort>(
+					path, header, count
+				);
+				return true;
+			case GL_UNSIGNED_INT:
+			case GL_UNSIGNED_INT_10F_11F_11F_REV:
+			case GL_UNSIGNED_INT_5_9_9_9_REV:
+			case GL_UNSIGNED_INT_2_10_10_10_REV:
+				image = aux::ImageCacheMap<GLuint>(
+					path, header, count
+				);
+				return true;
+			case GL_INT:
+				image = aux::ImageCacheMap<GLint>(
+					path, header, count
+				);
+				return true;
+			case GL_FLOAT:
+				image = aux::ImageCacheMap<GLfloat>(
+					path, header, count
+				);
+				return true;
+			default:;
+		}
+	}
+	catch(std::runtime_error&) { }
+	return false;
+}
+
+OGLPLUS_LIB_FUNC
+bool ImageCache::Contains(const ImageCacheKey& key) const
+{
+	std::ifstream file(FilePath(key), std::ios::in | std::ios::binary);
+	if(!file.good()) return false;
+
+	aux::ImageCacheHeader header;
+	file.read(reinterpret_cast<char*>(&header), sizeof(header));
+	return	file.good() &&
+		(std::memcmp(header.magic, aux::ImageCacheMagic(), 8) == 0) &&
+		(header.key == key.Hash()) &&
+		(header.version == _version);
+}
+
+OGLPLUS_LIB_FUNC
+bool ImageCache::Store(const ImageCacheKey& key, const ImageView& image) const
+{
+	if(!aux::ImageCacheSupported(image.Type())) return false;
+	const std::size_t comp_size = image.ComponentSize();
+
+	const std::size_t row_size = std::size_t(
+		GLsizei(image.Width())*GLsizei(image.Channels())
+	)*comp_size;
+
+	aux::ImageCacheHeader header;
+	std::memcpy(header.magic, aux::ImageCacheMagic(), 8);
+	header.key = key.Hash();
+	header.version = _version;
+	header.type = std::uint32_t(GLenum(image.Type()));
+	header.format = std::uint32_t(GLenum(image.Format()));
+	header.internal = std::uint32_t(GLenum(image.InternalFormat()));
+	header.width = std::uint32_t(GLsizei(image.Width()));
+	header.height = std::uint32_t(GLsizei(image.Height()));
+	header.depth = std::uint32_t(GLsizei(image.Depth()));
+	header.channels = std::uint32_t(GLsizei(image.Channels()));
+	header.comp_size = std::uint32_t(comp_size);
+	header.data_size = row_size*header.height*header.depth;
+
+	// the image is written to a temporary file which is then renamed
+	// so that concurrent readers never see a partially written file.
+	// the name of the temporary file is unique so that several threads
+	// or processes storing the same image do not write into one file
+	const std::string path = FilePath(key);
+	const std::string tmp_path = path+aux::ImageCacheTempSuffix();
+	std::ofstream file(tmp_path, std::ios::out | std::ios::binary);
+	if(!file.good()) return false;
+
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	for(GLsizei z=0, d=GLsizei(image.Depth()); z!=d; ++z)
+	{
+		for(GLsizei y=0, h=GLsizei(image.Height()); y!=h; ++y)
+		{
+			file.write(
+				static_cast<const char*>(image.RawPixel(0, y, z)),
+				std::streamsize(row_size)
+			);
+		}
+	}
+	file.close();
+	if(!file.good())
+	{
+		std::remove(tmp_path.c_str());
+		return false;
+	}
+	if(std::rename(tmp_path.c_str(), path.c_str()) != 0)
+	{
+		// some systems do not replace existing files on rename.
+		// this fallback is not atomic: between the removal and
+		// the second rename concurrent readers find no file (which
+		// is a cache miss) and another writer can win the rename
+		std::remove(path.c_str());
+		if(std::rename(tmp_path.c_str(), path.c_str()) != 0)
+		{
+			std::remove(tmp_path.c_str());
+			return false;
+		}
+	}
+	return true;
+}
+
+OGLPLUS_LIB_FUNC
+bool ImageCache::Remove(const ImageCacheKey& key) const
+{
+	return std::remove(FilePath(key).c_str()) == 0;
+}
+
+} // namespace images
+} // namespace oglplus
+
@@ -11,6 +11,7 @@
 
 #include <oglplus/lib/incl_begin.ipp>
 #include <oglplus/math/angle.hpp>
+#include <oglplus/detail/parallel_for.hpp>
 #include <oglplus/lib/incl_end.ipp>
 
 #include <algorithm>
@@ -22,7 +23,7 @@ namespace oglplus {
 namespace images {
 
 OGLPLUS_LIB_FUNC
-void Cloud::_adjust_sphere(Vec3f& center, GLfloat& radius) const
+void CloudTileSource::_adjust_sphere(Vec3f& center, GLfloat& radius)
 {
 	GLfloat c[3] = {center.x(), center.y(), center.z()};
 	for(unsigned i=0; i!=3; ++i)
@@ -104,7 +105,7 @@ GLfloat Cloud::_rand_s(void)
 OGLPLUS_LIB_FUNC
 void Cloud::_make_spheres(Vec3f center, GLfloat radius)
 {
-	_adjust_sphere(center, radius);
+	CloudTileSource::_adjust_sphere(center, radius);
 	if(radius < _min_radius) return;
 	if(!_apply_sphere(center, radius)) return;
 	GLfloat sub_radius = radius * _sub_scale;
@@ -146,6 +147,424 @@ Cloud::Cloud(
 	_make_spheres(origin, init_radius);
 }
 
+OGLPLUS_LIB_FUNC
+bool CloudTileSource::_texel_range(
+	GLfloat center,
+	GLfloat radius,
+	GLsizei size,
+	GLsizei& begin,
+	GLsizei& end
+)
+{
+	begin = GLsizei((center-radius)*size);
+	end = GLsizei((center+radius)*size);
+	if(begin < 0) begin = 0;
+	if(end > size) end = size;
+	return begin < end;
+}
+
+OGLPLUS_LIB_FUNC
+std::size_t CloudTileSource::_push_sphere(
+	Vec3f& center,
+	GLfloat& radius,
+	std::vector<Vec4f>& spheres
+) const
+{
+	_adjust_sphere(center, radius);
+	if(radius < _min_radius) return 0;
+
+	// the sphere in texture coordinates
+	Vec3f c = center*0.5f + Vec3f(0.5f, 0.5f, 0.5f);
+	GLfloat r = radius*0.5f;
+
+	GLsizei b, e;
+	if(!_texel_range(c.x(), r, _width, b, e)) return 0;
+	if(!_texel_range(c.y(), r, _height, b, e)) return 0;
+	if(!_texel_range(c.z(), r, _depth, b, e)) return 0;
+
+	spheres.push_back(Vec4f(c, r));
+
+	GLfloat sub_radius = radius * _sub_scale;
+	return std::size_t((8.0f*radius*radius)/(sub_radius*sub_radius));
+}
+
+OGLPLUS_LIB_FUNC
+void CloudTileSource::_gen_sub_sphere(
+	const Vec3f& center,
+	GLfloat radius,
+	const CounterRNG& rng,
+	std::size_t index,
+	std::vector<Vec4f>& spheres
+) const
+{
+	const CounterRNG sub_rng = rng.Branch(index);
+	GLfloat sub_radius = radius * _sub_scale;
+
+	auto rad = radius*(1.0f + sub_rng.Signed(0)*_sub_variance*0.5f);
+	auto rho = FullCircles(sub_rng.Unit(1));
+	auto phi = RightAngles(sub_rng.Signed(2));
+	_gen_spheres(
+		center + Vec3f(
+			rad*Cos(phi)*Cos(rho),
+			rad*Sin(phi),
+			rad*Cos(phi)*Sin(rho)
+		),
+		sub_radius*(1.0f + sub_rng.Signed(3)*_sub_variance),
+		sub_rng,
+		spheres
+	);
+}
+
+OGLPLUS_LIB_FUNC
+void CloudTileSource::_gen_spheres(
+	Vec3f center,
+	GLfloat radius,
+	const CounterRNG& rng,
+	std::vector<Vec4f>& spheres
+) const
+{
+	std::size_t n = _push_sphere(center, radius, spheres);
+	for(std::size_t i=0; i!=n; ++i)
+	{
+		_gen_sub_sphere(center, radius, rng, i, spheres);
+	}
+}
+
+OGLPLUS_LIB_FUNC
+void CloudTileSource::_splat_sphere(
+	const Vec4f& sphere,
+	GLsizei w,
+	GLsizei h,
+	GLsizei d,
+	GLsizei xoffs,
+	GLsizei yoffs,
+	GLsizei zoffs,
+	GLsizei rw,
+	GLsizei rh,
+	GLsizei rd,
+	GLubyte* data
+)
+{
+	const Vec3f c = sphere.xyz();
+	const GLfloat r = sphere.w();
+
+	GLsizei kb, ke, jb, je, ib, ie;
+	if(!_texel_range(c.z(), r, d, kb, ke)) return;
+	if(kb < zoffs) kb = zoffs;
+	if(ke > zoffs+rd) ke = zoffs+rd;
+	if(!(kb < ke)) return;
+	if(!_texel_range(c.y(), r, h, jb, je)) return;
+	if(jb < yoffs) jb = yoffs;
+	if(je > yoffs+rh) je = yoffs+rh;
+	if(!(jb < je)) return;
+	if(!_texel_range(c.x(), r, w, ib, ie)) return;
+	if(ib < xoffs) ib = xoffs;
+	if(ie > xoffs+rw) ie = xoffs+rw;
+	if(!(ib < ie)) return;
+
+	for(GLsizei k=kb; k!=ke; ++k)
+	for(GLsizei j=jb; j!=je; ++j)
+	for(GLsizei i=ib; i!=ie; ++i)
+	{
+		GLsizei n = ((k-zoffs)*rh + (j-yoffs))*rw + (i-xoffs);
+		GLuint b = data[n];
+		if(b == 0xFF) continue;
+
+		Vec3f p(GLfloat(i)/w, GLfloat(j)/h, GLfloat(k)/d);
+		GLfloat nd = (r - Distance(c, p))/r;
+		if(nd <= 0.0f) continue;
+		// saturating integer addition does not depend
+		// on the order in which the spheres are applied
+		b += GLuint(0xFF * std::sqrt(nd));
+		data[n] = GLubyte((b < 0xFF)?b:0xFF);
+	}
+}
+
+OGLPLUS_LIB_FUNC
+void CloudTileSource::_splat_spheres(
+	GLsizei w,
+	GLsizei h,
+	GLsizei d,
+	GLsizei xoffs,
+	GLsizei yoffs,
+	GLsizei zoffs,
+	GLsizei rw,
+	GLsizei rh,
+	GLsizei rd,
+	GLubyte* data
+) const
+{
+	for(auto s=_spheres.begin(); s!=_spheres.end(); ++s)
+	{
+		_splat_sphere(
+			*s,
+			w, h, d,
+			xoffs, yoffs, zoffs,
+			rw, rh, rd,
+			data
+		);
+	}
+}
+
+OGLPLUS_LIB_FUNC
+CloudTileSource::CloudTileSource(
+	SizeType width,
+	SizeType height,
+	SizeType depth,
+	RandomSeed seed,
+	const Vec3f& origin,
+	GLfloat init_radius,
+	GLfloat sub_scale,
+	GLfloat sub_variance,
+	GLfloat min_radius
+): _width(width)
+ , _height(height)
+ , _depth(depth)
+ , _sub_scale(sub_scale)
+ , _sub_variance(sub_variance)
+ , _min_radius(min_radius)
+{
+	const CounterRNG rng(seed);
+	Vec3f center = origin;
+	GLfloat radius = init_radius;
+
+	std::size_t n = _push_sphere(center, radius, _spheres);
+
+	// the top-level branches are generated in parallel
+	std::vector<std::vector<Vec4f>> branches(n);
+	oglplus::aux::ParallelFor(
+		n, 1,
+		[&](std::size_t b, std::size_t e)
+		{
+			for(std::size_t i=b; i!=e; ++i)
+			{
+				_gen_sub_sphere(center, radius, rng, i, branches[i]);
+			}
+		}
+	);
+	for(auto b=branches.begin(); b!=branches.end(); ++b)
+	{
+		_spheres.insert(_spheres.end(), b->begin(), b->end());
+		std::vector<Vec4f>().swap(*b);
+	}
+}
+
+OGLPLUS_LIB_FUNC
+GLint CloudTileSource::Levels(void) const
+{
+	GLsizei size = std::max(std::max(_width, _height), _depth);
+	GLint result = 1;
+	while(size > 1)
+	{
+		size /= 2;
+		++result;
+	}
+	return result;
+}
+
+OGLPLUS_LIB_FUNC
+Image CloudTileSource::MakeRegion(
+	GLint level,
+	GLint xoffs,
+	GLint yoffs,
+	GLint zoffs,
+	SizeType width,
+	SizeType height,
+	SizeType depth
+) const
+{
+	assert(level >= 0 && level < Levels());
+	const GLsizei w = LevelWidth(level);
+	const GLsizei h = LevelHeight(level);
+	const GLsizei d = LevelDepth(level);
+	const GLsizei rw = width, rh = height, rd = depth;
+	assert(xoffs >= 0 && xoffs+rw <= w);
+	assert(yoffs >= 0 && yoffs+rh <= h);
+	assert(zoffs >= 0 && zoffs+rd <= d);
+
+	oglplus::aux::AlignedPODArray storage(
+		&TypeTag<GLubyte>(),
+		std::size_t(rw*rh*rd)
+	);
+	storage.fill(0x00);
+	GLubyte* data = static_cast<GLubyte*>(storage.begin());
+
+	// the slices (or the rows of a single slice) of the region
+	// are splatted in parallel
+	if(rd > 1)
+	{
+		oglplus::aux::ParallelFor(
+			std::size_t(rd), 1,
+			[&](std::size_t b, std::size_t e)
+			{
+				_splat_spheres(
+					w, h, d,
+					xoffs, yoffs, zoffs+GLsizei(b),
+					rw, rh, GLsizei(e-b),
+					data+b*std::size_t(rw*rh)
+				);
+			}
+		);
+	}
+	else
+	{
+		oglplus::aux::ParallelFor(
+			std::size_t(rh), 8,
+			[&](std::size_t b, std::size_t e)
+			{
+				_splat_spheres(
+					w, h, d,
+					xoffs, yoffs+GLsizei(b), zoffs,
+					rw, GLsizei(e-b), 1,
+					data+b*std::size_t(rw)
+				);
+			}
+		);
+	}
+	return Image(
+		width, height, depth, 1,
+		&TypeTag<GLubyte>(),
+		std::move(storage),
+		Format(),
+		InternalFormat()
+	);
+}
+
+OGLPLUS_LIB_FUNC
+SparseImage CloudTileSource::MakeSparse(GLint level, GLsizei brick_size) const
+{
+	assert(level >= 0 && level < Levels());
+	const GLsizei w = LevelWidth(level);
+	const GLsizei h = LevelHeight(level);
+	const GLsizei d = LevelDepth(level);
+	const GLsizei s = brick_size;
+
+	SparseImage result(
+		w, h, d, 1,
+		&TypeTag<GLubyte>(),
+		Format(),
+		InternalFormat(),
+		brick_size
+	);
+	const GLsizei bw = result.BricksX();
+	const GLsizei bh = result.BricksY();
+
+	// bin the spheres into the bricks which they intersect
+	std::vector<std::vector<std::uint32_t>> bins(
+		std::size_t(bw*bh*result.BricksZ())
+	);
+	for(std::size_t i=0; i!=_spheres.size(); ++i)
+	{
+		const Vec4f& sphere = _spheres[i];
+		GLsizei kb, ke, jb, je, ib, ie;
+		if(!_texel_range(sphere.z(), sphere.w(), d, kb, ke)) continue;
+		if(!_texel_range(sphere.y(), sphere.w(), h, jb, je)) continue;
+		if(!_texel_range(sphere.x(), sphere.w(), w, ib, ie)) continue;
+
+		for(GLsizei bz=kb/s; bz<=(ke-1)/s; ++bz)
+		for(GLsizei by=jb/s; by<=(je-1)/s; ++by)
+		for(GLsizei bx=ib/s; bx<=(ie-1)/s; ++bx)
+		{
+			bins[std::size_t((bz*bh+by)*bw+bx)].push_back(
+				std::uint32_t(i)
+			);
+		}
+	}
+
+	// allocate the bricks (in the order of the grid)
+	result.Reserve(std::size_t(bins.size()-std::count_if(
+		bins.begin(),
+		bins.end(),
+		[](const std::vector<std::uint32_t>& bin) -> bool
+		{
+			return bin.empty();
+		}
+	)));
+	for(std::size_t i=0; i!=bins.size(); ++i)
+	{
+		if(bins[i].empty()) continue;
+		const GLsizei bx = GLsizei(i) % bw;
+		const GLsizei by = (GLsizei(i) / bw) % bh;
+		const GLsizei bz = GLsizei(i) / (bw*bh);
+		result.Brick<GLubyte>(bx, by, bz);
+	}
+
+	// and splat the spheres into them in parallel
+	oglplus::aux::ParallelFor(
+		result.OccupiedCount(), 1,
+		[&](std::size_t b, std::size_t e)
+		{
+			for(std::size_t i=b; i!=e; ++i)
+			{
+				GLsizei bx, by, bz;
+				result.OccupiedBrick(i, bx, by, bz);
+				// the data of allocated bricks are not moved
+				GLubyte* data = result.Brick<GLubyte>(bx, by, bz);
+				const std::vector<std::uint32_t>& bin =
+					bins[std::size_t((bz*bh+by)*bw+bx)];
+				for(auto sphere : bin)
+				{
+					_splat_sphere(
+						_spheres[sphere],
+						w, h, d,
+						bx*s, by*s, bz*s,
+						s, s, s,
+						data
+					);
+				}
+			}
+		}
+	);
+	result.Compact();
+	return result;
+}
+
+OGLPLUS_LIB_FUNC
+Cloud::Cloud(
+	SizeType width,
+	SizeType height,
+	SizeType depth,
+	RandomSeed seed,
+	const Vec3f& origin,
+	GLfloat init_radius,
+	GLfloat sub_scale,
+	GLfloat sub_variance,
+	GLfloat min_radius
+): Image(width, height, depth, 1, &TypeTag<GLubyte>())
+ , _sub_scale(sub_scale)
+ , _sub_variance(sub_variance)
+ , _min_radius(min_radius)
+{
+	this->_bzero();
+
+	const CloudTileSource source(
+		width, height, depth,
+		seed,
+		origin,
+		init_radius,
+		sub_scale,
+		sub_variance,
+		min_radius
+	);
+
+	// the spheres are splatted into disjoint z-slabs in parallel
+	const GLsizei w = Width(), h = Height();
+	const std::size_t d = std::size_t(Depth());
+	GLubyte* data = _begin_ub();
+	oglplus::aux::ParallelFor(
+		d, (d+31)/32,
+		[&](std::size_t b, std::size_t e)
+		{
+			source._splat_spheres(
+				w, h, GLsizei(d),
+				0, 0, GLsizei(b),
+				w, h, GLsizei(e-b),
+				data+b*std::size_t(w*h)
+			);
+		}
+	);
+}
+
 OGLPLUS_LIB_FUNC
 Cloud2D::Cloud2D(const Cloud& cloud)
  : Image(cloud.Width(), cloud.Height(), 1, 3, &TypeTag<GLubyte>())
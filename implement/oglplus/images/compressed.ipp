@@ -0,0 +1,748 @@
+/**
+ *  @file oglplus/images/compressed.ipp
+ *  @brief Implementation of the block-compressed (BCn) image encoder
+ *
+ *  @author Matus Chochlik
+ *
+ *  Copyright 2010-2015 Matus Chochlik. Distributed under the Boost
+ *  Software License, Version 1.0. (See accompanying file
+ *  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include <oglplus/detail/parallel_for.hpp>
+#include <stdexcept>
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+
+namespace oglplus {
+namespace images {
+namespace aux {
+
+// The pixels of a 4x4 block, the components are in the [0, 255] range
+// (or in the [-127, 127] range for signed BC4/BC5)
+struct BCBlock
+{
+	float px[16][4];
+};
+
+OGLPLUS_LIB_FUNC
+void BCFetchBlock(
+	const ImageView& image,
+	GLsizei bx,
+	GLsizei by,
+	bool snorm,
+	BCBlock& block
+)
+{
+	const GLsizei width = GLsizei(image.Width());
+	const GLsizei height = GLsizei(image.Height());
+	const GLsizei channels = GLsizei(image.Channels());
+	const bool is_ubyte = (image.Type() == PixelDataType::UnsignedByte);
+	const float lo = snorm?-127.0f:0.0f;
+	const float hi = snorm?+127.0f:255.0f;
+
+	for(GLsizei j=0; j!=4; ++j)
+	{
+		const GLsizei y = std::min(by*4+j, height-1);
+		for(GLsizei i=0; i!=4; ++i)
+		{
+			const GLsizei x = std::min(bx*4+i, width-1);
+			float* p = block.px[j*4+i];
+			const GLubyte* ub = static_cast<const GLubyte*>(
+				image.RawPixel(x, y, 0)
+			);
+			for(GLsizei c=0; c!=4; ++c)
+			{
+				float v;
+				if(c >= channels) v = (c == 3)?1.0f:0.0f;
+				else if(is_ubyte) v = ub[c]/255.0f;
+				else v = float(image.Component(x, y, 0, c));
+				v *= hi;
+				p[c] = (v < lo)?lo:(v > hi)?hi:v;
+			}
+		}
+	}
+}
+
+inline int BCRound(float v, int lo, int hi)
+{
+	int r = int(std::floor(v+0.5f));
+	return (r < lo)?lo:(r > hi)?hi:r;
+}
+
+// Finds the mean and the principal axis of the first n channels
+OGLPLUS_LIB_FUNC
+void BCPrincipalAxis(const BCBlock& block, int n, float mean[4], float axis[4])
+{
+	for(int c=0; c!=4; ++c)
+	{
+		mean[c] = 0.0f;
+		axis[c] = 0.0f;
+	}
+	for(int i=0; i!=16; ++i)
+	{
+		for(int c=0; c!=n; ++c) mean[c] += block.px[i][c];
+	}
+	for(int c=0; c!=n; ++c) mean[c] /= 16.0f;
+
+	float cov[4][4] = {{0}};
+	for(int i=0; i!=16; ++i)
+	{
+		float d[4];
+		for(int c=0; c!=n; ++c) d[c] = block.px[i][c]-mean[c];
+		for(int r=0; r!=n; ++r)
+		for(int c=0; c!=n; ++c)
+		{
+			cov[r][c] += d[r]*d[c];
+		}
+	}
+
+	// start the power iteration with the row of the largest variance
+	int start = 0;
+	for(int c=1; c!=n; ++c)
+	{
+		if(cov[c][c] > cov[start][start]) start = c;
+	}
+	if(cov[start][start] <= 0.0f)
+	{
+		axis[0] = 1.0f;
+		return;
+	}
+	for(int c=0; c!=n; ++c) axis[c] = cov[start][c];
+
+	for(int k=0; k!=8; ++k)
+	{
+		float t[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+		float l = 0.0f;
+		for(int r=0; r!=n; ++r)
+		{
+			for(int c=0; c!=n; ++c) t[r] += cov[r][c]*axis[c];
+			l += t[r]*t[r];
+		}
+		if(l <= 0.0f) break;
+		l = 1.0f/std::sqrt(l);
+		for(int c=0; c!=n; ++c) axis[c] = t[c]*l;
+	}
+}
+
+// Finds the extremes of the block pixels projected onto the principal axis
+OGLPLUS_LIB_FUNC
+void BCAxisEndpoints(
+	const BCBlock& block,
+	int n,
+	float lo,
+	float hi,
+	float e0[4],
+	float e1[4]
+)
+{
+	float mean[4], axis[4];
+	BCPrincipalAxis(block, n, mean, axis);
+
+	float tmin = 0.0f, tmax = 0.0f;
+	for(int i=0; i!=16; ++i)
+	{
+		float t = 0.0f;
+		for(int c=0; c!=n; ++c) t += (block.px[i][c]-mean[c])*axis[c];
+		if(tmin > t) tmin = t;
+		if(tmax < t) tmax = t;
+	}
+	for(int c=0; c!=n; ++c)
+	{
+		e0[c] = std::min(std::max(mean[c]+axis[c]*tmax, lo), hi);
+		e1[c] = std::min(std::max(mean[c]+axis[c]*tmin, lo), hi);
+	}
+}
+
+// Solves the least squares fit of two endpoints for the given weights
+// of the first endpoint (the second has weight 1-w)
+OGLPLUS_LIB_FUNC
+bool BCLeastSquares(
+	const BCBlock& block,
+	int n,
+	int first,
+	const float w[16],
+	float e0[4],
+	float e1[4]
+)
+{
+	float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+	float ax[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+	float bx[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+	for(int i=0; i!=16; ++i)
+	{
+		const float a = w[i], b = 1.0f-w[i];
+		aa += a*a;
+		ab += a*b;
+		bb += b*b;
+		for(int c=0; c!=n; ++c)
+		{
+			ax[c] += a*block.px[i][first+c];
+			bx[c] += b*block.px[i][first+c];
+		}
+	}
+	const float det = aa*bb-ab*ab;
+	if(std::fabs(det) < 1e-6f) return false;
+	for(int c=0; c!=n; ++c)
+	{
+		e0[c] = (ax[c]*bb-bx[c]*ab)/det;
+		e1[c] = (bx[c]*aa-ax[c]*ab)/det;
+	}
+	return true;
+}
+
+// BC4 (RGTC1) - a single channel
+
+inline void BC4Palette(int e0, int e1, bool snorm, float pal[8])
+{
+	pal[0] = float(e0);
+	pal[1] = float(e1);
+	if(e0 > e1)
+	{
+		for(int i=1; i!=7; ++i)
+		{
+			pal[i+1] = ((7-i)*e0+i*e1)/7.0f;
+		}
+	}
+	else
+	{
+		for(int i=1; i!=5; ++i)
+		{
+			pal[i+1] = ((5-i)*e0+i*e1)/5.0f;
+		}
+		pal[6] = snorm?-127.0f:0.0f;
+		pal[7] = snorm?+127.0f:255.0f;
+	}
+}
+
+inline float BC4Indices(const float v[16], const float pal[8], unsigned idx[16])
+{
+	float err = 0.0f;
+	for(int i=0; i!=16; ++i)
+	{
+		unsigned best = 0;
+		float best_d = (v[i]-pal[0])*(v[i]-pal[0]);
+		for(unsigned k=1; k!=8; ++k)
+		{
+			const float d = (v[i]-pal[k])*(v[i]-pal[k]);
+			if(best_d > d)
+			{
+				best_d = d;
+				best = k;
+			}
+		}
+		idx[i] = best;
+		err += best_d;
+	}
+	return err;
+}
+
+OGLPLUS_LIB_FUNC
+void BC4EncodeBlock(
+	const BCBlock& block,
+	int channel,
+	bool snorm,
+	bool high_quality,
+	unsigned char* out
+)
+{
+	const int lo = snorm?-127:0;
+	const int hi = snorm?+127:255;
+
+	float v[16];
+	float vmin = block.px[0][channel], vmax = vmin;
+	for(int i=0; i!=16; ++i)
+	{
+		v[i] = block.px[i][channel];
+		if(vmin > v[i]) vmin = v[i];
+		if(vmax < v[i]) vmax = v[i];
+	}
+
+	int b0 = BCRound(vmax, lo, hi), b1 = BCRound(vmin, lo, hi);
+	float pal[8];
+	unsigned best_idx[16], idx[16];
+	BC4Palette(b0, b1, snorm, pal);
+	float best = BC4Indices(v, pal, best_idx);
+
+	if(high_quality && (best > 0.0f))
+	{
+		// least-squares refinement in the 8-value mode
+		std::memcpy(idx, best_idx, sizeof(idx));
+		for(int k=0; k!=4; ++k)
+		{
+			float w[16];
+			for(int i=0; i!=16; ++i)
+			{
+				w[i] =	(idx[i] == 0)?1.0f:
+					(idx[i] == 1)?0.0f:
+					(8-int(idx[i]))/7.0f;
+			}
+			BCBlock tmp;
+			for(int i=0; i!=16; ++i) tmp.px[i][0] = v[i];
+			float e0, e1;
+			if(!BCLeastSquares(tmp, 1, 0, w, &e0, &e1)) break;
+			const int r0 = BCRound(e0, lo, hi);
+			const int r1 = BCRound(e1, lo, hi);
+			if(r0 <= r1) break;
+			BC4Palette(r0, r1, snorm, pal);
+			const float err = BC4Indices(v, pal, idx);
+			if(err >= best) break;
+			best = err;
+			b0 = r0;
+			b1 = r1;
+			std::memcpy(best_idx, idx, sizeof(idx));
+		}
+
+		// the 6-value mode with the extremes of the range
+		float imin = float(hi), imax = float(lo);
+		for(int i=0; i!=16; ++i)
+		{
+			if((v[i] < lo+0.5f) || (v[i] > hi-0.5f)) continue;
+			if(imin > v[i]) imin = v[i];
+			if(imax < v[i]) imax = v[i];
+		}
+		if(imin <= imax)
+		{
+			const int r0 = BCRound(imin, lo, hi);
+			const int r1 = BCRound(imax, lo, hi);
+			BC4Palette(r0, r1, snorm, pal);
+			const float err = BC4Indices(v, pal, idx);
+			if(err < best)
+			{
+				best = err;
+				b0 = r0;
+				b1 = r1;
+				std::memcpy(best_idx, idx, sizeof(idx));
+			}
+		}
+	}
+
+	out[0] = (unsigned char)(b0 & 0xFF);
+	out[1] = (unsigned char)(b1 & 0xFF);
+	for(int k=0; k!=2; ++k)
+	{
+		unsigned bits = 0;
+		for(int i=0; i!=8; ++i)
+		{
+			bits |= best_idx[k*8+i] << (3*i);
+		}
+		out[2+k*3+0] = (unsigned char)((bits >>  0) & 0xFF);
+		out[2+k*3+1] = (unsigned char)((bits >>  8) & 0xFF);
+		out[2+k*3+2] = (unsigned char)((bits >> 16) & 0xFF);
+	}
+}
+
+// BC1 (S3TC DXT1) - opaque RGB
+
+inline unsigned BC1Pack565(const float c[3])
+{
+	return	unsigned(BCRound(c[0]*31.0f/255.0f, 0, 31) << 11) |
+		unsigned(BCRound(c[1]*63.0f/255.0f, 0, 63) <<  5) |
+		unsigned(BCRound(c[2]*31.0f/255.0f, 0, 31) <<  0);
+}
+
+inline void BC1Unpack565(unsigned v, float c[3])
+{
+	const unsigned r = (v >> 11) & 0x1F;
+	const unsigned g = (v >>  5) & 0x3F;
+	const unsigned b = (v >>  0) & 0x1F;
+	c[0] = float((r << 3) | (r >> 2));
+	c[1] = float((g << 2) | (g >> 4));
+	c[2] = float((b << 3) | (b >> 2));
+}
+
+// Assigns the indices for the (4-color mode) endpoints, returns the error
+inline float BC1Indices(
+	const BCBlock& block,
+	unsigned c0,
+	unsigned c1,
+	unsigned idx[16]
+)
+{
+	float pal[4][3];
+	BC1Unpack565(c0, pal[0]);
+	BC1Unpack565(c1, pal[1]);
+	for(int c=0; c!=3; ++c)
+	{
+		pal[2][c] = (2*pal[0][c]+pal[1][c])/3.0f;
+		pal[3][c] = (pal[0][c]+2*pal[1][c])/3.0f;
+	}
+
+	float err = 0.0f;
+	for(int i=0; i!=16; ++i)
+	{
+		unsigned best = 0;
+		float best_d = 0.0f;
+		for(unsigned k=0; k!=4; ++k)
+		{
+			float d = 0.0f;
+			for(int c=0; c!=3; ++c)
+			{
+				const float t = block.px[i][c]-pal[k][c];
+				d += t*t;
+			}
+			if((k == 0) || (best_d > d))
+			{
+				best_d = d;
+				best = k;
+			}
+		}
+		idx[i] = best;
+		err += best_d;
+	}
+	return err;
+}
+
+// Orders the endpoints so that the block is decoded in the 4-color mode
+inline void BC1OrderEndpoints(unsigned& c0, unsigned& c1)
+{
+	if(c0 < c1) std::swap(c0, c1);
+	if(c0 == c1)
+	{
+		if(c1 > 0) --c1;
+		else ++c0;
+	}
+}
+
+OGLPLUS_LIB_FUNC
+void BC1EncodeBlock(const BCBlock& block, bool high_quality, unsigned char* out)
+{
+	float e0[4], e1[4];
+	BCAxisEndpoints(block, 3, 0.0f, 255.0f, e0, e1);
+
+	unsigned b0 = BC1Pack565(e0), b1 = BC1Pack565(e1);
+	BC1OrderEndpoints(b0, b1);
+
+	unsigned best_idx[16], idx[16];
+	float best = BC1Indices(block, b0, b1, best_idx);
+
+	if(high_quality && (best > 0.0f))
+	{
+		std::memcpy(idx, best_idx, sizeof(idx));
+		for(int k=0; k!=4; ++k)
+		{
+			static const float weights[4] = {
+				1.0f, 0.0f, 2.0f/3.0f, 1.0f/3.0f
+			};
+			float w[16];
+			for(int i=0; i!=16; ++i) w[i] = weights[idx[i]];
+			if(!BCLeastSquares(block, 3, 0, w, e0, e1)) break;
+
+			unsigned r0 = BC1Pack565(e0), r1 = BC1Pack565(e1);
+			BC1OrderEndpoints(r0, r1);
+			const float err = BC1Indices(block, r0, r1, idx);
+			if(err >= best) break;
+			best = err;
+			b0 = r0;
+			b1 = r1;
+			std::memcpy(best_idx, idx, sizeof(idx));
+		}
+	}
+
+	unsigned bits = 0;
+	for(int i=0; i!=16; ++i)
+	{
+		bits |= best_idx[i] << (2*i);
+	}
+	out[0] = (unsigned char)(b0 & 0xFF);
+	out[1] = (unsigned char)(b0 >> 8);
+	out[2] = (unsigned char)(b1 & 0xFF);
+	out[3] = (unsigned char)(b1 >> 8);
+	out[4] = (unsigned char)((bits >>  0) & 0xFF);
+	out[5] = (unsigned char)((bits >>  8) & 0xFF);
+	out[6] = (unsigned char)((bits >> 16) & 0xFF);
+	out[7] = (unsigned char)((bits >> 24) & 0xFF);
+}
+
+// BC7 (BPTC) - RGBA, encoded in mode 6 (a single subset with
+// 7-bit RGBA endpoints, a p-bit per endpoint and 4-bit indices)
+
+inline int BC7Weight(unsigned i)
+{
+	static const int weights[16] = {
+		0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64
+	};
+	return weights[i];
+}
+
+inline void BC7Quantize(const float e[4], int p, int q[4])
+{
+	for(int c=0; c!=4; ++c)
+	{
+		q[c] = BCRound((e[c]-p)*0.5f, 0, 127)*2+p;
+	}
+}
+
+// Assigns the indices for the (unquantized) endpoints, returns the error
+inline float BC7Indices(
+	const BCBlock& block,
+	const int q0[4],
+	const int q1[4],
+	unsigned idx[16]
+)
+{
+	float pal[16][4];
+	for(unsigned k=0; k!=16; ++k)
+	{
+		const int w = BC7Weight(k);
+		for(int c=0; c!=4; ++c)
+		{
+			pal[k][c] = float(((64-w)*q0[c]+w*q1[c]+32) >> 6);
+		}
+	}
+
+	float err = 0.0f;
+	for(int i=0; i!=16; ++i)
+	{
+		unsigned best = 0;
+		float best_d = 0.0f;
+		for(unsigned k=0; k!=16; ++k)
+		{
+			float d = 0.0f;
+			for(int c=0; c!=4; ++c)
+			{
+				const float t = block.px[i][c]-pal[k][c];
+				d += t*t;
+			}
+			if((k == 0) || (best_d > d))
+			{
+				best_d = d;
+				best = k;
+			}
+		}
+		idx[i] = best;
+		err += best_d;
+	}
+	return err;
+}
+
+// Quantizes the endpoints with the best combination of p-bits
+inline float BC7QuantizeBest(
+	const BCBlock& block,
+	const float e0[4],
+	const float e1[4],
+	int q0[4],
+	int q1[4],
+	unsigned idx[16]
+)
+{
+	float best = -1.0f;
+	for(int p=0; p!=4; ++p)
+	{
+		int t0[4], t1[4];
+		unsigned tidx[16];
+		BC7Quantize(e0, p & 1, t0);
+		BC7Quantize(e1, p >> 1, t1);
+		const float err = BC7Indices(block, t0, t1, tidx);
+		if((best < 0.0f) || (best > err))
+		{
+			best = err;
+			std::memcpy(q0, t0, sizeof(t0));
+			std::memcpy(q1, t1, sizeof(t1));
+			std::memcpy(idx, tidx, sizeof(tidx));
+		}
+	}
+	return best;
+}
+
+// Writes bits into the zero-initialized output block (LSB first)
+class BCBitWriter
+{
+private:
+	unsigned char* _out;
+	unsigned _pos;
+public:
+	BCBitWriter(unsigned char* out)
+	 : _out(out)
+	 , _pos(0)
+	{ }
+
+	void Put(unsigned value, unsigned bits)
+	{
+		for(unsigned b=0; b!=bits; ++b)
+		{
+			if((value >> b) & 1)
+			{
+				_out[_pos >> 3] |= (unsigned char)(1 << (_pos & 7));
+			}
+			++_pos;
+		}
+	}
+};
+
+OGLPLUS_LIB_FUNC
+void BC7EncodeBlock(const BCBlock& block, bool high_quality, unsigned char* out)
+{
+	float e0[4], e1[4];
+	BCAxisEndpoints(block, 4, 0.0f, 255.0f, e0, e1);
+
+	int q0[4], q1[4];
+	unsigned best_idx[16];
+	float best = BC7QuantizeBest(block, e0, e1, q0, q1, best_idx);
+
+	if(high_quality && (best > 0.0f))
+	{
+		unsigned idx[16];
+		std::memcpy(idx, best_idx, sizeof(idx));
+		for(int k=0; k!=4; ++k)
+		{
+			float w[16];
+			for(int i=0; i!=16; ++i)
+			{
+				w[i] = (64-BC7Weight(idx[i]))/64.0f;
+			}
+			if(!BCLeastSquares(block, 4, 0, w, e0, e1)) break;
+
+			int t0[4], t1[4];
+			const float err = BC7QuantizeBest(block, e0, e1, t0, t1, idx);
+			if(err >= best) break;
+			best = err;
+			std::memcpy(q0, t0, sizeof(t0));
+			std::memcpy(q1, t1, sizeof(t1));
+			std::memcpy(best_idx, idx, sizeof(idx));
+		}
+	}
+
+	// the most significant bit of the first (anchor) index is implied 0
+	if(best_idx[0] & 0x8)
+	{
+		for(int c=0; c!=4; ++c) std::swap(q0[c], q1[c]);
+		for(int i=0; i!=16; ++i) best_idx[i] = 15-best_idx[i];
+	}
+
+	std::memset(out, 0, 16);
+	BCBitWriter bits(out);
+	bits.Put(1 << 6, 7);
+	for(int c=0; c!=4; ++c)
+	{
+		bits.Put(unsigned(q0[c] >> 1), 7);
+		bits.Put(unsigned(q1[c] >> 1), 7);
+	}
+	bits.Put(unsigned(q0[0] & 1), 1);
+	bits.Put(unsigned(q1[0] & 1), 1);
+	bits.Put(best_idx[0], 3);
+	for(int i=1; i!=16; ++i)
+	{
+		bits.Put(best_idx[i], 4);
+	}
+}
+
+} // namespace aux
+
+OGLPLUS_LIB_FUNC
+PixelDataInternalFormat CompressedImage::_get_internal(
+	const BlockCompressionParams& params
+)
+{
+	GLenum result = GL_NONE;
+	switch(params.format)
+	{
+		case BlockCompression::BC1:
+			result = params.srgb?
+				GL_COMPRESSED_SRGB_S3TC_DXT1_EXT:
+				GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+			break;
+		case BlockCompression::BC3:
+			result = params.srgb?
+				GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT:
+				GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+			break;
+		case BlockCompression::BC4:
+			result = params.snorm?
+				GL_COMPRESSED_SIGNED_RED_RGTC1:
+				GL_COMPRESSED_RED_RGTC1;
+			break;
+		case BlockCompression::BC5:
+			result = params.snorm?
+				GL_COMPRESSED_SIGNED_RG_RGTC2:
+				GL_COMPRESSED_RG_RGTC2;
+			break;
+		case BlockCompression::BC7:
+			result = params.srgb?
+				GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM:
+				GL_COMPRESSED_RGBA_BPTC_UNORM;
+			break;
+	}
+	return PixelDataInternalFormat(result);
+}
+
+OGLPLUS_LIB_FUNC
+CompressedImage::CompressedImage(
+	const ImageView& image,
+	const BlockCompressionParams& params
+): _width(GLsizei(image.Width()))
+ , _height(GLsizei(image.Height()))
+ , _format(params.format)
+ , _internal(_get_internal(params))
+{
+	if(image.Depth() != 1)
+	{
+		throw std::runtime_error(
+			"Block compression of 3D images is not supported"
+		);
+	}
+	if((_width == 0) || (_height == 0))
+	{
+		throw std::runtime_error(
+			"Unable to block-compress an empty image"
+		);
+	}
+
+	const GLsizei bw = (_width+3)/4;
+	const GLsizei bh = (_height+3)/4;
+	const std::size_t block_size = BlockSize(_format);
+	_storage = oglplus::aux::AlignedPODArray(
+		static_cast<const GLubyte*>(nullptr),
+		std::size_t(bw*bh)*block_size
+	);
+
+	const bool snorm = params.snorm && (
+		(_format == BlockCompression::BC4) ||
+		(_format == BlockCompression::BC5)
+	);
+	const bool hq = params.high_quality;
+	const BlockCompression format = _format;
+	unsigned char* data = static_cast<unsigned char*>(_storage.begin());
+
+	oglplus::aux::ParallelFor(
+		std::size_t(bh),
+		1,
+		[&](std::size_t begin, std::size_t end)
+		{
+			aux::BCBlock block;
+			for(std::size_t by=begin; by!=end; ++by)
+			for(GLsizei bx=0; bx!=bw; ++bx)
+			{
+				aux::BCFetchBlock(image, bx, GLsizei(by), snorm, block);
+				unsigned char* out = data+
+					(by*std::size_t(bw)+std::size_t(bx))*
+					block_size;
+				switch(format)
+				{
+					case BlockCompression::BC1:
+						aux::BC1EncodeBlock(block, hq, out);
+						break;
+					case BlockCompression::BC3:
+						aux::BC4EncodeBlock(block, 3, false, hq, out);
+						aux::BC1EncodeBlock(block, hq, out+8);
+						break;
+					case BlockCompression::BC4:
+						aux::BC4EncodeBlock(block, 0, snorm, hq, out);
+						break;
+					case BlockCompression::BC5:
+						aux::BC4EncodeBlock(block, 0, snorm, hq, out);
+						aux::BC4EncodeBlock(block, 1, snorm, hq, out+8);
+						break;
+					case BlockCompression::BC7:
+						aux::BC7EncodeBlock(block, hq, out);
+						break;
+				}
+			}
+		},
+		params.max_threads
+	);
+}
+
+} // namespace images
+} // namespace oglplus
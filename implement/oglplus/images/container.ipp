@@ -0,0 +1,618 @@
+/**
+ *  @file oglplus/images/container.ipp
+ *  @brief Implementation of the KTX and DDS texture container loader
+ *
+ *  @author Matus Chochlik
+ *
+ *  Copyright 2010-2015 Matus Chochlik. Distributed under the Boost
+ *  Software License, Version 1.0. (See accompanying file
+ *  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include <stdexcept>
+#include <algorithm>
+#include <fstream>
+#include <cstring>
+#include <string>
+
+namespace oglplus {
+namespace images {
+namespace aux {
+
+inline GLuint ContainerGetUInt32(const unsigned char* p)
+{
+	return	GLuint(p[0]) | (GLuint(p[1]) << 8) |
+		(GLuint(p[2]) << 16) | (GLuint(p[3]) << 24);
+}
+
+inline GLuint ContainerFourCC(char a, char b, char c, char d)
+{
+	return	GLuint(GLubyte(a)) | (GLuint(GLubyte(b)) << 8) |
+		(GLuint(GLubyte(c)) << 16) | (GLuint(GLubyte(d)) << 24);
+}
+
+inline std::size_t ContainerPad(std::size_t size, std::size_t align)
+{
+	return ((size+align-1)/align)*align;
+}
+
+OGLPLUS_LIB_FUNC
+void ContainerSwapBytes(unsigned char* data, std::size_t size, std::size_t n)
+{
+	for(std::size_t i=0; i+n<=size; i+=n)
+	{
+		std::reverse(data+i, data+i+n);
+	}
+}
+
+OGLPLUS_LIB_FUNC
+GLsizei ContainerChannels(GLenum format)
+{
+	switch(format)
+	{
+		case GL_RED:
+		case GL_GREEN:
+		case GL_BLUE:
+		case GL_ALPHA:
+		case GL_RED_INTEGER:
+		case GL_DEPTH_COMPONENT:
+		case GL_STENCIL_INDEX:
+			return 1;
+		case GL_RG:
+		case GL_RG_INTEGER:
+		case GL_DEPTH_STENCIL:
+			return 2;
+		case GL_RGB:
+		case GL_BGR:
+		case GL_RGB_INTEGER:
+		case GL_BGR_INTEGER:
+			return 3;
+		case GL_RGBA:
+		case GL_BGRA:
+		case GL_RGBA_INTEGER:
+		case GL_BGRA_INTEGER:
+			return 4;
+		default:;
+	}
+	return 0;
+}
+
+// The GL formats corresponding to a DDS pixel format
+struct DDSFormat
+{
+	GLenum type, format, internal;
+	GLsizei channels;
+	std::size_t block_size;
+};
+
+OGLPLUS_LIB_FUNC
+bool DDSUncompressed(
+	DDSFormat& result,
+	GLenum type,
+	GLenum format,
+	GLenum internal,
+	GLsizei channels
+)
+{
+	result.type = type;
+	result.format = format;
+	result.internal = internal;
+	result.channels = channels;
+	result.block_size = 0;
+	return true;
+}
+
+OGLPLUS_LIB_FUNC
+bool DDSCompressed(
+	DDSFormat& result,
+	GLenum internal,
+	GLenum base_format,
+	std::size_t block_size
+)
+{
+	result.type = GL_UNSIGNED_BYTE;
+	result.format = base_format;
+	result.internal = internal;
+	result.channels = 0;
+	result.block_size = block_size;
+	return true;
+}
+
+OGLPLUS_LIB_FUNC
+bool DDSFormatFromDXGI(GLuint dxgi, DDSFormat& r)
+{
+	switch(dxgi)
+	{
+		case 2: return DDSUncompressed(r,
+			GL_FLOAT, GL_RGBA, GL_RGBA32F, 4
+		);
+		case 10: return DDSUncompressed(r,
+			GL_HALF_FLOAT, GL_RGBA, GL_RGBA16F, 4
+		);
+		case 28: return DDSUncompressed(r,
+			GL_UNSIGNED_BYTE, GL_RGBA, GL_RGBA8, 4
+		);
+		case 29: return DDSUncompressed(r,
+			GL_UNSIGNED_BYTE, GL_RGBA, GL_SRGB8_ALPHA8, 4
+		);
+		case 41: return DDSUncompressed(r,
+			GL_FLOAT, GL_RED, GL_R32F, 1
+		);
+		case 49: return DDSUncompressed(r,
+			GL_UNSIGNED_BYTE, GL_RG, GL_RG8, 2
+		);
+		case 54: return DDSUncompressed(r,
+			GL_HALF_FLOAT, GL_RED, GL_R16F, 1
+		);
+		case 61: return DDSUncompressed(r,
+			GL_UNSIGNED_BYTE, GL_RED, GL_R8, 1
+		);
+		case 87: return DDSUncompressed(r,
+			GL_UNSIGNED_BYTE, GL_BGRA, GL_RGBA8, 4
+		);
+		case 71: return DDSCompressed(r,
+			GL_COMPRESSED_RGBA_S3TC_DXT1_EXT, GL_RGBA, 8
+		);
+		case 72: return DDSCompressed(r,
+			GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT, GL_RGBA, 8
+		);
+		case 74: return DDSCompressed(r,
+			GL_COMPRESSED_RGBA_S3TC_DXT3_EXT, GL_RGBA, 16
+		);
+		case 75: return DDSCompressed(r,
+			GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT, GL_RGBA, 16
+		);
+		case 77: return DDSCompressed(r,
+			GL_COMPRESSED_RGBA_S3TC_DXT5_EXT, GL_RGBA, 16
+		);
+		case 78: return DDSCompressed(r,
+			GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT, GL_RGBA, 16
+		);
+		case 80: return DDSCompressed(r,
+			GL_COMPRESSED_RED_RGTC1, GL_RED, 8
+		);
+		case 81: return DDSCompressed(r,
+			GL_COMPRESSED_SIGNED_RED_RGTC1, GL_RED, 8
+		);
+		case 83: return DDSCompressed(r,
+			GL_COMPRESSED_RG_RGTC2, GL_RG, 16
+		);
+		case 84: return DDSCompressed(r,
+			GL_COMPRESSED_SIGNED_RG_RGTC2, GL_RG, 16
+		);
+		case 95: return DDSCompressed(r,
+			GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT, GL_RGB, 16
+		);
+		case 96: return DDSCompressed(r,
+			GL_COMPRESSED_RGB_BPTC_SIGNED_FLOAT, GL_RGB, 16
+		);
+		case 98: return DDSCompressed(r,
+			GL_COMPRESSED_RGBA_BPTC_UNORM, GL_RGBA, 16
+		);
+		case 99: return DDSCompressed(r,
+			GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM, GL_RGBA, 16
+		);
+		default:;
+	}
+	return false;
+}
+
+OGLPLUS_LIB_FUNC
+bool DDSFormatFromFourCC(GLuint fourcc, DDSFormat& r)
+{
+	if(fourcc == ContainerFourCC('D','X','T','1'))
+	{
+		return DDSFormatFromDXGI(71, r);
+	}
+	if(fourcc == ContainerFourCC('D','X','T','3'))
+	{
+		return DDSFormatFromDXGI(74, r);
+	}
+	if(fourcc == ContainerFourCC('D','X','T','5'))
+	{
+		return DDSFormatFromDXGI(77, r);
+	}
+	if(	(fourcc == ContainerFourCC('A','T','I','1')) ||
+		(fourcc == ContainerFourCC('B','C','4','U'))
+	) return DDSFormatFromDXGI(80, r);
+	if(fourcc == ContainerFourCC('B','C','4','S'))
+	{
+		return DDSFormatFromDXGI(81, r);
+	}
+	if(	(fourcc == ContainerFourCC('A','T','I','2')) ||
+		(fourcc == ContainerFourCC('B','C','5','U'))
+	) return DDSFormatFromDXGI(83, r);
+	if(fourcc == ContainerFourCC('B','C','5','S'))
+	{
+		return DDSFormatFromDXGI(84, r);
+	}
+	// the D3DFORMAT codes of the floating-point formats
+	switch(fourcc)
+	{
+		case 111: return DDSFormatFromDXGI(54, r);
+		case 113: return DDSFormatFromDXGI(10, r);
+		case 114: return DDSFormatFromDXGI(41, r);
+		case 116: return DDSFormatFromDXGI(2, r);
+		default:;
+	}
+	return false;
+}
+
+OGLPLUS_LIB_FUNC
+bool DDSFormatFromMasks(
+	GLuint flags,
+	GLuint bits,
+	GLuint rmask,
+	GLuint amask,
+	DDSFormat& r
+)
+{
+	const GLuint DDPF_ALPHAPIXELS = 0x1;
+	const GLuint DDPF_RGB = 0x40;
+	const GLuint DDPF_LUMINANCE = 0x20000;
+
+	const bool alpha = ((flags & DDPF_ALPHAPIXELS) != 0) && (amask != 0);
+
+	if((flags & DDPF_RGB) != 0)
+	{
+		if((bits == 32) && alpha)
+		{
+			if(rmask == 0x000000FF) return DDSFormatFromDXGI(28, r);
+			if(rmask == 0x00FF0000) return DDSFormatFromDXGI(87, r);
+		}
+		else if((bits == 24) && !alpha)
+		{
+			if(rmask == 0x000000FF)
+			{
+				return DDSUncompressed(r,
+					GL_UNSIGNED_BYTE, GL_RGB, GL_RGB8, 3
+				);
+			}
+			if(rmask == 0x00FF0000)
+			{
+				return DDSUncompressed(r,
+					GL_UNSIGNED_BYTE, GL_BGR, GL_RGB8, 3
+				);
+			}
+		}
+	}
+	else if(((flags & DDPF_LUMINANCE) != 0) && (bits == 8))
+	{
+		return DDSFormatFromDXGI(61, r);
+	}
+	return false;
+}
+
+} // namespace aux
+
+OGLPLUS_LIB_FUNC
+std::size_t TextureContainer::_image_size(GLsizei level) const
+{
+	const std::size_t w = std::size_t(_mip(_width, level));
+	const std::size_t h = std::size_t(_mip(_height, level));
+	const std::size_t d = std::size_t(_mip(_depth, level));
+	if(_compressed)
+	{
+		return ((w+3)/4)*((h+3)/4)*d*_block_size;
+	}
+	const std::size_t row = aux::ContainerPad(
+		w*std::size_t(_channels)*ImageView::ComponentSize(_type),
+		std::size_t(_alignment)
+	);
+	return row*h*d;
+}
+
+OGLPLUS_LIB_FUNC
+void TextureContainer::_add_image(std::size_t offset, std::size_t size)
+{
+	if(offset+size > _mapped.size())
+	{
+		throw std::runtime_error("Texture container file is truncated");
+	}
+	_offsets.push_back(offset);
+	_sizes.push_back(size);
+}
+
+OGLPLUS_LIB_FUNC
+void TextureContainer::_load_ktx(const char* path)
+{
+	unsigned char* data = static_cast<unsigned char*>(_mapped.begin());
+	const std::size_t size = _mapped.size();
+	const std::size_t header_size = 12+13*4;
+	if(size < header_size)
+	{
+		throw std::runtime_error("Invalid KTX file header");
+	}
+	unsigned char* header = data+12;
+
+	bool swap = false;
+	if(aux::ContainerGetUInt32(header) != 0x04030201)
+	{
+		if(aux::ContainerGetUInt32(header) != 0x01020304)
+		{
+			throw std::runtime_error("Invalid KTX file endianness");
+		}
+		swap = true;
+		aux::ContainerSwapBytes(header, 13*4, 4);
+	}
+	GLuint h[13];
+	for(std::size_t i=0; i!=13; ++i)
+	{
+		h[i] = aux::ContainerGetUInt32(header+i*4);
+	}
+	const GLuint gl_type = h[1];
+	const GLuint gl_type_size = h[2];
+
+	_compressed = (gl_type == 0);
+	_type = PixelDataType(_compressed?GL_UNSIGNED_BYTE:gl_type);
+	_format = PixelDataFormat(_compressed?h[5]:h[3]);
+	_internal = PixelDataInternalFormat(h[4]);
+	_channels = _compressed?0:
+		ImageView::IsPacked(_type)?1:
+		aux::ContainerChannels(h[3]);
+	_width = GLsizei(h[6]);
+	_height = GLsizei(h[7]?h[7]:1);
+	_depth = GLsizei(h[8]?h[8]:1);
+	_layers = GLsizei(h[9]?h[9]:1);
+	_is_array = (h[9] != 0);
+	_faces = GLsizei(h[10]);
+	_levels = GLsizei(h[11]?h[11]:1);
+	_alignment = 4;
+
+	if((_width == 0) || ((_faces != 1) && (_faces != 6)))
+	{
+		throw std::runtime_error(
+			std::string("Unsupported KTX file '")+path+"'"
+		);
+	}
+	std::size_t offs = header_size+std::size_t(h[12]);
+	const std::size_t images = std::size_t(_layers*_faces);
+
+	for(GLsizei level=0; level!=_levels; ++level)
+	{
+		if(offs+4 > size)
+		{
+			throw std::runtime_error(
+				"Texture container file is truncated"
+			);
+		}
+		if(swap) aux::ContainerSwapBytes(data+offs, 4, 4);
+		const std::size_t image_size = aux::ContainerGetUInt32(data+offs);
+		offs += 4;
+
+		if((_faces == 6) && !_is_array)
+		{
+			// the size of each face of non-array cube maps
+			for(GLsizei face=0; face!=6; ++face)
+			{
+				_add_image(offs, image_size);
+				offs += aux::ContainerPad(image_size, 4);
+			}
+		}
+		else
+		{
+			const std::size_t slice_size = image_size/images;
+			for(std::size_t i=0; i!=images; ++i)
+			{
+				_add_image(offs+i*slice_size, slice_size);
+			}
+			offs += aux::ContainerPad(image_size, 4);
+		}
+	}
+	// convert the data of big-endian files to the native byte order
+	if(swap && !_compressed && ((gl_type_size == 2) || (gl_type_size == 4)))
+	{
+		for(std::size_t i=0; i!=_offsets.size(); ++i)
+		{
+			aux::ContainerSwapBytes(
+				data+_offsets[i],
+				_sizes[i],
+				gl_type_size
+			);
+		}
+	}
+}
+
+OGLPLUS_LIB_FUNC
+void TextureContainer::_load_dds(const char* path)
+{
+	const unsigned char* data =
+		static_cast<const unsigned char*>(_mapped.begin());
+	const std::size_t size = _mapped.size();
+	if(size < 128)
+	{
+		throw std::runtime_error("Invalid DDS file header");
+	}
+	const GLuint DDSCAPS2_CUBEMAP = 0x200;
+	const GLuint DDSCAPS2_VOLUME = 0x200000;
+	const GLuint DDPF_FOURCC = 0x4;
+
+	const GLuint height = aux::ContainerGetUInt32(data+12);
+	const GLuint width = aux::ContainerGetUInt32(data+16);
+	const GLuint depth = aux::ContainerGetUInt32(data+24);
+	const GLuint levels = aux::ContainerGetUInt32(data+28);
+	const GLuint pf_flags = aux::ContainerGetUInt32(data+80);
+	const GLuint fourcc = aux::ContainerGetUInt32(data+84);
+	const GLuint caps2 = aux::ContainerGetUInt32(data+112);
+
+	std::size_t offs = 128;
+	bool is_volume = (caps2 & DDSCAPS2_VOLUME) != 0;
+	bool is_cube = (caps2 & DDSCAPS2_CUBEMAP) != 0;
+	GLuint layers = 1;
+
+	aux::DDSFormat fmt;
+	bool supported = false;
+
+	if((pf_flags & DDPF_FOURCC) != 0)
+	{
+		if(fourcc == aux::ContainerFourCC('D','X','1','0'))
+		{
+			if(size < 148)
+			{
+				throw std::runtime_error(
+					"Invalid DDS file header"
+				);
+			}
+			const GLuint dxgi = aux::ContainerGetUInt32(data+128);
+			const GLuint dim = aux::ContainerGetUInt32(data+132);
+			const GLuint misc = aux::ContainerGetUInt32(data+136);
+			layers = aux::ContainerGetUInt32(data+140);
+			is_volume = (dim == 4);
+			is_cube = (misc & 0x4) != 0;
+			_is_array = (layers > 1);
+			offs = 148;
+			supported = aux::DDSFormatFromDXGI(dxgi, fmt);
+		}
+		else supported = aux::DDSFormatFromFourCC(fourcc, fmt);
+	}
+	else
+	{
+		supported = aux::DDSFormatFromMasks(
+			pf_flags,
+			aux::ContainerGetUInt32(data+88),
+			aux::ContainerGetUInt32(data+92),
+			aux::ContainerGetUInt32(data+104),
+			fmt
+		);
+	}
+	if(!supported || (width == 0))
+	{
+		throw std::runtime_error(
+			std::string("Unsupported DDS file '")+path+"'"
+		);
+	}
+	_width = GLsizei(width);
+	_height = GLsizei(height?height:1);
+	_depth = GLsizei((is_volume && depth)?depth:1);
+	_layers = GLsizei(layers?layers:1);
+	_faces = is_cube?6:1;
+	_levels = GLsizei(levels?levels:1);
+	_alignment = 1;
+	_compressed = (fmt.block_size != 0);
+	_block_size = fmt.block_size;
+	_channels = fmt.channels;
+	_type = PixelDataType(fmt.type);
+	_format = PixelDataFormat(fmt.format);
+	_internal = PixelDataInternalFormat(fmt.internal);
+
+	// the images are stored by layer, face and level, but they
+	// are indexed by level, layer and face
+	const std::size_t count = std::size_t(_levels*_layers*_faces);
+	_offsets.resize(count);
+	_sizes.resize(count);
+	for(GLsizei layer=0; layer!=_layers; ++layer)
+	{
+		for(GLsizei face=0; face!=_faces; ++face)
+		{
+			for(GLsizei level=0; level!=_levels; ++level)
+			{
+				const std::size_t image_size = _image_size(level);
+				if(offs+image_size > size)
+				{
+					throw std::runtime_error(
+						"Texture container file is truncated"
+					);
+				}
+				const std::size_t i = _index(level, layer, face);
+				_offsets[i] = offs;
+				_sizes[i] = image_size;
+				offs += image_size;
+			}
+		}
+	}
+}
+
+OGLPLUS_LIB_FUNC
+TextureContainer::TextureContainer(const char* path)
+ : _width(0)
+ , _height(0)
+ , _depth(0)
+ , _layers(0)
+ , _faces(0)
+ , _levels(0)
+ , _channels(0)
+ , _alignment(1)
+ , _is_array(false)
+ , _compressed(false)
+ , _block_size(0)
+ , _type(PixelDataType::UnsignedByte)
+ , _format(PixelDataFormat::RGBA)
+ , _internal(PixelDataInternalFormat::RGBA)
+{
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+	if(!file.good())
+	{
+		throw std::runtime_error(
+			std::string("Unable to open file '")+path+"'"
+		);
+	}
+	const std::size_t size = std::size_t(file.tellg());
+	file.close();
+
+	if(size < 4)
+	{
+		throw std::runtime_error(
+			std::string("Unknown texture container '")+path+"'"
+		);
+	}
+	_mapped = oglplus::aux::AlignedPODArray::MapFile<GLubyte>(
+		path,
+		0, size
+	);
+	const unsigned char ktx_id[12] = {
+		0xAB, 0x4B, 0x54, 0x58, 0x20, 0x31,
+		0x31, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A
+	};
+	const unsigned char* data =
+		static_cast<const unsigned char*>(_mapped.begin());
+
+	if((size >= 12) && (std::memcmp(data, ktx_id, 12) == 0))
+	{
+		_load_ktx(path);
+	}
+	else if(std::memcmp(data, "DDS ", 4) == 0)
+	{
+		_load_dds(path);
+	}
+	else
+	{
+		throw std::runtime_error(
+			std::string("Unknown texture container '")+path+"'"
+		);
+	}
+}
+
+OGLPLUS_LIB_FUNC
+ImageView TextureContainer::View(
+	GLsizei level,
+	GLsizei layer,
+	GLsizei face
+) const
+{
+	const std::size_t comp_size = ImageView::ComponentSize(_type);
+	if(_compressed || (comp_size == 0) || (_channels == 0))
+	{
+		throw std::runtime_error(
+			"Unable to view compressed or packed texture images"
+		);
+	}
+	const std::size_t row = aux::ContainerPad(
+		std::size_t(_mip(_width, level)*_channels)*comp_size,
+		std::size_t(_alignment)
+	);
+	return ImageView(
+		Width(level),
+		Height(level),
+		Depth(level),
+		Channels(),
+		RawData(level, layer, face),
+		_type,
+		_format,
+		_internal,
+		std::ptrdiff_t(row)
+	);
+}
+
+} // namespace images
+} // namespace oglplus
+
@@ -0,0 +1,913 @@
+/**
+ *  @file oglplus/images/convert.ipp
+ *  @brief Implementation of images::Convert
+ *
+ *  @author Matus Chochlik
+ *
+ *  Copyright 2010-2015 Matus Chochlik. Distributed under the Boost
+ *  Software License, Version 1.0. (See accompanying file
+ *  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include <oglplus/lib/incl_begin.ipp>
+#include <oglplus/detail/parallel_for.hpp>
+#include <oglplus/detail/half_float.hpp>
+#include <oglplus/lib/incl_end.ipp>
+
+#include <stdexcept>
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+#include <vector>
+#include <cstring>
+#include <cmath>
+
+#if !OGLPLUS_NO_SIMD
+#include <emmintrin.h>
+#if defined(__F16C__)
+#include <immintrin.h>
+#endif
+#endif
+
+namespace oglplus {
+namespace images {
+namespace aux {
+
+// The components of a pixel data format, as indices of RGBA channels
+struct ConvertLayout
+{
+	GLsizei count;
+	GLsizei slot[4];
+};
+
+OGLPLUS_LIB_FUNC
+bool ConvertGetLayout(PixelDataFormat format, ConvertLayout& layout)
+{
+	static const GLsizei slots[8][4] = {
+		{0, 0, 0, 0}, // Red
+		{1, 0, 0, 0}, // Green
+		{2, 0, 0, 0}, // Blue
+		{0, 1, 0, 0}, // RG
+		{0, 1, 2, 0}, // RGB
+		{2, 1, 0, 0}, // BGR
+		{0, 1, 2, 3}, // RGBA
+		{2, 1, 0, 3}  // BGRA
+	};
+	std::size_t index = 0;
+	switch(GLenum(format))
+	{
+		case GL_RED:  index = 0; layout.count = 1; break;
+		case GL_GREEN:index = 1; layout.count = 1; break;
+		case GL_BLUE: index = 2; layout.count = 1; break;
+		case GL_RG:   index = 3; layout.count = 2; break;
+		case GL_RGB:  index = 4; layout.count = 3; break;
+		case GL_BGR:  index = 5; layout.count = 3; break;
+		case GL_RGBA: index = 6; layout.count = 4; break;
+		case GL_BGRA: index = 7; layout.count = 4; break;
+		default: return false;
+	}
+	std::copy(slots[index], slots[index]+4, layout.slot);
+	return true;
+}
+
+inline bool ConvertIsSRGB(PixelDataInternalFormat internal)
+{
+	return	(internal == PixelDataInternalFormat::SRGB8) ||
+		(internal == PixelDataInternalFormat::SRGB8Alpha8);
+}
+
+// Picks the sized internal format for the specified type and format
+OGLPLUS_LIB_FUNC
+PixelDataInternalFormat ConvertInternalFormat(
+	PixelDataType type,
+	GLsizei count,
+	bool srgb
+)
+{
+	typedef PixelDataInternalFormat PDIF;
+	static const PDIF ub[4] = {PDIF::R8, PDIF::RG8, PDIF::RGB8, PDIF::RGBA8};
+	static const PDIF b[4] = {
+		PDIF::R8SNorm, PDIF::RG8SNorm, PDIF::RGB8SNorm, PDIF::RGBA8SNorm
+	};
+	static const PDIF us[4] = {
+		PDIF::R16, PDIF::RG16, PDIF::RGB16, PDIF::RGBA16
+	};
+	static const PDIF s[4] = {
+		PDIF::R16SNorm, PDIF::RG16SNorm, PDIF::RGB16SNorm, PDIF::RGBA16SNorm
+	};
+	static const PDIF h[4] = {
+		PDIF::R16F, PDIF::RG16F, PDIF::RGB16F, PDIF::RGBA16F
+	};
+	static const PDIF f[4] = {
+		PDIF::R32F, PDIF::RG32F, PDIF::RGB32F, PDIF::RGBA32F
+	};
+	static const PDIF u[4] = {PDIF::Red, PDIF::RG, PDIF::RGB, PDIF::RGBA};
+
+	assert(count >= 1 && count <= 4);
+	const std::size_t i = std::size_t(count-1);
+	switch(GLenum(type))
+	{
+		case GL_UNSIGNED_BYTE:
+			if(srgb && (count == 3)) return PDIF::SRGB8;
+			if(srgb && (count == 4)) return PDIF::SRGB8Alpha8;
+			return ub[i];
+		case GL_BYTE: return b[i];
+		case GL_UNSIGNED_SHORT: return us[i];
+		case GL_SHORT: return s[i];
+		case GL_HALF_FLOAT: return h[i];
+		case GL_FLOAT: return f[i];
+		case GL_UNSIGNED_INT_10F_11F_11F_REV: return PDIF::R11FG11FB10F;
+		case GL_UNSIGNED_INT_5_9_9_9_REV: return PDIF::RGB9E5;
+		case GL_UNSIGNED_INT_2_10_10_10_REV: return PDIF::RGB10A2;
+		default:;
+	}
+	return u[i];
+}
+
+// Checks if the type and format can be converted, returns the number
+// of components per pixel in the image (i.e. 1 for the packed types)
+OGLPLUS_LIB_FUNC
+GLsizei ConvertCheck(
+	PixelDataType type,
+	PixelDataFormat format,
+	const ConvertLayout& layout
+)
+{
+	switch(GLenum(type))
+	{
+		case GL_UNSIGNED_BYTE:
+		case GL_BYTE:
+		case GL_UNSIGNED_SHORT:
+		case GL_SHORT:
+		case GL_UNSIGNED_INT:
+		case GL_INT:
+		case GL_HALF_FLOAT:
+		case GL_FLOAT:
+			return layout.count;
+		case GL_UNSIGNED_INT_10F_11F_11F_REV:
+		case GL_UNSIGNED_INT_5_9_9_9_REV:
+			if(format != PixelDataFormat::RGB)
+			{
+				throw std::runtime_error(
+					"Packed R11F_G11F_B10F and RGB9_E5 "
+					"images must have the RGB format"
+				);
+			}
+			return 1;
+		case GL_UNSIGNED_INT_2_10_10_10_REV:
+			if(layout.count != 4)
+			{
+				throw std::runtime_error(
+					"Packed RGB10_A2 images must have "
+					"the RGBA or BGRA format"
+				);
+			}
+			return 1;
+		default:;
+	}
+	throw std::runtime_error("Unsupported pixel data type for conversion");
+}
+
+OGLPLUS_LIB_FUNC
+oglplus::aux::AlignedPODArray ConvertAllocate(
+	PixelDataType type,
+	std::size_t count
+)
+{
+	typedef oglplus::aux::AlignedPODArray A;
+	switch(GLenum(type))
+	{
+		case GL_UNSIGNED_BYTE:
+			return A(static_cast<const GLubyte*>(nullptr), count);
+		case GL_BYTE:
+			return A(static_cast<const GLbyte*>(nullptr), count);
+		case GL_UNSIGNED_SHORT:
+		case GL_HALF_FLOAT:
+			return A(static_cast<const GLushort*>(nullptr), count);
+		case GL_SHORT:
+			return A(static_cast<const GLshort*>(nullptr), count);
+		case GL_INT:
+			return A(static_cast<const GLint*>(nullptr), count);
+		case GL_FLOAT:
+			return A(static_cast<const GLfloat*>(nullptr), count);
+		default:;
+	}
+	return A(static_cast<const GLuint*>(nullptr), count);
+}
+
+inline float ConvertSRGBToLinear(float v)
+{
+	if(v <= 0.04045f) return v/12.92f;
+	return std::pow((v+0.055f)/1.055f, 2.4f);
+}
+
+inline float ConvertLinearToSRGB(float v)
+{
+	if(!(v > 0.0f)) return 0.0f;
+	if(v <= 0.0031308f) return v*12.92f;
+	if(v >= 1.0f) return 1.0f;
+	return 1.055f*std::pow(v, 1.0f/2.4f)-0.055f;
+}
+
+// Normalized integer to float, signed values are clamped to -1
+template <typename T>
+inline float ConvertToFloat(T v)
+{
+	const float one = float(std::numeric_limits<T>::max());
+	const float f = float(v)/one;
+	return (f > -1.0f)?f:-1.0f;
+}
+
+// Float to normalized integer, NaNs are converted to zero
+template <typename T>
+inline T ConvertFromFloat(float v)
+{
+	// 32-bit integers cannot be represented exactly by floats
+	typedef typename std::conditional<
+		(sizeof(T) < 4),
+		float,
+		double
+	>::type F;
+	const F one = F(std::numeric_limits<T>::max());
+	const F lo = std::is_signed<T>::value?F(-1):F(0);
+	F f = (v == v)?F(v):F(0);
+	f = (f > lo)?f:lo;
+	f = (f < F(1))?f:F(1);
+	return T(f*one+((f < F(0))?F(-0.5):F(0.5)));
+}
+
+// Unsigned floats with 5-bit exponent and mbits-bit mantissa to float
+inline float ConvertUFloatToFloat(GLuint bits, int mbits)
+{
+	const GLuint e = bits >> mbits;
+	const GLuint m = bits & ((1u << mbits)-1);
+	if(e == 0) return std::ldexp(float(m), -14-mbits);
+	if(e == 31)
+	{
+		return (m == 0)?
+			std::numeric_limits<float>::infinity():
+			std::numeric_limits<float>::quiet_NaN();
+	}
+	return std::ldexp(float(m | (1u << mbits)), int(e)-15-mbits);
+}
+
+// Float to unsigned float with 5-bit exponent and mbits-bit mantissa
+/* The value is rounded to nearest even, negative values are converted
+ * to zero and finite values too large to be represented are clamped
+ * to the largest representable value.
+ */
+inline GLuint ConvertFloatToUFloat(float value, int mbits)
+{
+	if(!(value == value)) return (31u << mbits) | (1u << (mbits-1));
+	if(!(value > 0.0f)) return 0;
+
+	const GLuint max_finite = (30u << mbits) | ((1u << mbits)-1);
+	if(value == std::numeric_limits<float>::infinity())
+	{
+		return 31u << mbits;
+	}
+	std::uint32_t a;
+	std::memcpy(&a, &value, 4);
+	if(a >= 0x47800000) return max_finite;
+
+	std::uint32_t r, rem, half;
+	if(a < 0x38800000)
+	{
+		const std::uint32_t e = a >> 23;
+		const std::uint32_t shift = std::uint32_t(136-mbits)-e;
+		if(shift >= 25) return 0;
+		const std::uint32_t m = (a & 0x7FFFFF) | 0x800000;
+		r = m >> shift;
+		rem = m & ((1u << shift)-1);
+		half = 1u << (shift-1);
+	}
+	else
+	{
+		const std::uint32_t shift = std::uint32_t(23-mbits);
+		r = (a >> shift)-(112u << mbits);
+		rem = a & ((1u << shift)-1);
+		half = 1u << (shift-1);
+	}
+	if((rem > half) || ((rem == half) && (r & 1))) ++r;
+	return (r < max_finite)?r:max_finite;
+}
+
+inline void ConvertUnpackR11G11B10(GLuint p, float* dst)
+{
+	dst[0] = ConvertUFloatToFloat(p & 0x7FF, 6);
+	dst[1] = ConvertUFloatToFloat((p >> 11) & 0x7FF, 6);
+	dst[2] = ConvertUFloatToFloat(p >> 22, 5);
+}
+
+inline GLuint ConvertPackR11G11B10(const float* src)
+{
+	return	(ConvertFloatToUFloat(src[0], 6)) |
+		(ConvertFloatToUFloat(src[1], 6) << 11) |
+		(ConvertFloatToUFloat(src[2], 5) << 22);
+}
+
+inline void ConvertUnpackRGB9E5(GLuint p, float* dst)
+{
+	const int e = int(p >> 27)-15-9;
+	dst[0] = std::ldexp(float(p & 0x1FF), e);
+	dst[1] = std::ldexp(float((p >> 9) & 0x1FF), e);
+	dst[2] = std::ldexp(float((p >> 18) & 0x1FF), e);
+}
+
+// The encoding from the EXT_texture_shared_exponent specification
+OGLPLUS_LIB_FUNC
+GLuint ConvertPackRGB9E5(const float* src)
+{
+	const float max_value = 65408.0f;
+	float c[3];
+	for(int i=0; i!=3; ++i)
+	{
+		c[i] = (src[i] > 0.0f)?src[i]:0.0f;
+		c[i] = (c[i] < max_value)?c[i]:max_value;
+	}
+	const float max_c = std::max(std::max(c[0], c[1]), c[2]);
+	int exp_shared = -16;
+	if(max_c > 0.0f)
+	{
+		int e;
+		std::frexp(max_c, &e);
+		exp_shared = std::max(e-1, -16);
+	}
+	exp_shared += 1+15;
+
+	float max_m = std::floor(std::ldexp(max_c, 15+9-exp_shared)+0.5f);
+	if(max_m == 512.0f) ++exp_shared;
+
+	GLuint result = GLuint(exp_shared) << 27;
+	for(int i=0; i!=3; ++i)
+	{
+		const float m = std::floor(std::ldexp(c[i], 15+9-exp_shared)+0.5f);
+		result |= GLuint(m) << (9*i);
+	}
+	return result;
+}
+
+inline void ConvertUnpackRGB10A2(GLuint p, float* dst)
+{
+	dst[0] = float(p & 0x3FF)/1023.0f;
+	dst[1] = float((p >> 10) & 0x3FF)/1023.0f;
+	dst[2] = float((p >> 20) & 0x3FF)/1023.0f;
+	dst[3] = float(p >> 30)/3.0f;
+}
+
+inline GLuint ConvertUNorm(float v, float one)
+{
+	v = (v > 0.0f)?v:0.0f;
+	v = (v < 1.0f)?v:1.0f;
+	return GLuint(v*one+0.5f);
+}
+
+inline GLuint ConvertPackRGB10A2(const float* src)
+{
+	return	(ConvertUNorm(src[0], 1023.0f)) |
+		(ConvertUNorm(src[1], 1023.0f) << 10) |
+		(ConvertUNorm(src[2], 1023.0f) << 20) |
+		(ConvertUNorm(src[3], 3.0f) << 30);
+}
+
+#if !OGLPLUS_NO_SIMD
+// The SIMD kernels do the same operations as the scalar code above,
+// the results are therefore identical
+
+inline __m128 ConvertUNormToFloatX4(__m128i v, __m128 one)
+{
+	return _mm_div_ps(_mm_cvtepi32_ps(v), one);
+}
+
+inline __m128i ConvertFloatToUNormX4(const float* src, __m128 one)
+{
+	__m128 v = _mm_loadu_ps(src);
+	// _mm_max_ps returns the second operand if the first is NaN
+	v = _mm_max_ps(v, _mm_setzero_ps());
+	v = _mm_min_ps(v, _mm_set1_ps(1.0f));
+	v = _mm_add_ps(_mm_mul_ps(v, one), _mm_set1_ps(0.5f));
+	return _mm_cvttps_epi32(v);
+}
+
+inline std::size_t ConvertDecodeSIMD(
+	const GLubyte* src,
+	float* dst,
+	std::size_t count
+)
+{
+	const __m128 one = _mm_set1_ps(255.0f);
+	const __m128i zero = _mm_setzero_si128();
+	std::size_t i = 0;
+	for(; i+16 <= count; i += 16)
+	{
+		const __m128i b = _mm_loadu_si128(
+			reinterpret_cast<const __m128i*>(src+i)
+		);
+		const __m128i lo = _mm_unpacklo_epi8(b, zero);
+		const __m128i hi = _mm_unpackhi_epi8(b, zero);
+		_mm_storeu_ps(dst+i+ 0, ConvertUNormToFloatX4(
+			_mm_unpacklo_epi16(lo, zero), one
+		));
+		_mm_storeu_ps(dst+i+ 4, ConvertUNormToFloatX4(
+			_mm_unpackhi_epi16(lo, zero), one
+		));
+		_mm_storeu_ps(dst+i+ 8, ConvertUNormToFloatX4(
+			_mm_unpacklo_epi16(hi, zero), one
+		));
+		_mm_storeu_ps(dst+i+12, ConvertUNormToFloatX4(
+			_mm_unpackhi_epi16(hi, zero), one
+		));
+	}
+	return i;
+}
+
+inline std::size_t ConvertDecodeSIMD(
+	const GLushort* src,
+	float* dst,
+	std::size_t count
+)
+{
+	const __m128 one = _mm_set1_ps(65535.0f);
+	const __m128i zero = _mm_setzero_si128();
+	std::size_t i = 0;
+	for(; i+8 <= count; i += 8)
+	{
+		const __m128i s = _mm_loadu_si128(
+			reinterpret_cast<const __m128i*>(src+i)
+		);
+		_mm_storeu_ps(dst+i+0, ConvertUNormToFloatX4(
+			_mm_unpacklo_epi16(s, zero), one
+		));
+		_mm_storeu_ps(dst+i+4, ConvertUNormToFloatX4(
+			_mm_unpackhi_epi16(s, zero), one
+		));
+	}
+	return i;
+}
+
+inline std::size_t ConvertEncodeSIMD(
+	const float* src,
+	GLubyte* dst,
+	std::size_t count
+)
+{
+	const __m128 one = _mm_set1_ps(255.0f);
+	std::size_t i = 0;
+	for(; i+16 <= count; i += 16)
+	{
+		// the values are in [0, 255] so the saturation does nothing
+		const __m128i lo = _mm_packs_epi32(
+			ConvertFloatToUNormX4(src+i+ 0, one),
+			ConvertFloatToUNormX4(src+i+ 4, one)
+		);
+		const __m128i hi = _mm_packs_epi32(
+			ConvertFloatToUNormX4(src+i+ 8, one),
+			ConvertFloatToUNormX4(src+i+12, one)
+		);
+		_mm_storeu_si128(
+			reinterpret_cast<__m128i*>(dst+i),
+			_mm_packus_epi16(lo, hi)
+		);
+	}
+	return i;
+}
+
+inline std::size_t ConvertEncodeSIMD(
+	const float* src,
+	GLushort* dst,
+	std::size_t count
+)
+{
+	const __m128 one = _mm_set1_ps(65535.0f);
+	const __m128i bias = _mm_set1_epi32(0x8000);
+	std::size_t i = 0;
+	for(; i+8 <= count; i += 8)
+	{
+		// SSE2 has only signed saturation to 16 bits,
+		// so the values are biased to the signed range
+		const __m128i lo = _mm_sub_epi32(
+			ConvertFloatToUNormX4(src+i+0, one),
+			bias
+		);
+		const __m128i hi = _mm_sub_epi32(
+			ConvertFloatToUNormX4(src+i+4, one),
+			bias
+		);
+		_mm_storeu_si128(
+			reinterpret_cast<__m128i*>(dst+i),
+			_mm_xor_si128(
+				_mm_packs_epi32(lo, hi),
+				_mm_set1_epi16(-0x8000)
+			)
+		);
+	}
+	return i;
+}
+
+#if defined(__F16C__)
+inline std::size_t ConvertDecodeHalfSIMD(
+	const GLushort* src,
+	float* dst,
+	std::size_t count
+)
+{
+	std::size_t i = 0;
+	for(; i+4 <= count; i += 4)
+	{
+		_mm_storeu_ps(dst+i, _mm_cvtph_ps(_mm_loadl_epi64(
+			reinterpret_cast<const __m128i*>(src+i)
+		)));
+	}
+	return i;
+}
+
+inline std::size_t ConvertEncodeHalfSIMD(
+	const float* src,
+	GLushort* dst,
+	std::size_t count
+)
+{
+	std::size_t i = 0;
+	for(; i+4 <= count; i += 4)
+	{
+		_mm_storel_epi64(
+			reinterpret_cast<__m128i*>(dst+i),
+			_mm_cvtps_ph(_mm_loadu_ps(src+i), _MM_FROUND_TO_NEAREST_INT)
+		);
+	}
+	return i;
+}
+#endif // __F16C__
+#endif // !OGLPLUS_NO_SIMD
+
+inline std::size_t ConvertDecodeSIMD(const void*, float*, std::size_t)
+{
+	return 0;
+}
+
+inline std::size_t ConvertEncodeSIMD(const float*, void*, std::size_t)
+{
+	return 0;
+}
+
+template <typename T>
+inline void ConvertDecodeNorm(
+	const T* src,
+	float* dst,
+	std::size_t count,
+	bool vectorized
+)
+{
+	std::size_t i = vectorized?ConvertDecodeSIMD(src, dst, count):0;
+	for(; i!=count; ++i)
+	{
+		dst[i] = ConvertToFloat(src[i]);
+	}
+}
+
+template <typename T>
+inline void ConvertEncodeNorm(
+	const float* src,
+	T* dst,
+	std::size_t count,
+	bool vectorized
+)
+{
+	std::size_t i = vectorized?ConvertEncodeSIMD(src, dst, count):0;
+	for(; i!=count; ++i)
+	{
+		dst[i] = ConvertFromFloat<T>(src[i]);
+	}
+}
+
+// Decodes the pixels of a row into floats, count is the number of pixels
+// and n the number of components of the format of the pixels
+OGLPLUS_LIB_FUNC
+void ConvertDecodeRow(
+	PixelDataType type,
+	const void* src,
+	float* dst,
+	std::size_t count,
+	std::size_t n,
+	bool vectorized
+)
+{
+	switch(GLenum(type))
+	{
+		case GL_UNSIGNED_BYTE: return ConvertDecodeNorm(
+			static_cast<const GLubyte*>(src), dst, count*n, vectorized
+		);
+		case GL_BYTE: return ConvertDecodeNorm(
+			static_cast<const GLbyte*>(src), dst, count*n, vectorized
+		);
+		case GL_UNSIGNED_SHORT: return ConvertDecodeNorm(
+			static_cast<const GLushort*>(src), dst, count*n, vectorized
+		);
+		case GL_SHORT: return ConvertDecodeNorm(
+			static_cast<const GLshort*>(src), dst, count*n, vectorized
+		);
+		case GL_UNSIGNED_INT: return ConvertDecodeNorm(
+			static_cast<const GLuint*>(src), dst, count*n, vectorized
+		);
+		case GL_INT: return ConvertDecodeNorm(
+			static_cast<const GLint*>(src), dst, count*n, vectorized
+		);
+		case GL_FLOAT:
+			std::memcpy(dst, src, count*n*sizeof(float));
+			return;
+		case GL_HALF_FLOAT:
+		{
+			const GLushort* s = static_cast<const GLushort*>(src);
+			std::size_t i = 0;
+#if !OGLPLUS_NO_SIMD && defined(__F16C__)
+			if(vectorized) i = ConvertDecodeHalfSIMD(s, dst, count*n);
+#endif
+			for(; i!=count*n; ++i)
+			{
+				dst[i] = oglplus::aux::HalfToFloat(s[i]);
+			}
+			return;
+		}
+		default:;
+	}
+
+	const GLuint* s = static_cast<const GLuint*>(src);
+	for(std::size_t i=0; i!=count; ++i)
+	{
+		switch(GLenum(type))
+		{
+			case GL_UNSIGNED_INT_10F_11F_11F_REV:
+				ConvertUnpackR11G11B10(s[i], dst+i*n);
+				break;
+			case GL_UNSIGNED_INT_5_9_9_9_REV:
+				ConvertUnpackRGB9E5(s[i], dst+i*n);
+				break;
+			default:
+				ConvertUnpackRGB10A2(s[i], dst+i*n);
+		}
+	}
+}
+
+// Encodes a row of floats into the pixels of the specified type
+OGLPLUS_LIB_FUNC
+void ConvertEncodeRow(
+	PixelDataType type,
+	const float* src,
+	void* dst,
+	std::size_t count,
+	std::size_t n,
+	bool vectorized
+)
+{
+	switch(GLenum(type))
+	{
+		case GL_UNSIGNED_BYTE: return ConvertEncodeNorm(
+			src, static_cast<GLubyte*>(dst), count*n, vectorized
+		);
+		case GL_BYTE: return ConvertEncodeNorm(
+			src, static_cast<GLbyte*>(dst), count*n, vectorized
+		);
+		case GL_UNSIGNED_SHORT: return ConvertEncodeNorm(
+			src, static_cast<GLushort*>(dst), count*n, vectorized
+		);
+		case GL_SHORT: return ConvertEncodeNorm(
+			src, static_cast<GLshort*>(dst), count*n, vectorized
+		);
+		case GL_UNSIGNED_INT: return ConvertEncodeNorm(
+			src, static_cast<GLuint*>(dst), count*n, vectorized
+		);
+		case GL_INT: return ConvertEncodeNorm(
+			src, static_cast<GLint*>(dst), count*n, vectorized
+		);
+		case GL_FLOAT:
+			std::memcpy(dst, src, count*n*sizeof(float));
+			return;
+		case GL_HALF_FLOAT:
+		{
+			GLushort* d = static_cast<GLushort*>(dst);
+			std::size_t i = 0;
+#if !OGLPLUS_NO_SIMD && defined(__F16C__)
+			if(vectorized) i = ConvertEncodeHalfSIMD(src, d, count*n);
+#endif
+			for(; i!=count*n; ++i)
+			{
+				d[i] = oglplus::aux::FloatToHalf(src[i]);
+			}
+			return;
+		}
+		default:;
+	}
+
+	GLuint* d = static_cast<GLuint*>(dst);
+	for(std::size_t i=0; i!=count; ++i)
+	{
+		switch(GLenum(type))
+		{
+			case GL_UNSIGNED_INT_10F_11F_11F_REV:
+				d[i] = ConvertPackR11G11B10(src+i*n);
+				break;
+			case GL_UNSIGNED_INT_5_9_9_9_REV:
+				d[i] = ConvertPackRGB9E5(src+i*n);
+				break;
+			default:
+				d[i] = ConvertPackRGB10A2(src+i*n);
+		}
+	}
+}
+
+} // namespace aux
+
+OGLPLUS_LIB_FUNC
+Image Convert(
+	const ImageView& image,
+	PixelDataType type,
+	PixelDataFormat format,
+	const ConvertParams& params
+)
+{
+	aux::ConvertLayout layout;
+	if(!aux::ConvertGetLayout(format, layout))
+	{
+		throw std::runtime_error("Unsupported pixel data format");
+	}
+	return Convert(
+		image,
+		type,
+		format,
+		aux::ConvertInternalFormat(
+			type,
+			layout.count,
+			aux::ConvertIsSRGB(image.InternalFormat())
+		),
+		params
+	);
+}
+
+OGLPLUS_LIB_FUNC
+Image Convert(
+	const ImageView& image,
+	PixelDataType type,
+	PixelDataFormat format,
+	PixelDataInternalFormat internal,
+	const ConvertParams& params
+)
+{
+	aux::ConvertLayout src_layout, dst_layout;
+	if(	!aux::ConvertGetLayout(image.Format(), src_layout) ||
+		!aux::ConvertGetLayout(format, dst_layout)
+	)
+	{
+		throw std::runtime_error("Unsupported pixel data format");
+	}
+	const GLsizei src_channels = aux::ConvertCheck(
+		image.Type(),
+		image.Format(),
+		src_layout
+	);
+	const GLsizei dst_channels = aux::ConvertCheck(
+		type,
+		format,
+		dst_layout
+	);
+	if(src_channels != GLsizei(image.Channels()))
+	{
+		throw std::runtime_error(
+			"The number of image channels does not match its format"
+		);
+	}
+
+	const bool src_srgb = aux::ConvertIsSRGB(image.InternalFormat());
+	const bool dst_srgb = aux::ConvertIsSRGB(internal);
+
+	const GLsizei width = GLsizei(image.Width());
+	const GLsizei height = GLsizei(image.Height());
+	const GLsizei depth = GLsizei(image.Depth());
+
+	oglplus::aux::AlignedPODArray storage = aux::ConvertAllocate(
+		type,
+		std::size_t(width*height*depth*dst_channels)
+	);
+	unsigned char* dst = static_cast<unsigned char*>(storage.begin());
+	const std::size_t dst_row = std::size_t(width*dst_channels)*
+		ImageView::ComponentSize(type);
+
+	// where each destination component comes from, -1 and -2 mean
+	// the constants 0 and 1 and whether it is (de/en)coded as sRGB
+	GLsizei source[4];
+	bool convert_srgb[4];
+	bool identity = (src_layout.count == dst_layout.count);
+	for(GLsizei j=0; j!=dst_layout.count; ++j)
+	{
+		const GLsizei slot = dst_layout.slot[j];
+		source[j] = (slot == 3)?-2:-1;
+		for(GLsizei i=0; i!=src_layout.count; ++i)
+		{
+			if(src_layout.slot[i] == slot) source[j] = i;
+		}
+		convert_srgb[j] = (src_srgb != dst_srgb) && (slot != 3);
+		identity &= (source[j] == j) && !convert_srgb[j];
+	}
+
+	const bool copy = identity && (type == image.Type());
+	const bool srgb_lut =
+		src_srgb && (image.Type() == PixelDataType::UnsignedByte);
+
+	// the sRGB decoding of 8-bit values is tabulated
+	float lut[256];
+	if(srgb_lut)
+	{
+		for(int i=0; i!=256; ++i)
+		{
+			lut[i] = aux::ConvertSRGBToLinear(float(i)/255.0f);
+		}
+	}
+
+	const std::size_t rows = std::size_t(height*depth);
+	const std::size_t n_src = std::size_t(src_layout.count);
+	const std::size_t n_dst = std::size_t(dst_layout.count);
+	const std::size_t w = std::size_t(width);
+
+	oglplus::aux::ParallelFor(
+		rows,
+		8,
+		[&](std::size_t begin, std::size_t end)
+		{
+			std::vector<float> in(copy?0:w*n_src);
+			std::vector<float> out(identity?0:w*n_dst);
+			for(std::size_t r=begin; r!=end; ++r)
+			{
+				const GLsizei y = GLsizei(r % std::size_t(height));
+				const GLsizei z = GLsizei(r / std::size_t(height));
+				const void* src = image.RawPixel(0, y, z);
+				void* d = dst+r*dst_row;
+				if(copy)
+				{
+					std::memcpy(d, src, dst_row);
+					continue;
+				}
+				aux::ConvertDecodeRow(
+					image.Type(),
+					src,
+					in.data(),
+					w, n_src,
+					params.vectorized
+				);
+				const float* result = in.data();
+				if(!identity)
+				{
+					const float* s = in.data();
+					float* o = out.data();
+					for(std::size_t x=0; x!=w; ++x)
+					{
+						for(std::size_t j=0; j!=n_dst; ++j)
+						{
+							const GLsizei i = source[j];
+							if(i < 0)
+							{
+								*o++ = (i == -2)?1.0f:0.0f;
+								continue;
+							}
+							float v = s[i];
+							if(!convert_srgb[j]) { }
+							else if(srgb_lut)
+							{
+								v = lut[int(v*255.0f+0.5f)];
+							}
+							else if(src_srgb)
+							{
+								v = aux::ConvertSRGBToLinear(v);
+							}
+							else v = aux::ConvertLinearToSRGB(v);
+							*o++ = v;
+						}
+						s += n_src;
+					}
+					result = out.data();
+				}
+				aux::ConvertEncodeRow(
+					type,
+					result,
+					d,
+					w, n_dst,
+					params.vectorized
+				);
+			}
+		},
+		params.max_threads
+	);
+
+	return Image(
+		width,
+		height,
+		depth,
+		dst_channels,
+		type,
+		std::move(storage),
+		format,
+		internal
+	);
+}
+
+} // namespace images
+} // namespace oglplus
+
@@ -0,0 +1,399 @@
+/**
+ *  @file oglplus/images/convolution.ipp
+ *  @brief Implementation of the separable convolution image filters
+ *
+ *  @author Matus Chochlik
+ *
+ *  Copyright 2010-2015 Matus Chochlik. Distributed under the Boost
+ *  Software License, Version 1.0. (See accompanying file
+ *  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include <oglplus/lib/incl_begin.ipp>
+#include <oglplus/images/convert.hpp>
+#include <oglplus/detail/parallel_for.hpp>
+#include <oglplus/lib/incl_end.ipp>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#if !OGLPLUS_NO_SIMD
+#include <emmintrin.h>
+#endif
+
+namespace oglplus {
+namespace images {
+namespace aux {
+
+// The width (in floats) of the strips in which the columns and the depth
+// of the image are convolved, so that a strip with size elements
+// (and the padding) fits into the (L2) cache
+inline std::size_t ConvolveStripWidth(std::size_t size)
+{
+	std::size_t result = (std::size_t(1) << 16)/size;
+	result -= result % 16;
+	return std::max(std::size_t(16), std::min(std::size_t(256), result));
+}
+
+// dst[j] = sum(weights[k]*src[j+k*step]) for j in [0, count)
+inline void ConvolveLine(
+	const float* src,
+	std::size_t step,
+	float* dst,
+	std::size_t count,
+	const float* weights,
+	std::size_t taps,
+	bool vectorized
+)
+{
+	std::size_t j = 0;
+#if !OGLPLUS_NO_SIMD
+	if(vectorized)
+	{
+		// the same operations as the scalar loop below,
+		// four outputs at a time
+		for(; j+8 <= count; j+=8)
+		{
+			__m128 acc0 = _mm_setzero_ps();
+			__m128 acc1 = _mm_setzero_ps();
+			const float* s = src+j;
+			for(std::size_t k=0; k!=taps; ++k)
+			{
+				const __m128 w = _mm_set1_ps(weights[k]);
+				acc0 = _mm_add_ps(
+					acc0,
+					_mm_mul_ps(w, _mm_loadu_ps(s+0))
+				);
+				acc1 = _mm_add_ps(
+					acc1,
+					_mm_mul_ps(w, _mm_loadu_ps(s+4))
+				);
+				s += step;
+			}
+			_mm_storeu_ps(dst+j+0, acc0);
+			_mm_storeu_ps(dst+j+4, acc1);
+		}
+		for(; j+4 <= count; j+=4)
+		{
+			__m128 acc = _mm_setzero_ps();
+			const float* s = src+j;
+			for(std::size_t k=0; k!=taps; ++k)
+			{
+				acc = _mm_add_ps(
+					acc,
+					_mm_mul_ps(
+						_mm_set1_ps(weights[k]),
+						_mm_loadu_ps(s)
+					)
+				);
+				s += step;
+			}
+			_mm_storeu_ps(dst+j, acc);
+		}
+	}
+#else
+	OGLPLUS_FAKE_USE(vectorized);
+#endif
+	for(; j!=count; ++j)
+	{
+		float acc = 0.0f;
+		const float* s = src+j;
+		for(std::size_t k=0; k!=taps; ++k)
+		{
+			acc += weights[k]*(*s);
+			s += step;
+		}
+		dst[j] = acc;
+	}
+}
+
+// dst[j] = sum(src[j+k*step])/taps for j in [0, count), with running sums
+inline void ConvolveBoxLine(
+	const float* src,
+	std::size_t step,
+	float* dst,
+	std::size_t count,
+	std::size_t taps,
+	double* sums
+)
+{
+	assert(count % step == 0);
+	const double scale = 1.0/double(taps);
+	const std::size_t back = (taps-1)*step;
+	for(std::size_t l=0; l!=step; ++l)
+	{
+		double sum = 0.0;
+		for(std::size_t k=0; k!=taps; ++k)
+		{
+			sum += src[l+k*step];
+		}
+		sums[l] = sum;
+		dst[l] = float(sum*scale);
+	}
+	for(std::size_t j=step; j!=count; j+=step)
+	{
+		for(std::size_t l=0; l!=step; ++l)
+		{
+			const std::size_t i = j+l;
+			sums[l] += double(src[i+back])-double(src[i-step]);
+			dst[i] = float(sums[l]*scale);
+		}
+	}
+}
+
+// Returns the index of the texel used for the coordinate pos
+inline std::size_t ConvolveEdge(std::ptrdiff_t pos, std::size_t size, bool repeat)
+{
+	const std::ptrdiff_t n = std::ptrdiff_t(size);
+	if(repeat)
+	{
+		pos %= n;
+		if(pos < 0) pos += n;
+	}
+	else if(pos < 0) pos = 0;
+	else if(pos >= n) pos = n-1;
+	return std::size_t(pos);
+}
+
+// Convolves the data along one axis
+/* The data consist of outer blocks (at outer_stride floats from each other)
+ * of size elements along the axis (at axis_stride), each of them having
+ * lanes contiguous floats. The lanes are split into strips which are
+ * gathered (with the padding at the edges) into a contiguous buffer,
+ * convolved and scattered back. If the strips are contiguous (the rows
+ * of the image) they are written directly.
+ */
+OGLPLUS_LIB_FUNC
+void ConvolveAxis(
+	float* data,
+	std::size_t outer,
+	std::size_t outer_stride,
+	std::size_t size,
+	std::size_t axis_stride,
+	std::size_t lanes,
+	const ConvolutionKernel& kernel,
+	const ConvolutionParams& params
+)
+{
+	if(kernel.IsIdentity()) return;
+
+	const std::size_t radius = std::size_t(kernel.Radius());
+	const std::size_t strip_width = std::min(
+		lanes,
+		ConvolveStripWidth(size+2*radius)
+	);
+	const std::size_t strips = (lanes+strip_width-1)/strip_width;
+	// the strip is contiguous (for example a row of the image)
+	const bool contiguous = (strip_width == axis_stride);
+	const std::size_t taps = 2*radius+1;
+	// the direct evaluation is faster for small boxes
+	const bool running_sum = kernel.IsBox() && (taps > 5);
+
+	oglplus::aux::ParallelFor(
+		outer*strips,
+		(strips > 1)?4:8,
+		[&](std::size_t begin, std::size_t end)
+		{
+			std::vector<float> padded((size+2*radius)*strip_width);
+			std::vector<float> result(contiguous?0:size*strip_width);
+			std::vector<double> sums(strip_width);
+
+			for(std::size_t t=begin; t!=end; ++t)
+			{
+				const std::size_t o = t / strips;
+				const std::size_t s = t % strips;
+				const std::size_t offs = s*strip_width;
+				const std::size_t width =
+					std::min(strip_width, lanes-offs);
+				float* base = data+o*outer_stride+offs;
+
+				float* p = padded.data();
+				for(std::size_t i=0; i!=size+2*radius; ++i)
+				{
+					const std::ptrdiff_t pos =
+						std::ptrdiff_t(i)-std::ptrdiff_t(radius);
+					// copy the contiguous interior at once
+					if(contiguous && (pos == 0))
+					{
+						p = std::copy(base, base+size*width, p);
+						i += size-1;
+						continue;
+					}
+					const std::size_t e = ConvolveEdge(
+						pos,
+						size,
+						params.repeat
+					);
+					p = std::copy(
+						base+e*axis_stride,
+						base+e*axis_stride+width,
+						p
+					);
+				}
+				// contiguous elements are written directly
+				float* dst = contiguous?base:result.data();
+
+				if(running_sum)
+				{
+					ConvolveBoxLine(
+						padded.data(),
+						width,
+						dst,
+						size*width,
+						taps,
+						sums.data()
+					);
+				}
+				else
+				{
+					ConvolveLine(
+						padded.data(),
+						width,
+						dst,
+						size*width,
+						kernel.Weights().data(),
+						taps,
+						params.vectorized
+					);
+				}
+
+				if(contiguous) continue;
+				const float* r = result.data();
+				for(std::size_t i=0; i!=size; ++i)
+				{
+					std::copy(r, r+width, base+i*axis_stride);
+					r += width;
+				}
+			}
+		},
+		params.max_threads
+	);
+}
+
+inline ConvertParams ConvolveConvertParams(const ConvolutionParams& params)
+{
+	ConvertParams result;
+	result.vectorized = params.vectorized;
+	result.max_threads = params.max_threads;
+	return result;
+}
+
+} // namespace aux
+
+OGLPLUS_LIB_FUNC
+ConvolutionKernel::ConvolutionKernel(
+	std::vector<GLfloat>&& weights,
+	bool is_box
+): _weights(std::move(weights))
+ , _is_box(is_box)
+{ }
+
+OGLPLUS_LIB_FUNC
+ConvolutionKernel::ConvolutionKernel(const std::vector<GLfloat>& weights)
+ : _weights(weights)
+ , _is_box(false)
+{
+	if(_weights.size() % 2 != 1)
+	{
+		throw std::runtime_error(
+			"Convolution kernel must have an odd number of weights"
+		);
+	}
+}
+
+OGLPLUS_LIB_FUNC
+ConvolutionKernel ConvolutionKernel::Gaussian(GLfloat sigma, GLint radius)
+{
+	assert(sigma > 0.0f);
+	assert(radius >= 0);
+	if(radius == 0)
+	{
+		radius = GLint(std::ceil(3.0f*sigma));
+	}
+	std::vector<GLfloat> weights(std::size_t(2*radius+1));
+	double sum = 0.0;
+	for(GLint i=-radius; i<=radius; ++i)
+	{
+		const double w = std::exp(-0.5*(i*i)/(double(sigma)*sigma));
+		weights[std::size_t(i+radius)] = GLfloat(w);
+		sum += w;
+	}
+	for(GLfloat& w : weights)
+	{
+		w = GLfloat(w/sum);
+	}
+	return ConvolutionKernel(std::move(weights), false);
+}
+
+OGLPLUS_LIB_FUNC
+ConvolutionKernel ConvolutionKernel::Box(GLint radius)
+{
+	assert(radius >= 0);
+	const std::size_t taps = std::size_t(2*radius+1);
+	return ConvolutionKernel(
+		std::vector<GLfloat>(taps, GLfloat(1.0/double(taps))),
+		true
+	);
+}
+
+OGLPLUS_LIB_FUNC
+void SeparableConvolution::_convolve(
+	const ConvolutionKernel& kx,
+	const ConvolutionKernel& ky,
+	const ConvolutionKernel& kz,
+	const ConvolutionParams& params
+)
+{
+	const std::size_t w = std::size_t(GLsizei(Width()));
+	const std::size_t h = std::size_t(GLsizei(Height()));
+	const std::size_t d = std::size_t(GLsizei(Depth()));
+	const std::size_t c = std::size_t(GLsizei(Channels()));
+	GLfloat* data = this->_begin<GLfloat>();
+
+	// the rows (each row is a single strip of the channels)
+	aux::ConvolveAxis(data, h*d, w*c, w, c, c, kx, params);
+	// the columns of each slice
+	aux::ConvolveAxis(data, d, w*h*c, h, w*c, w*c, ky, params);
+	// the depth
+	if(d > 1)
+	{
+		aux::ConvolveAxis(data, 1, 0, d, w*h*c, w*h*c, kz, params);
+	}
+}
+
+OGLPLUS_LIB_FUNC
+SeparableConvolution::SeparableConvolution(
+	const ImageView& input,
+	const ConvolutionKernel& kernel,
+	const ConvolutionParams& params
+): Image(Convert(
+	input,
+	PixelDataType::Float,
+	input.Format(),
+	aux::ConvolveConvertParams(params)
+))
+{
+	_convolve(kernel, kernel, kernel, params);
+}
+
+OGLPLUS_LIB_FUNC
+SeparableConvolution::SeparableConvolution(
+	const ImageView& input,
+	const ConvolutionKernel& kx,
+	const ConvolutionKernel& ky,
+	const ConvolutionKernel& kz,
+	const ConvolutionParams& params
+): Image(Convert(
+	input,
+	PixelDataType::Float,
+	input.Format(),
+	aux::ConvolveConvertParams(params)
+))
+{
+	_convolve(kx, ky, kz, params);
+}
+
+} // namespace images
+} // namespace oglplus
+
@@ -0,0 +1,812 @@
+/**
+ *  @file oglplus/images/cube_map.ipp
+ *  @brief Implementation of the cube map conversions and filtering
+ *
+ *  @author Matus Chochlik
+ *
+ *  Copyright 2010-2015 Matus Chochlik. Distributed under the Boost
+ *  Software License, Version 1.0. (See accompanying file
+ *  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include <oglplus/lib/incl_begin.ipp>
+#include <oglplus/images/convert.hpp>
+#include <oglplus/images/mipmap.hpp>
+#include <oglplus/detail/parallel_for.hpp>
+#include <oglplus/detail/float_lanes.hpp>
+#include <oglplus/lib/incl_end.ipp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace oglplus {
+namespace images {
+namespace aux {
+
+// The operations on RGBA pixels stored as four floats
+struct CubeMapPixelX1
+{
+	struct V
+	{
+		float c[4];
+	};
+
+	static V Zero(void)
+	{
+		V r = {{0.0f, 0.0f, 0.0f, 0.0f}};
+		return r;
+	}
+
+	static V Load(const float* p)
+	{
+		V r = {{p[0], p[1], p[2], p[3]}};
+		return r;
+	}
+
+	static void Store(float* p, V v)
+	{
+		for(int i=0; i!=4; ++i) p[i] = v.c[i];
+	}
+
+	// returns a+b*w
+	static V MulAdd(V a, V b, float w)
+	{
+		for(int i=0; i!=4; ++i) a.c[i] += b.c[i]*w;
+		return a;
+	}
+
+	static V Scale(V a, float w)
+	{
+		for(int i=0; i!=4; ++i) a.c[i] *= w;
+		return a;
+	}
+};
+
+#if !OGLPLUS_NO_SIMD
+namespace OGLPLUS_AUX_LANES_NAMESPACE {
+
+// The operations on RGBA pixels stored in a FloatQuad
+/* FloatLanes has eight lanes with AVX, the four components of a pixel
+ * fit into the four-wide FloatQuad. Declared in the namespace of
+ * the instruction set, like FloatQuad.
+ */
+struct CubeMapPixelX4
+{
+	typedef oglplus::aux::FloatQuad V;
+
+	static V Zero(void) { return V(0.0f); }
+	static V Load(const float* p) { return V::Load(p); }
+	static void Store(float* p, V v) { v.Store(p); }
+
+	// returns a+b*w
+	static V MulAdd(V a, V b, float w) { return a+b*V(w); }
+
+	static V Scale(V a, float w) { return a*V(w); }
+};
+
+} // namespace OGLPLUS_AUX_LANES_NAMESPACE
+using namespace OGLPLUS_AUX_LANES_NAMESPACE;
+#endif
+
+inline float CubeMapPi(void)
+{
+	return 3.14159265358979f;
+}
+
+// Gets the indices and weights of the texels interpolated at coord
+// (in texel units, with the centers at i+0.5), returns their number
+inline GLsizei CubeMapTaps(
+	float coord,
+	GLsizei size,
+	bool wrap,
+	bool bicubic,
+	GLsizei* index,
+	float* weight
+)
+{
+	const float f = coord-0.5f;
+	const float i0 = std::floor(f);
+	const float t = f-i0;
+	GLsizei first = GLsizei(i0);
+	GLsizei n = 2;
+	if(bicubic)
+	{
+		// Catmull-Rom
+		weight[0] = t*((2.0f-t)*t-1.0f)*0.5f;
+		weight[1] = (t*t*(3.0f*t-5.0f)+2.0f)*0.5f;
+		weight[2] = t*((4.0f-3.0f*t)*t+1.0f)*0.5f;
+		weight[3] = (t-1.0f)*t*t*0.5f;
+		first -= 1;
+		n = 4;
+	}
+	else
+	{
+		weight[0] = 1.0f-t;
+		weight[1] = t;
+	}
+	for(GLsizei i=0; i!=n; ++i)
+	{
+		GLsizei k = first+i;
+		if(wrap) k = ((k % size)+size) % size;
+		else k = std::min(std::max(k, 0), size-1);
+		index[i] = k;
+	}
+	return n;
+}
+
+// Interpolates a plane of RGBA float pixels at x, y (in texel units)
+template <class P>
+inline typename P::V CubeMapSample(
+	const float* plane,
+	GLsizei w,
+	GLsizei h,
+	float x,
+	float y,
+	bool wrap_x,
+	bool bicubic
+)
+{
+	GLsizei xi[4], yi[4];
+	float xw[4], yw[4];
+	const GLsizei nx = CubeMapTaps(x, w, wrap_x, bicubic, xi, xw);
+	const GLsizei ny = CubeMapTaps(y, h, false, bicubic, yi, yw);
+
+	typename P::V result = P::Zero();
+	for(GLsizei j=0; j!=ny; ++j)
+	{
+		const float* row = plane+std::size_t(yi[j]*w)*4;
+		typename P::V r = P::Zero();
+		for(GLsizei i=0; i!=nx; ++i)
+		{
+			r = P::MulAdd(r, P::Load(row+std::size_t(xi[i])*4), xw[i]);
+		}
+		result = P::MulAdd(result, r, yw[j]);
+	}
+	return result;
+}
+
+inline void CubeMapNormalize(float* v)
+{
+	const float l = std::sqrt(v[0]*v[0]+v[1]*v[1]+v[2]*v[2]);
+	v[0] /= l;
+	v[1] /= l;
+	v[2] /= l;
+}
+
+// Gets the (unnormalized) direction of the point a, b (both in [-1, 1])
+// on the specified face (see the table 8.19 of the GL 4.5 specification)
+inline void CubeMapFaceDir(GLsizei face, float a, float b, float* dir)
+{
+	switch(face)
+	{
+		case 0: dir[0] = 1.0f; dir[1] = -b; dir[2] = -a; break;
+		case 1: dir[0] =-1.0f; dir[1] = -b; dir[2] =  a; break;
+		case 2: dir[0] =    a; dir[1] = 1.0f; dir[2] = b; break;
+		case 3: dir[0] =    a; dir[1] =-1.0f; dir[2] =-b; break;
+		case 4: dir[0] =    a; dir[1] = -b; dir[2] = 1.0f; break;
+		default:dir[0] =   -a; dir[1] = -b; dir[2] =-1.0f;
+	}
+}
+
+// Gets the face and the coordinates s, t (in [0, 1]) of a direction
+inline GLsizei CubeMapDirFace(const float* dir, float& s, float& t)
+{
+	const float ax = std::fabs(dir[0]);
+	const float ay = std::fabs(dir[1]);
+	const float az = std::fabs(dir[2]);
+	GLsizei face;
+	float sc, tc, ma;
+	if((ax >= ay) && (ax >= az))
+	{
+		face = (dir[0] > 0.0f)?0:1;
+		sc = (dir[0] > 0.0f)?-dir[2]:dir[2];
+		tc = -dir[1];
+		ma = ax;
+	}
+	else if(ay >= az)
+	{
+		face = (dir[1] > 0.0f)?2:3;
+		sc = dir[0];
+		tc = (dir[1] > 0.0f)?dir[2]:-dir[2];
+		ma = ay;
+	}
+	else
+	{
+		face = (dir[2] > 0.0f)?4:5;
+		sc = (dir[2] > 0.0f)?dir[0]:-dir[0];
+		tc = -dir[1];
+		ma = az;
+	}
+	s = 0.5f*(sc/ma+1.0f);
+	t = 0.5f*(tc/ma+1.0f);
+	return face;
+}
+
+// Samples the face of a cube map of RGBA floats in the direction dir
+template <class P>
+inline typename P::V CubeMapSampleDir(
+	const float* faces,
+	GLsizei size,
+	const float* dir,
+	bool bicubic
+)
+{
+	float s, t;
+	const GLsizei face = CubeMapDirFace(dir, s, t);
+	return CubeMapSample<P>(
+		faces+std::size_t(face*size*size)*4,
+		size, size,
+		s*float(size),
+		t*float(size),
+		false,
+		bicubic
+	);
+}
+
+// Decodes an image into linear RGBA floats
+OGLPLUS_LIB_FUNC
+Image CubeMapDecode(const ImageView& image, const CubeMapParams& params)
+{
+	ConvertParams convert;
+	convert.vectorized = params.vectorized;
+	convert.max_threads = params.max_threads;
+	return Convert(
+		image,
+		PixelDataType::Float,
+		PixelDataFormat::RGBA,
+		PixelDataInternalFormat::RGBA32F,
+		convert
+	);
+}
+
+// Encodes linear RGBA floats into the type and format of the source
+OGLPLUS_LIB_FUNC
+Image CubeMapEncode(
+	oglplus::aux::AlignedPODArray&& storage,
+	GLsizei width,
+	GLsizei height,
+	GLsizei depth,
+	const ImageView& source,
+	const CubeMapParams& params
+)
+{
+	ConvertParams convert;
+	convert.vectorized = params.vectorized;
+	convert.max_threads = params.max_threads;
+	return Convert(
+		Image(
+			width, height, depth, 4,
+			static_cast<const GLfloat*>(nullptr),
+			std::move(storage),
+			PixelDataFormat::RGBA,
+			PixelDataInternalFormat::RGBA32F
+		),
+		source.Type(),
+		source.Format(),
+		source.InternalFormat(),
+		convert
+	);
+}
+
+OGLPLUS_LIB_FUNC
+void CubeMapCheck(const ImageView& cube_map)
+{
+	if((cube_map.Depth() != 6) || (cube_map.Width() != cube_map.Height()))
+	{
+		throw std::runtime_error(
+			"Cube maps must have six square faces"
+		);
+	}
+}
+
+template <class P>
+void CubeMapFromEquirectRow(
+	const float* panorama,
+	GLsizei pw,
+	GLsizei ph,
+	GLsizei size,
+	GLsizei face,
+	GLsizei y,
+	bool bicubic,
+	float* dst
+)
+{
+	const float pi = CubeMapPi();
+	const float b = 2.0f*(float(y)+0.5f)/float(size)-1.0f;
+	for(GLsizei x=0; x!=size; ++x)
+	{
+		const float a = 2.0f*(float(x)+0.5f)/float(size)-1.0f;
+		float dir[3];
+		CubeMapFaceDir(face, a, b, dir);
+		CubeMapNormalize(dir);
+		const float lon = std::atan2(dir[0], -dir[2]);
+		const float lat = std::asin(std::min(std::max(dir[1],-1.0f),1.0f));
+		P::Store(dst+std::size_t(x)*4, CubeMapSample<P>(
+			panorama, pw, ph,
+			(0.5f+lon/(2.0f*pi))*float(pw),
+			(0.5f+lat/pi)*float(ph),
+			true,
+			bicubic
+		));
+	}
+}
+
+template <class P>
+void EquirectFromCubeMapRow(
+	const float* faces,
+	GLsizei size,
+	GLsizei width,
+	GLsizei height,
+	GLsizei y,
+	bool bicubic,
+	float* dst
+)
+{
+	const float pi = CubeMapPi();
+	const float lat = ((float(y)+0.5f)/float(height)-0.5f)*pi;
+	for(GLsizei x=0; x!=width; ++x)
+	{
+		const float lon = ((float(x)+0.5f)/float(width)-0.5f)*2.0f*pi;
+		const float dir[3] = {
+			std::cos(lat)*std::sin(lon),
+			std::sin(lat),
+			-std::cos(lat)*std::cos(lon)
+		};
+		P::Store(
+			dst+std::size_t(x)*4,
+			CubeMapSampleDir<P>(faces, size, dir, bicubic)
+		);
+	}
+}
+
+// A sample of the GGX distribution around the +Z axis
+struct CubeMapGGXSample
+{
+	// the direction of the sampled light
+	float dir[3];
+	// the cosine of the angle between the light and the normal
+	float weight;
+	// the mipmap level of the source sampled in this direction
+	float lod;
+};
+
+// Makes the importance samples for the specified roughness
+OGLPLUS_LIB_FUNC
+std::vector<CubeMapGGXSample> CubeMapGGXSamples(
+	unsigned count,
+	float roughness,
+	GLsizei source_size
+)
+{
+	const float pi = CubeMapPi();
+	const float alpha2 = roughness*roughness*roughness*roughness;
+	// the solid angle of a texel of the source
+	const float texel_sa = 4.0f*pi/(6.0f*float(source_size*source_size));
+
+	std::vector<CubeMapGGXSample> result;
+	result.reserve(count);
+	for(unsigned i=0; i!=count; ++i)
+	{
+		// the Hammersley point set
+		std::uint32_t bits = i;
+		bits = (bits << 16) | (bits >> 16);
+		bits = ((bits & 0x55555555u) << 1) | ((bits & 0xAAAAAAAAu) >> 1);
+		bits = ((bits & 0x33333333u) << 2) | ((bits & 0xCCCCCCCCu) >> 2);
+		bits = ((bits & 0x0F0F0F0Fu) << 4) | ((bits & 0xF0F0F0F0u) >> 4);
+		bits = ((bits & 0x00FF00FFu) << 8) | ((bits & 0xFF00FF00u) >> 8);
+		const float u = float(i)/float(count);
+		const float v = float(bits)*2.3283064365386963e-10f;
+
+		// the half vector and the reflected light direction
+		const float phi = 2.0f*pi*u;
+		const float cos_t = std::sqrt((1.0f-v)/(1.0f+(alpha2-1.0f)*v));
+		const float sin_t = std::sqrt(1.0f-cos_t*cos_t);
+		CubeMapGGXSample sample;
+		sample.dir[0] = 2.0f*cos_t*sin_t*std::cos(phi);
+		sample.dir[1] = 2.0f*cos_t*sin_t*std::sin(phi);
+		sample.dir[2] = 2.0f*cos_t*cos_t-1.0f;
+		sample.weight = sample.dir[2];
+		if(sample.weight <= 0.0f) continue;
+
+		// with the normal and the view direction being the same
+		// the density of the light direction is D/4
+		const float d = (alpha2-1.0f)*cos_t*cos_t+1.0f;
+		const float pdf = alpha2/(4.0f*pi*d*d);
+		const float sample_sa = 1.0f/(float(count)*pdf);
+		sample.lod = (alpha2 > 0.0f)?
+			std::max(0.5f*std::log2(sample_sa/texel_sa)+1.0f, 0.0f):
+			0.0f;
+		result.push_back(sample);
+	}
+	return result;
+}
+
+// Makes the box-filtered mipmap levels of a cube map of RGBA floats
+OGLPLUS_LIB_FUNC
+std::vector<std::vector<float>> CubeMapMipmaps(
+	const Image& source,
+	const CubeMapParams& params
+)
+{
+	GLsizei size = source.Width();
+	const float* data = source.Data<GLfloat>();
+	std::vector<std::vector<float>> result(
+		MipmapChain::FullLevelCount(size, size)
+	);
+	result[0].assign(data, data+std::size_t(6*size*size)*4);
+	for(std::size_t l=1; l!=result.size(); ++l)
+	{
+		const GLsizei src_size = size;
+		size = std::max(size/2, 1);
+		const float* src = result[l-1].data();
+		result[l].resize(std::size_t(6*size*size)*4);
+		float* dst = result[l].data();
+		oglplus::aux::ParallelFor(
+			std::size_t(6*size),
+			16,
+			[&](std::size_t begin, std::size_t end)
+			{
+				for(std::size_t r=begin; r!=end; ++r)
+				{
+					const GLsizei face = GLsizei(r)/size;
+					const GLsizei y = GLsizei(r)%size;
+					const float* plane = src+
+						std::size_t(face*src_size*src_size)*4;
+					const GLsizei y0 = std::min(2*y, src_size-1);
+					const GLsizei y1 = std::min(2*y+1, src_size-1);
+					for(GLsizei x=0; x!=size; ++x)
+					{
+						const GLsizei x0 = std::min(2*x, src_size-1);
+						const GLsizei x1 = std::min(2*x+1, src_size-1);
+						for(GLsizei c=0; c!=4; ++c)
+						{
+							dst[(r*std::size_t(size)+
+								std::size_t(x))*4+
+								std::size_t(c)
+							] = 0.25f*(
+								plane[(y0*src_size+x0)*4+c]+
+								plane[(y0*src_size+x1)*4+c]+
+								plane[(y1*src_size+x0)*4+c]+
+								plane[(y1*src_size+x1)*4+c]
+							);
+						}
+					}
+				}
+			},
+			params.max_threads
+		);
+	}
+	return result;
+}
+
+// Samples the mipmap levels of a cube map with trilinear interpolation
+template <class P>
+inline typename P::V CubeMapSampleLod(
+	const std::vector<std::vector<float>>& mipmaps,
+	GLsizei size,
+	const float* dir,
+	float lod
+)
+{
+	float s, t;
+	const GLsizei face = CubeMapDirFace(dir, s, t);
+	const GLsizei last = GLsizei(mipmaps.size())-1;
+	const GLsizei l = std::min(GLsizei(lod), last);
+	const float f = (l < last)?lod-float(l):0.0f;
+
+	typename P::V result = P::Zero();
+	for(GLsizei i=0; i!=((f > 0.0f)?2:1); ++i)
+	{
+		const GLsizei n = std::max(size >> (l+i), 1);
+		result = P::MulAdd(
+			result,
+			CubeMapSample<P>(
+				mipmaps[std::size_t(l+i)].data()+
+				std::size_t(face*n*n)*4,
+				n, n,
+				s*float(n),
+				t*float(n),
+				false,
+				false
+			),
+			(i == 0)?1.0f-f:f
+		);
+	}
+	return result;
+}
+
+template <class P>
+void CubeMapRadianceRow(
+	const std::vector<std::vector<float>>& mipmaps,
+	GLsizei source_size,
+	const std::vector<CubeMapGGXSample>& samples,
+	GLsizei size,
+	GLsizei face,
+	GLsizei y,
+	float* dst
+)
+{
+	const float b = 2.0f*(float(y)+0.5f)/float(size)-1.0f;
+	for(GLsizei x=0; x!=size; ++x)
+	{
+		const float a = 2.0f*(float(x)+0.5f)/float(size)-1.0f;
+
+		// the tangent space of the normal (and view) direction
+		float n[3];
+		CubeMapFaceDir(face, a, b, n);
+		CubeMapNormalize(n);
+		const bool z_up = std::fabs(n[2]) < 0.999f;
+		float t[3] = {
+			z_up?-n[1]:0.0f,
+			z_up?n[0]:-n[2],
+			z_up?0.0f:n[1]
+		};
+		CubeMapNormalize(t);
+		const float bt[3] = {
+			n[1]*t[2]-n[2]*t[1],
+			n[2]*t[0]-n[0]*t[2],
+			n[0]*t[1]-n[1]*t[0]
+		};
+
+		typename P::V sum = P::Zero();
+		float weight = 0.0f;
+		for(const CubeMapGGXSample& s : samples)
+		{
+			float dir[3];
+			for(int i=0; i!=3; ++i)
+			{
+				dir[i] =
+					t[i]*s.dir[0]+
+					bt[i]*s.dir[1]+
+					n[i]*s.dir[2];
+			}
+			sum = P::MulAdd(
+				sum,
+				CubeMapSampleLod<P>(mipmaps, source_size, dir, s.lod),
+				s.weight
+			);
+			weight += s.weight;
+		}
+		P::Store(dst+std::size_t(x)*4, P::Scale(sum, 1.0f/weight));
+	}
+}
+
+} // namespace aux
+
+OGLPLUS_LIB_FUNC
+Image CubeMapFromEquirect::_make(
+	const ImageView& panorama,
+	SizeType face_size,
+	const CubeMapParams& params
+)
+{
+	if(panorama.Depth() != 1)
+	{
+		throw std::runtime_error(
+			"Equirectangular panoramas must be 2D images"
+		);
+	}
+	const Image input = aux::CubeMapDecode(panorama, params);
+	const float* src = input.Data<GLfloat>();
+	const GLsizei pw = input.Width();
+	const GLsizei ph = input.Height();
+	const GLsizei size = face_size;
+	const bool bicubic = params.sampling == CubeMapSampling::Bicubic;
+
+	oglplus::aux::AlignedPODArray storage(
+		static_cast<const GLfloat*>(nullptr),
+		std::size_t(6*size*size)*4
+	);
+	float* dst = static_cast<float*>(storage.begin());
+
+	// the rows of all faces are made in parallel
+	oglplus::aux::ParallelFor(
+		std::size_t(6*size),
+		4,
+		[&](std::size_t begin, std::size_t end)
+		{
+			for(std::size_t r=begin; r!=end; ++r)
+			{
+				const GLsizei face = GLsizei(r)/size;
+				const GLsizei y = GLsizei(r)%size;
+				float* row = dst+r*std::size_t(size)*4;
+#if !OGLPLUS_NO_SIMD
+				if(params.vectorized)
+				{
+					aux::CubeMapFromEquirectRow<
+						aux::CubeMapPixelX4
+					>(src, pw, ph, size, face, y, bicubic, row);
+					continue;
+				}
+#endif
+				aux::CubeMapFromEquirectRow<aux::CubeMapPixelX1>(
+					src, pw, ph, size, face, y, bicubic, row
+				);
+			}
+		},
+		params.max_threads
+	);
+	return aux::CubeMapEncode(
+		std::move(storage),
+		size, size, 6,
+		panorama,
+		params
+	);
+}
+
+OGLPLUS_LIB_FUNC
+Image EquirectFromCubeMap::_make(
+	const ImageView& cube_map,
+	SizeType width,
+	SizeType height,
+	const CubeMapParams& params
+)
+{
+	aux::CubeMapCheck(cube_map);
+	const Image input = aux::CubeMapDecode(cube_map, params);
+	const float* src = input.Data<GLfloat>();
+	const GLsizei size = input.Width();
+	const GLsizei w = width;
+	const GLsizei h = height;
+	const bool bicubic = params.sampling == CubeMapSampling::Bicubic;
+
+	oglplus::aux::AlignedPODArray storage(
+		static_cast<const GLfloat*>(nullptr),
+		std::size_t(w*h)*4
+	);
+	float* dst = static_cast<float*>(storage.begin());
+
+	oglplus::aux::ParallelFor(
+		std::size_t(h),
+		4,
+		[&](std::size_t begin, std::size_t end)
+		{
+			for(std::size_t r=begin; r!=end; ++r)
+			{
+				float* row = dst+r*std::size_t(w)*4;
+#if !OGLPLUS_NO_SIMD
+				if(params.vectorized)
+				{
+					aux::EquirectFromCubeMapRow<
+						aux::CubeMapPixelX4
+					>(src, size, w, h, GLsizei(r), bicubic, row);
+					continue;
+				}
+#endif
+				aux::EquirectFromCubeMapRow<aux::CubeMapPixelX1>(
+					src, size, w, h, GLsizei(r), bicubic, row
+				);
+			}
+		},
+		params.max_threads
+	);
+	return aux::CubeMapEncode(
+		std::move(storage),
+		w, h, 1,
+		cube_map,
+		params
+	);
+}
+
+OGLPLUS_LIB_FUNC
+void PrefilteredCubeMap::_build(
+	const ImageView& cube_map,
+	const ImageCache* cache,
+	const CubeMapParams& params
+)
+{
+	aux::CubeMapCheck(cube_map);
+	const GLsizei source_size = cube_map.Width();
+
+	std::size_t levels = MipmapChain::FullLevelCount(
+		source_size,
+		source_size
+	);
+	if((params.max_levels != 0) && (levels > params.max_levels))
+	{
+		levels = params.max_levels;
+	}
+
+	// the decoded source and its mipmaps are made only if necessary
+	std::vector<std::vector<float>> mipmaps;
+	auto make_level = [&](std::size_t level) -> Image
+	{
+		if(mipmaps.empty())
+		{
+			mipmaps = aux::CubeMapMipmaps(
+				aux::CubeMapDecode(cube_map, params),
+				params
+			);
+		}
+		const GLsizei size = std::max(source_size >> level, 1);
+		const std::vector<aux::CubeMapGGXSample> samples =
+			aux::CubeMapGGXSamples(
+				std::max(params.samples, 1u),
+				GLfloat(level)/GLfloat(levels-1),
+				source_size
+			);
+
+		oglplus::aux::AlignedPODArray storage(
+			static_cast<const GLfloat*>(nullptr),
+			std::size_t(6*size*size)*4
+		);
+		float* dst = static_cast<float*>(storage.begin());
+		oglplus::aux::ParallelFor(
+			std::size_t(6*size),
+			1,
+			[&](std::size_t begin, std::size_t end)
+			{
+				for(std::size_t r=begin; r!=end; ++r)
+				{
+					const GLsizei face = GLsizei(r)/size;
+					const GLsizei y = GLsizei(r)%size;
+					float* row = dst+r*std::size_t(size)*4;
+#if !OGLPLUS_NO_SIMD
+					if(params.vectorized)
+					{
+						aux::CubeMapRadianceRow<
+							aux::CubeMapPixelX4
+						>(
+							mipmaps, source_size,
+							samples,
+							size, face, y,
+							row
+						);
+						continue;
+					}
+#endif
+					aux::CubeMapRadianceRow<
+						aux::CubeMapPixelX1
+					>(
+						mipmaps, source_size,
+						samples,
+						size, face, y,
+						row
+					);
+				}
+			},
+			params.max_threads
+		);
+		return aux::CubeMapEncode(
+			std::move(storage),
+			size, size, 6,
+			cube_map,
+			params
+		);
+	};
+
+	// level 0 is the unfiltered source
+	_levels.reserve(levels);
+	_levels.push_back(Convert(
+		cube_map,
+		cube_map.Type(),
+		cube_map.Format(),
+		cube_map.InternalFormat()
+	));
+	if(levels < 2) return;
+
+	ImageCacheKey key("oglplus::images::PrefilteredCubeMap");
+	if(cache)
+	{
+		key.Add(cube_map).Add(GLsizei(levels)).Add(params.samples);
+	}
+	for(std::size_t level=1; level!=levels; ++level)
+	{
+		if(cache)
+		{
+			_levels.push_back(cache->Get(
+				ImageCacheKey(key).Add(GLsizei(level)),
+				[&](void) { return make_level(level); }
+			));
+		}
+		else _levels.push_back(make_level(level));
+	}
+}
+
+} // namespace images
+} // namespace oglplus
+
@@ -0,0 +1,309 @@
+/**
+ *  @file oglplus/images/distance_field.ipp
+ *  @brief Implementation of the DistanceField generator
+ *
+ *  @author Matus Chochlik
+ *
+ *  Copyright 2010-2015 Matus Chochlik. Distributed under the Boost
+ *  Software License, Version 1.0. (See accompanying file
+ *  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include <oglplus/lib/incl_begin.ipp>
+#include <oglplus/images/convert.hpp>
+#include <oglplus/detail/parallel_for.hpp>
+#include <oglplus/lib/incl_end.ipp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace oglplus {
+namespace images {
+namespace aux {
+
+// The squared distance of texels from an empty set of features
+/* This is finite, so that the intersections of the parabolas are too.
+ */
+inline float DistanceFieldInf(void)
+{
+	return 1e20f;
+}
+
+// The number of columns transformed together, so that the gathered
+// parts of the rows are at least a cache line long
+inline std::size_t DistanceFieldColumnGroup(void)
+{
+	return 16;
+}
+
+// One dimensional squared Euclidean distance transform of f (n samples)
+/* This is the lower envelope of the parabolas (q-i)^2+f[i] (Felzenszwalb
+ * and Huttenlocher, Distance Transforms of Sampled Functions), which
+ * is linear in n. The v and z buffers must have room for n and n+1
+ * elements respectively, f and d must not overlap.
+ */
+inline void DistanceTransform1D(
+	const float* f,
+	std::size_t n,
+	float* d,
+	std::ptrdiff_t* v,
+	float* z
+)
+{
+	const float inf = std::numeric_limits<float>::infinity();
+	std::ptrdiff_t k = 0;
+	v[0] = 0;
+	z[0] = -inf;
+	z[1] = +inf;
+	for(std::ptrdiff_t q=1; q!=std::ptrdiff_t(n); ++q)
+	{
+		const float fq = f[q]+float(q*q);
+		float s;
+		while(true)
+		{
+			const std::ptrdiff_t p = v[k];
+			s = (fq-(f[p]+float(p*p)))/float(2*(q-p));
+			if(s > z[k]) break;
+			--k;
+		}
+		++k;
+		v[k] = q;
+		z[k] = s;
+		z[k+1] = +inf;
+	}
+	k = 0;
+	for(std::ptrdiff_t q=0; q!=std::ptrdiff_t(n); ++q)
+	{
+		while(z[k+1] < float(q)) ++k;
+		const std::ptrdiff_t p = v[k];
+		d[q] = float((q-p)*(q-p))+f[p];
+	}
+}
+
+} // namespace aux
+
+OGLPLUS_LIB_FUNC
+Image DistanceField::_make(
+	const ImageView& input,
+	const DistanceFieldParams& params
+)
+{
+	assert(params.downsample > 0);
+	assert(params.spread > 0.0f);
+
+	const std::size_t w = std::size_t(GLsizei(input.Width()));
+	const std::size_t h = std::size_t(GLsizei(input.Height()));
+	const std::size_t d = std::size_t(GLsizei(input.Depth()));
+	const std::size_t c = std::size_t(GLsizei(input.Channels()));
+	const std::size_t ds = std::size_t(params.downsample);
+
+	if(params.channel >= c)
+	{
+		throw std::runtime_error(
+			"Invalid coverage channel for the distance field"
+		);
+	}
+
+	ConvertParams convert_params;
+	convert_params.max_threads = params.max_threads;
+	const Image coverage = Convert(
+		input,
+		PixelDataType::Float,
+		input.Format(),
+		convert_params
+	);
+	const GLfloat* cov = coverage.Data<GLfloat>()+params.channel;
+
+	// the squared distances to the nearest inside and outside texel
+	const std::size_t count = w*h*d;
+	std::vector<float> dist_in(count);
+	std::vector<float> dist_out(count);
+	const float inf = aux::DistanceFieldInf();
+
+	// the rows
+	oglplus::aux::ParallelFor(
+		h*d,
+		16,
+		[&](std::size_t begin, std::size_t end)
+		{
+			std::vector<float> f_in(w), f_out(w);
+			std::vector<std::ptrdiff_t> v(w);
+			std::vector<float> z(w+1);
+			for(std::size_t r=begin; r!=end; ++r)
+			{
+				const GLfloat* src = cov+r*w*c;
+				for(std::size_t x=0; x!=w; ++x)
+				{
+					const bool inside =
+						src[x*c] >= params.threshold;
+					f_in[x] = inside?0.0f:inf;
+					f_out[x] = inside?inf:0.0f;
+				}
+				aux::DistanceTransform1D(
+					f_in.data(), w,
+					dist_in.data()+r*w,
+					v.data(), z.data()
+				);
+				aux::DistanceTransform1D(
+					f_out.data(), w,
+					dist_out.data()+r*w,
+					v.data(), z.data()
+				);
+			}
+		},
+		params.max_threads
+	);
+
+	// the columns of each slice, in groups gathered into a buffer
+	const std::size_t group = aux::DistanceFieldColumnGroup();
+	const std::size_t groups = (w+group-1)/group;
+	oglplus::aux::ParallelFor(
+		d*groups,
+		1,
+		[&](std::size_t begin, std::size_t end)
+		{
+			std::vector<float> f(h*group), col(h);
+			std::vector<std::ptrdiff_t> v(h);
+			std::vector<float> z(h+1);
+			for(std::size_t t=begin; t!=end; ++t)
+			{
+				const std::size_t x0 = (t % groups)*group;
+				const std::size_t n = std::min(group, w-x0);
+				const std::size_t offs = (t / groups)*w*h+x0;
+				for(float* dist : {dist_in.data(), dist_out.data()})
+				{
+					float* base = dist+offs;
+					for(std::size_t y=0; y!=h; ++y)
+					{
+						for(std::size_t i=0; i!=n; ++i)
+						{
+							f[i*h+y] = base[y*w+i];
+						}
+					}
+					for(std::size_t i=0; i!=n; ++i)
+					{
+						aux::DistanceTransform1D(
+							f.data()+i*h, h,
+							col.data(),
+							v.data(), z.data()
+						);
+						for(std::size_t y=0; y!=h; ++y)
+						{
+							base[y*w+i] = col[y];
+						}
+					}
+				}
+			}
+		},
+		params.max_threads
+	);
+
+	const std::size_t ow = (w+ds-1)/ds;
+	const std::size_t oh = (h+ds-1)/ds;
+	// no distance in a slice is larger than its diagonal
+	const float max_dist = std::sqrt(float(w*w+h*h));
+
+	// the signed distance of the texel with index i (in input texels)
+	auto signed_dist = [&](std::size_t i) -> float
+	{
+		const float value = cov[i*c];
+		// the edge passes through partially covered texels
+		if((value > 0.0f) && (value < 1.0f))
+		{
+			return value-params.threshold;
+		}
+		if(value >= params.threshold)
+		{
+			return std::min(std::sqrt(dist_out[i]), max_dist)-0.5f;
+		}
+		return 0.5f-std::min(std::sqrt(dist_in[i]), max_dist);
+	};
+
+	oglplus::aux::AlignedPODArray storage;
+	if(params.floating)
+	{
+		storage = oglplus::aux::AlignedPODArray(
+			static_cast<const GLfloat*>(nullptr),
+			ow*oh*d
+		);
+	}
+	else
+	{
+		storage = oglplus::aux::AlignedPODArray(
+			static_cast<const GLubyte*>(nullptr),
+			ow*oh*d
+		);
+	}
+	GLfloat* dst_f = static_cast<GLfloat*>(storage.begin());
+	GLubyte* dst_ub = static_cast<GLubyte*>(storage.begin());
+	const float scale = 0.5f/params.spread;
+
+	// the output rows, averaging the distances in the blocks
+	oglplus::aux::ParallelFor(
+		oh*d,
+		16,
+		[&](std::size_t begin, std::size_t end)
+		{
+			for(std::size_t r=begin; r!=end; ++r)
+			{
+				const std::size_t oz = r / oh;
+				const std::size_t y0 = (r % oh)*ds;
+				const std::size_t y1 = std::min(y0+ds, h);
+				for(std::size_t ox=0; ox!=ow; ++ox)
+				{
+					const std::size_t x0 = ox*ds;
+					const std::size_t x1 = std::min(x0+ds, w);
+					float sum = 0.0f;
+					for(std::size_t y=y0; y!=y1; ++y)
+					{
+						const std::size_t row = (oz*h+y)*w;
+						for(std::size_t x=x0; x!=x1; ++x)
+						{
+							sum += signed_dist(row+x);
+						}
+					}
+					// in output texels
+					const float dist =
+						sum/float((y1-y0)*(x1-x0)*ds);
+					const std::size_t o = r*ow+ox;
+					if(params.floating)
+					{
+						dst_f[o] = dist;
+						continue;
+					}
+					const float value = std::max(0.0f, std::min(
+						0.5f+dist*scale,
+						1.0f
+					));
+					dst_ub[o] = GLubyte(value*255.0f+0.5f);
+				}
+			}
+		},
+		params.max_threads
+	);
+
+	if(params.floating)
+	{
+		return Image(
+			GLsizei(ow), GLsizei(oh), GLsizei(d), 1,
+			static_cast<const GLfloat*>(nullptr),
+			std::move(storage),
+			PixelDataFormat::Red,
+			PixelDataInternalFormat::R32F
+		);
+	}
+	return Image(
+		GLsizei(ow), GLsizei(oh), GLsizei(d), 1,
+		static_cast<const GLubyte*>(nullptr),
+		std::move(storage),
+		PixelDataFormat::Red,
+		PixelDataInternalFormat::R8
+	);
+}
+
+} // namespace images
+} // namespace oglplus
+
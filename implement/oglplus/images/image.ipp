@@ -19,6 +19,32 @@ OGLPLUS_NOEXCEPT(true)
 	return (!_storage.empty()) && (_convert != nullptr);
 }
 
+OGLPLUS_LIB_FUNC
+Image::_convert_func Image::_get_convert(PixelDataType type)
+OGLPLUS_NOEXCEPT(true)
+{
+	switch(GLenum(type))
+	{
+		case GL_UNSIGNED_BYTE: return &_do_convert<GLubyte>;
+		case GL_BYTE: return &_do_convert<GLbyte>;
+		case GL_UNSIGNED_SHORT: return &_do_convert<GLushort>;
+		case GL_SHORT: return &_do_convert<GLshort>;
+		case GL_UNSIGNED_INT: return &_do_convert<GLuint>;
+		case GL_INT: return &_do_convert<GLint>;
+		case GL_FLOAT: return &_do_convert<GLfloat>;
+#ifdef GL_HALF_FLOAT
+		case GL_HALF_FLOAT: return &_do_convert_half;
+#endif
+		// the packed types are accessible only as raw integers
+		case GL_UNSIGNED_INT_10F_11F_11F_REV:
+		case GL_UNSIGNED_INT_5_9_9_9_REV:
+		case GL_UNSIGNED_INT_2_10_10_10_REV:
+			return &_do_convert<GLuint>;
+		default:;
+	}
+	return nullptr;
+}
+
 OGLPLUS_LIB_FUNC
 PixelDataFormat Image::_get_def_pdf(unsigned n)
 OGLPLUS_NOEXCEPT(true)
@@ -17,13 +17,99 @@
 #include <oglplus/images/png.hpp>
 #endif
 #include <oglplus/images/xpm.hpp>
+#include <oglplus/images/container.hpp>
 #include <oglplus/lib/incl_end.ipp>
 
 #include <fstream>
 #include <stdexcept>
+#include <cstring>
 
 namespace oglplus {
 namespace images {
+namespace aux {
+
+template <typename T>
+Image LoadContainerImage(const ImageView& view, bool flip_y, bool flip_x)
+{
+	const GLsizei width = GLsizei(view.Width());
+	const GLsizei height = GLsizei(view.Height());
+	const GLsizei channels = GLsizei(view.Channels());
+	const std::size_t pixel_size = std::size_t(channels)*sizeof(T);
+
+	oglplus::aux::AlignedPODArray storage(
+		static_cast<const T*>(nullptr),
+		std::size_t(width*height*channels)
+	);
+	unsigned char* dst = static_cast<unsigned char*>(storage.begin());
+	for(GLsizei y=0; y!=height; ++y)
+	{
+		const GLsizei sy = flip_y?height-y-1:y;
+		const unsigned char* src = static_cast<const unsigned char*>(
+			view.RawPixel(0, sy, 0)
+		);
+		if(flip_x)
+		{
+			for(GLsizei x=0; x!=width; ++x)
+			{
+				std::memcpy(
+					dst+std::size_t(x)*pixel_size,
+					src+std::size_t(width-x-1)*pixel_size,
+					pixel_size
+				);
+			}
+		}
+		else std::memcpy(dst, src, std::size_t(width)*pixel_size);
+		dst += std::size_t(width)*pixel_size;
+	}
+	return Image(
+		view.Width(),
+		view.Height(),
+		1,
+		view.Channels(),
+		static_cast<const T*>(nullptr),
+		std::move(storage),
+		view.Format(),
+		view.InternalFormat()
+	);
+}
+
+// Copies the first image from a KTX (bottom-to-top) or DDS (top-to-bottom)
+// texture container file
+OGLPLUS_LIB_FUNC
+Image LoadContainerImage(
+	const std::string& path,
+	bool is_dds,
+	bool y_is_up,
+	bool x_is_right
+)
+{
+	TextureContainer container(path.c_str());
+	if(container.IsCompressed() || (container.Depth() != 1))
+	{
+		throw std::runtime_error(
+			"Unable to load a compressed or 3D texture "
+			"container as an image: "+path
+		);
+	}
+	const ImageView view = container.View(0);
+	const bool flip_y = (is_dds == y_is_up);
+	const bool flip_x = !x_is_right;
+	switch(GLenum(view.Type()))
+	{
+		case GL_UNSIGNED_BYTE:
+			return LoadContainerImage<GLubyte>(view, flip_y, flip_x);
+		case GL_UNSIGNED_SHORT:
+			return LoadContainerImage<GLushort>(view, flip_y, flip_x);
+		case GL_FLOAT:
+			return LoadContainerImage<GLfloat>(view, flip_y, flip_x);
+		default:;
+	}
+	throw std::runtime_error(
+		"Unsupported texture container pixel type: "+path
+	);
+}
+
+} // namespace aux
 
 OGLPLUS_LIB_FUNC
 Image LoadByName(
@@ -33,17 +119,29 @@ Image LoadByName(
 	bool x_is_right
 )
 {
-	std::ifstream file;
-	const char* exts[] = {".png", ".xpm"};
+	const char* exts[] = {".png", ".xpm", ".ktx", ".dds"};
 	std::size_t nexts = sizeof(exts)/sizeof(exts[0]);
+	std::string path;
 	std::size_t iext = oglplus::FindResourceFile(
-		file,
+		path,
 		category,
 		name,
 		exts,
 		nexts
 	);
+	if(iext == nexts)
+		throw std::runtime_error("Unable to find image: "+name);
+	if(iext >= 2) //.ktx, .dds
+	{
+		return aux::LoadContainerImage(
+			path,
+			iext == 3,
+			y_is_up,
+			x_is_right
+		);
+	}
 
+	std::ifstream file(path, std::ios::binary);
 	if(!file.good())
 		throw std::runtime_error("Unable to open image: "+name);
 	if(iext == 0) //.png
@@ -62,6 +160,27 @@ Image LoadByName(
 	throw std::runtime_error("Unable to open this image type");
 }
 
+OGLPLUS_LIB_FUNC
+TextureContainer LoadContainerByName(
+	std::string category,
+	std::string name
+)
+{
+	const char* exts[] = {".ktx", ".dds"};
+	std::size_t nexts = sizeof(exts)/sizeof(exts[0]);
+	std::string path;
+	std::size_t iext = oglplus::FindResourceFile(
+		path,
+		category,
+		name,
+		exts,
+		nexts
+	);
+	if(iext == nexts)
+		throw std::runtime_error("Unable to find texture: "+name);
+	return TextureContainer(path.c_str());
+}
+
 } // images
 } // oglplus
 
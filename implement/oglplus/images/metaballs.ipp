@@ -12,13 +12,143 @@
 #include <oglplus/lib/incl_begin.ipp>
 #include <oglplus/math/angle.hpp>
 #include <oglplus/math/vector.hpp>
+#include <oglplus/detail/parallel_for.hpp>
+#include <oglplus/detail/float_lanes.hpp>
 #include <oglplus/lib/incl_end.ipp>
 
+#include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <cstdint>
 #include <cstdlib>
+#include <vector>
 
 namespace oglplus {
 namespace images {
+namespace aux {
+
+// One of the (up to) nine seamless repetitions of a single ball
+// and the range of pixels which it can possibly affect
+struct MetaballCopy
+{
+	std::size_t b;
+	int xo, yo;
+	GLsizei x0, x1;
+	GLsizei y0, y1;
+};
+
+// The width and height of the tiles into which the balls are binned,
+// must be a multiple of the SIMD vector width
+inline GLsizei MetaballsTileSize(void)
+{
+	return 32;
+}
+
+// Calculates the range of pixels [b, e) in one dimension, outside of which
+// a ball with center at c and with radius of influence rad has no effect
+inline bool MetaballRange(
+	GLfloat c,
+	int o,
+	double rad,
+	GLsizei size,
+	GLsizei& b,
+	GLsizei& e
+)
+{
+	// the contribution is zero at a distance greater than twice
+	// the radius of the ball, the range is extended by a small margin
+	// to account for the rounding errors
+	const double lo = (double(c)-o-rad*1.001)*size-0.5;
+	const double hi = (double(c)-o+rad*1.001)*size-0.5;
+
+	// the whole range is used if the values are not finite or too big
+	if(!(std::abs(lo) < 1e9) || !(std::abs(hi) < 1e9))
+	{
+		b = 0;
+		e = size;
+		return true;
+	}
+	b = std::max(GLsizei(std::floor(lo))-1, GLsizei(0));
+	e = std::min(GLsizei(std::ceil(hi))+2, size);
+	return b < e;
+}
+
+// Evaluates the contribution of a single copy of a ball to the pixel
+// with normalized coordinates i, j
+inline GLfloat MetaballSample(
+	const GLfloat* ball,
+	std::size_t n,
+	const MetaballCopy& copy,
+	GLfloat i,
+	GLfloat j
+)
+{
+	const auto fc = FullCircle();
+	const Vec2f p(i, j);
+	const Vec2f c(ball, 2);
+	const Vec2f o(copy.xo, copy.yo);
+	const Vec2f d = p - c + o;
+
+	GLfloat r = ball[2];
+
+	if(n > 3)
+	{
+		GLfloat w = ArcTan(d.y(), d.x())/fc;
+		w += ball[2];
+		w = Sin(fc*w*ball[3]);
+
+		if(n > 4) r += ball[4]*r*w;
+		else r += 0.25f*r*w;
+	}
+
+	float t = (r*r/Dot(d,d))-0.25f;
+	return (t>0.0f)?t:0.0f;
+}
+
+namespace OGLPLUS_AUX_LANES_NAMESPACE {
+
+// Adds the contribution of a single copy of a (non-star) ball to the
+// values in row[s, e) of the tile starting at pixel x = tx in the row
+// with the normalized y-coordinate j, s and e must be multiples of 8
+/* Declared in the namespace of the instruction set, like FloatLanes.
+ */
+inline void MetaballSpanSIMD(
+	const GLfloat* ball,
+	const MetaballCopy& copy,
+	GLfloat* row,
+	GLsizei tx,
+	GLsizei s,
+	GLsizei e,
+	GLfloat width,
+	GLfloat j
+)
+{
+	typedef oglplus::aux::FloatLanes L;
+	typedef oglplus::aux::IntLanes I;
+
+	const GLfloat dy = (j-ball[1])+GLfloat(copy.yo);
+	const L dyy = dy*dy;
+	const L rr = ball[2]*ball[2];
+	const L cx = ball[0];
+	const L ox = GLfloat(copy.xo);
+	const L half = 0.5f;
+	const L quarter = 0.25f;
+	const L zero = 0.0f;
+	const L w = width;
+	for(; s < e; s+=GLsizei(L::Width))
+	{
+		const L i = (ToFloat(I::Iota(std::uint32_t(tx+s)))+half)/w;
+		const L dx = (i-cx)+ox;
+		// returns the zero also if t is NaN (like the scalar version)
+		const L t = Max((rr/(dx*dx+dyy))-quarter, zero);
+		(L::Load(row+s)+t).Store(row+s);
+	}
+}
+
+} // namespace OGLPLUS_AUX_LANES_NAMESPACE
+using namespace OGLPLUS_AUX_LANES_NAMESPACE;
+
+} // namespace aux
 
 OGLPLUS_LIB_FUNC
 BaseMetaballs::BaseMetaballs(
@@ -26,7 +156,8 @@ BaseMetaballs::BaseMetaballs(
 	SizeType height,
 	const GLfloat* balls,
 	std::size_t size,
-	std::size_t n
+	std::size_t n,
+	bool vectorized
 ): Image(
 	width,
 	height,
@@ -39,52 +170,123 @@ BaseMetaballs::BaseMetaballs(
 {
 	assert(size % n == 0);
 
-	const auto fc = FullCircle();
-	auto a = this->_begin<GLfloat>();
+	const GLsizei ts = aux::MetaballsTileSize();
+	const GLsizei tiles_x = (width+ts-1)/ts;
+	const GLsizei tiles_y = (height+ts-1)/ts;
+
+	// find the ranges of pixels affected by each copy of each ball
+	// and bin the copies into tiles, keeping the order of the copies
+	// so that the values are summed in the same order in every pixel
+	std::vector<aux::MetaballCopy> copies;
+	std::vector<std::vector<std::size_t>> bins(
+		std::size_t(tiles_x*tiles_y)
+	);
 
-	for(GLsizei y=0; y!=height; ++y)
+	for(std::size_t b=0; b!=size; b+=n)
 	{
-		const GLfloat j = (y+0.5f)/GLfloat(height);
+		const GLfloat k = (n > 4)?balls[b+4]:((n > 3)?0.25f:0.0f);
+		const double rad =
+			2.0*std::abs(double(balls[b+2]))*(1.0+std::abs(double(k)));
 
-		for(GLsizei x=0; x!=width; ++x)
+		for(int yo=-1; yo!=2; ++yo)
+		for(int xo=-1; xo!=2; ++xo)
 		{
-			GLfloat v = 0.0f;
-			const GLfloat i = (x+0.5f)/GLfloat(width);
-			const Vec2f p(i, j);
+			aux::MetaballCopy copy;
+			copy.b = b;
+			copy.xo = xo;
+			copy.yo = yo;
+			if(!aux::MetaballRange(
+				balls[b+0], xo, rad,
+				width, copy.x0, copy.x1
+			)) continue;
+			if(!aux::MetaballRange(
+				balls[b+1], yo, rad,
+				height, copy.y0, copy.y1
+			)) continue;
 
-			for(std::size_t b=0; b!=size; b+=n)
+			for(GLsizei ty=copy.y0/ts; ty<=(copy.y1-1)/ts; ++ty)
+			for(GLsizei tx=copy.x0/ts; tx<=(copy.x1-1)/ts; ++tx)
 			{
-				const Vec2f c(balls+b, 2);
+				bins[std::size_t(ty*tiles_x+tx)].push_back(
+					copies.size()
+				);
+			}
+			copies.push_back(copy);
+		}
+	}
 
-				for(int yo=-1; yo!=2; ++yo)
-				for(int xo=-1; xo!=2; ++xo)
-				{
-					const Vec2f o(xo, yo);
-					const Vec2f d = p - c + o;
+	const bool simd = vectorized && (n == 3);
+	GLfloat* const data = this->_begin<GLfloat>();
 
-					GLfloat r = balls[b+2];
+	oglplus::aux::ParallelFor(
+		bins.size(),
+		1,
+		[&](std::size_t begin, std::size_t end)
+		{
+			std::vector<GLfloat> row(static_cast<std::size_t>(ts));
+
+			for(std::size_t tile=begin; tile!=end; ++tile)
+			{
+				const GLsizei tx0 = GLsizei(tile)%tiles_x*ts;
+				const GLsizei ty0 = GLsizei(tile)/tiles_x*ts;
+				const GLsizei tx1 = std::min(tx0+ts, GLsizei(width));
+				const GLsizei ty1 = std::min(ty0+ts, GLsizei(height));
+				const std::vector<std::size_t>& bin = bins[tile];
+
+				for(GLsizei y=ty0; y!=ty1; ++y)
+				{
+					const GLfloat j = (y+0.5f)/GLfloat(height);
+					std::fill(row.begin(), row.end(), 0.0f);
 
-					if(n > 3)
+					for(std::size_t idx : bin)
 					{
-						GLfloat w = ArcTan(d.y(), d.x())/fc;
-						w += balls[b+2];
-						w = Sin(fc*w*balls[b+3]);
+						const aux::MetaballCopy& copy = copies[idx];
+						if((y < copy.y0) || (y >= copy.y1)) continue;
 
-						if(n > 4) r += balls[b+4]*r*w;
-						else r += 0.25f*r*w;
-					}
+						const GLfloat* ball = balls+copy.b;
+						const GLsizei xb = std::max(copy.x0, tx0)-tx0;
+						const GLsizei xe = std::min(copy.x1, tx1)-tx0;
+						if(xb >= xe) continue;
 
-					float t = (r*r/Dot(d,d))-0.25f;
-					v += (t>0.0f)?t:0.0f;
+						if(simd)
+						{
+							// the values outside of the range
+							// of the copy are zero so the span
+							// can be extended to whole vectors
+							aux::MetaballSpanSIMD(
+								ball, copy,
+								row.data(), tx0,
+								xb & ~7, (xe+7) & ~7,
+								GLfloat(width), j
+							);
+						}
+						else
+						{
+							for(GLsizei x=xb; x!=xe; ++x)
+							{
+								const GLfloat i =
+									(tx0+x+0.5f)/
+									GLfloat(width);
+								row[std::size_t(x)] +=
+									aux::MetaballSample(
+										ball, n, copy,
+										i, j
+									);
+							}
+						}
+					}
+					std::copy(
+						row.begin(),
+						row.begin()+(tx1-tx0),
+						data+std::size_t(y)*std::size_t(width)+tx0
+					);
 				}
 			}
-			assert(a != this->_end<GLfloat>());
-			*a++ = v;
 		}
-	}
-	assert(a == this->_end<GLfloat>());
+	);
 }
 
+OGLPLUS_LIB_FUNC
 std::vector<GLfloat> RandomMetaballs::_make_balls(
 	std::size_t count,
 	GLfloat rad_min,
@@ -106,6 +308,29 @@ std::vector<GLfloat> RandomMetaballs::_make_balls(
 	return std::move(result);
 }
 
+OGLPLUS_LIB_FUNC
+std::vector<GLfloat> RandomMetaballs::_make_balls(
+	std::size_t count,
+	GLfloat rad_min,
+	GLfloat rad_max,
+	RandomSeed seed
+)
+{
+	std::vector<GLfloat> result(count*3);
+
+	const CounterRNG rng(seed);
+	const GLfloat rd = rad_max-rad_min;
+
+	for(std::size_t i=0; i!=count; ++i)
+	{
+		result[3*i+0] = rng.Unit(3*i+0);
+		result[3*i+1] = rng.Unit(3*i+1);
+		result[3*i+2] = rad_min+rng.Unit(3*i+2)*rd;
+	}
+
+	return result;
+}
+
 OGLPLUS_LIB_FUNC
 RandomMetaballs::RandomMetaballs(
 	SizeType width,
@@ -122,7 +347,25 @@ RandomMetaballs::RandomMetaballs(
 )
 { }
 
+OGLPLUS_LIB_FUNC
+RandomMetaballs::RandomMetaballs(
+	SizeType width,
+	SizeType height,
+	std::size_t count,
+	GLfloat rad_min,
+	GLfloat rad_max,
+	RandomSeed seed
+): BaseMetaballs(
+	width,
+	height,
+	_make_balls(count, rad_min, rad_max, seed).data(),
+	3*count,
+	3
+)
+{ }
+
 
+OGLPLUS_LIB_FUNC
 std::vector<GLfloat> RandomMetastars::_make_stars(
 	std::size_t count,
 	GLfloat rad_min,
@@ -152,6 +395,37 @@ std::vector<GLfloat> RandomMetastars::_make_stars(
 	return std::move(result);
 }
 
+OGLPLUS_LIB_FUNC
+std::vector<GLfloat> RandomMetastars::_make_stars(
+	std::size_t count,
+	GLfloat rad_min,
+	GLfloat rad_max,
+	GLfloat dif_min,
+	GLfloat dif_max,
+	GLuint ptc_min,
+	GLuint ptc_max,
+	RandomSeed seed
+)
+{
+	std::vector<GLfloat> result(count*5);
+
+	const CounterRNG rng(seed);
+	const GLfloat rd = rad_max-rad_min;
+	const std::uint32_t pd = ptc_max-ptc_min+1;
+	const GLfloat dd = dif_max-dif_min;
+
+	for(std::size_t i=0; i!=count; ++i)
+	{
+		result[5*i+0] = rng.Unit(5*i+0);
+		result[5*i+1] = rng.Unit(5*i+1);
+		result[5*i+2] = rad_min+rng.Unit(5*i+2)*rd;
+		result[5*i+3] = GLfloat(ptc_min+rng.Below(5*i+3, pd));
+		result[5*i+4] = dif_min+rng.Unit(5*i+4)*dd;
+	}
+
+	return result;
+}
+
 OGLPLUS_LIB_FUNC
 RandomMetastars::RandomMetastars(
 	SizeType width,
@@ -180,6 +454,36 @@ RandomMetastars::RandomMetastars(
 )
 { }
 
+OGLPLUS_LIB_FUNC
+RandomMetastars::RandomMetastars(
+	SizeType width,
+	SizeType height,
+	std::size_t count,
+	GLfloat rad_min,
+	GLfloat rad_max,
+	GLfloat dif_min,
+	GLfloat dif_max,
+	GLuint ptc_min,
+	GLuint ptc_max,
+	RandomSeed seed
+): BaseMetaballs(
+	width,
+	height,
+	_make_stars(
+		count,
+		rad_min,
+		rad_max,
+		dif_min,
+		dif_max,
+		ptc_min,
+		ptc_max,
+		seed
+	).data(),
+	5*count,
+	5
+)
+{ }
+
 } // namespace images
 } // namespace oglplus
 
@@ -0,0 +1,491 @@
+/**
+ *  @file oglplus/images/mipmap.ipp
+ *  @brief Implementation of images::MipmapChain
+ *
+ *  @author Matus Chochlik
+ *
+ *  Copyright 2010-2015 Matus Chochlik. Distributed under the Boost
+ *  Software License, Version 1.0. (See accompanying file
+ *  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include <oglplus/detail/parallel_for.hpp>
+#include <oglplus/math/constants.hpp>
+#include <stdexcept>
+#include <algorithm>
+#include <limits>
+#include <cstring>
+#include <cmath>
+
+namespace oglplus {
+namespace images {
+namespace aux {
+
+inline double MipmapSinc(double x)
+{
+	if(x == 0.0) return 1.0;
+	x *= math::Pi();
+	return std::sin(x)/x;
+}
+
+// The modified Bessel function of the first kind of order 0
+inline double MipmapBesselI0(double x)
+{
+	double sum = 1.0, term = 1.0;
+	const double q = x*x*0.25;
+	for(int k=1; k!=32; ++k)
+	{
+		term *= q/(k*k);
+		sum += term;
+		if(term < sum*1e-12) break;
+	}
+	return sum;
+}
+
+// The resampling filter kernel, x is in the destination pixel units
+class MipmapKernel
+{
+private:
+	MipmapFilter _filter;
+	double _i0_alpha;
+
+	static double _kaiser_alpha(void) { return 4.0; }
+public:
+	MipmapKernel(MipmapFilter filter)
+	 : _filter(filter)
+	 , _i0_alpha(MipmapBesselI0(_kaiser_alpha()))
+	{ }
+
+	double Support(void) const
+	{
+		return (_filter == MipmapFilter::Box)?0.5:3.0;
+	}
+
+	double operator()(double x) const
+	{
+		switch(_filter)
+		{
+			case MipmapFilter::Box:
+				return ((x >= -0.5) && (x < 0.5))?1.0:0.0;
+			case MipmapFilter::Kaiser:
+			{
+				const double t = x/3.0;
+				if(t*t >= 1.0) return 0.0;
+				return	MipmapSinc(x)*
+					MipmapBesselI0(
+						_kaiser_alpha()*std::sqrt(1.0-t*t)
+					)/_i0_alpha;
+			}
+			case MipmapFilter::Lanczos:
+				if((x <= -3.0) || (x >= 3.0)) return 0.0;
+				return MipmapSinc(x)*MipmapSinc(x/3.0);
+		}
+		return 0.0;
+	}
+};
+
+// Precomputed (normalized) weights and clamped source indices
+// of the resampling of a single dimension
+class MipmapTaps
+{
+private:
+	std::vector<std::size_t> _offs;
+	std::vector<GLsizei> _index;
+	std::vector<float> _weight;
+public:
+	MipmapTaps(GLsizei src_size, GLsizei dst_size, const MipmapKernel& kernel)
+	{
+		assert(src_size > 0 && dst_size > 0);
+		const double ratio = double(src_size)/double(dst_size);
+		const double support = kernel.Support()*ratio;
+
+		_offs.reserve(std::size_t(dst_size+1));
+		for(GLsizei i=0; i!=dst_size; ++i)
+		{
+			_offs.push_back(_weight.size());
+			const double center = (i+0.5)*ratio;
+			const GLsizei jmin = GLsizei(std::floor(center-support));
+			const GLsizei jmax = GLsizei(std::ceil(center+support));
+
+			double sum = 0.0;
+			const std::size_t first = _weight.size();
+			for(GLsizei j=jmin; j<=jmax; ++j)
+			{
+				const double w = kernel((j+0.5-center)/ratio);
+				if(w == 0.0) continue;
+				_index.push_back(std::min(std::max(j, 0), src_size-1));
+				_weight.push_back(float(w));
+				sum += w;
+			}
+			assert(sum != 0.0);
+			for(std::size_t k=first; k!=_weight.size(); ++k)
+			{
+				_weight[k] = float(_weight[k]/sum);
+			}
+		}
+		_offs.push_back(_weight.size());
+	}
+
+	std::size_t Begin(GLsizei i) const { return _offs[std::size_t(i)]; }
+	std::size_t End(GLsizei i) const { return _offs[std::size_t(i+1)]; }
+	GLsizei Index(std::size_t k) const { return _index[k]; }
+	float Weight(std::size_t k) const { return _weight[k]; }
+};
+
+// Resamples the src image into dst, first vertically (whole rows at once)
+// and then horizontally (the rows of the intermediate result)
+OGLPLUS_LIB_FUNC
+void MipmapDownsample(
+	const float* src,
+	GLsizei src_width,
+	GLsizei src_height,
+	float* dst,
+	GLsizei dst_width,
+	GLsizei dst_height,
+	GLsizei channels,
+	MipmapFilter filter,
+	unsigned max_threads
+)
+{
+	assert(channels >= 1 && channels <= 4);
+	const MipmapKernel kernel(filter);
+	const MipmapTaps xtaps(src_width, dst_width, kernel);
+	const MipmapTaps ytaps(src_height, dst_height, kernel);
+
+	const std::size_t src_row = std::size_t(src_width*channels);
+	const std::size_t dst_row = std::size_t(dst_width*channels);
+
+	oglplus::aux::ParallelFor(
+		std::size_t(dst_height),
+		8,
+		[&](std::size_t begin, std::size_t end)
+		{
+			std::vector<float> tmp(src_row);
+			for(std::size_t y=begin; y!=end; ++y)
+			{
+				float* t = tmp.data();
+				std::fill(tmp.begin(), tmp.end(), 0.0f);
+				const GLsizei iy = GLsizei(y);
+				for(
+					std::size_t k=ytaps.Begin(iy);
+					k!=ytaps.End(iy);
+					++k
+				)
+				{
+					const float w = ytaps.Weight(k);
+					const float* s =
+						src+std::size_t(ytaps.Index(k))*src_row;
+					for(std::size_t i=0; i!=src_row; ++i)
+					{
+						t[i] += w*s[i];
+					}
+				}
+
+				float* d = dst+y*dst_row;
+				for(GLsizei x=0; x!=dst_width; ++x)
+				{
+					float acc[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+					for(
+						std::size_t k=xtaps.Begin(x);
+						k!=xtaps.End(x);
+						++k
+					)
+					{
+						const float w = xtaps.Weight(k);
+						const float* s =
+							t+xtaps.Index(k)*channels;
+						for(GLsizei c=0; c!=channels; ++c)
+						{
+							acc[c] += w*s[c];
+						}
+					}
+					for(GLsizei c=0; c!=channels; ++c)
+					{
+						*d++ = acc[c];
+					}
+				}
+			}
+		},
+		max_threads
+	);
+}
+
+// Renormalizes the vectors in the first three channels
+OGLPLUS_LIB_FUNC
+void MipmapRenormalize(
+	float* data,
+	std::size_t count,
+	GLsizei channels,
+	bool is_signed
+)
+{
+	assert(channels >= 3);
+	for(std::size_t i=0; i!=count; ++i)
+	{
+		float* p = data+i*std::size_t(channels);
+		float n[3];
+		for(int c=0; c!=3; ++c)
+		{
+			n[c] = is_signed?p[c]:p[c]*2.0f-1.0f;
+		}
+		const float l = std::sqrt(n[0]*n[0]+n[1]*n[1]+n[2]*n[2]);
+		if(l <= 0.0f) continue;
+		for(int c=0; c!=3; ++c)
+		{
+			n[c] /= l;
+			p[c] = is_signed?n[c]:n[c]*0.5f+0.5f;
+		}
+	}
+}
+
+inline float MipmapSRGBToLinear(float v)
+{
+	if(v <= 0.04045f) return v/12.92f;
+	return std::pow((v+0.055f)/1.055f, 2.4f);
+}
+
+inline float MipmapLinearToSRGB(float v)
+{
+	if(v <= 0.0f) return 0.0f;
+	if(v <= 0.0031308f) return v*12.92f;
+	return 1.055f*std::pow(v, 1.0f/2.4f)-0.055f;
+}
+
+template <typename T>
+inline T MipmapFromFloat(float v, TypeTag<T>)
+{
+	const float one = float(std::numeric_limits<T>::max());
+	if(v <= 0.0f) return T(0);
+	if(v >= 1.0f) return T(one);
+	return T(v*one+0.5f);
+}
+
+inline GLfloat MipmapFromFloat(float v, TypeTag<GLfloat>)
+{
+	return v;
+}
+
+template <typename T>
+inline float MipmapToFloat(T v)
+{
+	return float(v)/float(std::numeric_limits<T>::max());
+}
+
+inline float MipmapToFloat(GLfloat v)
+{
+	return v;
+}
+
+// The number of color (non-alpha) channels
+inline GLsizei MipmapColorChannels(GLsizei channels)
+{
+	return ((channels == 2) || (channels == 4))?channels-1:channels;
+}
+
+// Converts the image into (linear) floating-point values
+template <typename T>
+void MipmapLoad(
+	const ImageView& image,
+	bool srgb,
+	float* dst,
+	unsigned max_threads
+)
+{
+	const GLsizei width = GLsizei(image.Width());
+	const GLsizei channels = GLsizei(image.Channels());
+	const GLsizei color = srgb?MipmapColorChannels(channels):0;
+	const std::size_t row = std::size_t(width*channels);
+
+	// the sRGB conversion of 8-bit values is tabulated
+	float lut[256];
+	const bool use_lut = srgb && (sizeof(T) == 1);
+	if(use_lut)
+	{
+		for(int i=0; i!=256; ++i)
+		{
+			lut[i] = MipmapSRGBToLinear(i/255.0f);
+		}
+	}
+
+	oglplus::aux::ParallelFor(
+		std::size_t(image.Height()),
+		16,
+		[&](std::size_t begin, std::size_t end)
+		{
+			for(std::size_t y=begin; y!=end; ++y)
+			{
+				const T* s = static_cast<const T*>(
+					image.RawPixel(0, GLsizei(y), 0)
+				);
+				float* d = dst+y*row;
+				for(GLsizei x=0; x!=width; ++x)
+				{
+					for(GLsizei c=0; c!=channels; ++c)
+					{
+						if(c >= color)
+						{
+							*d++ = MipmapToFloat(*s++);
+						}
+						else if(use_lut)
+						{
+							*d++ = lut[std::size_t(*s++)];
+						}
+						else
+						{
+							*d++ = MipmapSRGBToLinear(
+								MipmapToFloat(*s++)
+							);
+						}
+					}
+				}
+			}
+		},
+		max_threads
+	);
+}
+
+// Converts the (linear) floating-point values to the image data type
+template <typename T>
+void MipmapStore(
+	const float* src,
+	std::size_t count,
+	GLsizei channels,
+	bool srgb,
+	T* dst,
+	unsigned max_threads
+)
+{
+	const GLsizei color = srgb?MipmapColorChannels(channels):0;
+	oglplus::aux::ParallelFor(
+		count,
+		4096,
+		[&](std::size_t begin, std::size_t end)
+		{
+			for(std::size_t i=begin; i!=end; ++i)
+			{
+				const float* s = src+i*std::size_t(channels);
+				T* d = dst+i*std::size_t(channels);
+				for(GLsizei c=0; c!=channels; ++c)
+				{
+					const float v = (c < color)?
+						MipmapLinearToSRGB(s[c]):
+						s[c];
+					d[c] = MipmapFromFloat(v, TypeTag<T>());
+				}
+			}
+		},
+		max_threads
+	);
+}
+
+} // namespace aux
+
+template <typename T>
+void MipmapChain::_build(const ImageView& image, const MipmapParams& params)
+{
+	GLsizei width = GLsizei(image.Width());
+	GLsizei height = GLsizei(image.Height());
+	const GLsizei channels = GLsizei(image.Channels());
+
+	// level 0 is a (contiguous) copy of the original
+	std::vector<T> data(std::size_t(width*height*channels));
+	const std::size_t row_size = std::size_t(width*channels)*sizeof(T);
+	for(GLsizei y=0; y!=height; ++y)
+	{
+		std::memcpy(
+			data.data()+std::size_t(y*width*channels),
+			image.RawPixel(0, y, 0),
+			row_size
+		);
+	}
+	_levels.push_back(Image(
+		width, height, 1, channels,
+		data.data(),
+		image.Format(),
+		image.InternalFormat()
+	));
+
+	std::size_t levels = FullLevelCount(width, height);
+	if((params.max_levels != 0) && (levels > params.max_levels))
+	{
+		levels = params.max_levels;
+	}
+	if(levels <= 1) return;
+	_levels.reserve(levels);
+
+	std::vector<float> cur(data.size()), next;
+	aux::MipmapLoad<T>(image, params.srgb, cur.data(), params.max_threads);
+
+	const bool renormalize = params.normal_map && (channels >= 3);
+	const bool is_signed = !std::numeric_limits<T>::is_integer;
+
+	for(std::size_t l=1; l!=levels; ++l)
+	{
+		const GLsizei w = (width > 1)?width/2:1;
+		const GLsizei h = (height > 1)?height/2:1;
+		const std::size_t count = std::size_t(w*h);
+
+		next.resize(count*std::size_t(channels));
+		aux::MipmapDownsample(
+			cur.data(), width, height,
+			next.data(), w, h,
+			channels,
+			params.filter,
+			params.max_threads
+		);
+		if(renormalize)
+		{
+			aux::MipmapRenormalize(next.data(), count, channels, is_signed);
+		}
+
+		data.resize(next.size());
+		aux::MipmapStore(
+			next.data(),
+			count,
+			channels,
+			params.srgb,
+			data.data(),
+			params.max_threads
+		);
+		_levels.push_back(Image(
+			w, h, 1, channels,
+			data.data(),
+			image.Format(),
+			image.InternalFormat()
+		));
+
+		cur.swap(next);
+		width = w;
+		height = h;
+	}
+}
+
+OGLPLUS_LIB_FUNC
+MipmapChain::MipmapChain(const ImageView& image, const MipmapParams& params)
+{
+	if(image.Depth() != 1)
+	{
+		throw std::runtime_error("Mipmap chain of a 3D image is not supported");
+	}
+	if((image.Channels() < 1) || (image.Channels() > 4))
+	{
+		throw std::runtime_error("Unsupported mipmap number of channels");
+	}
+
+	if(image.Type() == PixelDataType::UnsignedByte)
+	{
+		_build<GLubyte>(image, params);
+	}
+	else if(image.Type() == PixelDataType::UnsignedShort)
+	{
+		_build<GLushort>(image, params);
+	}
+	else if(image.Type() == PixelDataType::Float)
+	{
+		_build<GLfloat>(image, params);
+	}
+	else throw std::runtime_error("Unsupported mipmap pixel data type");
+}
+
+} // namespace images
+} // namespace oglplus
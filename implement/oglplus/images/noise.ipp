@@ -0,0 +1,589 @@
+/**
+ *  @file oglplus/images/noise.ipp
+ *  @brief Implementation of the noise image generators
+ *
+ *  @author Matus Chochlik
+ *
+ *  Copyright 2010-2015 Matus Chochlik. Distributed under the Boost
+ *  Software License, Version 1.0. (See accompanying file
+ *  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include <oglplus/lib/incl_begin.ipp>
+#include <oglplus/images/convert.hpp>
+#include <oglplus/detail/parallel_for.hpp>
+#include <oglplus/detail/float_lanes.hpp>
+#include <oglplus/lib/incl_end.ipp>
+
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace oglplus {
+namespace images {
+namespace aux {
+
+// The operations of the noise kernels on single floats
+/* The noise functions below are templates parametrized by the type
+ * implementing the arithmetic on a number of lanes (texels), so that
+ * the scalar and the SIMD code do exactly the same operations.
+ */
+struct NoiseLanesX1
+{
+	typedef float F;
+	typedef std::uint32_t I;
+	typedef bool M;
+
+	static const std::size_t size = 1;
+
+	static F Load(const float* p) { return *p; }
+	static void Store(float* p, F v) { *p = v; }
+	static F Set(float v) { return v; }
+	static I SetI(std::uint32_t v) { return v; }
+	static F Index(std::size_t i) { return float(i); }
+
+	static F Add(F a, F b) { return a+b; }
+	static F Sub(F a, F b) { return a-b; }
+	static F Mul(F a, F b) { return a*b; }
+	static F Max(F a, F b) { return (a > b)?a:b; }
+	static F Floor(F a) { return std::floor(a); }
+
+	// converts integral floats to integers and back
+	static I ToInt(F a) { return I(std::int32_t(a)); }
+	static F ToFloat(I a) { return F(std::int32_t(a)); }
+
+	static I AddI(I a, I b) { return a+b; }
+	static I MulI(I a, std::uint32_t c) { return a*c; }
+	static I Xor(I a, I b) { return a^b; }
+	static I And(I a, std::uint32_t c) { return a&c; }
+	static I Shr(I a, int n) { return a >> n; }
+
+	static M Less(F a, F b) { return a < b; }
+	static M LessEq(F a, F b) { return a <= b; }
+	static M LessI(I a, std::uint32_t c) { return a < c; }
+	static M EqualI(I a, I b) { return a == b; }
+	static M AndM(M a, M b) { return a && b; }
+	static M OrM(M a, M b) { return a || b; }
+	static M NotM(M a) { return !a; }
+
+	static F Select(M m, F a, F b) { return m?a:b; }
+	static I SelectI(M m, I a, I b) { return m?a:b; }
+
+	// negates a if the bit of b (shifted to the sign bit by n) is set
+	static F FlipSign(F a, I b, int n) { return ((b << n) >> 31)?-a:a; }
+};
+
+#if !OGLPLUS_NO_SIMD
+namespace OGLPLUS_AUX_LANES_NAMESPACE {
+
+// The operations of the noise kernels on FloatLanes::Width floats
+/* Declared in the namespace of the instruction set (like FloatLanes),
+ * so the kernels instantiated for different instruction sets differ.
+ */
+struct NoiseLanesXN
+{
+	typedef oglplus::aux::FloatLanes F;
+	typedef oglplus::aux::IntLanes I;
+	typedef oglplus::aux::FloatLanesMask M;
+
+	static const std::size_t size = F::Width;
+
+	static F Load(const float* p) { return F::Load(p); }
+	static void Store(float* p, F v) { v.Store(p); }
+	static F Set(float v) { return F(v); }
+	static I SetI(std::uint32_t v) { return I(v); }
+	static F Index(std::size_t i)
+	{
+		return ToFloat(I::Iota(std::uint32_t(i)));
+	}
+
+	static F Add(F a, F b) { return a+b; }
+	static F Sub(F a, F b) { return a-b; }
+	static F Mul(F a, F b) { return a*b; }
+	static F Max(F a, F b) { return oglplus::aux::Max(a, b); }
+	static F Floor(F a) { return oglplus::aux::Floor(a); }
+
+	static I ToInt(F a) { return Truncate(a); }
+	static F ToFloat(I a) { return oglplus::aux::ToFloat(a); }
+
+	static I AddI(I a, I b) { return a+b; }
+	static I MulI(I a, std::uint32_t c) { return a*I(c); }
+	static I Xor(I a, I b) { return a^b; }
+	static I And(I a, std::uint32_t c) { return a&I(c); }
+	static I Shr(I a, int n) { return a >> n; }
+
+	static M Less(F a, F b) { return a < b; }
+	static M LessEq(F a, F b) { return a <= b; }
+	// the compared values are small, so the signed comparison works
+	static M LessI(I a, std::uint32_t c) { return a < I(c); }
+	static M EqualI(I a, I b) { return a == b; }
+	static M AndM(M a, M b) { return a & b; }
+	static M OrM(M a, M b) { return a | b; }
+	static M NotM(M a) { return !a; }
+
+	static F Select(M m, F a, F b)
+	{
+		return oglplus::aux::Select(m, a, b);
+	}
+	static I SelectI(M m, I a, I b)
+	{
+		return oglplus::aux::Select(m, a, b);
+	}
+
+	static F FlipSign(F a, I b, int n)
+	{
+		return oglplus::aux::FlipSign(a, b << n);
+	}
+};
+
+} // namespace OGLPLUS_AUX_LANES_NAMESPACE
+using namespace OGLPLUS_AUX_LANES_NAMESPACE;
+#endif
+
+// Hashes the coordinates of a lattice point
+template <typename L>
+inline typename L::I NoiseHash(
+	typename L::I i,
+	typename L::I j,
+	typename L::I k,
+	typename L::I seed
+)
+{
+	typename L::I h = L::Xor(
+		L::Xor(L::MulI(i, 0x8DA6B343u), L::MulI(j, 0xD8163841u)),
+		L::Xor(L::MulI(k, 0xCB1AB31Fu), seed)
+	);
+	h = L::Xor(h, L::Shr(h, 16));
+	h = L::MulI(h, 0x7FEB352Du);
+	h = L::Xor(h, L::Shr(h, 15));
+	h = L::MulI(h, 0x846CA68Bu);
+	return L::Xor(h, L::Shr(h, 16));
+}
+
+// The dot product of the offset from a lattice point with its gradient
+/* The gradient is one of the twelve vectors to the edges of a cube
+ * (four of them twice), selected by the top four bits of the hash.
+ */
+template <typename L>
+inline typename L::F NoiseGradient(
+	typename L::I hash,
+	typename L::F x,
+	typename L::F y,
+	typename L::F z
+)
+{
+	const typename L::I g = L::Shr(hash, 28);
+	const typename L::M xz = L::OrM(
+		L::EqualI(g, L::SetI(12)),
+		L::EqualI(g, L::SetI(14))
+	);
+	const typename L::F u = L::Select(L::LessI(g, 8), x, y);
+	const typename L::F v = L::Select(
+		L::LessI(g, 4),
+		y,
+		L::Select(xz, x, z)
+	);
+	return L::Add(L::FlipSign(u, g, 31), L::FlipSign(v, g, 30));
+}
+
+// The contribution of a corner of a simplex
+template <typename L>
+inline typename L::F SimplexNoiseCorner(
+	typename L::I hash,
+	typename L::F x,
+	typename L::F y,
+	typename L::F z
+)
+{
+	typename L::F t = L::Sub(
+		L::Set(0.5f),
+		L::Add(L::Add(L::Mul(x, x), L::Mul(y, y)), L::Mul(z, z))
+	);
+	t = L::Max(t, L::Set(0.0f));
+	t = L::Mul(t, t);
+	return L::Mul(L::Mul(t, t), NoiseGradient<L>(hash, x, y, z));
+}
+
+// Scales the sum of the contributions of the corners to about [-1, 1]
+inline float SimplexNoiseScale(void)
+{
+	return 76.0f;
+}
+
+// 3D simplex noise (Perlin 2001), in approximately the [-1, 1] range
+template <typename L>
+inline typename L::F SimplexNoise3D(
+	typename L::F x,
+	typename L::F y,
+	typename L::F z,
+	typename L::I seed
+)
+{
+	typedef typename L::F F;
+	typedef typename L::I I;
+	typedef typename L::M M;
+
+	const F one = L::Set(1.0f);
+	const F zero = L::Set(0.0f);
+	const F g3 = L::Set(1.0f/6.0f);
+
+	// the cell of the skewed lattice
+	const F s = L::Mul(L::Add(L::Add(x, y), z), L::Set(1.0f/3.0f));
+	const F fi = L::Floor(L::Add(x, s));
+	const F fj = L::Floor(L::Add(y, s));
+	const F fk = L::Floor(L::Add(z, s));
+	const F t = L::Mul(L::Add(L::Add(fi, fj), fk), g3);
+	const F x0 = L::Sub(x, L::Sub(fi, t));
+	const F y0 = L::Sub(y, L::Sub(fj, t));
+	const F z0 = L::Sub(z, L::Sub(fk, t));
+
+	// the simplex in the cell, by the order of the coordinates
+	const M xy = L::LessEq(y0, x0);
+	const M xz = L::LessEq(z0, x0);
+	const M yz = L::LessEq(z0, y0);
+	const F i1 = L::Select(L::AndM(xy, xz), one, zero);
+	const F j1 = L::Select(L::AndM(L::NotM(xy), yz), one, zero);
+	const F k1 = L::Select(L::AndM(L::NotM(xz), L::NotM(yz)), one, zero);
+	const F i2 = L::Select(L::OrM(xy, xz), one, zero);
+	const F j2 = L::Select(L::OrM(L::NotM(xy), yz), one, zero);
+	const F k2 = L::Select(L::OrM(L::NotM(xz), L::NotM(yz)), one, zero);
+
+	const I ii = L::ToInt(fi);
+	const I ij = L::ToInt(fj);
+	const I ik = L::ToInt(fk);
+	const I i_one = L::SetI(1);
+
+	F result = SimplexNoiseCorner<L>(
+		NoiseHash<L>(ii, ij, ik, seed),
+		x0, y0, z0
+	);
+	result = L::Add(result, SimplexNoiseCorner<L>(
+		NoiseHash<L>(
+			L::AddI(ii, L::ToInt(i1)),
+			L::AddI(ij, L::ToInt(j1)),
+			L::AddI(ik, L::ToInt(k1)),
+			seed
+		),
+		L::Add(L::Sub(x0, i1), g3),
+		L::Add(L::Sub(y0, j1), g3),
+		L::Add(L::Sub(z0, k1), g3)
+	));
+	const F g3x2 = L::Set(2.0f/6.0f);
+	result = L::Add(result, SimplexNoiseCorner<L>(
+		NoiseHash<L>(
+			L::AddI(ii, L::ToInt(i2)),
+			L::AddI(ij, L::ToInt(j2)),
+			L::AddI(ik, L::ToInt(k2)),
+			seed
+		),
+		L::Add(L::Sub(x0, i2), g3x2),
+		L::Add(L::Sub(y0, j2), g3x2),
+		L::Add(L::Sub(z0, k2), g3x2)
+	));
+	const F g3x3 = L::Set(3.0f/6.0f);
+	result = L::Add(result, SimplexNoiseCorner<L>(
+		NoiseHash<L>(
+			L::AddI(ii, i_one),
+			L::AddI(ij, i_one),
+			L::AddI(ik, i_one),
+			seed
+		),
+		L::Add(L::Sub(x0, one), g3x3),
+		L::Add(L::Sub(y0, one), g3x3),
+		L::Add(L::Sub(z0, one), g3x3)
+	));
+	return L::Mul(result, L::Set(SimplexNoiseScale()));
+}
+
+template <typename L>
+inline typename L::F NoiseLerp(
+	typename L::F a,
+	typename L::F b,
+	typename L::F t
+)
+{
+	return L::Add(a, L::Mul(t, L::Sub(b, a)));
+}
+
+// The quintic interpolation weight of the gradient noise
+template <typename L>
+inline typename L::F NoiseFade(typename L::F t)
+{
+	typename L::F r = L::Sub(L::Mul(t, L::Set(6.0f)), L::Set(15.0f));
+	r = L::Add(L::Mul(t, r), L::Set(10.0f));
+	return L::Mul(L::Mul(L::Mul(t, t), t), r);
+}
+
+// Returns i+1 wrapped to zero at the period p
+template <typename L>
+inline typename L::I NoiseNext(typename L::I i, typename L::I p)
+{
+	const typename L::I n = L::AddI(i, L::SetI(1));
+	return L::SelectI(L::EqualI(n, p), L::SetI(0), n);
+}
+
+// 3D gradient noise (Perlin 2002) periodic in px, py and pz
+/* The coordinates must be in the [0, p) range.
+ */
+template <typename L>
+inline typename L::F GradientNoise3D(
+	typename L::F x,
+	typename L::F y,
+	typename L::F z,
+	typename L::I px,
+	typename L::I py,
+	typename L::I pz,
+	typename L::I seed
+)
+{
+	typedef typename L::F F;
+	typedef typename L::I I;
+
+	const F one = L::Set(1.0f);
+	const F fi = L::Floor(x);
+	const F fj = L::Floor(y);
+	const F fk = L::Floor(z);
+	const F x0 = L::Sub(x, fi), x1 = L::Sub(x0, one);
+	const F y0 = L::Sub(y, fj), y1 = L::Sub(y0, one);
+	const F z0 = L::Sub(z, fk), z1 = L::Sub(z0, one);
+
+	const I i0 = L::ToInt(fi), i1 = NoiseNext<L>(i0, px);
+	const I j0 = L::ToInt(fj), j1 = NoiseNext<L>(j0, py);
+	const I k0 = L::ToInt(fk), k1 = NoiseNext<L>(k0, pz);
+
+	const F u = NoiseFade<L>(x0);
+	const F v = NoiseFade<L>(y0);
+	const F w = NoiseFade<L>(z0);
+
+	const F n00 = NoiseLerp<L>(
+		NoiseGradient<L>(NoiseHash<L>(i0, j0, k0, seed), x0, y0, z0),
+		NoiseGradient<L>(NoiseHash<L>(i1, j0, k0, seed), x1, y0, z0),
+		u
+	);
+	const F n10 = NoiseLerp<L>(
+		NoiseGradient<L>(NoiseHash<L>(i0, j1, k0, seed), x0, y1, z0),
+		NoiseGradient<L>(NoiseHash<L>(i1, j1, k0, seed), x1, y1, z0),
+		u
+	);
+	const F n01 = NoiseLerp<L>(
+		NoiseGradient<L>(NoiseHash<L>(i0, j0, k1, seed), x0, y0, z1),
+		NoiseGradient<L>(NoiseHash<L>(i1, j0, k1, seed), x1, y0, z1),
+		u
+	);
+	const F n11 = NoiseLerp<L>(
+		NoiseGradient<L>(NoiseHash<L>(i0, j1, k1, seed), x0, y1, z1),
+		NoiseGradient<L>(NoiseHash<L>(i1, j1, k1, seed), x1, y1, z1),
+		u
+	);
+	return NoiseLerp<L>(
+		NoiseLerp<L>(n00, n10, v),
+		NoiseLerp<L>(n01, n11, v),
+		w
+	);
+}
+
+// The parameters of an octave of a channel of the noise
+struct NoiseOctave
+{
+	// the texel to noise coordinate scales
+	float sx, sy, sz;
+	// the periods of the tiling noise
+	std::uint32_t px, py, pz;
+	std::uint32_t seed;
+	float amplitude;
+};
+
+// Adds an octave of the noise to count values of a row starting at x
+template <typename L>
+inline std::size_t NoiseAddOctave(
+	const NoiseOctave& octave,
+	bool tiling,
+	std::size_t x,
+	std::size_t count,
+	std::size_t y,
+	std::size_t z,
+	float* dst
+)
+{
+	typedef typename L::F F;
+
+	const F sx = L::Set(octave.sx);
+	const F ny = L::Set(float(y)*octave.sy);
+	const F nz = L::Set(float(z)*octave.sz);
+	const F amplitude = L::Set(octave.amplitude);
+	const typename L::I seed = L::SetI(octave.seed);
+
+	for(; x+L::size <= count; x+=L::size)
+	{
+		const F nx = L::Mul(L::Index(x), sx);
+		const F n = tiling?
+			GradientNoise3D<L>(
+				nx, ny, nz,
+				L::SetI(octave.px),
+				L::SetI(octave.py),
+				L::SetI(octave.pz),
+				seed
+			):SimplexNoise3D<L>(nx, ny, nz, seed);
+		L::Store(dst+x, L::Add(L::Load(dst+x), L::Mul(amplitude, n)));
+	}
+	return x;
+}
+
+} // namespace aux
+
+OGLPLUS_LIB_FUNC
+Image FractalNoise::_make(
+	SizeType width,
+	SizeType height,
+	SizeType depth,
+	SizeType channels,
+	RandomSeed seed,
+	const NoiseParams& params
+)
+{
+	assert(params.scale > 0.0f);
+	assert(params.octaves > 0);
+
+	const std::size_t w = std::size_t(GLsizei(width));
+	const std::size_t h = std::size_t(GLsizei(height));
+	const std::size_t d = std::size_t(GLsizei(depth));
+	const std::size_t c = std::size_t(GLsizei(channels));
+
+	if((c < 1) || (c > 4))
+	{
+		throw std::runtime_error(
+			"Noise images must have one to four channels"
+		);
+	}
+	if(	(params.type != PixelDataType::Float) &&
+		(params.type != PixelDataType::HalfFloat) &&
+		(params.type != PixelDataType::UnsignedByte)
+	)
+	{
+		throw std::runtime_error("Unsupported noise image data type");
+	}
+	const bool unorm = (params.type == PixelDataType::UnsignedByte);
+
+	// the octaves of each channel
+	const CounterRNG rng(seed);
+	const std::size_t octaves = params.octaves;
+	std::vector<aux::NoiseOctave> octave(c*octaves);
+	float frequency = 1.0f/params.scale;
+	float amplitude = 1.0f;
+	float amplitudes = 0.0f;
+	for(std::size_t o=0; o!=octaves; ++o)
+	{
+		aux::NoiseOctave oct;
+		oct.sx = oct.sy = oct.sz = frequency;
+		oct.px = oct.py = oct.pz = 0;
+		if(params.tiling)
+		{
+			// integral numbers of cells per image
+			const std::size_t size[3] = {w, h, d};
+			std::uint32_t* period[3] = {&oct.px, &oct.py, &oct.pz};
+			float* scale[3] = {&oct.sx, &oct.sy, &oct.sz};
+			for(std::size_t a=0; a!=3; ++a)
+			{
+				const float cells = std::floor(
+					float(size[a])*frequency+0.5f
+				);
+				*period[a] = std::uint32_t((cells > 1.0f)?cells:1.0f);
+				*scale[a] = float(*period[a])/float(size[a]);
+			}
+		}
+		oct.amplitude = amplitude;
+		for(std::size_t ch=0; ch!=c; ++ch)
+		{
+			oct.seed = std::uint32_t(
+				rng.Branch(ch).Bits(o) >> 32
+			);
+			octave[ch*octaves+o] = oct;
+		}
+		amplitudes += amplitude;
+		frequency *= params.lacunarity;
+		amplitude *= params.gain;
+	}
+	const float normalize = 1.0f/amplitudes;
+
+	oglplus::aux::AlignedPODArray storage =
+		aux::ConvertAllocate(params.type, w*h*d*c);
+	const std::size_t texel_size = storage.ElemSize()*c;
+	GLubyte* data = static_cast<GLubyte*>(storage.begin());
+
+	oglplus::aux::ParallelFor(
+		h*d,
+		4,
+		[&](std::size_t begin, std::size_t end)
+		{
+			std::vector<float> noise(w);
+			std::vector<float> row(w*c);
+			for(std::size_t r=begin; r!=end; ++r)
+			{
+				const std::size_t y = r % h;
+				const std::size_t z = r / h;
+				for(std::size_t ch=0; ch!=c; ++ch)
+				{
+					std::fill(noise.begin(), noise.end(), 0.0f);
+					for(std::size_t o=0; o!=octaves; ++o)
+					{
+						const aux::NoiseOctave& oct =
+							octave[ch*octaves+o];
+						std::size_t x = 0;
+#if !OGLPLUS_NO_SIMD
+						if(params.vectorized)
+						{
+							x = aux::NoiseAddOctave<
+								aux::NoiseLanesXN
+							>(
+								oct, params.tiling,
+								x, w, y, z,
+								noise.data()
+							);
+						}
+#endif
+						aux::NoiseAddOctave<aux::NoiseLanesX1>(
+							oct, params.tiling,
+							x, w, y, z,
+							noise.data()
+						);
+					}
+					for(std::size_t x=0; x!=w; ++x)
+					{
+						float v = noise[x]*normalize;
+						if(unorm) v = v*0.5f+0.5f;
+						row[x*c+ch] = v;
+					}
+				}
+				aux::ConvertEncodeRow(
+					params.type,
+					row.data(),
+					data+r*w*texel_size,
+					w,
+					c,
+					params.vectorized
+				);
+			}
+		},
+		params.max_threads
+	);
+
+	static const PixelDataFormat formats[4] = {
+		PixelDataFormat::Red,
+		PixelDataFormat::RG,
+		PixelDataFormat::RGB,
+		PixelDataFormat::RGBA
+	};
+	return Image(
+		width, height, depth, channels,
+		params.type,
+		std::move(storage),
+		formats[c-1],
+		aux::ConvertInternalFormat(params.type, GLsizei(c), false)
+	);
+}
+
+} // namespace images
+} // namespace oglplus
+
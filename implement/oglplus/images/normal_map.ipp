@@ -49,7 +49,7 @@ struct NormalMap_filter
 };
 
 OGLPLUS_LIB_FUNC
-NormalMap::NormalMap(const Image& image)
+NormalMap::NormalMap(const ImageView& image)
  : Filtered(
 	image,
 	NormalMap_filter(),
@@ -62,7 +62,7 @@ NormalMap::NormalMap(const Image& image)
 }
 
 OGLPLUS_LIB_FUNC
-NormalMap::NormalMap(const Image& image, Filtered::FromRed)
+NormalMap::NormalMap(const ImageView& image, Filtered::FromRed)
  : Filtered(
 	image,
 	NormalMap_filter(),
@@ -75,7 +75,7 @@ NormalMap::NormalMap(const Image& image, Filtered::FromRed)
 }
 
 OGLPLUS_LIB_FUNC
-NormalMap::NormalMap(const Image& image, Filtered::FromAlpha)
+NormalMap::NormalMap(const ImageView& image, Filtered::FromAlpha)
  : Filtered(
 	image,
 	NormalMap_filter(),
@@ -9,9 +9,11 @@
  *  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
  */
 
+#include <oglplus/detail/aligned_pod_array.hpp>
 #include <stdexcept>
 #include <fstream>
 #include <cassert>
+#include <cstring>
 #include <iostream>
 #include <png.h>
 
@@ -19,17 +21,11 @@ namespace oglplus {
 namespace images {
 namespace aux {
 
-class PNGLoader;
-
-struct PNGHeaderValidator
-{
-	PNGHeaderValidator(std::istream& input);
-};
-
-// structure managing the png_struct pointer
+// structure managing the png_struct and png_info pointers
 struct PNGReadStruct
 {
 	::png_structp _read;
+	::png_infop _info;
 
 	// Error handling function
 	OGLPLUS_NORETURN
@@ -39,86 +35,65 @@ struct PNGReadStruct
 	// Warning handling function
 	static void _png_handle_warning(::png_structp/*sp*/, const char* /*msg*/);
 
-	PNGReadStruct(PNGLoader& /*loader*/);
+	PNGReadStruct(void);
 	~PNGReadStruct(void);
 };
 
-// structure managing the first png_info pointer
-struct PNGReadInfoStruct : PNGReadStruct
+class PNGDecoderImpl
 {
-	::png_infop _info;
-
-	PNGReadInfoStruct(PNGLoader& loader);
-	~PNGReadInfoStruct(void);
-};
+private:
+	// the input stream to read from or nullptr
+	::std::istream* _input;
 
-struct PNGReadInfoEndStruct : PNGReadInfoStruct
-{
-	::png_infop _end;
+	// the memory buffer to read from (if _input is nullptr)
+	const ::png_byte* _mem_data;
+	::std::size_t _mem_size;
+	::std::size_t _mem_pos;
 
-	// data read callback
-	static void _png_read_data(::png_structp, ::png_bytep, ::png_size_t);
-	static int _png_read_user_chunk(::png_structp, ::png_unknown_chunkp);
+	// keeps the mapped input file if any
+	oglplus::aux::AlignedPODArray _mapped;
 
-	PNGReadInfoEndStruct(PNGLoader& loader);
-	~PNGReadInfoEndStruct(void);
-};
+	PNGReadStruct _png;
 
-class PNGLoader
-{
-private:
-	// reference to an input stream to read from
-	::std::istream& _input;
+	GLuint _width, _height, _channels;
+	std::size_t _rowsize;
+	int _passes;
+	GLuint _next_row;
 
-	PNGHeaderValidator _validate_header;
+	// the whole decoded image, used only for interlaced images
+	std::vector< ::png_byte> _buffer;
 
-	friend struct PNGReadInfoEndStruct;
+	// data read callbacks
+	static void _png_read_data(::png_structp, ::png_bytep, ::png_size_t);
+	static int _png_read_user_chunk(::png_structp, ::png_unknown_chunkp);
 
-	// data read functions
 	void _read_data(::png_bytep data, ::png_size_t size);
-	int _read_user_chunk(::png_unknown_chunkp /*chunk*/);
 
-	PNGReadInfoEndStruct _png;
+	void _init(void);
 
-	static GLenum _translate_format(GLuint color_type, bool /*has_alpha*/);
+	void _flip_x(::png_bytep row) const;
+	void _decode_all(::png_bytep* rows);
 public:
-	PNGLoader(
-		std::istream& input,
-		Image& image,
+	PNGDecoderImpl(std::istream& input);
+	PNGDecoderImpl(const void* data, std::size_t size);
+	PNGDecoderImpl(const char* file_path);
+
+	GLuint Width(void) const { return _width; }
+	GLuint Height(void) const { return _height; }
+	GLuint Channels(void) const { return _channels; }
+	std::size_t RowSize(void) const { return _rowsize; }
+	GLuint RowsDecoded(void) const { return _next_row; }
+
+	bool ReadRow(::png_bytep dest, bool x_is_right);
+
+	void ReadImage(
+		::png_bytep dest,
+		std::ptrdiff_t row_stride,
 		bool y_is_up,
 		bool x_is_right
 	);
 };
 
-OGLPLUS_LIB_FUNC
-PNGHeaderValidator::PNGHeaderValidator(std::istream& input)
-{
-	if(!input.good())
-	{
-		throw std::runtime_error(
-			"Unable to open file for reading"
-		);
-	}
-
-	const size_t sig_size = 8;
-	::png_byte sig[sig_size];
-	input.read(reinterpret_cast<char*>(sig), sig_size);
-
-	if(!input.good())
-	{
-		throw std::runtime_error(
-			"Unable to read PNG signature"
-		);
-	}
-
-	if(::png_sig_cmp(sig, 0, sig_size) != 0)
-	{
-		throw std::runtime_error(
-			"Invalid PNG signature"
-		);
-	}
-}
-
 OGLPLUS_NORETURN
 OGLPLUS_LIB_FUNC
 void PNGReadStruct::_png_handle_error(
@@ -139,37 +114,21 @@ void PNGReadStruct::_png_handle_warning(
 }
 
 OGLPLUS_LIB_FUNC
-PNGReadStruct::PNGReadStruct(PNGLoader& /*loader*/)
+PNGReadStruct::PNGReadStruct(void)
  : _read(::png_create_read_struct(
 	PNG_LIBPNG_VER_STRING,
 	reinterpret_cast<::png_voidp>(this),
 	&_png_handle_error,
 	&_png_handle_warning
-))
+)), _info(nullptr)
 {
 	assert(_read);
-}
-
-OGLPLUS_LIB_FUNC
-PNGReadStruct::~PNGReadStruct(void)
-{
-	::png_destroy_read_struct(
-		&_read,
-		static_cast<::png_infopp>(nullptr),
-		static_cast<::png_infopp>(nullptr)
-	);
-}
-
-OGLPLUS_LIB_FUNC
-PNGReadInfoStruct::PNGReadInfoStruct(PNGLoader& loader)
- : PNGReadStruct(loader)
- , _info(::png_create_info_struct(_read))
-{
+	_info = ::png_create_info_struct(_read);
 	assert(_info);
 }
 
 OGLPLUS_LIB_FUNC
-PNGReadInfoStruct::~PNGReadInfoStruct(void)
+PNGReadStruct::~PNGReadStruct(void)
 {
 	::png_destroy_read_struct(
 		&_read,
@@ -179,7 +138,7 @@ PNGReadInfoStruct::~PNGReadInfoStruct(void)
 }
 
 OGLPLUS_LIB_FUNC
-void PNGReadInfoEndStruct::_png_read_data(
+void PNGDecoderImpl::_png_read_data(
 	::png_structp png,
 	::png_bytep data,
 	::png_size_t size
@@ -187,110 +146,78 @@ void PNGReadInfoEndStruct::_png_read_data(
 {
 	::png_voidp p = ::png_get_io_ptr(png);
 	assert(p != 0);
-	(reinterpret_cast<PNGLoader*>(p))->_read_data(data, size);
+	(reinterpret_cast<PNGDecoderImpl*>(p))->_read_data(data, size);
 }
 
 OGLPLUS_LIB_FUNC
-int PNGReadInfoEndStruct::_png_read_user_chunk(
-	::png_structp png,
-	::png_unknown_chunkp chunk
+int PNGDecoderImpl::_png_read_user_chunk(
+	::png_structp /*png*/,
+	::png_unknown_chunkp /*chunk*/
 )
 {
-	::png_voidp p = ::png_get_user_chunk_ptr(png);
-	assert(p != 0);
-	return (reinterpret_cast<PNGLoader*>(p))->_read_user_chunk(chunk);
+	return 0;
+}
+
+OGLPLUS_LIB_FUNC
+void PNGDecoderImpl::_read_data(::png_bytep data, ::png_size_t size)
+{
+	if(_input)
+	{
+		_input->read(reinterpret_cast<char*>(data), std::streamsize(size));
+		if(!_input->good())
+		{
+			throw std::runtime_error(
+				"Unable to read PNG data"
+			);
+		}
+	}
+	else
+	{
+		if(_mem_size - _mem_pos < size)
+		{
+			throw std::runtime_error(
+				"Unexpected end of PNG data"
+			);
+		}
+		std::memcpy(data, _mem_data+_mem_pos, size);
+		_mem_pos += size;
+	}
 }
 
 OGLPLUS_LIB_FUNC
-PNGReadInfoEndStruct::PNGReadInfoEndStruct(PNGLoader& loader)
- : PNGReadInfoStruct(loader)
- , _end(::png_create_info_struct(_read))
+void PNGDecoderImpl::_init(void)
 {
-	assert(_end);
 	::png_set_read_fn(
-		_read,
-		reinterpret_cast<::png_voidp>(&loader),
+		_png._read,
+		reinterpret_cast<::png_voidp>(this),
 		&_png_read_data
 	);
 	::png_set_read_user_chunk_fn(
-		_read,
-		reinterpret_cast<::png_voidp>(&loader),
+		_png._read,
+		reinterpret_cast<::png_voidp>(this),
 		&_png_read_user_chunk
 	);
 	::png_set_keep_unknown_chunks(
-		_read,
+		_png._read,
 		PNG_HANDLE_CHUNK_NEVER,
 		0, 0
 	);
 
-}
-
-OGLPLUS_LIB_FUNC
-PNGReadInfoEndStruct::~PNGReadInfoEndStruct(void)
-{
-	::png_destroy_read_struct(
-		&_read,
-		&_info,
-		&_end
-	);
-}
+	const size_t sig_size = 8;
+	::png_byte sig[sig_size];
+	_read_data(sig, sig_size);
 
-OGLPLUS_LIB_FUNC
-void PNGLoader::_read_data(::png_bytep data, ::png_size_t size)
-{
-	_input.read(reinterpret_cast<char*>(data), std::streamsize(size));
-	if(!_input.good())
+	if(::png_sig_cmp(sig, 0, sig_size) != 0)
 	{
 		throw std::runtime_error(
-			"Unable to read PNG signature"
+			"Invalid PNG signature"
 		);
 	}
-}
-
-OGLPLUS_LIB_FUNC
-int PNGLoader::_read_user_chunk(::png_unknown_chunkp /*chunk*/)
-{
-	return 0;
-}
-
-OGLPLUS_LIB_FUNC
-GLenum PNGLoader::_translate_format(GLuint color_type, bool /*has_alpha*/)
-{
-	switch(color_type)
-	{
-		case PNG_COLOR_TYPE_GRAY:
-			return GL_RED;
-		case PNG_COLOR_TYPE_GRAY_ALPHA:
-			return GL_RG;
-		case PNG_COLOR_TYPE_RGB:
-			return GL_RGB;
-		case PNG_COLOR_TYPE_RGB_ALPHA:
-			return GL_RGBA;
-		// TODO other color types
-		default:;
-	}
-	OGLPLUS_ABORT("Unknown color type!");
-	return 0;
-}
 
-OGLPLUS_LIB_FUNC
-PNGLoader::PNGLoader(
-	std::istream& input,
-	Image& image,
-	bool y_is_up,
-	bool x_is_right
-): _input(input)
- , _validate_header(_input)
- , _png(*this)
-{
-	const size_t sig_size = 8;
 	::png_set_sig_bytes(_png._read, sig_size);
 	::png_read_info(_png._read, _png._info);
 
-	GLuint width = GLuint(png_get_image_width(_png._read, _png._info));
-	GLuint height = GLuint(png_get_image_height(_png._read, _png._info));
 	GLuint bitdepth = png_get_bit_depth(_png._read, _png._info);
-	GLuint channels = png_get_channels(_png._read, _png._info);
 	GLuint color_type = png_get_color_type(_png._read, _png._info);
 
 	// color conversions
@@ -298,24 +225,19 @@ PNGLoader::PNGLoader(
 	{
 		case PNG_COLOR_TYPE_PALETTE:
 			::png_set_palette_to_rgb(_png._read);
-			channels = 3;
 			break;
 		case PNG_COLOR_TYPE_GRAY:
 			if(bitdepth < 8)
 				::png_set_expand_gray_1_2_4_to_8(_png._read);
-			bitdepth = 8;
 			break;
 		// TODO: other conversions
 		default:;
 	}
 
 	// handle transparency
-	bool has_alpha = false;
 	if(::png_get_valid(_png._read, _png._info, PNG_INFO_tRNS))
 	{
 		::png_set_tRNS_to_alpha(_png._read);
-		channels += 1;
-		has_alpha = true;
 	}
 
 	// if there are too many bits per channel strip them down
@@ -324,72 +246,313 @@ PNGLoader::PNGLoader(
 		::png_set_strip_16(_png._read);
 	}
 
-	// bytes per row
-	GLuint rowsize = width * channels * bitdepth / 8;
-	// allocate the buffer
-	std::vector<GLubyte> data(rowsize * height, GLubyte(0));
+	_passes = ::png_set_interlace_handling(_png._read);
+	::png_read_update_info(_png._read, _png._info);
+
+	_width = GLuint(png_get_image_width(_png._read, _png._info));
+	_height = GLuint(png_get_image_height(_png._read, _png._info));
+	_channels = png_get_channels(_png._read, _png._info);
+	_rowsize = png_get_rowbytes(_png._read, _png._info);
+
+	assert(_rowsize == _width*_channels);
+}
+
+OGLPLUS_LIB_FUNC
+PNGDecoderImpl::PNGDecoderImpl(std::istream& input)
+ : _input(&input)
+ , _mem_data(nullptr)
+ , _mem_size(0)
+ , _mem_pos(0)
+ , _next_row(0)
+{
+	if(!input.good())
 	{
-		// allocate and initialize the row pointers
-		std::vector< ::png_bytep> rows(height);
-		//
-		for(GLuint r=0; r<height; ++r)
+		throw std::runtime_error(
+			"Unable to open file for reading"
+		);
+	}
+	_init();
+}
+
+OGLPLUS_LIB_FUNC
+PNGDecoderImpl::PNGDecoderImpl(const void* data, std::size_t size)
+ : _input(nullptr)
+ , _mem_data(static_cast<const ::png_byte*>(data))
+ , _mem_size(size)
+ , _mem_pos(0)
+ , _next_row(0)
+{
+	_init();
+}
+
+OGLPLUS_LIB_FUNC
+PNGDecoderImpl::PNGDecoderImpl(const char* file_path)
+ : _input(nullptr)
+ , _mem_data(nullptr)
+ , _mem_size(0)
+ , _mem_pos(0)
+ , _next_row(0)
+{
+	std::ifstream file(file_path, std::ios::binary | std::ios::ate);
+	if(!file.good())
+	{
+		throw std::runtime_error(
+			"Unable to open file for reading"
+		);
+	}
+	_mem_size = std::size_t(file.tellg());
+	file.close();
+
+	_mapped = oglplus::aux::AlignedPODArray::MapFile<::png_byte>(
+		file_path,
+		0, _mem_size
+	);
+	_mem_data = static_cast<const ::png_byte*>(_mapped.begin());
+	_init();
+}
+
+OGLPLUS_LIB_FUNC
+void PNGDecoderImpl::_flip_x(::png_bytep row) const
+{
+	for(GLuint p=0; p<_width/2; ++p)
+	{
+		::png_bytep l = row + p*_channels;
+		::png_bytep r = row + (_width-p-1)*_channels;
+		for(GLuint c=0; c<_channels; ++c)
 		{
-			GLuint row = y_is_up? (height-r-1): r;
-			GLuint offs = row * rowsize;
-			rows[r] = reinterpret_cast<::png_bytep>(data.data()) + offs;
+			::png_byte tmp = l[c];
+			l[c] = r[c];
+			r[c] = tmp;
 		}
+	}
+}
+
+OGLPLUS_LIB_FUNC
+void PNGDecoderImpl::_decode_all(::png_bytep* rows)
+{
+	assert(_next_row == 0);
+	::png_read_image(_png._read, rows);
+	_next_row = _height;
+}
+
+OGLPLUS_LIB_FUNC
+bool PNGDecoderImpl::ReadRow(::png_bytep dest, bool x_is_right)
+{
+	if(_next_row >= _height) return false;
 
-		// read
-		::png_read_image(_png._read, rows.data());
+	if(_passes > 1)
+	{
+		// interlaced images have to be decoded completely
+		if(_buffer.empty())
+		{
+			_buffer.resize(_rowsize*_height);
+			std::vector< ::png_bytep> rows(_height);
+			for(GLuint r=0; r<_height; ++r)
+			{
+				rows[r] = _buffer.data() + r*_rowsize;
+			}
+			_decode_all(rows.data());
+			_next_row = 0;
+		}
+		std::memcpy(dest, _buffer.data()+_next_row*_rowsize, _rowsize);
+	}
+	else
+	{
+		::png_read_row(_png._read, dest, nullptr);
+	}
+	if(!x_is_right) _flip_x(dest);
+	++_next_row;
+	return true;
+}
 
+OGLPLUS_LIB_FUNC
+void PNGDecoderImpl::ReadImage(
+	::png_bytep dest,
+	std::ptrdiff_t row_stride,
+	bool y_is_up,
+	bool x_is_right
+)
+{
+	assert(row_stride >= std::ptrdiff_t(_rowsize));
+	if((_passes > 1) && _buffer.empty() && (_next_row == 0))
+	{
+		// interlaced images are decoded directly into the destination
+		std::vector< ::png_bytep> rows(_height);
+		for(GLuint r=0; r<_height; ++r)
+		{
+			GLuint row = y_is_up? (_height-r-1): r;
+			rows[r] = dest + row*row_stride;
+		}
+		_decode_all(rows.data());
 		if(!x_is_right)
 		{
-			for(GLuint r=0; r<height; ++r)
+			for(GLuint r=0; r<_height; ++r)
 			{
-				for(GLuint p=0; p<width/2; ++p)
-				{
-					for(GLuint c=0; c<channels; ++c)
-					{
-						::png_byte tmp = rows[r][p*channels+c];
-						rows[r][p*channels+c] = rows[r][(width-p-1)*channels+c];
-						rows[r][(width-p-1)*channels+c] = tmp;
-					}
-				}
+				_flip_x(rows[r]);
 			}
 		}
+		return;
 	}
+	while(_next_row < _height)
+	{
+		GLuint row = y_is_up? (_height-_next_row-1): _next_row;
+		ReadRow(dest + row*row_stride, x_is_right);
+	}
+}
 
-	GLenum gl_format = _translate_format(color_type, has_alpha);
-	std::size_t size = data.size();
+} // namespace aux
 
-	assert(size % (width*height) == 0);
+OGLPLUS_LIB_FUNC
+PNGDecoder::PNGDecoder(std::istream& input)
+ : _pimpl(new aux::PNGDecoderImpl(input))
+{ }
 
-	image = Image(
-		width,
-		height,
-		1,
-		channels,
-		data.data(),
-		PixelDataFormat(gl_format),
-		PixelDataInternalFormat(gl_format)
-	);
+OGLPLUS_LIB_FUNC
+PNGDecoder::PNGDecoder(const void* data, std::size_t size)
+ : _pimpl(new aux::PNGDecoderImpl(data, size))
+{ }
+
+OGLPLUS_LIB_FUNC
+PNGDecoder::PNGDecoder(const char* file_path)
+ : _pimpl(new aux::PNGDecoderImpl(file_path))
+{ }
+
+OGLPLUS_LIB_FUNC
+PNGDecoder::PNGDecoder(PNGDecoder&& tmp)
+ : _pimpl(std::move(tmp._pimpl))
+ , _row(std::move(tmp._row))
+{ }
+
+OGLPLUS_LIB_FUNC
+PNGDecoder::~PNGDecoder(void)
+{ }
+
+OGLPLUS_LIB_FUNC
+SizeType PNGDecoder::Width(void) const
+{
+	assert(_pimpl);
+	return SizeType(_pimpl->Width());
 }
 
-} // namespace aux
+OGLPLUS_LIB_FUNC
+SizeType PNGDecoder::Height(void) const
+{
+	assert(_pimpl);
+	return SizeType(_pimpl->Height());
+}
+
+OGLPLUS_LIB_FUNC
+SizeType PNGDecoder::Channels(void) const
+{
+	assert(_pimpl);
+	return SizeType(_pimpl->Channels());
+}
+
+OGLPLUS_LIB_FUNC
+PixelDataFormat PNGDecoder::Format(void) const
+{
+	switch(_pimpl->Channels())
+	{
+		case 1: return PixelDataFormat::Red;
+		case 2: return PixelDataFormat::RG;
+		case 3: return PixelDataFormat::RGB;
+		case 4: return PixelDataFormat::RGBA;
+		default:;
+	}
+	OGLPLUS_ABORT("Unknown color type!");
+	return PixelDataFormat::Red;
+}
+
+OGLPLUS_LIB_FUNC
+PixelDataInternalFormat PNGDecoder::InternalFormat(void) const
+{
+	return PixelDataInternalFormat(GLenum(Format()));
+}
+
+OGLPLUS_LIB_FUNC
+std::size_t PNGDecoder::RowSize(void) const
+{
+	assert(_pimpl);
+	return _pimpl->RowSize();
+}
+
+OGLPLUS_LIB_FUNC
+GLuint PNGDecoder::RowsDecoded(void) const
+{
+	assert(_pimpl);
+	return _pimpl->RowsDecoded();
+}
+
+OGLPLUS_LIB_FUNC
+bool PNGDecoder::ReadRow(void* dest, bool x_is_right)
+{
+	assert(_pimpl);
+	return _pimpl->ReadRow(static_cast< ::png_bytep>(dest), x_is_right);
+}
+
+OGLPLUS_LIB_FUNC
+void PNGDecoder::ReadImage(
+	void* dest,
+	std::ptrdiff_t row_stride,
+	bool y_is_up,
+	bool x_is_right
+)
+{
+	assert(_pimpl);
+	_pimpl->ReadImage(
+		static_cast< ::png_bytep>(dest),
+		row_stride,
+		y_is_up,
+		x_is_right
+	);
+}
 
 OGLPLUS_LIB_FUNC
 PNGImage::PNGImage(const char* file_path, bool y_is_up, bool x_is_right)
 {
-	std::ifstream  file(file_path, std::ios::binary);
-	aux::PNGLoader(file, *this, y_is_up, x_is_right);
+	PNGDecoder decoder(file_path);
+	*this = PNGImage(decoder, y_is_up, x_is_right);
 }
 
 OGLPLUS_LIB_FUNC
 PNGImage::PNGImage(std::istream& input, bool y_is_up, bool x_is_right)
 {
-	aux::PNGLoader(input, *this, y_is_up, x_is_right);
+	PNGDecoder decoder(input);
+	*this = PNGImage(decoder, y_is_up, x_is_right);
+}
+
+OGLPLUS_LIB_FUNC
+PNGImage::PNGImage(
+	const void* data,
+	std::size_t size,
+	bool y_is_up,
+	bool x_is_right
+)
+{
+	PNGDecoder decoder(data, size);
+	*this = PNGImage(decoder, y_is_up, x_is_right);
+}
+
+OGLPLUS_LIB_FUNC
+PNGImage::PNGImage(PNGDecoder& decoder, bool y_is_up, bool x_is_right)
+ : Image(
+	decoder.Width(),
+	decoder.Height(),
+	1,
+	decoder.Channels(),
+	&TypeTag<GLubyte>(),
+	decoder.Format(),
+	decoder.InternalFormat()
+)
+{
+	assert(decoder.RowsDecoded() == 0);
+	decoder.ReadImage(
+		this->_begin_ub(),
+		std::ptrdiff_t(decoder.RowSize()),
+		y_is_up,
+		x_is_right
+	);
 }
 
 } // images
 } // oglplus
-
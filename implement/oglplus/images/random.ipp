@@ -9,11 +9,62 @@
  *  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
  */
 
+#include <oglplus/lib/incl_begin.ipp>
+#include <oglplus/detail/parallel_for.hpp>
+#include <oglplus/lib/incl_end.ipp>
+
 #include <cassert>
 #include <cstdlib>
 
 namespace oglplus {
 namespace images {
+namespace aux {
+
+// Fills the rows of an image with bytes of the hashes of texel coordinates,
+// the c-th component of a texel is the c-th byte of its hash
+inline void RandomFillUByte(
+	GLubyte* data,
+	GLsizei width,
+	GLsizei height,
+	GLsizei depth,
+	GLsizei channels,
+	RandomSeed seed
+)
+{
+	assert(channels <= 8);
+	const CounterRNG rng(seed);
+	const std::size_t row_size = std::size_t(width*channels);
+
+	oglplus::aux::ParallelFor(
+		std::size_t(height*depth),
+		16,
+		[&](std::size_t begin, std::size_t end)
+		{
+			for(std::size_t r=begin; r!=end; ++r)
+			{
+				const std::uint32_t y = std::uint32_t(r%height);
+				const std::uint32_t z = std::uint32_t(r/height);
+				GLubyte* p = data+r*row_size;
+
+				for(GLsizei x=0; x!=width; ++x)
+				{
+					std::uint64_t bits = rng.Bits(
+						CounterRNG::TexelCounter(
+							std::uint32_t(x), y, z
+						)
+					);
+					for(GLsizei c=0; c!=channels; ++c)
+					{
+						*p++ = GLubyte(bits & 0xFF);
+						bits >>= 8;
+					}
+				}
+			}
+		}
+	);
+}
+
+} // namespace aux
 
 OGLPLUS_LIB_FUNC
 RandomRedUByte::RandomRedUByte(SizeType width, SizeType height, SizeType depth)
@@ -32,6 +83,17 @@ RandomRedUByte::RandomRedUByte(SizeType width, SizeType height, SizeType depth)
 	assert(p == e);
 }
 
+OGLPLUS_LIB_FUNC
+RandomRedUByte::RandomRedUByte(
+	SizeType width,
+	SizeType height,
+	SizeType depth,
+	RandomSeed seed
+): Image(width, height, depth, 1, &TypeTag<GLubyte>())
+{
+	aux::RandomFillUByte(this->_begin_ub(), width, height, depth, 1, seed);
+}
+
 OGLPLUS_LIB_FUNC
 RandomRGBUByte::RandomRGBUByte(SizeType width, SizeType height, SizeType depth)
  : Image(width, height, depth, 3, &TypeTag<GLubyte>())
@@ -50,6 +112,17 @@ RandomRGBUByte::RandomRGBUByte(SizeType width, SizeType height, SizeType depth)
 	assert(p == e);
 }
 
+OGLPLUS_LIB_FUNC
+RandomRGBUByte::RandomRGBUByte(
+	SizeType width,
+	SizeType height,
+	SizeType depth,
+	RandomSeed seed
+): Image(width, height, depth, 3, &TypeTag<GLubyte>())
+{
+	aux::RandomFillUByte(this->_begin_ub(), width, height, depth, 3, seed);
+}
+
 } // images
 } // oglplus
 
@@ -0,0 +1,501 @@
+/**
+ *  @file oglplus/images/save_png.ipp
+ *  @brief Implementation of the parallel PNG image writer (based on zlib)
+ *
+ *  @author Matus Chochlik
+ *
+ *  Copyright 2010-2015 Matus Chochlik. Distributed under the Boost
+ *  Software License, Version 1.0. (See accompanying file
+ *  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include <oglplus/detail/parallel_for.hpp>
+#include <stdexcept>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <zlib.h>
+
+namespace oglplus {
+namespace images {
+namespace aux {
+
+// manages the z_stream compressing a single band of rows
+struct PNGDeflateStream
+{
+	::z_stream _zs;
+
+	PNGDeflateStream(int level, int strategy)
+	{
+		std::memset(&_zs, 0, sizeof(_zs));
+		// raw deflate, the zlib header and trailer are written separately
+		if(::deflateInit2(&_zs, level, Z_DEFLATED, -15, 8, strategy) != Z_OK)
+		{
+			throw std::runtime_error("Unable to initialize zlib");
+		}
+	}
+
+	~PNGDeflateStream(void)
+	{
+		::deflateEnd(&_zs);
+	}
+};
+
+// Converts the row of the view at the specified position (from the top)
+// to the byte order used by PNG, returns a pointer to the converted row
+OGLPLUS_LIB_FUNC
+const unsigned char* PNGSaveRow(
+	const ImageView& image,
+	GLsizei row,
+	bool y_is_up,
+	std::vector<unsigned char>& buffer
+)
+{
+	const GLsizei height = GLsizei(image.Height());
+	const GLsizei y = y_is_up?height-1-row:row;
+	const unsigned char* src = static_cast<const unsigned char*>(
+		image.RawPixel(0, y, 0)
+	);
+	if(image.ComponentSize() == 1) return src;
+
+	// 16-bit values are stored in the big-endian order
+	assert(image.ComponentSize() == 2);
+	const std::size_t count = buffer.size()/2;
+	for(std::size_t i=0; i!=count; ++i)
+	{
+		GLushort v;
+		std::memcpy(&v, src+i*2, 2);
+		buffer[i*2+0] = (unsigned char)(v >> 8);
+		buffer[i*2+1] = (unsigned char)(v & 0xFF);
+	}
+	return buffer.data();
+}
+
+inline unsigned char PNGPaethPredictor(int a, int b, int c)
+{
+	const int p = a+b-c;
+	const int pa = std::abs(p-a);
+	const int pb = std::abs(p-b);
+	const int pc = std::abs(p-c);
+	if((pa <= pb) && (pa <= pc)) return (unsigned char)a;
+	if(pb <= pc) return (unsigned char)b;
+	return (unsigned char)c;
+}
+
+// Applies the specified filter to the cur row, prev is the previous row
+// (all zeros for the first row) and bpp the number of bytes per pixel
+OGLPLUS_LIB_FUNC
+void PNGFilterRow(
+	PNGRowFilter filter,
+	const unsigned char* cur,
+	const unsigned char* prev,
+	std::size_t size,
+	std::size_t bpp,
+	unsigned char* dst
+)
+{
+	std::size_t i;
+	switch(filter)
+	{
+		case PNGRowFilter::None:
+			std::memcpy(dst, cur, size);
+			break;
+		case PNGRowFilter::Sub:
+			for(i=0; i!=bpp; ++i)
+				dst[i] = cur[i];
+			for(i=bpp; i<size; ++i)
+				dst[i] = (unsigned char)(cur[i]-cur[i-bpp]);
+			break;
+		case PNGRowFilter::Up:
+			for(i=0; i!=size; ++i)
+				dst[i] = (unsigned char)(cur[i]-prev[i]);
+			break;
+		case PNGRowFilter::Average:
+			for(i=0; i!=bpp; ++i)
+				dst[i] = (unsigned char)(cur[i]-(prev[i]>>1));
+			for(i=bpp; i<size; ++i)
+				dst[i] = (unsigned char)(
+					cur[i]-((cur[i-bpp]+prev[i])>>1)
+				);
+			break;
+		case PNGRowFilter::Paeth:
+			for(i=0; i!=bpp; ++i)
+				dst[i] = (unsigned char)(cur[i]-prev[i]);
+			for(i=bpp; i<size; ++i)
+				dst[i] = (unsigned char)(cur[i]-PNGPaethPredictor(
+					cur[i-bpp],
+					prev[i],
+					prev[i-bpp]
+				));
+			break;
+		case PNGRowFilter::Adaptive:
+			assert(!"Adaptive is not an actual filter");
+	}
+}
+
+// The sum of the filtered values taken as signed bytes,
+// used to select the filter by the adaptive heuristic
+inline unsigned long PNGFilterCost(const unsigned char* row, std::size_t size)
+{
+	unsigned long result = 0;
+	for(std::size_t i=0; i!=size; ++i)
+	{
+		result += (row[i] < 128)?row[i]:256-row[i];
+	}
+	return result;
+}
+
+// Filters rows [begin, end) of the image into the output buffer
+// where each row is prefixed by the filter type byte
+class PNGRowFilterer
+{
+private:
+	const ImageView* _image;
+	PNGRowFilter _filter;
+	bool _y_is_up;
+	std::size_t _rowsize, _bpp;
+	unsigned char* _output;
+
+	std::vector<unsigned char> _cur, _prev, _zeros, _tmp;
+public:
+	PNGRowFilterer(
+		const ImageView& image,
+		const PNGSaveParams& params,
+		unsigned char* output
+	): _image(&image)
+	 , _filter(params.filter)
+	 , _y_is_up(params.y_is_up)
+	 , _rowsize(image.PixelSize()*std::size_t(image.Width()))
+	 , _bpp(image.PixelSize())
+	 , _output(output)
+	{ }
+
+	void operator()(std::size_t begin, std::size_t end)
+	{
+		// the buffers are allocated by each worker's copy
+		_cur.resize(_rowsize);
+		_prev.resize(_rowsize);
+		_zeros.resize(_rowsize, 0);
+		if(_filter == PNGRowFilter::Adaptive)
+		{
+			_tmp.resize(_rowsize);
+		}
+
+		for(std::size_t r=begin; r!=end; ++r)
+		{
+			const unsigned char* cur = PNGSaveRow(
+				*_image, GLsizei(r), _y_is_up, _cur
+			);
+			const unsigned char* prev = (r == 0)?
+				_zeros.data():
+				PNGSaveRow(*_image, GLsizei(r-1), _y_is_up, _prev);
+
+			unsigned char* dst = _output+r*(_rowsize+1);
+			if(_filter != PNGRowFilter::Adaptive)
+			{
+				dst[0] = (unsigned char)_filter;
+				PNGFilterRow(_filter, cur, prev, _rowsize, _bpp, dst+1);
+				continue;
+			}
+
+			dst[0] = (unsigned char)PNGRowFilter::None;
+			std::memcpy(dst+1, cur, _rowsize);
+			unsigned long best = PNGFilterCost(dst+1, _rowsize);
+
+			const PNGRowFilter filters[4] = {
+				PNGRowFilter::Sub,
+				PNGRowFilter::Up,
+				PNGRowFilter::Average,
+				PNGRowFilter::Paeth
+			};
+			for(std::size_t f=0; f!=4; ++f)
+			{
+				PNGFilterRow(
+					filters[f],
+					cur, prev,
+					_rowsize, _bpp,
+					_tmp.data()
+				);
+				unsigned long cost = PNGFilterCost(
+					_tmp.data(),
+					_rowsize
+				);
+				if(best > cost)
+				{
+					best = cost;
+					dst[0] = (unsigned char)filters[f];
+					std::memcpy(dst+1, _tmp.data(), _rowsize);
+				}
+			}
+		}
+	}
+};
+
+// A band of filtered rows compressed as a sequence of deflate blocks
+struct PNGBand
+{
+	std::vector<unsigned char> data;
+	std::size_t input_size;
+	::uLong adler;
+};
+
+// Compresses the specified range of the filtered data into the band.
+// The last band is finished, the others end with a sync flush marker
+// so that the compressed bands can be simply concatenated.
+OGLPLUS_LIB_FUNC
+void PNGCompressBand(
+	const unsigned char* filtered,
+	std::size_t begin,
+	std::size_t end,
+	bool last,
+	int level,
+	int strategy,
+	PNGBand& band
+)
+{
+	PNGDeflateStream stream(level, strategy);
+	::z_stream& zs = stream._zs;
+
+	// prime the compressor with the data preceding this band
+	if(begin > 0)
+	{
+		const std::size_t dict_size = (begin < 32768)?begin:32768;
+		::deflateSetDictionary(
+			&zs,
+			filtered+begin-dict_size,
+			::uInt(dict_size)
+		);
+	}
+
+	const std::size_t size = end-begin;
+	band.input_size = size;
+	band.adler = ::adler32(
+		::adler32(0, Z_NULL, 0),
+		filtered+begin,
+		::uInt(size)
+	);
+	band.data.resize(::deflateBound(&zs, ::uLong(size))+16);
+
+	zs.next_in = const_cast< ::Bytef*>(filtered+begin);
+	zs.avail_in = ::uInt(size);
+
+	const int flush = last?Z_FINISH:Z_SYNC_FLUSH;
+	std::size_t done = 0;
+	while(true)
+	{
+		if(done == band.data.size())
+		{
+			band.data.resize(band.data.size()*2);
+		}
+		zs.next_out = band.data.data()+done;
+		zs.avail_out = ::uInt(band.data.size()-done);
+
+		int result = ::deflate(&zs, flush);
+		if((result != Z_OK) && (result != Z_STREAM_END) && (result != Z_BUF_ERROR))
+		{
+			throw std::runtime_error("Error compressing PNG data");
+		}
+		done = band.data.size()-zs.avail_out;
+
+		if(last && (result == Z_STREAM_END)) break;
+		if(!last && (zs.avail_in == 0) && (zs.avail_out != 0)) break;
+	}
+	band.data.resize(done);
+}
+
+inline void PNGPutUInt32(unsigned char* dst, ::uLong value)
+{
+	dst[0] = (unsigned char)((value >> 24) & 0xFF);
+	dst[1] = (unsigned char)((value >> 16) & 0xFF);
+	dst[2] = (unsigned char)((value >>  8) & 0xFF);
+	dst[3] = (unsigned char)((value >>  0) & 0xFF);
+}
+
+OGLPLUS_LIB_FUNC
+void PNGWriteChunk(
+	std::ostream& output,
+	const char* type,
+	const unsigned char* data,
+	std::size_t size
+)
+{
+	unsigned char buf[4];
+	PNGPutUInt32(buf, ::uLong(size));
+	output.write(reinterpret_cast<const char*>(buf), 4);
+	output.write(type, 4);
+	if(size > 0)
+	{
+		output.write(reinterpret_cast<const char*>(data), std::streamsize(size));
+	}
+
+	::uLong crc = ::crc32(0, Z_NULL, 0);
+	crc = ::crc32(crc, reinterpret_cast<const ::Bytef*>(type), 4);
+	if(size > 0) crc = ::crc32(crc, data, ::uInt(size));
+	PNGPutUInt32(buf, crc);
+	output.write(reinterpret_cast<const char*>(buf), 4);
+}
+
+} // namespace aux
+
+OGLPLUS_LIB_FUNC
+void SavePNG(
+	const ImageView& image,
+	std::ostream& output,
+	const PNGSaveParams& params
+)
+{
+	int bit_depth = 0;
+	if(image.Type() == PixelDataType::UnsignedByte) bit_depth = 8;
+	else if(image.Type() == PixelDataType::UnsignedShort) bit_depth = 16;
+	else throw std::runtime_error("Unsupported PNG pixel data type");
+
+	int color_type = 0;
+	switch(GLsizei(image.Channels()))
+	{
+		case 1: color_type = 0; break; // gray
+		case 2: color_type = 4; break; // gray + alpha
+		case 3: color_type = 2; break; // RGB
+		case 4: color_type = 6; break; // RGBA
+		default: throw std::runtime_error(
+			"Unsupported PNG number of channels"
+		);
+	}
+
+	if((image.Width() == 0) || (image.Height() == 0))
+	{
+		throw std::runtime_error("Unable to save empty PNG image");
+	}
+	if(image.Depth() != 1)
+	{
+		throw std::runtime_error("Unable to save 3D image as PNG");
+	}
+
+	const std::size_t height = std::size_t(image.Height());
+	const std::size_t rowsize = image.PixelSize()*std::size_t(image.Width());
+	const std::size_t filtered_rowsize = rowsize+1;
+
+	// filter the rows in parallel
+	std::vector<unsigned char> filtered(height*filtered_rowsize);
+	oglplus::aux::ParallelFor(
+		height,
+		16,
+		aux::PNGRowFilterer(image, params, filtered.data()),
+		params.max_threads
+	);
+
+	// compress the bands of rows in parallel
+	std::size_t band_rows = params.band_rows;
+	if(band_rows == 0)
+	{
+		band_rows = (std::size_t(256) << 10) / filtered_rowsize;
+		if(band_rows == 0) band_rows = 1;
+	}
+	const std::size_t band_count = (height+band_rows-1)/band_rows;
+
+	int level = params.compression_level;
+	if(level < 0) level = 6;
+	if(level > 9) level = 9;
+	const int strategy = (params.filter == PNGRowFilter::None)?
+		Z_DEFAULT_STRATEGY:
+		Z_FILTERED;
+
+	std::vector<aux::PNGBand> bands(band_count);
+	oglplus::aux::ParallelFor(
+		band_count,
+		1,
+		[&](std::size_t begin, std::size_t end)
+		{
+			for(std::size_t b=begin; b!=end; ++b)
+			{
+				std::size_t e = (b+1)*band_rows;
+				if(e > height) e = height;
+				aux::PNGCompressBand(
+					filtered.data(),
+					b*band_rows*filtered_rowsize,
+					e*filtered_rowsize,
+					b+1 == band_count,
+					level,
+					strategy,
+					bands[b]
+				);
+			}
+		},
+		params.max_threads
+	);
+
+	// the zlib stream header
+	unsigned char zlib_header[2] = { 0x78, 0x00 };
+	const int flevel = (level < 2)?0:(level < 6)?1:(level == 6)?2:3;
+	zlib_header[1] = (unsigned char)(flevel << 6);
+	zlib_header[1] += (unsigned char)(31-(0x7800 | zlib_header[1]) % 31);
+
+	// the checksum of the whole stream combined from the bands' checksums
+	::uLong adler = ::adler32(0, Z_NULL, 0);
+	for(std::size_t b=0; b!=band_count; ++b)
+	{
+		adler = ::adler32_combine(
+			adler,
+			bands[b].adler,
+			::z_off_t(bands[b].input_size)
+		);
+	}
+	unsigned char zlib_trailer[4];
+	aux::PNGPutUInt32(zlib_trailer, adler);
+
+	const unsigned char signature[8] = {
+		0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A
+	};
+	output.write(reinterpret_cast<const char*>(signature), 8);
+
+	unsigned char ihdr[13];
+	aux::PNGPutUInt32(ihdr+0, ::uLong(image.Width()));
+	aux::PNGPutUInt32(ihdr+4, ::uLong(image.Height()));
+	ihdr[ 8] = (unsigned char)bit_depth;
+	ihdr[ 9] = (unsigned char)color_type;
+	ihdr[10] = 0; // compression method
+	ihdr[11] = 0; // filter method
+	ihdr[12] = 0; // interlace method
+	aux::PNGWriteChunk(output, "IHDR", ihdr, sizeof(ihdr));
+
+	aux::PNGWriteChunk(output, "IDAT", zlib_header, sizeof(zlib_header));
+	for(std::size_t b=0; b!=band_count; ++b)
+	{
+		aux::PNGWriteChunk(
+			output,
+			"IDAT",
+			bands[b].data.data(),
+			bands[b].data.size()
+		);
+	}
+	aux::PNGWriteChunk(output, "IDAT", zlib_trailer, sizeof(zlib_trailer));
+	aux::PNGWriteChunk(output, "IEND", nullptr, 0);
+
+	if(!output.good())
+	{
+		throw std::runtime_error("Error writing PNG data");
+	}
+}
+
+OGLPLUS_LIB_FUNC
+void SavePNG(
+	const ImageView& image,
+	const char* file_path,
+	const PNGSaveParams& params
+)
+{
+	assert(file_path != nullptr);
+	std::ofstream output(file_path, std::ios::out | std::ios::binary);
+	if(!output.good())
+	{
+		throw std::runtime_error(
+			std::string("Unable to open file '")+file_path+"' for writing"
+		);
+	}
+	SavePNG(image, output, params);
+}
+
+} // namespace images
+} // namespace oglplus
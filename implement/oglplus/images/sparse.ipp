@@ -0,0 +1,349 @@
+/**
+ *  @file oglplus/images/sparse.ipp
+ *  @brief Implementation of images::SparseImage
+ *
+ *  @author Matus Chochlik
+ *
+ *  Copyright 2010-2015 Matus Chochlik. Distributed under the Boost
+ *  Software License, Version 1.0. (See accompanying file
+ *  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include <oglplus/lib/incl_begin.ipp>
+#include <oglplus/images/convert.hpp>
+#include <oglplus/detail/parallel_for.hpp>
+#include <oglplus/lib/incl_end.ipp>
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+
+namespace oglplus {
+namespace images {
+namespace aux {
+
+// The (approximate) maximum size of the chunks of memory of the bricks
+inline std::size_t SparseImageMaxChunkSize(void)
+{
+	return std::size_t(4) << 20;
+}
+
+// Returns true if all size bytes are zero
+inline bool SparseImageIsZero(const unsigned char* data, std::size_t size)
+{
+	return	(size == 0) || (
+		(data[0] == 0) &&
+		(std::memcmp(data, data+1, size-1) == 0)
+	);
+}
+
+} // namespace aux
+
+OGLPLUS_LIB_FUNC
+void SparseImage::_init(void)
+{
+	assert(_brick_size > 0);
+	if(_comp_size == 0)
+	{
+		throw std::runtime_error(
+			"Unsupported pixel data type for sparse images"
+		);
+	}
+	_bricks_x = (_width+_brick_size-1)/_brick_size;
+	_bricks_y = (_height+_brick_size-1)/_brick_size;
+	_bricks_z = (_depth+_brick_size-1)/_brick_size;
+	_index.assign(std::size_t(_bricks_x*_bricks_y*_bricks_z), 0);
+}
+
+OGLPLUS_LIB_FUNC
+void SparseImage::_add_chunk(std::size_t slots)
+{
+	assert(slots > 0);
+	_chunks.push_back(oglplus::aux::AlignedPODArray(
+		static_cast<const GLubyte*>(nullptr),
+		slots*_brick_bytes()
+	));
+	_chunk_ends.push_back(_capacity()+slots);
+}
+
+OGLPLUS_LIB_FUNC
+void SparseImage::Reserve(std::size_t count)
+{
+	if(count > _capacity())
+	{
+		_add_chunk(count-_capacity());
+	}
+}
+
+OGLPLUS_LIB_FUNC
+unsigned char* SparseImage::_alloc(std::size_t index)
+{
+	assert(index < _index.size());
+	if(_index[index] != 0)
+	{
+		return _slot_data(_index[index]-1);
+	}
+	const std::size_t slot = _slots.size();
+	if(slot == _capacity())
+	{
+		// the capacity doubles until the chunks reach the maximum size
+		const std::size_t max_slots = std::max(
+			std::size_t(1),
+			aux::SparseImageMaxChunkSize()/_brick_bytes()
+		);
+		_add_chunk(std::min(std::max(slot, std::size_t(1)), max_slots));
+	}
+	_slots.push_back(std::uint32_t(index));
+	_index[index] = std::uint32_t(slot+1);
+	unsigned char* result = _slot_data(slot);
+	std::memset(result, 0, _brick_bytes());
+	return result;
+}
+
+OGLPLUS_LIB_FUNC
+SparseImage::SparseImage(const ImageView& image, GLsizei brick_size)
+ : _width(image.Width())
+ , _height(image.Height())
+ , _depth(image.Depth())
+ , _channels(image.Channels())
+ , _brick_size(brick_size)
+ , _comp_size(ImageView::ComponentSize(image.Type()))
+ , _type(image.Type())
+ , _format(image.Format())
+ , _internal(image.InternalFormat())
+{
+	_init();
+
+	const std::size_t count = _index.size();
+	const std::size_t pixel_size = std::size_t(_channels)*_comp_size;
+
+	// calls func(src, offs, size) for the rows of the image in a brick
+	// (offs is the offset of the row in the brick) while it returns true
+	typedef std::function<
+		bool(const unsigned char*, std::size_t, std::size_t)
+	> row_func;
+	auto for_each_row = [&](std::size_t index, const row_func& func)
+	{
+		const GLsizei s = _brick_size;
+		const GLsizei bx = GLsizei(index) % _bricks_x;
+		const GLsizei by = (GLsizei(index) / _bricks_x) % _bricks_y;
+		const GLsizei bz = GLsizei(index) / (_bricks_x*_bricks_y);
+		const GLsizei w = std::min(s, _width-bx*s);
+		const GLsizei h = std::min(s, _height-by*s);
+		const GLsizei d = std::min(s, _depth-bz*s);
+		for(GLsizei z=0; z!=d; ++z)
+		for(GLsizei y=0; y!=h; ++y)
+		{
+			if(!func(
+				static_cast<const unsigned char*>(
+					image.RawPixel(bx*s, by*s+y, bz*s+z)
+				),
+				std::size_t((z*s+y)*s)*pixel_size,
+				std::size_t(w)*pixel_size
+			)) return;
+		}
+	};
+
+	// find the non-empty bricks
+	std::vector<unsigned char> occupied(count);
+	oglplus::aux::ParallelFor(
+		count, 1,
+		[&](std::size_t begin, std::size_t end)
+		{
+			for(std::size_t i=begin; i!=end; ++i)
+			{
+				for_each_row(
+					i,
+					[&](
+						const unsigned char* src,
+						std::size_t,
+						std::size_t size
+					) -> bool
+					{
+						if(aux::SparseImageIsZero(src, size))
+						{
+							return true;
+						}
+						occupied[i] = 1;
+						return false;
+					}
+				);
+			}
+		}
+	);
+	// the slots of the bricks are allocated at once
+	Reserve(std::size_t(std::count(occupied.begin(), occupied.end(), 1)));
+	for(std::size_t i=0; i!=count; ++i)
+	{
+		if(occupied[i]) _alloc(i);
+	}
+
+	// copy them
+	oglplus::aux::ParallelFor(
+		_slots.size(), 1,
+		[&](std::size_t begin, std::size_t end)
+		{
+			for(std::size_t slot=begin; slot!=end; ++slot)
+			{
+				unsigned char* brick = _slot_data(slot);
+				for_each_row(
+					_slots[slot],
+					[brick](
+						const unsigned char* src,
+						std::size_t offs,
+						std::size_t size
+					) -> bool
+					{
+						std::memcpy(brick+offs, src, size);
+						return true;
+					}
+				);
+			}
+		}
+	);
+}
+
+OGLPLUS_LIB_FUNC
+ImageView SparseImage::BrickView(GLsizei bx, GLsizei by, GLsizei bz) const
+{
+	const std::uint32_t slot = _index[_brick_index(bx, by, bz)];
+	assert(slot != 0);
+	const GLsizei s = _brick_size;
+	const std::ptrdiff_t row_stride =
+		std::ptrdiff_t(std::size_t(s*_channels)*_comp_size);
+	return ImageView(
+		std::min(s, _width-bx*s),
+		std::min(s, _height-by*s),
+		std::min(s, _depth-bz*s),
+		_channels,
+		_slot_data(slot-1),
+		_type,
+		_format,
+		_internal,
+		row_stride,
+		row_stride*s
+	);
+}
+
+OGLPLUS_LIB_FUNC
+std::size_t SparseImage::Compact(void)
+{
+	const std::size_t count = _slots.size();
+	const std::size_t size = _brick_bytes();
+
+	std::vector<unsigned char> zero(count);
+	oglplus::aux::ParallelFor(
+		count, 4,
+		[&](std::size_t begin, std::size_t end)
+		{
+			for(std::size_t slot=begin; slot!=end; ++slot)
+			{
+				zero[slot] = aux::SparseImageIsZero(
+					_slot_data(slot),
+					size
+				)?1:0;
+			}
+		}
+	);
+
+	// move the last non-empty bricks into the released slots
+	std::size_t last = count;
+	for(std::size_t slot=0; slot!=last; ++slot)
+	{
+		if(!zero[slot]) continue;
+		_index[_slots[slot]] = 0;
+		while((--last != slot) && zero[last])
+		{
+			_index[_slots[last]] = 0;
+		}
+		if(last == slot) break;
+		std::memcpy(_slot_data(slot), _slot_data(last), size);
+		_slots[slot] = _slots[last];
+		_index[_slots[slot]] = std::uint32_t(slot+1);
+	}
+	_slots.resize(last);
+
+	// release the unused chunks and shrink the last used one
+	while(!_chunk_ends.empty())
+	{
+		const std::size_t n = _chunk_ends.size();
+		const std::size_t first = (n > 1)?_chunk_ends[n-2]:0;
+		if(first < last)
+		{
+			if(_chunk_ends.back() != last)
+			{
+				oglplus::aux::AlignedPODArray chunk(
+					static_cast<const GLubyte*>(nullptr),
+					(last-first)*size
+				);
+				std::memcpy(
+					chunk.begin(),
+					_chunks.back().begin(),
+					(last-first)*size
+				);
+				_chunks.pop_back();
+				_chunks.push_back(std::move(chunk));
+				_chunk_ends.back() = last;
+			}
+			break;
+		}
+		_chunk_ends.pop_back();
+		_chunks.pop_back();
+	}
+	return count-last;
+}
+
+OGLPLUS_LIB_FUNC
+Image SparseImage::ToImage(void) const
+{
+	const std::size_t pixel_size = std::size_t(_channels)*_comp_size;
+	const std::size_t row_size = std::size_t(_width)*pixel_size;
+	oglplus::aux::AlignedPODArray storage = aux::ConvertAllocate(
+		_type,
+		std::size_t(_width*_height*_depth*_channels)
+	);
+	storage.fill(0x00);
+	unsigned char* data = static_cast<unsigned char*>(storage.begin());
+
+	// the bricks are disjoint, so they are copied in parallel
+	oglplus::aux::ParallelFor(
+		_slots.size(), 1,
+		[&](std::size_t begin, std::size_t end)
+		{
+			for(std::size_t slot=begin; slot!=end; ++slot)
+			{
+				GLsizei bx, by, bz;
+				OccupiedBrick(slot, bx, by, bz);
+				const ImageView brick = BrickView(bx, by, bz);
+				const std::size_t size =
+					std::size_t(GLsizei(brick.Width()))*
+					pixel_size;
+				const GLsizei s = _brick_size;
+				for(GLsizei z=0; z!=GLsizei(brick.Depth()); ++z)
+				for(GLsizei y=0; y!=GLsizei(brick.Height()); ++y)
+				{
+					std::memcpy(
+						data+
+						std::size_t((bz*s+z)*_height+by*s+y)*
+						row_size+
+						std::size_t(bx*s)*pixel_size,
+						brick.RawPixel(0, y, z),
+						size
+					);
+				}
+			}
+		}
+	);
+	return Image(
+		_width, _height, _depth, _channels,
+		_type,
+		std::move(storage),
+		_format,
+		_internal
+	);
+}
+
+} // namespace images
+} // namespace oglplus
+
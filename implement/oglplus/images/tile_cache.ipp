@@ -0,0 +1,231 @@
+/**
+ *  @file oglplus/images/tile_cache.ipp
+ *  @brief Implementation of images::ImageTileCache
+ *
+ *  @author Matus Chochlik
+ *
+ *  Copyright 2010-2015 Matus Chochlik. Distributed under the Boost
+ *  Software License, Version 1.0. (See accompanying file
+ *  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include <oglplus/lib/incl_begin.ipp>
+#include <oglplus/detail/parallel_for.hpp>
+#include <oglplus/lib/incl_end.ipp>
+
+#include <algorithm>
+#include <vector>
+
+namespace oglplus {
+namespace images {
+
+OGLPLUS_LIB_FUNC
+ImageTileCache::ImageTileCache(
+	const ImageTileSource& source,
+	SizeType tile_width,
+	SizeType tile_height,
+	SizeType tile_depth,
+	std::size_t budget
+): _source(source)
+ , _tile_width(tile_width)
+ , _tile_height(tile_height)
+ , _tile_depth(tile_depth)
+ , _budget(budget)
+ , _size(0)
+{
+	assert(_tile_width > 0 && _tile_height > 0 && _tile_depth > 0);
+}
+
+OGLPLUS_LIB_FUNC
+ImageTileCache::_key_t ImageTileCache::_key(
+	GLint level,
+	GLsizei x,
+	GLsizei y,
+	GLsizei z
+)
+{
+	assert(level >= 0 && level < 64);
+	assert(x >= 0 && x < (1 << 20));
+	assert(y >= 0 && y < (1 << 20));
+	assert(z >= 0 && z < (1 << 18));
+	return	(_key_t(level) << 58) |
+		(_key_t(z) << 40) |
+		(_key_t(y) << 20) |
+		(_key_t(x));
+}
+
+OGLPLUS_LIB_FUNC
+ImageTileCache::TilePtr ImageTileCache::_find(_key_t key)
+{
+	auto pos = _index.find(key);
+	if(pos == _index.end()) return TilePtr();
+	// move the tile to the front of the LRU list
+	_lru.splice(_lru.begin(), _lru, pos->second);
+	return pos->second->second;
+}
+
+OGLPLUS_LIB_FUNC
+ImageTileCache::TilePtr ImageTileCache::_insert(_key_t key, TilePtr tile)
+{
+	// the tile could have been made concurrently by another thread
+	TilePtr found = _find(key);
+	if(found) return found;
+
+	_lru.push_front(std::make_pair(key, tile));
+	_index[key] = _lru.begin();
+	_size += tile->DataSize();
+	_evict();
+	return tile;
+}
+
+OGLPLUS_LIB_FUNC
+void ImageTileCache::_evict(void)
+{
+	while((_size > _budget) && (_lru.size() > 1))
+	{
+		_size -= _lru.back().second->DataSize();
+		_index.erase(_lru.back().first);
+		_lru.pop_back();
+	}
+}
+
+OGLPLUS_LIB_FUNC
+ImageTileCache::TilePtr ImageTileCache::Tile(
+	GLint level,
+	GLsizei tx,
+	GLsizei ty,
+	GLsizei tz
+)
+{
+	assert(level >= 0 && level < _source.Levels());
+	assert(tx >= 0 && tx < TilesX(level));
+	assert(ty >= 0 && ty < TilesY(level));
+	assert(tz >= 0 && tz < TilesZ(level));
+
+	const _key_t key = _key(level, tx, ty, tz);
+	{
+		_lock lock(*this);
+		TilePtr tile = _find(key);
+		if(tile) return tile;
+	}
+
+	// the tile is made without holding the lock, so that other
+	// tiles can be made (or found) in the meantime
+	const GLint x = tx*_tile_width;
+	const GLint y = ty*_tile_height;
+	const GLint z = tz*_tile_depth;
+	TilePtr tile = std::make_shared<const Image>(_source.MakeRegion(
+		level, x, y, z,
+		std::min(_tile_width, GLsizei(_source.LevelWidth(level))-x),
+		std::min(_tile_height, GLsizei(_source.LevelHeight(level))-y),
+		std::min(_tile_depth, GLsizei(_source.LevelDepth(level))-z)
+	));
+
+	_lock lock(*this);
+	return _insert(key, tile);
+}
+
+OGLPLUS_LIB_FUNC
+bool ImageTileCache::Contains(
+	GLint level,
+	GLsizei tx,
+	GLsizei ty,
+	GLsizei tz
+) const
+{
+	_lock lock(*this);
+	return _index.find(_key(level, tx, ty, tz)) != _index.end();
+}
+
+OGLPLUS_LIB_FUNC
+void ImageTileCache::Prefetch(
+	GLint level,
+	GLint xoffs,
+	GLint yoffs,
+	GLint zoffs,
+	SizeType width,
+	SizeType height,
+	SizeType depth,
+	unsigned max_threads
+)
+{
+	if((width == 0) || (height == 0) || (depth == 0)) return;
+
+	const GLsizei tx0 = xoffs/_tile_width;
+	const GLsizei ty0 = yoffs/_tile_height;
+	const GLsizei tz0 = zoffs/_tile_depth;
+	const GLsizei tx1 = (xoffs+GLsizei(width)-1)/_tile_width+1;
+	const GLsizei ty1 = (yoffs+GLsizei(height)-1)/_tile_height+1;
+	const GLsizei tz1 = (zoffs+GLsizei(depth)-1)/_tile_depth+1;
+
+	std::vector<_key_t> missing;
+	for(GLsizei tz=tz0; tz!=tz1; ++tz)
+	for(GLsizei ty=ty0; ty!=ty1; ++ty)
+	for(GLsizei tx=tx0; tx!=tx1; ++tx)
+	{
+		if(!Contains(level, tx, ty, tz))
+		{
+			missing.push_back(_key(level, tx, ty, tz));
+		}
+	}
+
+	oglplus::aux::ParallelFor(
+		missing.size(),
+		1,
+		[&](std::size_t begin, std::size_t end)
+		{
+			for(std::size_t i=begin; i!=end; ++i)
+			{
+				Tile(
+					level,
+					GLsizei((missing[i] >>  0) & 0xFFFFF),
+					GLsizei((missing[i] >> 20) & 0xFFFFF),
+					GLsizei((missing[i] >> 40) & 0x3FFFF)
+				);
+			}
+		},
+		max_threads
+	);
+}
+
+OGLPLUS_LIB_FUNC
+std::size_t ImageTileCache::Size(void) const
+{
+	_lock lock(*this);
+	return _size;
+}
+
+OGLPLUS_LIB_FUNC
+std::size_t ImageTileCache::TileCount(void) const
+{
+	_lock lock(*this);
+	return _lru.size();
+}
+
+OGLPLUS_LIB_FUNC
+std::size_t ImageTileCache::Budget(void) const
+{
+	_lock lock(*this);
+	return _budget;
+}
+
+OGLPLUS_LIB_FUNC
+void ImageTileCache::Budget(std::size_t budget)
+{
+	_lock lock(*this);
+	_budget = budget;
+	_evict();
+}
+
+OGLPLUS_LIB_FUNC
+void ImageTileCache::Clear(void)
+{
+	_lock lock(*this);
+	_index.clear();
+	_lru.clear();
+	_size = 0;
+}
+
+} // namespace images
+} // namespace oglplus
+
@@ -0,0 +1,43 @@
+/**
+ *  @file oglplus/images/tile_source.ipp
+ *  @brief Implementation of images::ImageViewTileSource
+ *
+ *  @author Matus Chochlik
+ *
+ *  Copyright 2010-2015 Matus Chochlik. Distributed under the Boost
+ *  Software License, Version 1.0. (See accompanying file
+ *  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include <oglplus/lib/incl_begin.ipp>
+#include <oglplus/images/convert.hpp>
+#include <oglplus/lib/incl_end.ipp>
+
+namespace oglplus {
+namespace images {
+
+OGLPLUS_LIB_FUNC
+Image ImageViewTileSource::MakeRegion(
+	GLint level,
+	GLint xoffs,
+	GLint yoffs,
+	GLint zoffs,
+	SizeType width,
+	SizeType height,
+	SizeType depth
+) const
+{
+	assert(level == 0);
+	OGLPLUS_FAKE_USE(level);
+	// converting to the same type and format just copies the rows
+	return Convert(
+		_image.Region(xoffs, yoffs, zoffs, width, height, depth),
+		_image.Type(),
+		_image.Format(),
+		_image.InternalFormat()
+	);
+}
+
+} // namespace images
+} // namespace oglplus
+
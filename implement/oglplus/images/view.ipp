@@ -0,0 +1,84 @@
+/**
+ *  @file oglplus/images/view.ipp
+ *  @brief Implementation of images::ImageView
+ *
+ *  @author Matus Chochlik
+ *
+ *  Copyright 2010-2015 Matus Chochlik. Distributed under the Boost
+ *  Software License, Version 1.0. (See accompanying file
+ *  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+namespace oglplus {
+namespace images {
+
+OGLPLUS_LIB_FUNC
+ImageView::_convert_func ImageView::_get_convert(PixelDataType type)
+OGLPLUS_NOEXCEPT(true)
+{
+	switch(GLenum(type))
+	{
+		case GL_UNSIGNED_BYTE: return &_do_convert<GLubyte>;
+		case GL_BYTE: return &_do_convert<GLbyte>;
+		case GL_UNSIGNED_SHORT: return &_do_convert<GLushort>;
+		case GL_SHORT: return &_do_convert<GLshort>;
+		case GL_UNSIGNED_INT: return &_do_convert<GLuint>;
+		case GL_INT: return &_do_convert<GLint>;
+		case GL_FLOAT: return &_do_convert<GLfloat>;
+#ifdef GL_HALF_FLOAT
+		case GL_HALF_FLOAT: return &_do_convert_half;
+#endif
+		case GL_UNSIGNED_INT_10F_11F_11F_REV:
+		case GL_UNSIGNED_INT_5_9_9_9_REV:
+		case GL_UNSIGNED_INT_2_10_10_10_REV:
+			return &_do_convert<GLuint>;
+		default:;
+	}
+	return nullptr;
+}
+
+OGLPLUS_LIB_FUNC
+std::size_t ImageView::ComponentSize(PixelDataType type)
+OGLPLUS_NOEXCEPT(true)
+{
+	switch(GLenum(type))
+	{
+		case GL_UNSIGNED_BYTE:
+		case GL_BYTE:
+			return 1;
+		case GL_UNSIGNED_SHORT:
+		case GL_SHORT:
+#ifdef GL_HALF_FLOAT
+		case GL_HALF_FLOAT:
+#endif
+			return 2;
+		case GL_UNSIGNED_INT:
+		case GL_INT:
+		case GL_FLOAT:
+		case GL_UNSIGNED_INT_10F_11F_11F_REV:
+		case GL_UNSIGNED_INT_5_9_9_9_REV:
+		case GL_UNSIGNED_INT_2_10_10_10_REV:
+			return 4;
+		default:;
+	}
+	return 0;
+}
+
+OGLPLUS_LIB_FUNC
+bool ImageView::IsPacked(PixelDataType type)
+OGLPLUS_NOEXCEPT(true)
+{
+	switch(GLenum(type))
+	{
+		case GL_UNSIGNED_INT_10F_11F_11F_REV:
+		case GL_UNSIGNED_INT_5_9_9_9_REV:
+		case GL_UNSIGNED_INT_2_10_10_10_REV:
+			return true;
+		default:;
+	}
+	return false;
+}
+
+} // namespace images
+} // namespace oglplus
+
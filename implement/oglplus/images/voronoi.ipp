@@ -44,7 +44,7 @@ VoronoiDiagram::VoronoiDiagram(
 	SizeType cell_w,
 	SizeType cell_h,
 	SizeType cell_d,
-	const Image& input
+	const ImageView& input
 ): Image(static_cast<Image&&>(
 	CellImageGen<GLubyte, 3>(
 		cell_w, cell_h, cell_d,
@@ -69,7 +69,7 @@ VoronoiCells::VoronoiCells(
 	SizeType cell_w,
 	SizeType cell_h,
 	SizeType cell_d,
-	const Image& input
+	const ImageView& input
 ): Image(static_cast<Image&&>(
 	WorleyCellGen(
 		cell_w, cell_h, cell_d,
@@ -30,7 +30,7 @@ WorleyCells::WorleyCells(
 	SizeType cell_w,
 	SizeType cell_h,
 	SizeType cell_d,
-	const Image& input
+	const ImageView& input
 ): Image(static_cast<Image&&>(
 	WorleyCellGen(
 		cell_w, cell_h, cell_d,
@@ -45,7 +45,7 @@ WorleyCells::WorleyCells(
 	SizeType cell_w,
 	SizeType cell_h,
 	SizeType cell_d,
-	const Image& input,
+	const ImageView& input,
 	std::function<double(const std::vector<double>&)> calc_value,
 	unsigned order
 ): Image(static_cast<Image&&>(
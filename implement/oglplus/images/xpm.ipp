@@ -10,34 +10,55 @@
  */
 
 #include <stdexcept>
-#include <map>
-#include <array>
+#include <vector>
 #include <string>
-#include <sstream>
 #include <cstring>
+#include <cstdint>
 #include <cassert>
 
 namespace oglplus {
 namespace images {
 namespace aux {
 
+inline bool xpm_load_is_space(char c)
+{
+	return (c == ' ') || (c == '\t');
+}
+
+// Finds the next line in the buffer, without the line terminator
+OGLPLUS_LIB_FUNC
+bool xpm_load_next_line(
+	const char*& pos,
+	const char* end,
+	const char*& line,
+	std::size_t& line_len
+)
+{
+	if(pos == end) return false;
+	line = pos;
+	const void* nl = std::memchr(pos, '\n', std::size_t(end-pos));
+	const char* eol = nl?static_cast<const char*>(nl):end;
+	pos = nl?eol+1:end;
+	if((eol != line) && (eol[-1] == '\r')) --eol;
+	line_len = std::size_t(eol-line);
+	return true;
+}
+
 OGLPLUS_LIB_FUNC
 bool xpm_load_is_header_line(
 	const char* line,
 	const std::size_t size,
-	std::size_t &/*width*/,
-	std::size_t &/*height*/,
 	std::size_t &depth
 )
 {
-	if(std::strncmp(line, "! XPM2", size<6?size:6) == 0)
+	if((size >= 7) && (std::strncmp(line, "! XPM3D", 7) == 0))
 	{
-		depth = 1;
+		depth = 0;
 		return true;
 	}
-	if(std::strncmp(line, "! XPM3D", size<7?size:7) == 0)
+	if((size >= 6) && (std::strncmp(line, "! XPM2", 6) == 0))
 	{
-		depth = 0;
+		depth = 1;
 		return true;
 	}
 	return false;
@@ -46,17 +67,30 @@ bool xpm_load_is_header_line(
 OGLPLUS_LIB_FUNC
 bool xpm_load_is_dims_line(const char* line, const std::size_t line_len)
 {
+	if(line_len == 0) return false;
 	for(std::size_t i=0; i!=line_len; ++i)
 	{
 		char c = line[i];
 		if(c >= '0' && c <= '9') continue;
-		if(c == ' ') continue;
-		if(c == '\t') continue;
+		if(xpm_load_is_space(c)) continue;
 		return false;
 	}
 	return true;
 }
 
+OGLPLUS_LIB_FUNC
+bool xpm_load_parse_number(const char*& pos, const char* end, std::size_t& n)
+{
+	while((pos != end) && xpm_load_is_space(*pos)) ++pos;
+	if((pos == end) || (*pos < '0') || (*pos > '9')) return false;
+	n = 0;
+	while((pos != end) && (*pos >= '0') && (*pos <= '9'))
+	{
+		n = n*10+std::size_t(*pos++ - '0');
+	}
+	return n != 0;
+}
+
 OGLPLUS_LIB_FUNC
 bool xpm_load_parse_dims_line(
 	const char* line,
@@ -68,137 +102,85 @@ bool xpm_load_parse_dims_line(
 	std::size_t& chpp
 )
 {
-	std::stringstream ss(std::ios::in);
-	ss.str(std::string(line, line_len));
-	if(!width && (!(ss >> width).good() || width == 0)) return false;
-	if(!height && (!(ss >> height).good() || height == 0)) return false;
-	if(!depth && (!(ss >> depth).good() || depth == 0)) return false;
-	if(!colors && (!(ss >> colors).good() || colors == 0)) return false;
-	if(!chpp && (!(ss >> chpp).good() || chpp == 0)) return false;
+	const char* end = line+line_len;
+	if(!xpm_load_parse_number(line, end, width)) return false;
+	if(!xpm_load_parse_number(line, end, height)) return false;
+	if(!depth && !xpm_load_parse_number(line, end, depth)) return false;
+	if(!xpm_load_parse_number(line, end, colors)) return false;
+	if(!xpm_load_parse_number(line, end, chpp)) return false;
 	return true;
 }
 
+// Returns the value of a named color or nullptr if the name is unknown
 OGLPLUS_LIB_FUNC
-bool xpm_load_parse_palette_entry(
-	const char* line,
-	const std::size_t line_len,
-	const std::size_t chpp,
-	std::string& color_code,
-	std::string& color_value
-)
+const char* xpm_load_find_color_name(const char* name, std::size_t len)
 {
-	if(line_len == 0) return false;
-	color_code.clear();
-	std::size_t todo = chpp;
-	std::size_t i=0;
-	while((i != line_len) && (todo-- != 0))
+	static const char* color_names[][2] = {
+		{"black", "#000000"},
+		{"gray", "#808080"},
+		{"white", "#FFFFFF"},
+		{"red", "#FF0000"},
+		{"green", "#00FF00"},
+		{"blue", "#0000FF"},
+		{"yellow", "#FFFF00"},
+		{"magenta", "#FF00FF"},
+		{"cyan", "#00FFFF"}
+	};
+	const std::size_t n = sizeof(color_names)/sizeof(color_names[0]);
+	for(std::size_t i=0; i!=n; ++i)
 	{
-		color_code.append(1, line[i++]);
+		if(	(std::strlen(color_names[i][0]) == len) &&
+			(std::strncmp(color_names[i][0], name, len) == 0)
+		) return color_names[i][1];
 	}
-
-	while((i != line_len) && ((line[i] == ' ') || (line[i] == '\t'))) ++i;
-	color_value.assign(line+i, line_len-i);
-	return (!color_code.empty()) && (!color_value.empty());
+	return nullptr;
 }
 
+// Finds the next (type, color) pair in the value of a palette entry
 OGLPLUS_LIB_FUNC
-std::size_t xpm_load_color_code_bipp(
-	const std::string& color,
-	const std::map<std::string, std::string>& color_names
+bool xpm_load_next_color(
+	const char*& pos,
+	const char* end,
+	char& type,
+	const char*& color,
+	std::size_t& color_len
 )
 {
-	if(color.empty()) return 0;
-
-	if(color.front() == '#')
+	while((pos != end) && xpm_load_is_space(*pos)) ++pos;
+	if(pos == end) return false;
+
+	type = *pos++;
+	while((pos != end) && xpm_load_is_space(*pos)) ++pos;
+	color = pos;
+	while((pos != end) && !xpm_load_is_space(*pos)) ++pos;
+	color_len = std::size_t(pos-color);
+	if(color_len == 0)
 	{
-		return (color.size()-1)*4;
-	}
-	else
-	{
-		auto p = color_names.find(color);
-		if(p != color_names.end())
-		{
-			return xpm_load_color_code_bipp(
-				p->second,
-				color_names
-			);
-		}
-		else
-		{
-			throw std::runtime_error(
-				"Unknown color name '"+
-				color +
-				"' in XPM palette"
-			);
-		}
+		throw std::runtime_error(
+			"Missing color name in XPM color entry"
+		);
 	}
-	return 0;
+	return true;
 }
 
 OGLPLUS_LIB_FUNC
-void xpm_load_preload_col_ents(
-	const std::map<std::string, std::string>& col_ents,
-	const std::map<std::string, std::string>& color_names,
-	std::size_t& chpp,
-	std::size_t& bipp
-)
+std::size_t xpm_load_color_code_bipp(const char* color, std::size_t len)
 {
-	for(auto i = col_ents.begin(); i != col_ents.end(); ++i)
-	{
-		assert(!i->second.empty());
+	if(len == 0) return 0;
 
-		if(chpp < i->first.size())
-		{
-			chpp = i->first.size();
-		}
-		const std::string& val = i->second;
-		std::size_t ebipp = 0;
-		std::size_t j = 0, n = val.size();
-		while(j != n)
-		{
-			if(!val[j]) break;
-
-			++j;
-			while((j != n) && ((val[j] == ' ') || (val[j] == '\t')))
-			{
-				++j;
-			}
-			std::size_t v = j;
-			while((j != n) && ((val[j] != ' ') && (val[j] != '\t') && val[j]))
-			{
-				++j;
-			}
-			if(v == j)
-			{
-				throw std::runtime_error(
-					"Missing color name in XPM color entry"
-				);
-			}
-			std::size_t cbipp = xpm_load_color_code_bipp(
-				std::string(val.data()+v, val.data()+j),
-				color_names
-			);
-			if(ebipp < cbipp)
-			{
-				ebipp = cbipp;
-			}
-
-			while((j != n) && ((val[j] == ' ') || (val[j] == '\t')))
-			{
-				++j;
-			}
-		}
-		if(ebipp == 0)
-		{
-			throw std::runtime_error(
-				"Failed to determine bits per pixel for XPM color entry"
-			);
-		}
-		if(bipp < ebipp)
-		{
-			bipp = ebipp;
-		}
+	if(color[0] == '#')
+	{
+		return (len-1)*4;
 	}
+	else if(const char* value = xpm_load_find_color_name(color, len))
+	{
+		return xpm_load_color_code_bipp(value, std::strlen(value));
+	}
+	throw std::runtime_error(
+		"Unknown color name '"+
+		std::string(color, len) +
+		"' in XPM palette"
+	);
 }
 
 OGLPLUS_LIB_FUNC
@@ -234,22 +216,22 @@ unsigned char xpm_load_convert_color_channel(const char*& begin, const char* end
 
 OGLPLUS_LIB_FUNC
 bool xpm_load_convert_color(
-	const std::string& color,
-	const std::map<std::string, std::string>& color_names,
+	const char* color,
+	std::size_t len,
 	const std::size_t bipp,
-	std::array<unsigned char, 4>& color_buf
+	unsigned char* color_buf
 )
 {
-	if(color.empty()) return false;
+	if(len == 0) return false;
 
 	assert(bipp % 8 == 0);
 	std::size_t bpp = bipp/8;
 
-	if(color.front() == '#')
+	if(color[0] == '#')
 	{
-		std::size_t ebipp = (color.size()-1)*4;
-		const char* begin = color.data()+1;
-		const char* end  = color.data()+color.size();
+		std::size_t ebipp = (len-1)*4;
+		const char* begin = color+1;
+		const char* end  = color+len;
 
 		if(bipp == ebipp)
 		{
@@ -260,7 +242,7 @@ bool xpm_load_convert_color(
 					end
 				);
 			}
-			for(std::size_t b=bpp; b!=4; ++b)
+			for(std::size_t b=bpp; b<4; ++b)
 			{
 				color_buf[b] = 0xFF;
 			}
@@ -289,103 +271,139 @@ bool xpm_load_convert_color(
 		}
 		else return false;
 	}
-	else
+	else if(const char* value = xpm_load_find_color_name(color, len))
 	{
-		auto p = color_names.find(color);
-		if(p != color_names.end())
-		{
-			return xpm_load_convert_color(
-				p->second,
-				color_names,
-				bipp,
-				color_buf
-			);
-		}
-		else return false;
+		return xpm_load_convert_color(
+			value,
+			std::strlen(value),
+			bipp,
+			color_buf
+		);
 	}
+	else return false;
 	return true;
 }
 
-OGLPLUS_LIB_FUNC
-void xpm_load_make_palette(
-	const std::map<std::string, std::string>& col_ents,
-	const std::map<std::string, std::string>& color_names,
-	std::map<std::string, std::array<unsigned char, 4>>& palette,
-	const std::size_t bipp
-)
+// The palette of an XPM image, the color codes of up to 8 characters
+// are packed into integer keys, which are looked up in a flat table
+// (indexed directly by the key for 1 and 2 characters per pixel
+// or an open-addressing hash table for longer codes)
+class XPMPalette
 {
-	for(auto i = col_ents.begin(); i != col_ents.end(); ++i)
-	{
-		assert(!i->second.empty());
+private:
+	std::size_t _chpp;
+	bool _direct;
+	unsigned _hash_shift;
+	std::vector<std::uint64_t> _keys;
+	std::vector<std::uint32_t> _table;
 
-		const std::string& val = i->second;
-		std::array<unsigned char, 4> pal_color;
-		std::size_t j = 0, n = val.size();
-		char best_type = '\0';
-		while(j != n)
-		{
-			const char type = val[j];
-			if(!type) break;
+	enum : std::uint32_t { _npos = 0xFFFFFFFFu };
 
-			++j;
-			while((j != n) && ((val[j] == ' ') || (val[j] == '\t')))
-			{
-				++j;
-			}
-			std::size_t v = j;
-			while((j != n) && ((val[j] != ' ') && (val[j] != '\t')) && val[j])
+	std::size_t _slot(std::uint64_t key) const
+	{
+		return std::size_t((key*0x9E3779B97F4A7C15ull) >> _hash_shift);
+	}
+public:
+	// The colors of the entries, 4 components per entry
+	std::vector<unsigned char> colors;
+
+	XPMPalette(std::size_t chpp, std::size_t count)
+	 : _chpp(chpp)
+	 , _direct(chpp <= 2)
+	 , _hash_shift(64)
+	{
+		if((chpp == 0) || (chpp > 8))
+		{
+			throw std::runtime_error(
+				"Unsupported number of characters per XPM pixel"
+			);
+		}
+		std::size_t size = 1;
+		if(_direct)
+		{
+			size <<= 8*chpp;
+		}
+		else
+		{
+			while(size < 2*count)
 			{
-				++j;
-			}
-			assert(v != j);
-
-			if(xpm_load_convert_color(
-				std::string(val.data()+v, val.data()+j),
-				color_names,
-				bipp,
-				pal_color
-			))
-			{
-				best_type = type;
-				if(type == 'c') break;
+				size <<= 1;
+				--_hash_shift;
 			}
+		}
+		_table.resize(size, std::uint32_t(_npos));
+		_keys.reserve(count);
+		colors.reserve(count*4);
+	}
 
-			while((j != n) && ((val[j] == ' ') || (val[j] == '\t')))
-			{
-				++j;
-			}
+	std::uint64_t Key(const char* code) const
+	{
+		std::uint64_t key = 0;
+		for(std::size_t i=0; i!=_chpp; ++i)
+		{
+			key |= std::uint64_t(static_cast<unsigned char>(code[i]))<<(i*8);
 		}
-		if(!best_type)
+		return key;
+	}
+
+	std::uint32_t Find(std::uint64_t key) const
+	{
+		if(_direct)
 		{
-			throw std::runtime_error(
-				"Failed to load XPM palette color entry '" +
-				i->second +
-				"'"
-			);
+			return _table[std::size_t(key)];
+		}
+		const std::size_t mask = _table.size()-1;
+		for(std::size_t s=_slot(key); ; s = (s+1) & mask)
+		{
+			const std::uint32_t i = _table[s];
+			if((i == _npos) || (_keys[i] == key)) return i;
 		}
-		palette[i->first] = pal_color;
 	}
-}
+
+	bool Insert(std::uint64_t key)
+	{
+		if(_keys.size() >= _npos) return false;
+
+		std::size_t s = std::size_t(key);
+		if(!_direct)
+		{
+			const std::size_t mask = _table.size()-1;
+			s = _slot(key);
+			while((_table[s] != _npos) && (_keys[_table[s]] != key))
+			{
+				s = (s+1) & mask;
+			}
+		}
+		if(_table[s] != _npos) return false;
+		_table[s] = std::uint32_t(_keys.size());
+		_keys.push_back(key);
+		colors.resize(colors.size()+4, 0xFF);
+		return true;
+	}
+
+	static bool IsNone(std::uint32_t index)
+	{
+		return index == _npos;
+	}
+};
 
 OGLPLUS_LIB_FUNC
 void xpm_load(
-	std::istream& input,
+	const char* pos,
+	const char* end,
 	Image& image,
-	const std::map<std::string, std::string>& color_names,
 	bool y_is_up,
 	bool x_is_right
 )
 {
-	const std::size_t max_line = 63;
+	const char* line = nullptr;
 	std::size_t line_len = 0;
-	char line[max_line+1];
 
 	// read first line
-	if(!input.getline(line, max_line).good())
+	if(!xpm_load_next_line(pos, end, line, line_len))
 	{
 		throw std::runtime_error("Failed to read XPM header from input");
 	}
-	line_len = std::size_t(input.gcount());
 
 	std::size_t width = 0, height = 0, depth = 0, colors = 0, chpp = 0, bipp = 0;
 
@@ -406,15 +424,15 @@ void xpm_load(
 			throw std::runtime_error("Failed to parse XPM header data");
 		}
 	}
-	// otherwise the first line must be the XPM2 header
-	else if(!xpm_load_is_header_line(line, line_len, width, height, depth))
+	// otherwise the first line must be the XPM2 or XPM3D header
+	else if(!xpm_load_is_header_line(line, line_len, depth))
 	{
 		throw std::runtime_error("Failed to parse XPM header");
 	}
 	// so we need to read the line with the dimensions data
 	else if(
-		!input.getline(line, max_line).good() ||
-		!(line_len = std::size_t(input.gcount()))
+		!xpm_load_next_line(pos, end, line, line_len) ||
+		(line_len == 0)
 	)
 	{
 		throw std::runtime_error("Failed to read XPM header data from input");
@@ -432,55 +450,106 @@ void xpm_load(
 		throw std::runtime_error("Failed to parse XPM header data");
 	}
 
-	std::map<std::string, std::string> col_ents;
+	XPMPalette palette(chpp, colors);
+
+	// the color values of the palette entries
+	std::vector<const char*> values(colors);
+	std::vector<std::size_t> value_lens(colors);
 
 	// read and parse the palette entries
 	for(std::size_t c=0; c!=colors; ++c)
 	{
 		do
 		{
-			if(!input.getline(line, max_line).good())
+			if(!xpm_load_next_line(pos, end, line, line_len))
 			{
 				throw std::runtime_error("Failed to read XPM palette entry");
 			}
-			line_len = std::size_t(input.gcount());
 		}
 		while(line_len == 0);
 
-		std::string color_code, color_value;
-
-		if(!xpm_load_parse_palette_entry(
-			line,
-			line_len,
-			chpp,
-			color_code,
-			color_value
-		))
+		std::size_t i = chpp;
+		while((i < line_len) && xpm_load_is_space(line[i])) ++i;
+		if(i >= line_len)
 		{
 			throw std::runtime_error("Failed to parse XPM palette entry");
 		}
-
-		if(col_ents.find(color_code) != col_ents.end())
+		if(!palette.Insert(palette.Key(line)))
 		{
 			throw std::runtime_error(
 				"Duplicate XPM palette entry code '"+
-				color_code +
+				std::string(line, chpp) +
 				"'"
 			);
 		}
-
-		col_ents[color_code] = color_value;
+		values[c] = line+i;
+		value_lens[c] = line_len-i;
 	}
-	assert(col_ents.size() == colors);
-
-	xpm_load_preload_col_ents(col_ents, color_names, chpp, bipp);
 
-	std::map<std::string, std::array<unsigned char, 4>> palette;
+	char type;
+	const char* color;
+	std::size_t color_len;
 
-	xpm_load_make_palette(col_ents, color_names, palette, bipp);
+	// determine the number of bits per pixel
+	for(std::size_t c=0; c!=colors; ++c)
+	{
+		const char* vpos = values[c];
+		const char* vend = vpos+value_lens[c];
+		std::size_t ebipp = 0;
+		while(xpm_load_next_color(vpos, vend, type, color, color_len))
+		{
+			std::size_t cbipp = xpm_load_color_code_bipp(
+				color,
+				color_len
+			);
+			if(ebipp < cbipp)
+			{
+				ebipp = cbipp;
+			}
+		}
+		if(ebipp == 0)
+		{
+			throw std::runtime_error(
+				"Failed to determine bits per pixel for XPM color entry"
+			);
+		}
+		if(bipp < ebipp)
+		{
+			bipp = ebipp;
+		}
+	}
+	if(bipp % 8 != 0)
+	{
+		throw std::runtime_error(
+			"Unsupported number of bits per pixel in XPM palette"
+		);
+	}
 
-	assert(palette.size() == colors);
-	assert(bipp % 8 == 0);
+	// convert the palette colors, preferring the 'c' (color) values
+	for(std::size_t c=0; c!=colors; ++c)
+	{
+		const char* vpos = values[c];
+		const char* vend = vpos+value_lens[c];
+		unsigned char pal_color[4];
+		char best_type = '\0';
+		while(xpm_load_next_color(vpos, vend, type, color, color_len))
+		{
+			if(xpm_load_convert_color(color, color_len, bipp, pal_color))
+			{
+				std::memcpy(palette.colors.data()+c*4, pal_color, 4);
+				best_type = type;
+				if(type == 'c') break;
+			}
+		}
+		if(!best_type)
+		{
+			throw std::runtime_error(
+				"Failed to load XPM palette color entry '" +
+				std::string(values[c], value_lens[c]) +
+				"'"
+			);
+		}
+	}
 
 	std::size_t channels = bipp / 8;
 	GLenum gl_format = 0;
@@ -492,59 +561,49 @@ void xpm_load(
 		"Unable to determine GL pixel format for XPM data"
 	);
 
-	std::vector<unsigned char> data(width*height*depth*channels);
+	// the pixels are decoded directly into the storage of the image
+	oglplus::aux::AlignedPODArray storage(
+		static_cast<const unsigned char*>(nullptr),
+		width*height*depth*channels
+	);
+	unsigned char* data = static_cast<unsigned char*>(storage.begin());
 
-	for(std::size_t iz=0; iz!=depth; ++iz)
+	for(std::size_t z=0; z!=depth; ++z)
 	{
-		std::size_t z = iz;
-		std::size_t plane_offs = width*height*z*channels;
 		for(std::size_t iy=0; iy!=height; ++iy)
 		{
 			std::size_t y = y_is_up ? iy : (height-iy-1);
-			std::size_t row_offs = plane_offs+height*y*channels;
+			unsigned char* row = data+((z*height+y)*width)*channels;
 			for(std::size_t ix=0; ix!=width; ++ix)
 			{
 				std::size_t x = x_is_right ? ix : (width-ix-1);
-				std::size_t cur_offs = row_offs+x*channels;
-				char b;
-				do
+
+				while((pos != end) && ((*pos == '\n') || (*pos == '\r')))
 				{
-					if(!input.get(b).good())
-					{
-						throw std::runtime_error(
-							"Unexpected end of XPM pixel data"
-						);
-					}
+					++pos;
 				}
-				while((b == '\n') || (b == '\r'));
-
-				std::string code(1, b);
-
-				std::size_t todo = chpp;
-
-				while(--todo != 0)
+				if(std::size_t(end-pos) < chpp)
 				{
-					if(!input.get(b).good())
-					{
-						throw std::runtime_error(
-							"Unexpected end of XPM pixel data"
-						);
-					}
-					code.append(1, b);
+					throw std::runtime_error(
+						"Unexpected end of XPM pixel data"
+					);
 				}
-
-				auto p = palette.find(code);
-				if(p == palette.end())
+				const std::uint32_t i = palette.Find(palette.Key(pos));
+				if(XPMPalette::IsNone(i))
 				{
 					throw std::runtime_error(
 						"Color code '" +
-						code +
+						std::string(pos, chpp) +
 						"' not found in XPM palette"
 					);
 				}
+				pos += chpp;
+
+				const unsigned char* src = palette.colors.data()+i*4;
+				unsigned char* dst = row+x*channels;
 				for(std::size_t c=0; c!=channels; ++c)
 				{
-					data[cur_offs+c] = p->second[c];
+					dst[c] = src[c];
 				}
 			}
 		}
@@ -555,7 +614,8 @@ void xpm_load(
 		height,
 		depth,
 		channels,
-		data.data(),
+		static_cast<const unsigned char*>(nullptr),
+		std::move(storage),
 		PixelDataFormat(gl_format),
 		PixelDataInternalFormat(gl_format)
 	);
@@ -566,17 +626,34 @@ void xpm_load(
 OGLPLUS_LIB_FUNC
 XPMImage::XPMImage(std::istream& input, bool y_is_up, bool x_is_right)
 {
-	std::map<std::string, std::string> color_names;
-	color_names["black"] = "#000000";
-	color_names["gray"] = "#808080";
-	color_names["white"] = "#FFFFFF";
-	color_names["red"] = "#FF0000";
-	color_names["green"] = "#00FF00";
-	color_names["blue"] = "#0000FF";
-	color_names["yellow"] = "#FFFF00";
-	color_names["magenta"] = "#FF00FF";
-	color_names["cyan"] = "#00FFFF";
-	aux::xpm_load(input, *this, color_names, y_is_up, x_is_right);
+	std::vector<char> buffer;
+	const std::size_t chunk = 64*1024;
+	std::size_t size = 0;
+	do
+	{
+		buffer.resize(size+chunk);
+		input.read(buffer.data()+size, std::streamsize(chunk));
+		size += std::size_t(input.gcount());
+	}
+	while(input.good());
+	aux::xpm_load(
+		buffer.data(),
+		buffer.data()+size,
+		*this,
+		y_is_up,
+		x_is_right
+	);
+}
+
+OGLPLUS_LIB_FUNC
+XPMImage::XPMImage(
+	const char* data,
+	std::size_t size,
+	bool y_is_up,
+	bool x_is_right
+)
+{
+	aux::xpm_load(data, data+size, *this, y_is_up, x_is_right);
 }
 
 } // images
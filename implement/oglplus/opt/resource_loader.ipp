@@ -0,0 +1,257 @@
+/**
+ *  @file oglplus/opt/resource_loader.ipp
+ *  @brief Implementation of the asynchronous ResourceLoader
+ *
+ *  @author Matus Chochlik
+ *
+ *  Copyright 2010-2015 Matus Chochlik. Distributed under the Boost
+ *  Software License, Version 1.0. (See accompanying file
+ *  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include <oglplus/lib/incl_begin.ipp>
+#include <oglplus/opt/resources.hpp>
+#include <oglplus/detail/parallel_for.hpp>
+#include <oglplus/lib/incl_end.ipp>
+
+#include <stdexcept>
+
+namespace oglplus {
+
+OGLPLUS_LIB_FUNC
+ResourceLoader::ResourceLoader(unsigned max_threads)
+ : _sequence(0)
+#if !OGLPLUS_NO_THREADS
+ , _stop(false)
+#endif
+{
+#if !OGLPLUS_NO_THREADS
+	const unsigned n = aux::ParallelThreadCount(max_threads);
+	_stop_on_scope_exit cleaner = { this };
+	_threads.reserve(n);
+	for(unsigned t=0; t!=n; ++t)
+	{
+		_threads.push_back(std::thread(&ResourceLoader::_work, this));
+	}
+	cleaner.loader = nullptr;
+#else
+	OGLPLUS_FAKE_USE(max_threads);
+#endif
+}
+
+OGLPLUS_LIB_FUNC
+ResourceLoader::~ResourceLoader(void)
+{
+#if !OGLPLUS_NO_THREADS
+	_stop_threads();
+#endif
+}
+
+#if !OGLPLUS_NO_THREADS
+OGLPLUS_LIB_FUNC
+void ResourceLoader::_stop_threads(void)
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stop = true;
+	}
+	_wake.notify_all();
+	for(auto& thread : _threads)
+	{
+		thread.join();
+	}
+}
+
+OGLPLUS_LIB_FUNC
+void ResourceLoader::_work(void)
+{
+	while(true)
+	{
+		_task_ptr task;
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_wake.wait(
+				lock,
+				[this](void) { return _stop || !_queue.empty(); }
+			);
+			if(_stop) return;
+			task = _queue.top().task;
+			_queue.pop();
+			// the request was queued again with a higher priority
+			// and has already been started from the other entry
+			if(task->started) continue;
+			task->started = true;
+		}
+		// the packaged task stores the exceptions in the future
+		task->run();
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_finish(task);
+			if(_tasks.empty()) _idle.notify_all();
+		}
+	}
+}
+#endif
+
+OGLPLUS_LIB_FUNC
+void ResourceLoader::_finish(const _task_ptr& task)
+{
+	auto pos = _tasks.find(task->key);
+	if((pos != _tasks.end()) && (pos->second == task))
+	{
+		_tasks.erase(pos);
+	}
+	const std::shared_ptr<void> future = task->future;
+	for(const _callback& callback : task->callbacks)
+	{
+		_completed.push_back(
+			[callback, future](void) { callback(future); }
+		);
+	}
+	task->callbacks.clear();
+}
+
+OGLPLUS_LIB_FUNC
+ResourceLoader::_task_ptr ResourceLoader::_submit(
+	const std::string& key,
+	int priority,
+	const std::function<_task_ptr(void)>& make,
+	const _callback& callback
+)
+{
+#if !OGLPLUS_NO_THREADS
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	auto pos = _tasks.find(key);
+	if(pos != _tasks.end())
+	{
+		_task_ptr task = pos->second;
+		if(callback) task->callbacks.push_back(callback);
+		if(!task->started && (task->priority < priority))
+		{
+			// the old entry is skipped when it gets to the top
+			task->priority = priority;
+			_queue.push(_entry{priority, _sequence++, task});
+			_wake.notify_one();
+		}
+		return task;
+	}
+#endif
+	_task_ptr task = make();
+	task->key = key;
+	task->priority = priority;
+	task->started = false;
+	if(callback) task->callbacks.push_back(callback);
+#if !OGLPLUS_NO_THREADS
+	_tasks[key] = task;
+	_queue.push(_entry{priority, _sequence++, task});
+	_wake.notify_one();
+#else
+	task->started = true;
+	task->run();
+	_finish(task);
+#endif
+	return task;
+}
+
+OGLPLUS_LIB_FUNC
+std::shared_future<std::vector<char>> ResourceLoader::RequestFile(
+	const std::string& category,
+	const std::string& name,
+	const char* ext,
+	int priority
+)
+{
+	const std::string extension(ext);
+	return Request<std::vector<char>>(
+		category+aux::FilesysPathSep()+name+extension,
+		priority,
+		[category, name, extension](void) -> std::vector<char>
+		{
+			const char* exts = extension.c_str();
+			const char* pack_data = nullptr;
+			std::size_t pack_size = 0;
+			if(ResourceIndex::Global().FindData(
+				pack_data,
+				pack_size,
+				category,
+				name,
+				&exts,
+				1
+			) == 0)
+			{
+				return std::vector<char>(
+					pack_data,
+					pack_data+pack_size
+				);
+			}
+			ResourceFile file(category, name, exts);
+			file.seekg(0, std::ios::end);
+			const std::streamoff size = file.tellg();
+			file.seekg(0, std::ios::beg);
+			std::vector<char> data(static_cast<std::size_t>(size));
+			file.read(data.data(), std::streamsize(size));
+			if(file.fail())
+			{
+				throw std::runtime_error(
+					"Failed to read resource file '"+
+					category+
+					aux::FilesysPathSep()+
+					name+
+					extension+
+					"'"
+				);
+			}
+			return data;
+		}
+	);
+}
+
+OGLPLUS_LIB_FUNC
+std::size_t ResourceLoader::Dispatch(std::size_t max_count)
+{
+	std::vector<std::function<void(void)>> completed;
+	{
+#if !OGLPLUS_NO_THREADS
+		std::lock_guard<std::mutex> lock(_mutex);
+#endif
+		if((max_count == 0) || (max_count >= _completed.size()))
+		{
+			completed.swap(_completed);
+		}
+		else
+		{
+			auto end = _completed.begin()+std::ptrdiff_t(max_count);
+			completed.assign(_completed.begin(), end);
+			_completed.erase(_completed.begin(), end);
+		}
+	}
+	// the callbacks are called without holding the lock,
+	// so that they can make new requests
+	for(auto& callback : completed)
+	{
+		callback();
+	}
+	return completed.size();
+}
+
+OGLPLUS_LIB_FUNC
+std::size_t ResourceLoader::PendingCount(void) const
+{
+#if !OGLPLUS_NO_THREADS
+	std::lock_guard<std::mutex> lock(_mutex);
+#endif
+	return _tasks.size();
+}
+
+OGLPLUS_LIB_FUNC
+void ResourceLoader::Wait(void)
+{
+#if !OGLPLUS_NO_THREADS
+	std::unique_lock<std::mutex> lock(_mutex);
+	_idle.wait(lock, [this](void) { return _tasks.empty(); });
+#endif
+}
+
+} // namespace oglplus
+
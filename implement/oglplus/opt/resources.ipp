@@ -9,11 +9,115 @@
  *  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
  */
 
+# include <cstring>
 # include <stdexcept>
 
+#if defined(WIN32) || defined(_WIN32) || defined(WIN64) || defined(_WIN64)
+# include <io.h>
+#else
+# include <dirent.h>
+# include <sys/stat.h>
+#endif
+
 namespace oglplus {
 namespace aux {
 
+// Converts a relative resource path to the form used as a key
+// in the ResourceIndex and in ResourcePacks (with / as the separator)
+inline std::string ResourceKey(std::string path)
+{
+	const std::string sep = FilesysPathSep();
+	if(sep != "/")
+	{
+		for(char& c : path)
+		{
+			if(c == sep[0]) c = '/';
+		}
+	}
+	return path;
+}
+
+// Converts a resource key back to a native relative path
+inline std::string ResourceKeyPath(std::string key)
+{
+	const std::string sep = FilesysPathSep();
+	if(sep != "/")
+	{
+		for(char& c : key)
+		{
+			if(c == '/') c = sep[0];
+		}
+	}
+	return key;
+}
+
+// Appends the files in directory/relative to files
+OGLPLUS_LIB_FUNC
+void ListResourceFiles(
+	const std::string& directory,
+	const std::string& relative,
+	std::vector<std::string>& files
+)
+{
+	const std::string sep = FilesysPathSep();
+	const std::string path = relative.empty()?
+		directory:
+		directory+sep+ResourceKeyPath(relative);
+	const std::string prefix = relative.empty()?
+		std::string():
+		relative+'/';
+#if defined(WIN32) || defined(_WIN32) || defined(WIN64) || defined(_WIN64)
+	::_finddata_t entry;
+	intptr_t handle = ::_findfirst((path+sep+"*").c_str(), &entry);
+	if(handle == -1) return;
+	do
+	{
+		const std::string name(entry.name);
+		if((name == ".") || (name == "..")) continue;
+		if(entry.attrib & _A_SUBDIR)
+		{
+			ListResourceFiles(directory, prefix+name, files);
+		}
+		else files.push_back(prefix+name);
+	}
+	while(::_findnext(handle, &entry) == 0);
+	::_findclose(handle);
+#else
+	::DIR* dir = ::opendir(path.c_str());
+	if(!dir) return;
+	while(::dirent* entry = ::readdir(dir))
+	{
+		const std::string name(entry->d_name);
+		if((name == ".") || (name == "..")) continue;
+		const std::string entry_path = path+sep+name;
+		struct ::stat st;
+		if(::lstat(entry_path.c_str(), &st) != 0) continue;
+		if(S_ISDIR(st.st_mode))
+		{
+			ListResourceFiles(directory, prefix+name, files);
+		}
+		// the links to files are listed, but the links to directories
+		// are not followed, because they could form cycles
+		else if(S_ISLNK(st.st_mode))
+		{
+			if(	(::stat(entry_path.c_str(), &st) == 0) &&
+				S_ISREG(st.st_mode)
+			) files.push_back(prefix+name);
+		}
+		else if(S_ISREG(st.st_mode))
+		{
+			files.push_back(prefix+name);
+		}
+	}
+	::closedir(dir);
+#endif
+}
+
+inline const char* ResourcePackMagic(void)
+{
+	return "OGLPPAK1";
+}
+
 OGLPLUS_LIB_FUNC
 std::size_t FindResourceFile(
 	std::ifstream& file,
@@ -34,13 +138,27 @@ std::size_t FindResourceFile(
 
 OGLPLUS_LIB_FUNC
 std::size_t FindResourceFile(
-	std::ifstream& file,
+	std::string& found,
 	const std::string& category,
 	const std::string& name,
 	const char** exts,
 	std::size_t nexts
 )
 {
+	std::size_t iext = ResourceIndex::Global().Find(
+		found,
+		category,
+		name,
+		exts,
+		nexts
+	);
+	// the indexed file could have been removed after the index was built
+	if((iext != nexts) && std::ifstream(found, std::ios::binary).good())
+	{
+		return iext;
+	}
+
+	// or the file could have been created after the index was built
 	const std::string dirsep = aux::FilesysPathSep();
 	const std::string pardir(aux::FilesysPathParDir() + dirsep);
 	const std::string path = category+dirsep+name;
@@ -49,18 +167,47 @@ std::size_t FindResourceFile(
 
 	for(std::size_t i=0; i!=5; ++i)
 	{
-		std::size_t iext = aux::FindResourceFile(
+		std::ifstream file;
+		iext = aux::FindResourceFile(
 			file,
 			apppath+prefix+path,
 			exts,
 			nexts
 		);
-		if(iext != nexts) return iext;
+		if(iext != nexts)
+		{
+			found = apppath+prefix+path+exts[iext];
+			return iext;
+		}
 		prefix = pardir + prefix;
 	}
 	return nexts;
 }
 
+OGLPLUS_LIB_FUNC
+std::size_t FindResourceFile(
+	std::ifstream& file,
+	const std::string& category,
+	const std::string& name,
+	const char** exts,
+	std::size_t nexts
+)
+{
+	std::string path;
+	std::size_t iext = FindResourceFile(
+		path,
+		category,
+		name,
+		exts,
+		nexts
+	);
+	if(iext != nexts)
+	{
+		file.open(path, std::ios::binary);
+	}
+	return iext;
+}
+
 OGLPLUS_LIB_FUNC
 ResourceFile::ResourceFile(
 	const std::string& category,
@@ -81,5 +228,333 @@ ResourceFile::ResourceFile(
 	}
 }
 
+OGLPLUS_LIB_FUNC
+ResourcePack::ResourcePack(const std::string& path)
+{
+	std::ifstream file(path, std::ios::in | std::ios::binary);
+	if(!file.good())
+	{
+		throw std::runtime_error(
+			"Unable to open resource pack '"+path+"'"
+		);
+	}
+	file.seekg(0, std::ios::end);
+	const std::size_t file_size = std::size_t(file.tellg());
+	file.close();
+
+	const std::size_t header_size = 16;
+	const std::size_t entry_size = 20;
+	auto invalid = [&path](void) -> std::runtime_error
+	{
+		return std::runtime_error(
+			"Invalid resource pack '"+path+"'"
+		);
+	};
+	if(file_size < header_size) throw invalid();
+
+	_data = aux::AlignedPODArray::MapFile<char>(
+		path.c_str(),
+		0,
+		file_size
+	);
+	const char* base = static_cast<const char*>(_data.begin());
+	if(std::memcmp(base, aux::ResourcePackMagic(), 8) != 0)
+	{
+		throw invalid();
+	}
+	std::uint64_t count;
+	std::memcpy(&count, base+8, 8);
+
+	std::size_t pos = header_size;
+	for(std::uint64_t i=0; i!=count; ++i)
+	{
+		if(file_size-pos < entry_size) throw invalid();
+		std::uint64_t offset, size;
+		std::uint32_t length;
+		std::memcpy(&offset, base+pos+ 0, 8);
+		std::memcpy(&size,   base+pos+ 8, 8);
+		std::memcpy(&length, base+pos+16, 4);
+		pos += entry_size;
+		if(	(file_size-pos < length) ||
+			(offset > file_size) ||
+			(size > file_size-offset)
+		) throw invalid();
+		_entry entry = {std::size_t(offset), std::size_t(size)};
+		_entries[std::string(base+pos, length)] = entry;
+		pos += length;
+	}
+}
+
+OGLPLUS_LIB_FUNC
+bool ResourcePack::Find(
+	const std::string& path,
+	const char*& data,
+	std::size_t& size
+) const
+{
+	auto pos = _entries.find(path);
+	if(pos == _entries.end()) return false;
+	data = static_cast<const char*>(_data.begin())+pos->second.offset;
+	size = pos->second.size;
+	return true;
+}
+
+OGLPLUS_LIB_FUNC
+void ResourcePack::Write(
+	const std::string& path,
+	const std::string& root,
+	const std::vector<std::string>& files
+)
+{
+	const std::string sep = aux::FilesysPathSep();
+	// the data of the resources is aligned to 16 bytes
+	const std::size_t align = 16;
+
+	std::vector<std::uint64_t> sizes;
+	sizes.reserve(files.size());
+	std::size_t offset = 16;
+	for(const std::string& file : files)
+	{
+		const std::string file_path = root+sep+aux::ResourceKeyPath(file);
+		std::ifstream input(file_path, std::ios::in | std::ios::binary);
+		if(!input.good())
+		{
+			throw std::runtime_error(
+				"Unable to open resource file '"+file_path+"'"
+			);
+		}
+		input.seekg(0, std::ios::end);
+		sizes.push_back(std::uint64_t(input.tellg()));
+		offset += 20+file.size();
+	}
+
+	std::ofstream output(path, std::ios::out | std::ios::binary);
+	if(!output.good())
+	{
+		throw std::runtime_error(
+			"Unable to create resource pack '"+path+"'"
+		);
+	}
+	const std::uint64_t count = files.size();
+	output.write(aux::ResourcePackMagic(), 8);
+	output.write(reinterpret_cast<const char*>(&count), 8);
+
+	std::size_t data_offset = (offset+align-1)/align*align;
+	for(std::size_t i=0; i!=files.size(); ++i)
+	{
+		const std::uint64_t entry_offset = data_offset;
+		const std::uint32_t length = std::uint32_t(files[i].size());
+		output.write(reinterpret_cast<const char*>(&entry_offset), 8);
+		output.write(reinterpret_cast<const char*>(&sizes[i]), 8);
+		output.write(reinterpret_cast<const char*>(&length), 4);
+		output.write(files[i].data(), std::streamsize(length));
+		data_offset += (std::size_t(sizes[i])+align-1)/align*align;
+	}
+
+	const char padding[align] = {0};
+	for(std::size_t i=0; i!=files.size(); ++i)
+	{
+		// offset is the end of the previous resource (or of the index)
+		// relative to an aligned position
+		output.write(padding, std::streamsize((align-offset%align)%align));
+		std::ifstream input(
+			root+sep+aux::ResourceKeyPath(files[i]),
+			std::ios::in | std::ios::binary
+		);
+		if(sizes[i] > 0) output << input.rdbuf();
+		offset = std::size_t(sizes[i]);
+	}
+	output.close();
+	if(!output.good())
+	{
+		throw std::runtime_error(
+			"Failed to write resource pack '"+path+"'"
+		);
+	}
+}
+
+OGLPLUS_LIB_FUNC
+ResourceIndex& ResourceIndex::Global(void)
+{
+	static ResourceIndex index;
+	return index;
+}
+
+OGLPLUS_LIB_FUNC
+std::vector<std::string> ResourceIndex::_roots(void)
+{
+	const std::string pardir(
+		aux::FilesysPathParDir()+
+		aux::FilesysPathSep()
+	);
+	// the same directories as searched by FindResourceFile
+	std::vector<std::string> result;
+	std::string prefix;
+	for(std::size_t i=0; i!=5; ++i)
+	{
+		result.push_back(Application::RelativePath()+prefix);
+		prefix = pardir+prefix;
+	}
+	return result;
+}
+
+OGLPLUS_LIB_FUNC
+const ResourceIndex::_category& ResourceIndex::_get(
+	const std::string& category
+)
+{
+	// the index is built again if the application path changes
+	if(_app_path != Application::RelativePath())
+	{
+		_app_path = Application::RelativePath();
+		_categories.clear();
+	}
+	auto pos = _categories.find(category);
+	if(pos != _categories.end()) return pos->second;
+
+	_category& result = _categories[category];
+	const std::string sep = aux::FilesysPathSep();
+	const std::vector<std::string> roots = _roots();
+	for(std::size_t r=0; r!=roots.size(); ++r)
+	{
+		const std::string directory = roots[r]+category;
+		std::vector<std::string> files;
+		std::ifstream manifest(directory+sep+ManifestName());
+		if(manifest.good())
+		{
+			std::string line;
+			while(std::getline(manifest, line))
+			{
+				if(!line.empty() && (line.back() == '\r'))
+				{
+					line.pop_back();
+				}
+				if(line.empty() || (line[0] == '#')) continue;
+				files.push_back(line);
+			}
+		}
+		else ListFiles(directory, files);
+
+		for(const std::string& file : files)
+		{
+			if(result.find(file) == result.end())
+			{
+				_file entry = {
+					r,
+					directory+sep+aux::ResourceKeyPath(file)
+				};
+				result[file] = entry;
+			}
+		}
+	}
+	return result;
+}
+
+OGLPLUS_LIB_FUNC
+std::size_t ResourceIndex::Find(
+	std::string& path,
+	const std::string& category,
+	const std::string& name,
+	const char** exts,
+	std::size_t nexts
+)
+{
+	const std::string key = aux::ResourceKey(name);
+#if !OGLPLUS_NO_THREADS
+	std::lock_guard<std::mutex> lock(_mutex);
+#endif
+	const _category& files = _get(category);
+
+	std::size_t result = nexts;
+	std::size_t root = 0;
+	for(std::size_t e=0; e!=nexts; ++e)
+	{
+		auto pos = files.find(key+exts[e]);
+		if(pos == files.end()) continue;
+		if((result == nexts) || (pos->second.root < root))
+		{
+			result = e;
+			root = pos->second.root;
+			path = pos->second.path;
+		}
+	}
+	return result;
+}
+
+OGLPLUS_LIB_FUNC
+std::size_t ResourceIndex::FindData(
+	const char*& data,
+	std::size_t& size,
+	const std::string& category,
+	const std::string& name,
+	const char** exts,
+	std::size_t nexts
+) const
+{
+	const std::string key = aux::ResourceKey(category+'/'+name);
+#if !OGLPLUS_NO_THREADS
+	std::lock_guard<std::mutex> lock(_mutex);
+#endif
+	for(std::size_t e=0; e!=nexts; ++e)
+	{
+		for(const auto& pack : _packs)
+		{
+			if(pack->Find(key+exts[e], data, size)) return e;
+		}
+	}
+	return nexts;
+}
+
+OGLPLUS_LIB_FUNC
+void ResourceIndex::AddPack(const std::string& path)
+{
+	auto pack = std::make_shared<const ResourcePack>(path);
+#if !OGLPLUS_NO_THREADS
+	std::lock_guard<std::mutex> lock(_mutex);
+#endif
+	_packs.push_back(pack);
+}
+
+OGLPLUS_LIB_FUNC
+void ResourceIndex::Refresh(void)
+{
+#if !OGLPLUS_NO_THREADS
+	std::lock_guard<std::mutex> lock(_mutex);
+#endif
+	_categories.clear();
+}
+
+OGLPLUS_LIB_FUNC
+void ResourceIndex::ListFiles(
+	const std::string& directory,
+	std::vector<std::string>& files
+)
+{
+	aux::ListResourceFiles(directory, std::string(), files);
+}
+
+OGLPLUS_LIB_FUNC
+void ResourceIndex::WriteManifest(const std::string& category_dir)
+{
+	std::vector<std::string> files;
+	ListFiles(category_dir, files);
+	const std::string path =
+		category_dir+
+		aux::FilesysPathSep()+
+		ManifestName();
+	std::ofstream manifest(path);
+	for(const std::string& file : files)
+	{
+		if(file != ManifestName()) manifest << file << '\n';
+	}
+	manifest.close();
+	if(!manifest.good())
+	{
+		throw std::runtime_error(
+			"Failed to write resource manifest '"+path+"'"
+		);
+	}
+}
+
 } // namespace oglplus
 
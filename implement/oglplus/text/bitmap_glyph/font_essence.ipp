@@ -11,8 +11,11 @@
 
 #include <oglplus/lib/incl_begin.ipp>
 #include <oglplus/images/load.hpp>
+#include <oglplus/detail/parallel_for.hpp>
 #include <oglplus/lib/incl_end.ipp>
 
+#include <memory>
+
 namespace oglplus {
 namespace text {
 
@@ -135,6 +138,39 @@ std::vector<GLfloat> BitmapGlyphFontEssence::_load_page_metric(GLuint page)
 	return metrics;
 }
 
+OGLPLUS_LIB_FUNC
+void BitmapGlyphFontEssence::_load_pages(const std::vector<GLuint>& pages)
+{
+	const std::size_t n = pages.size();
+	std::vector<std::unique_ptr<oglplus::images::Image>> bitmaps(n);
+	std::vector<std::vector<GLfloat>> metrics(n);
+	// the bitmaps and the metrics are read and decoded in parallel
+	aux::ParallelFor(
+		n,
+		1,
+		[&](std::size_t begin, std::size_t end)
+		{
+			for(std::size_t i=begin; i!=end; ++i)
+			{
+				bitmaps[i].reset(new oglplus::images::Image(
+					_load_page_bitmap(pages[i])
+				));
+				metrics[i] = _load_page_metric(pages[i]);
+			}
+		}
+	);
+	// but the textures are updated by the calling thread
+	for(std::size_t i=0; i!=n; ++i)
+	{
+		// let the pager find a frame for the new page
+		auto frame = _pager.FindFrame();
+		_page_storage.LoadPage(frame, *bitmaps[i], metrics[i]);
+		// tell the pager that the page
+		// is successfully loaded in the frame
+		_pager.SwapPageIn(frame, pages[i]);
+	}
+}
+
 OGLPLUS_LIB_FUNC
 GLfloat BitmapGlyphFontEssence::QueryXOffsets(
 	const CodePoint* cps,
@@ -12,6 +12,14 @@
 #include <oglplus/lib/incl_begin.ipp>
 #include <oglplus/images/image_spec.hpp>
 #include <oglplus/images/image.hpp>
+#include <oglplus/images/view.hpp>
+#include <oglplus/images/mipmap.hpp>
+#include <oglplus/images/cube_map.hpp>
+#include <oglplus/images/compressed.hpp>
+#include <oglplus/images/container.hpp>
+#include <oglplus/images/tile_cache.hpp>
+#include <oglplus/images/sparse.hpp>
+#include <oglplus/detail/unpack_params.hpp>
 #include <oglplus/lib/incl_end.ipp>
 
 namespace oglplus {
@@ -436,6 +444,463 @@ SubImage2D(
 	);
 }
 
+OGLPLUS_LIB_FUNC
+void ObjZeroOps<tag::ExplicitSel, tag::Texture>::
+Image3D(
+	Target target,
+	const images::ImageView& image,
+	GLint level,
+	GLint border
+)
+{
+	aux::ImageViewUnpackParams unpack(image, true);
+	Image3D(
+		target,
+		level,
+		image.InternalFormat(),
+		image.Width(),
+		image.Height(),
+		image.Depth(),
+		border,
+		image.Format(),
+		image.Type(),
+		image.RawData()
+	);
+}
+
+OGLPLUS_LIB_FUNC
+void ObjZeroOps<tag::ExplicitSel, tag::Texture>::
+SubImage3D(
+	Target target,
+	const images::ImageView& image,
+	GLint xoffs,
+	GLint yoffs,
+	GLint zoffs,
+	GLint level
+)
+{
+	aux::ImageViewUnpackParams unpack(image, true);
+	SubImage3D(
+		target,
+		level,
+		xoffs,
+		yoffs,
+		zoffs,
+		image.Width(),
+		image.Height(),
+		image.Depth(),
+		image.Format(),
+		image.Type(),
+		image.RawData()
+	);
+}
+
+namespace aux {
+
+// Calls upload(view, x, y, z) for the parts of the tiles intersecting
+// the specified region, the tiles are made a row of tiles at a time
+template <typename Upload>
+void TextureStreamTiles(
+	images::ImageTileCache& cache,
+	GLint level,
+	GLint xoffs,
+	GLint yoffs,
+	GLint zoffs,
+	GLsizei width,
+	GLsizei height,
+	GLsizei depth,
+	Upload upload
+)
+{
+	if((width <= 0) || (height <= 0) || (depth <= 0)) return;
+
+	const GLint tw = GLint(cache.TileWidth());
+	const GLint th = GLint(cache.TileHeight());
+	const GLint td = GLint(cache.TileDepth());
+	const GLint x1 = xoffs+width;
+	const GLint y1 = yoffs+height;
+	const GLint z1 = zoffs+depth;
+
+	// the tiles are tightly packed
+	UnpackAlignmentParam alignment(1);
+
+	for(GLint tz=zoffs/td; tz*td < z1; ++tz)
+	{
+		const GLint bz = std::max(zoffs, tz*td);
+		const GLint ez = std::min(z1, (tz+1)*td);
+		for(GLint ty=yoffs/th; ty*th < y1; ++ty)
+		{
+			const GLint by = std::max(yoffs, ty*th);
+			const GLint ey = std::min(y1, (ty+1)*th);
+			cache.Prefetch(
+				level,
+				xoffs, by, bz,
+				width, ey-by, ez-bz
+			);
+			for(GLint tx=xoffs/tw; tx*tw < x1; ++tx)
+			{
+				const GLint bx = std::max(xoffs, tx*tw);
+				const GLint ex = std::min(x1, (tx+1)*tw);
+				images::ImageTileCache::TilePtr tile =
+					cache.Tile(level, tx, ty, tz);
+				upload(
+					images::ImageView(*tile).Region(
+						bx-tx*tw,
+						by-ty*th,
+						bz-tz*td,
+						ex-bx,
+						ey-by,
+						ez-bz
+					),
+					bx, by, bz
+				);
+			}
+		}
+	}
+}
+
+} // namespace aux
+
+OGLPLUS_LIB_FUNC
+void ObjZeroOps<tag::ExplicitSel, tag::Texture>::
+SubImage3D(
+	Target target,
+	images::ImageTileCache& cache,
+	GLint level,
+	GLint xoffs,
+	GLint yoffs,
+	GLint zoffs,
+	SizeType width,
+	SizeType height,
+	SizeType depth
+)
+{
+	aux::TextureStreamTiles(
+		cache,
+		level,
+		xoffs, yoffs, zoffs,
+		width, height, depth,
+		[&](const images::ImageView& view, GLint x, GLint y, GLint z)
+		{
+			SubImage3D(target, view, x, y, z, level);
+		}
+	);
+}
+
+OGLPLUS_LIB_FUNC
+void ObjZeroOps<tag::ExplicitSel, tag::Texture>::
+SubImage3D(
+	Target target,
+	const images::SparseImage& image,
+	GLint xoffs,
+	GLint yoffs,
+	GLint zoffs,
+	GLint level
+)
+{
+	const GLint s = image.BrickSize();
+	image.ForEachBrick(
+		[&](GLint bx, GLint by, GLint bz, const images::ImageView& view)
+		{
+			SubImage3D(
+				target,
+				view,
+				xoffs+bx*s,
+				yoffs+by*s,
+				zoffs+bz*s,
+				level
+			);
+		}
+	);
+}
+
+OGLPLUS_LIB_FUNC
+void ObjZeroOps<tag::ExplicitSel, tag::Texture>::
+Image2D(
+	Target target,
+	const images::ImageView& image,
+	GLint level,
+	GLint border
+)
+{
+	assert(image.Depth() == 1);
+	aux::ImageViewUnpackParams unpack(image, false);
+	Image2D(
+		target,
+		level,
+		image.InternalFormat(),
+		image.Width(),
+		image.Height(),
+		border,
+		image.Format(),
+		image.Type(),
+		image.RawData()
+	);
+}
+
+OGLPLUS_LIB_FUNC
+void ObjZeroOps<tag::ExplicitSel, tag::Texture>::
+Image2D(
+	Target target,
+	const images::MipmapChain& chain,
+	GLint border
+)
+{
+	assert(chain.Levels() > 0);
+	for(std::size_t level=0; level!=chain.Levels(); ++level)
+	{
+		Image2D(target, chain.Level(level), GLint(level), border);
+	}
+	MaxLevel(target, GLint(chain.Levels()-1));
+}
+
+OGLPLUS_LIB_FUNC
+void ObjZeroOps<tag::ExplicitSel, tag::Texture>::
+Image2D(
+	Target target,
+	const images::PrefilteredCubeMap& cube_map
+)
+{
+	assert(target == Target::CubeMap);
+	assert(cube_map.Levels() > 0);
+	for(std::size_t level=0; level!=cube_map.Levels(); ++level)
+	{
+		const images::ImageView view(cube_map.Level(level));
+		for(GLuint face=0; face!=6; ++face)
+		{
+			ImageCM(face, view.Slice(GLsizei(face)), GLint(level));
+		}
+	}
+	MaxLevel(target, GLint(cube_map.Levels()-1));
+}
+
+OGLPLUS_LIB_FUNC
+void ObjZeroOps<tag::ExplicitSel, tag::Texture>::
+Image2D(
+	Target target,
+	const images::TextureContainer& container
+)
+{
+	assert(!container.IsArray());
+	assert(container.Depth() == 1);
+	aux::UnpackAlignmentParam alignment(container.RowAlignment());
+
+	for(GLsizei level=0; level!=container.Levels(); ++level)
+	{
+		for(GLsizei face=0; face!=container.Faces(); ++face)
+		{
+			Target face_target = container.IsCubeMap()?
+				Target(GL_TEXTURE_CUBE_MAP_POSITIVE_X+face):
+				target;
+			if(container.IsCompressed())
+			{
+				CompressedImage2D(
+					face_target,
+					level,
+					container.InternalFormat(),
+					container.Width(level),
+					container.Height(level),
+					0,
+					container.DataSize(level, 0, face),
+					container.RawData(level, 0, face)
+				);
+			}
+			else
+			{
+				Image2D(
+					face_target,
+					level,
+					container.InternalFormat(),
+					container.Width(level),
+					container.Height(level),
+					0,
+					container.Format(),
+					container.Type(),
+					container.RawData(level, 0, face)
+				);
+			}
+		}
+	}
+	MaxLevel(target, container.Levels()-1);
+}
+
+OGLPLUS_LIB_FUNC
+void ObjZeroOps<tag::ExplicitSel, tag::Texture>::
+Image3D(
+	Target target,
+	const images::TextureContainer& container
+)
+{
+	aux::UnpackAlignmentParam alignment(container.RowAlignment());
+
+	const GLsizei slices = container.Layers()*container.Faces();
+	for(GLsizei level=0; level!=container.Levels(); ++level)
+	{
+		const GLsizei depth = (slices > 1)?
+			slices:
+			GLsizei(container.Depth(level));
+		const SizeType size_z = MakeSizeType(depth, std::nothrow);
+		if(container.IsCompressed())
+		{
+			CompressedImage3D(
+				target,
+				level,
+				container.InternalFormat(),
+				container.Width(level),
+				container.Height(level),
+				size_z,
+				0,
+				container.LevelDataSize(level),
+				nullptr
+			);
+		}
+		else
+		{
+			Image3D(
+				target,
+				level,
+				container.InternalFormat(),
+				container.Width(level),
+				container.Height(level),
+				size_z,
+				0,
+				container.Format(),
+				container.Type(),
+				nullptr
+			);
+		}
+		for(GLsizei layer=0; layer!=container.Layers(); ++layer)
+		{
+			for(GLsizei face=0; face!=container.Faces(); ++face)
+			{
+				const GLsizei z = layer*container.Faces()+face;
+				const SizeType size_1 = (slices > 1)?
+					MakeSizeType(1, std::nothrow):
+					size_z;
+				if(container.IsCompressed())
+				{
+					CompressedSubImage3D(
+						target,
+						level,
+						0, 0, z,
+						container.Width(level),
+						container.Height(level),
+						size_1,
+						PixelDataFormat(GLenum(
+							container.InternalFormat()
+						)),
+						container.DataSize(level, layer, face),
+						container.RawData(level, layer, face)
+					);
+				}
+				else
+				{
+					SubImage3D(
+						target,
+						level,
+						0, 0, z,
+						container.Width(level),
+						container.Height(level),
+						size_1,
+						container.Format(),
+						container.Type(),
+						container.RawData(level, layer, face)
+					);
+				}
+			}
+		}
+	}
+	MaxLevel(target, container.Levels()-1);
+}
+
+OGLPLUS_LIB_FUNC
+void ObjZeroOps<tag::ExplicitSel, tag::Texture>::
+CompressedImage2D(
+	Target target,
+	const images::CompressedImage& image,
+	GLint level,
+	GLint border
+)
+{
+	CompressedImage2D(
+		target,
+		level,
+		image.InternalFormat(),
+		image.Width(),
+		image.Height(),
+		border,
+		image.DataSize(),
+		image.RawData()
+	);
+}
+
+OGLPLUS_LIB_FUNC
+void ObjZeroOps<tag::ExplicitSel, tag::Texture>::
+ImageCM(
+	GLuint face,
+	const images::ImageView& image,
+	GLint level,
+	GLint border
+)
+{
+	assert(face <= 5);
+	Image2D(
+		Target(GL_TEXTURE_CUBE_MAP_POSITIVE_X+face),
+		image,
+		level,
+		border
+	);
+}
+
+OGLPLUS_LIB_FUNC
+void ObjZeroOps<tag::ExplicitSel, tag::Texture>::
+SubImage2D(
+	Target target,
+	const images::ImageView& image,
+	GLint xoffs,
+	GLint yoffs,
+	GLint level
+)
+{
+	assert(image.Depth() == 1);
+	aux::ImageViewUnpackParams unpack(image, false);
+	SubImage2D(
+		target,
+		level,
+		xoffs,
+		yoffs,
+		image.Width(),
+		image.Height(),
+		image.Format(),
+		image.Type(),
+		image.RawData()
+	);
+}
+
+OGLPLUS_LIB_FUNC
+void ObjZeroOps<tag::ExplicitSel, tag::Texture>::
+SubImage2D(
+	Target target,
+	images::ImageTileCache& cache,
+	GLint level,
+	GLint xoffs,
+	GLint yoffs,
+	SizeType width,
+	SizeType height
+)
+{
+	aux::TextureStreamTiles(
+		cache,
+		level,
+		xoffs, yoffs, 0,
+		width, height, 1,
+		[&](const images::ImageView& view, GLint x, GLint y, GLint)
+		{
+			SubImage2D(target, view, x, y, level);
+		}
+	);
+}
+
 #if GL_VERSION_3_0
 
 OGLPLUS_LIB_FUNC
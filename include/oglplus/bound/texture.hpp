@@ -493,6 +493,40 @@ public:
 	}
 
 
+	/** Wrapper for Texture::Image3D()
+	 *  @see Texture::Image3D()
+	 */
+	const BoundObjOps& Image3D(
+		const images::ImageView & image,
+		GLint level = 0,
+		GLint border = 0
+	) const
+	{
+		ExplicitOps::Image3D(
+			this->target,
+			image,
+			level,
+			border
+		);
+		return *this;
+	}
+
+
+	/** Wrapper for Texture::Image3D()
+	 *  @see Texture::Image3D()
+	 */
+	const BoundObjOps& Image3D(
+		const images::TextureContainer & container
+	) const
+	{
+		ExplicitOps::Image3D(
+			this->target,
+			container
+		);
+		return *this;
+	}
+
+
 	/** Wrapper for Texture::SubImage3D()
 	 *  @see Texture::SubImage3D()
 	 */
@@ -549,6 +583,81 @@ public:
 	}
 
 
+	/** Wrapper for Texture::SubImage3D()
+	 *  @see Texture::SubImage3D()
+	 */
+	const BoundObjOps& SubImage3D(
+		const images::ImageView & image,
+		GLint xoffs,
+		GLint yoffs,
+		GLint zoffs,
+		GLint level = 0
+	) const
+	{
+		ExplicitOps::SubImage3D(
+			this->target,
+			image,
+			xoffs,
+			yoffs,
+			zoffs,
+			level
+		);
+		return *this;
+	}
+
+
+	/** Wrapper for Texture::SubImage3D()
+	 *  @see Texture::SubImage3D()
+	 */
+	const BoundObjOps& SubImage3D(
+		images::ImageTileCache & cache,
+		GLint level,
+		GLint xoffs,
+		GLint yoffs,
+		GLint zoffs,
+		SizeType width,
+		SizeType height,
+		SizeType depth
+	) const
+	{
+		ExplicitOps::SubImage3D(
+			this->target,
+			cache,
+			level,
+			xoffs,
+			yoffs,
+			zoffs,
+			width,
+			height,
+			depth
+		);
+		return *this;
+	}
+
+
+	/** Wrapper for Texture::SubImage3D()
+	 *  @see Texture::SubImage3D()
+	 */
+	const BoundObjOps& SubImage3D(
+		const images::SparseImage & image,
+		GLint xoffs,
+		GLint yoffs,
+		GLint zoffs,
+		GLint level = 0
+	) const
+	{
+		ExplicitOps::SubImage3D(
+			this->target,
+			image,
+			xoffs,
+			yoffs,
+			zoffs,
+			level
+		);
+		return *this;
+	}
+
+
 	/** Wrapper for Texture::Image2D()
 	 *  @see Texture::Image2D()
 	 */
@@ -597,6 +706,72 @@ public:
 	}
 
 
+	/** Wrapper for Texture::Image2D()
+	 *  @see Texture::Image2D()
+	 */
+	const BoundObjOps& Image2D(
+		const images::ImageView & image,
+		GLint level = 0,
+		GLint border = 0
+	) const
+	{
+		ExplicitOps::Image2D(
+			this->target,
+			image,
+			level,
+			border
+		);
+		return *this;
+	}
+
+
+	/** Wrapper for Texture::Image2D()
+	 *  @see Texture::Image2D()
+	 */
+	const BoundObjOps& Image2D(
+		const images::MipmapChain & chain,
+		GLint border = 0
+	) const
+	{
+		ExplicitOps::Image2D(
+			this->target,
+			chain,
+			border
+		);
+		return *this;
+	}
+
+
+	/** Wrapper for Texture::Image2D()
+	 *  @see Texture::Image2D()
+	 */
+	const BoundObjOps& Image2D(
+		const images::PrefilteredCubeMap & cube_map
+	) const
+	{
+		ExplicitOps::Image2D(
+			this->target,
+			cube_map
+		);
+		return *this;
+	}
+
+
+	/** Wrapper for Texture::Image2D()
+	 *  @see Texture::Image2D()
+	 */
+	const BoundObjOps& Image2D(
+		const images::TextureContainer & container
+	) const
+	{
+		ExplicitOps::Image2D(
+			this->target,
+			container
+		);
+		return *this;
+	}
+
+
 	/** Wrapper for Texture::SubImage2D()
 	 *  @see Texture::SubImage2D()
 	 */
@@ -647,6 +822,52 @@ public:
 	}
 
 
+	/** Wrapper for Texture::SubImage2D()
+	 *  @see Texture::SubImage2D()
+	 */
+	const BoundObjOps& SubImage2D(
+		const images::ImageView & image,
+		GLint xoffs,
+		GLint yoffs,
+		GLint level = 0
+	) const
+	{
+		ExplicitOps::SubImage2D(
+			this->target,
+			image,
+			xoffs,
+			yoffs,
+			level
+		);
+		return *this;
+	}
+
+
+	/** Wrapper for Texture::SubImage2D()
+	 *  @see Texture::SubImage2D()
+	 */
+	const BoundObjOps& SubImage2D(
+		images::ImageTileCache & cache,
+		GLint level,
+		GLint xoffs,
+		GLint yoffs,
+		SizeType width,
+		SizeType height
+	) const
+	{
+		ExplicitOps::SubImage2D(
+			this->target,
+			cache,
+			level,
+			xoffs,
+			yoffs,
+			width,
+			height
+		);
+		return *this;
+	}
+
+
 	/** Wrapper for Texture::Image1D()
 	 *  @see Texture::Image1D()
 	 */
@@ -962,6 +1183,25 @@ public:
 	}
 
 
+	/** Wrapper for Texture::CompressedImage2D()
+	 *  @see Texture::CompressedImage2D()
+	 */
+	const BoundObjOps& CompressedImage2D(
+		const images::CompressedImage & image,
+		GLint level = 0,
+		GLint border = 0
+	) const
+	{
+		ExplicitOps::CompressedImage2D(
+			this->target,
+			image,
+			level,
+			border
+		);
+		return *this;
+	}
+
+
 	/** Wrapper for Texture::CompressedImage1D()
 	 *  @see Texture::CompressedImage1D()
 	 */
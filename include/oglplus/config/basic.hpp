@@ -86,6 +86,23 @@
 # endif
 #endif
 
+#if OGLPLUS_DOCUMENTATION_ONLY
+/// Compile-time option specifying the alignment of image data
+/** The storage of image pixel data (see @ref oglplus::images::Image)
+ *  is allocated at an address which is a multiple of this value.
+ *  It must be a power of two. By default the image data is aligned
+ *  to 64 bytes, which is the size of cache lines on most current
+ *  processors and sufficient for any SIMD instruction set.
+ *
+ *  @ingroup compile_time_config
+ */
+#define OGLPLUS_IMAGE_DATA_ALIGNMENT
+#else
+# ifndef OGLPLUS_IMAGE_DATA_ALIGNMENT
+#  define OGLPLUS_IMAGE_DATA_ALIGNMENT 64
+# endif
+#endif
+
 #if OGLPLUS_LINK_LIBRARY
 # define OGLPLUS_LIB_FUNC
 #else
@@ -199,6 +199,33 @@
 #endif
 #endif
 
+#ifndef OGLPLUS_NO_THREADS
+#if	defined(BOOST_NO_CXX11_HDR_THREAD) ||\
+	defined(BOOST_NO_HDR_THREAD)
+#define OGLPLUS_NO_THREADS 1
+#else
+#define OGLPLUS_NO_THREADS 0
+#endif
+#endif
+
+#ifndef OGLPLUS_NO_MMAP
+#if	defined(__unix__) || defined(__unix) ||\
+	(defined(__APPLE__) && defined(__MACH__))
+#define OGLPLUS_NO_MMAP 0
+#else
+#define OGLPLUS_NO_MMAP 1
+#endif
+#endif
+
+#ifndef OGLPLUS_NO_SIMD
+#if	defined(__SSE2__) || defined(_M_X64) ||\
+	(defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define OGLPLUS_NO_SIMD 0
+#else
+#define OGLPLUS_NO_SIMD 1
+#endif
+#endif
+
 #ifndef OGLPLUS_NO_SCOPED_ENUM_TEMPLATE_PARAMS
 #ifdef _MSC_VER // TODO < specific version
 #define OGLPLUS_NO_SCOPED_ENUM_TEMPLATE_PARAMS 1
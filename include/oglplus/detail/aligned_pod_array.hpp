@@ -1,5 +1,5 @@
 /**
- *  @file oglplus/detaul/aligned_pod_array.hpp
+ *  @file oglplus/detail/aligned_pod_array.hpp
  *  @brief Aligned plain-old-data array
  *
  *  @author Matus Chochlik
@@ -13,44 +13,103 @@
 #ifndef OGLPLUS_AUX_ALIGNED_POD_ARRAY_1107121519_HPP
 #define OGLPLUS_AUX_ALIGNED_POD_ARRAY_1107121519_HPP
 
+#include <oglplus/config/basic.hpp>
+#include <oglplus/config/compiler.hpp>
+
 #include <cassert>
 #include <cstddef>
+#include <cstdint>
 #include <cstring>
+#include <new>
 
 namespace oglplus {
 namespace aux {
 
+// Allocator hook used by AlignedPODArray
+/* The allocate function must return a block of at least size bytes
+ * aligned to alignment (a power of two) or throw. The deallocate function
+ * gets the pointer and the size passed to / returned by allocate.
+ * The context is passed to both functions unchanged, which allows
+ * for example to allocate the image data from an arena.
+ */
+struct PODArrayAllocator
+{
+	void* (*allocate)(std::size_t size, std::size_t alignment, void* context);
+	void (*deallocate)(void* ptr, std::size_t size, void* context);
+	void* context;
+};
+
+// Allocates aligned memory from the free store
+inline void* HeapPODArrayAllocate(std::size_t size, std::size_t align, void*)
+{
+	assert((align & (align-1)) == 0);
+	if(align < sizeof(void*)) align = sizeof(void*);
+
+	// the original pointer is stored right before the aligned block
+	void* raw = ::operator new(size+align+sizeof(void*));
+	std::uintptr_t addr = reinterpret_cast<std::uintptr_t>(raw);
+	addr += sizeof(void*);
+	addr = (addr + (align-1)) & ~std::uintptr_t(align-1);
+	void* result = reinterpret_cast<void*>(addr);
+	static_cast<void**>(result)[-1] = raw;
+	return result;
+}
+
+inline void HeapPODArrayDeallocate(void* ptr, std::size_t, void*)
+{
+	if(ptr) ::operator delete(static_cast<void**>(ptr)[-1]);
+}
+
+inline PODArrayAllocator HeapPODArrayAllocator(void)
+{
+	PODArrayAllocator result = {
+		&HeapPODArrayAllocate,
+		&HeapPODArrayDeallocate,
+		nullptr
+	};
+	return result;
+}
+
+#if !OGLPLUS_NO_MMAP
+OGLPLUS_LIB_FUNC
+std::size_t MMapPageSize(void);
+
+// Allocates (page-aligned) memory by mapping anonymous pages
+/* Large blocks are advised to be backed by huge pages where the system
+ * supports it.
+ */
+OGLPLUS_LIB_FUNC
+void* MMapPODArrayAllocate(std::size_t size, std::size_t align, void*);
+
+// Unmaps pages mapped by MMapPODArrayAllocate or AlignedPODArray::MapFile
+/* The pointer does not have to point to the start of a page (a file
+ * mapped from an unaligned offset), the whole pages are unmapped.
+ */
+OGLPLUS_LIB_FUNC
+void MMapPODArrayDeallocate(void* ptr, std::size_t size, void*);
+
+OGLPLUS_LIB_FUNC
+PODArrayAllocator MMapPODArrayAllocator(void);
+#endif
+
 // Helper class for storing (image) PO data
 class AlignedPODArray
 {
 private:
 	std::size_t _count;
 	std::size_t _sizeof;
+	std::size_t _align;
 
 	void* _data;
 
-	void (*_delete)(void*);
-	void* (*_dup)(const void*, std::size_t);
-
-	template <typename T>
-	static void _do_delete(void* ptr)
-	{
-		delete[] static_cast<T*>(ptr);
-	}
-
-	template <typename T>
-	static void* _do_dup(const void* src, std::size_t count)
-	{
-		T* dst = new T[count];
-		if(src != nullptr) std::memcpy(dst, src, count*sizeof(T));
-		return static_cast<void*>(dst);
-	}
+	PODArrayAllocator _alloc;
 
 	void* _data_copy(void) const
 	{
-		if(_dup) return _dup(_data, _count);
-		assert(!_data && !_count);
-		return nullptr;
+		if(!_data) return nullptr;
+		void* result = _alloc.allocate(size(), _align, _alloc.context);
+		std::memcpy(result, _data, size());
+		return result;
 	}
 
 	void* _release_data(void)
@@ -65,42 +124,111 @@ private:
 	{
 		if(_data)
 		{
-			assert(_delete);
-			_delete(_data);
+			assert(_alloc.deallocate);
+			_alloc.deallocate(_data, size(), _alloc.context);
 		}
 	}
+
+	void _init(const void* src)
+	{
+		assert(_alloc.allocate);
+		_data = _alloc.allocate(size(), _align, _alloc.context);
+		assert(_data != nullptr);
+		assert((reinterpret_cast<std::uintptr_t>(_data) % _align) == 0);
+		if(src != nullptr) std::memcpy(_data, src, size());
+	}
+
+	static PODArrayAllocator& _default_alloc(void)
+	{
+		static PODArrayAllocator alloc = HeapPODArrayAllocator();
+		return alloc;
+	}
+
+	static std::size_t _default_align(void)
+	{
+		return OGLPLUS_IMAGE_DATA_ALIGNMENT;
+	}
+
+	static AlignedPODArray _map_file(
+		const char* path,
+		std::size_t offset,
+		std::size_t count,
+		std::size_t elem_size,
+		std::size_t elem_align
+	);
 public:
+	// Returns the allocator used by the constructors without an allocator
+	/* This can be changed (before any images are created) to make
+	 * the image generators and loaders allocate their storage
+	 * with a custom allocator.
+	 */
+	static PODArrayAllocator& DefaultAllocator(void)
+	{
+		return _default_alloc();
+	}
+
 	AlignedPODArray(void)
 	 : _count(0)
 	 , _sizeof(0)
+	 , _align(_default_align())
 	 , _data(nullptr)
-	 , _delete(nullptr)
-	 , _dup(nullptr)
+	 , _alloc(_default_alloc())
 	{ }
 
 	template <typename T>
 	AlignedPODArray(const T* data, std::size_t count)
 	 : _count(count)
 	 , _sizeof(sizeof(T))
-	 , _data(_do_dup<T>(static_cast<const void*>(data), count))
-	 , _delete(&_do_delete<T>)
-	 , _dup(&_do_dup<T>)
-	{ }
+	 , _align(_default_align())
+	 , _data(nullptr)
+	 , _alloc(_default_alloc())
+	{
+		_init(static_cast<const void*>(data));
+	}
+
+	template <typename T>
+	AlignedPODArray(
+		const T* data,
+		std::size_t count,
+		const PODArrayAllocator& alloc,
+		std::size_t align = OGLPLUS_IMAGE_DATA_ALIGNMENT
+	): _count(count)
+	 , _sizeof(sizeof(T))
+	 , _align(align < alignof(T) ? alignof(T) : align)
+	 , _data(nullptr)
+	 , _alloc(alloc)
+	{
+		_init(static_cast<const void*>(data));
+	}
+
+	// Maps count elements from the specified file starting at offset
+	/* The pages of the file are mapped privately (copy-on-write), i.e.
+	 * the file is never modified, even if the data is. Copies of the
+	 * array are allocated as anonymous mappings. On systems without
+	 * mmap the data is read into memory allocated from the free store.
+	 */
+	template <typename T>
+	static AlignedPODArray MapFile(
+		const char* path,
+		std::size_t offset,
+		std::size_t count
+	);
 
 	AlignedPODArray(AlignedPODArray&& tmp)
+	OGLPLUS_NOEXCEPT(true)
 	 : _count(tmp._count)
 	 , _sizeof(tmp._sizeof)
+	 , _align(tmp._align)
 	 , _data(tmp._release_data())
-	 , _delete(tmp._delete)
-	 , _dup(tmp._dup)
+	 , _alloc(tmp._alloc)
 	{ }
 
 	AlignedPODArray(const AlignedPODArray& that)
 	 : _count(that._count)
 	 , _sizeof(that._sizeof)
+	 , _align(that._align)
 	 , _data(that._data_copy())
-	 , _delete(that._delete)
-	 , _dup(that._dup)
+	 , _alloc(that._alloc)
 	{ }
 
 	~AlignedPODArray(void)
@@ -109,15 +237,16 @@ public:
 	}
 
 	AlignedPODArray& operator = (AlignedPODArray&& tmp)
+	OGLPLUS_NOEXCEPT(true)
 	{
 		if(this != &tmp)
 		{
 			_cleanup();
 			_count = tmp._count;
 			_sizeof = tmp._sizeof;
+			_align = tmp._align;
 			_data = tmp._release_data();
-			_delete = tmp._delete;
-			_dup = tmp._dup;
+			_alloc = tmp._alloc;
 		}
 		return *this;
 	}
@@ -130,9 +259,9 @@ public:
 			_cleanup();
 			_count = that._count;
 			_sizeof = that._sizeof;
+			_align = that._align;
 			_data = tmp_data;
-			_delete = that._delete;
-			_dup = that._dup;
+			_alloc = that._alloc;
 		}
 		return *this;
 	}
@@ -171,6 +300,16 @@ public:
 		return _sizeof;
 	}
 
+	std::size_t Alignment(void) const
+	{
+		return _align;
+	}
+
+	const PODArrayAllocator& Allocator(void) const
+	{
+		return _alloc;
+	}
+
 	std::size_t size(void) const
 	{
 		return Count()*ElemSize();
@@ -182,7 +321,21 @@ public:
 	}
 };
 
+template <typename T>
+inline AlignedPODArray AlignedPODArray::MapFile(
+	const char* path,
+	std::size_t offset,
+	std::size_t count
+)
+{
+	return _map_file(path, offset, count, sizeof(T), alignof(T));
+}
+
 } // namespace aux
 } // namespace oglplus
 
+#if !OGLPLUS_LINK_LIBRARY || defined(OGLPLUS_IMPLEMENTING_LIBRARY)
+#include <oglplus/detail/aligned_pod_array.ipp>
+#endif // OGLPLUS_LINK_LIBRARY
+
 #endif // include guard
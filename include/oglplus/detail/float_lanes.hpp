@@ -0,0 +1,862 @@
+/**
+ *  @file oglplus/detail/float_lanes.hpp
+ *  @brief Helper for evaluating (image generator) expressions on SIMD lanes
+ *
+ *  @author Matus Chochlik
+ *
+ *  Copyright 2010-2015 Matus Chochlik. Distributed under the Boost
+ *  Software License, Version 1.0. (See accompanying file
+ *  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#pragma once
+#ifndef OGLPLUS_AUX_FLOAT_LANES_1107121519_HPP
+#define OGLPLUS_AUX_FLOAT_LANES_1107121519_HPP
+
+#include <oglplus/config/compiler.hpp>
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#if !OGLPLUS_NO_SIMD
+#include <emmintrin.h>
+#if defined(__AVX__)
+#include <immintrin.h>
+#endif
+#endif
+
+// The namespace of the SIMD lane types, specific to the instruction set
+/* The width and the code of FloatLanes, IntLanes and FloatQuad depend on
+ * the instruction set which the translation unit is compiled for. They
+ * are declared in a namespace named after the instruction set (which is
+ * made visible in oglplus::aux), so translation units compiled with
+ * different flags do not share different definitions of the same classes
+ * and inline functions. The code using the lane types in its signatures
+ * or as template arguments gets distinct names the same way, other helpers
+ * whose code depends on the instruction set should be declared in this
+ * namespace too.
+ */
+#if OGLPLUS_NO_SIMD
+#define OGLPLUS_AUX_LANES_NAMESPACE lanes_scalar
+#elif defined(__AVX2__)
+#define OGLPLUS_AUX_LANES_NAMESPACE lanes_avx2
+#elif defined(__AVX__)
+#define OGLPLUS_AUX_LANES_NAMESPACE lanes_avx
+#else
+#define OGLPLUS_AUX_LANES_NAMESPACE lanes_sse2
+#endif
+
+namespace oglplus {
+namespace aux {
+namespace OGLPLUS_AUX_LANES_NAMESPACE {
+
+// A mask of FloatLanes, the result of comparisons
+class FloatLanesMask;
+
+// A pack of 32-bit integers with the same number of lanes as FloatLanes
+class IntLanes;
+
+// Tag distinguishing the constructors from raw SIMD registers
+struct FloatLanesRawTag { };
+
+// A pack of floats processed together by the SIMD instructions
+/* The number of lanes is 8 with AVX, 4 with SSE2 and 1 if OGLPLUS_NO_SIMD
+ * is set. All the operations are done with single precision and rounded
+ * like the equivalent scalar expressions (as long as the compiler does not
+ * contract them into fused multiply-adds), so code written generically
+ * for float and FloatLanes produces the same results for each lane.
+ */
+class FloatLanes
+{
+private:
+#if OGLPLUS_NO_SIMD
+	typedef float _vec_t;
+#elif defined(__AVX__)
+	typedef __m256 _vec_t;
+#else
+	typedef __m128 _vec_t;
+#endif
+	_vec_t _v;
+
+	FloatLanes(_vec_t v, FloatLanesRawTag)
+	 : _v(v)
+	{ }
+
+	friend class FloatLanesMask;
+public:
+#if OGLPLUS_NO_SIMD
+	enum { Width = 1 };
+#elif defined(__AVX__)
+	enum { Width = 8 };
+#else
+	enum { Width = 4 };
+#endif
+
+	FloatLanes(void)
+	{ }
+
+	// Sets all lanes to the same value
+	FloatLanes(float value)
+#if OGLPLUS_NO_SIMD
+	 : _v(value)
+#elif defined(__AVX__)
+	 : _v(_mm256_set1_ps(value))
+#else
+	 : _v(_mm_set1_ps(value))
+#endif
+	{ }
+
+	// Loads Width values from (not necessarily aligned) memory
+	static FloatLanes Load(const float* ptr)
+	{
+#if OGLPLUS_NO_SIMD
+		return FloatLanes(*ptr, FloatLanesRawTag());
+#elif defined(__AVX__)
+		return FloatLanes(_mm256_loadu_ps(ptr), FloatLanesRawTag());
+#else
+		return FloatLanes(_mm_loadu_ps(ptr), FloatLanesRawTag());
+#endif
+	}
+
+	// Stores Width values into (not necessarily aligned) memory
+	void Store(float* ptr) const
+	{
+#if OGLPLUS_NO_SIMD
+		*ptr = _v;
+#elif defined(__AVX__)
+		_mm256_storeu_ps(ptr, _v);
+#else
+		_mm_storeu_ps(ptr, _v);
+#endif
+	}
+
+	friend FloatLanes operator + (FloatLanes a, FloatLanes b)
+	{
+#if OGLPLUS_NO_SIMD
+		return FloatLanes(a._v + b._v, FloatLanesRawTag());
+#elif defined(__AVX__)
+		return FloatLanes(
+			_mm256_add_ps(a._v, b._v),
+			FloatLanesRawTag()
+		);
+#else
+		return FloatLanes(_mm_add_ps(a._v, b._v), FloatLanesRawTag());
+#endif
+	}
+
+	friend FloatLanes operator - (FloatLanes a, FloatLanes b)
+	{
+#if OGLPLUS_NO_SIMD
+		return FloatLanes(a._v - b._v, FloatLanesRawTag());
+#elif defined(__AVX__)
+		return FloatLanes(
+			_mm256_sub_ps(a._v, b._v),
+			FloatLanesRawTag()
+		);
+#else
+		return FloatLanes(_mm_sub_ps(a._v, b._v), FloatLanesRawTag());
+#endif
+	}
+
+	friend FloatLanes operator * (FloatLanes a, FloatLanes b)
+	{
+#if OGLPLUS_NO_SIMD
+		return FloatLanes(a._v * b._v, FloatLanesRawTag());
+#elif defined(__AVX__)
+		return FloatLanes(
+			_mm256_mul_ps(a._v, b._v),
+			FloatLanesRawTag()
+		);
+#else
+		return FloatLanes(_mm_mul_ps(a._v, b._v), FloatLanesRawTag());
+#endif
+	}
+
+	friend FloatLanes operator / (FloatLanes a, FloatLanes b)
+	{
+#if OGLPLUS_NO_SIMD
+		return FloatLanes(a._v / b._v, FloatLanesRawTag());
+#elif defined(__AVX__)
+		return FloatLanes(
+			_mm256_div_ps(a._v, b._v),
+			FloatLanesRawTag()
+		);
+#else
+		return FloatLanes(_mm_div_ps(a._v, b._v), FloatLanesRawTag());
+#endif
+	}
+
+	friend FloatLanes operator - (FloatLanes a)
+	{
+#if OGLPLUS_NO_SIMD
+		return FloatLanes(-a._v, FloatLanesRawTag());
+#elif defined(__AVX__)
+		return FloatLanes(
+			_mm256_xor_ps(a._v, _mm256_set1_ps(-0.0f)),
+			FloatLanesRawTag()
+		);
+#else
+		return FloatLanes(
+			_mm_xor_ps(a._v, _mm_set1_ps(-0.0f)),
+			FloatLanesRawTag()
+		);
+#endif
+	}
+
+	FloatLanes& operator += (FloatLanes b)
+	{
+		return *this = *this + b;
+	}
+
+	FloatLanes& operator -= (FloatLanes b)
+	{
+		return *this = *this - b;
+	}
+
+	FloatLanes& operator *= (FloatLanes b)
+	{
+		return *this = *this * b;
+	}
+
+	FloatLanes& operator /= (FloatLanes b)
+	{
+		return *this = *this / b;
+	}
+
+	friend FloatLanes Sqrt(FloatLanes a)
+	{
+#if OGLPLUS_NO_SIMD
+		return FloatLanes(std::sqrt(a._v), FloatLanesRawTag());
+#elif defined(__AVX__)
+		return FloatLanes(_mm256_sqrt_ps(a._v), FloatLanesRawTag());
+#else
+		return FloatLanes(_mm_sqrt_ps(a._v), FloatLanesRawTag());
+#endif
+	}
+
+	friend FloatLanes Floor(FloatLanes a);
+	friend FloatLanes Max(FloatLanes a, FloatLanes b);
+
+	friend FloatLanesMask operator <  (FloatLanes a, FloatLanes b);
+	friend FloatLanesMask operator <= (FloatLanes a, FloatLanes b);
+	friend FloatLanesMask operator == (FloatLanes a, FloatLanes b);
+
+	friend FloatLanes Select(FloatLanesMask m, FloatLanes a, FloatLanes b);
+
+	friend IntLanes Truncate(FloatLanes a);
+	friend FloatLanes ToFloat(IntLanes a);
+	friend FloatLanes FlipSign(FloatLanes a, IntLanes b);
+};
+
+class FloatLanesMask
+{
+private:
+#if OGLPLUS_NO_SIMD
+	typedef bool _vec_t;
+#elif defined(__AVX__)
+	typedef __m256 _vec_t;
+#else
+	typedef __m128 _vec_t;
+#endif
+	_vec_t _m;
+
+	FloatLanesMask(_vec_t m, FloatLanesRawTag)
+	 : _m(m)
+	{ }
+
+	friend class FloatLanes;
+public:
+	// Creates a mask with all lanes set to the specified value
+	explicit
+	FloatLanesMask(bool value)
+#if OGLPLUS_NO_SIMD
+	 : _m(value)
+#elif defined(__AVX__)
+	 : _m(_mm256_castsi256_ps(_mm256_set1_epi32(value?-1:0)))
+#else
+	 : _m(_mm_castsi128_ps(_mm_set1_epi32(value?-1:0)))
+#endif
+	{ }
+
+	friend FloatLanesMask operator & (FloatLanesMask a, FloatLanesMask b)
+	{
+#if OGLPLUS_NO_SIMD
+		return FloatLanesMask(a._m && b._m, FloatLanesRawTag());
+#elif defined(__AVX__)
+		return FloatLanesMask(
+			_mm256_and_ps(a._m, b._m),
+			FloatLanesRawTag()
+		);
+#else
+		return FloatLanesMask(
+			_mm_and_ps(a._m, b._m),
+			FloatLanesRawTag()
+		);
+#endif
+	}
+
+	friend FloatLanesMask operator | (FloatLanesMask a, FloatLanesMask b)
+	{
+#if OGLPLUS_NO_SIMD
+		return FloatLanesMask(a._m || b._m, FloatLanesRawTag());
+#elif defined(__AVX__)
+		return FloatLanesMask(
+			_mm256_or_ps(a._m, b._m),
+			FloatLanesRawTag()
+		);
+#else
+		return FloatLanesMask(
+			_mm_or_ps(a._m, b._m),
+			FloatLanesRawTag()
+		);
+#endif
+	}
+
+	friend FloatLanesMask operator ! (FloatLanesMask a)
+	{
+		return AndNot(FloatLanesMask(true), a);
+	}
+
+	// Returns the lanes of a which are not set in b
+	friend FloatLanesMask AndNot(FloatLanesMask a, FloatLanesMask b)
+	{
+#if OGLPLUS_NO_SIMD
+		return FloatLanesMask(a._m && !b._m, FloatLanesRawTag());
+#elif defined(__AVX__)
+		return FloatLanesMask(
+			_mm256_andnot_ps(b._m, a._m),
+			FloatLanesRawTag()
+		);
+#else
+		return FloatLanesMask(
+			_mm_andnot_ps(b._m, a._m),
+			FloatLanesRawTag()
+		);
+#endif
+	}
+
+	// Returns true if any of the lanes is set
+	friend bool Any(FloatLanesMask a)
+	{
+#if OGLPLUS_NO_SIMD
+		return a._m;
+#elif defined(__AVX__)
+		return _mm256_movemask_ps(a._m) != 0;
+#else
+		return _mm_movemask_ps(a._m) != 0;
+#endif
+	}
+
+	friend FloatLanesMask operator <  (FloatLanes a, FloatLanes b);
+	friend FloatLanesMask operator <= (FloatLanes a, FloatLanes b);
+	friend FloatLanesMask operator == (FloatLanes a, FloatLanes b);
+
+	friend FloatLanes Select(FloatLanesMask m, FloatLanes a, FloatLanes b);
+
+	friend FloatLanesMask operator <  (IntLanes a, IntLanes b);
+	friend FloatLanesMask operator == (IntLanes a, IntLanes b);
+
+	friend IntLanes Select(FloatLanesMask m, IntLanes a, IntLanes b);
+};
+
+inline FloatLanesMask operator < (FloatLanes a, FloatLanes b)
+{
+#if OGLPLUS_NO_SIMD
+	return FloatLanesMask(a._v < b._v, FloatLanesRawTag());
+#elif defined(__AVX__)
+	return FloatLanesMask(
+		_mm256_cmp_ps(a._v, b._v, _CMP_LT_OQ),
+		FloatLanesRawTag()
+	);
+#else
+	return FloatLanesMask(_mm_cmplt_ps(a._v, b._v), FloatLanesRawTag());
+#endif
+}
+
+inline FloatLanesMask operator <= (FloatLanes a, FloatLanes b)
+{
+#if OGLPLUS_NO_SIMD
+	return FloatLanesMask(a._v <= b._v, FloatLanesRawTag());
+#elif defined(__AVX__)
+	return FloatLanesMask(
+		_mm256_cmp_ps(a._v, b._v, _CMP_LE_OQ),
+		FloatLanesRawTag()
+	);
+#else
+	return FloatLanesMask(_mm_cmple_ps(a._v, b._v), FloatLanesRawTag());
+#endif
+}
+
+inline FloatLanesMask operator == (FloatLanes a, FloatLanes b)
+{
+#if OGLPLUS_NO_SIMD
+	return FloatLanesMask(a._v == b._v, FloatLanesRawTag());
+#elif defined(__AVX__)
+	return FloatLanesMask(
+		_mm256_cmp_ps(a._v, b._v, _CMP_EQ_OQ),
+		FloatLanesRawTag()
+	);
+#else
+	return FloatLanesMask(_mm_cmpeq_ps(a._v, b._v), FloatLanesRawTag());
+#endif
+}
+
+inline FloatLanes Floor(FloatLanes a)
+{
+#if OGLPLUS_NO_SIMD
+	return FloatLanes(std::floor(a._v), FloatLanesRawTag());
+#elif defined(__AVX__)
+	return FloatLanes(_mm256_floor_ps(a._v), FloatLanesRawTag());
+#else
+	// truncates and subtracts one from the values rounded up
+	// (the values must be in the range of 32-bit integers)
+	const __m128 t = _mm_cvtepi32_ps(_mm_cvttps_epi32(a._v));
+	return FloatLanes(
+		_mm_sub_ps(t, _mm_and_ps(
+			_mm_cmpgt_ps(t, a._v),
+			_mm_set1_ps(1.0f)
+		)),
+		FloatLanesRawTag()
+	);
+#endif
+}
+
+// Returns a where a > b and b otherwise
+inline FloatLanes Max(FloatLanes a, FloatLanes b)
+{
+#if OGLPLUS_NO_SIMD
+	return FloatLanes((a._v > b._v)?a._v:b._v, FloatLanesRawTag());
+#elif defined(__AVX__)
+	return FloatLanes(
+		_mm256_max_ps(a._v, b._v),
+		FloatLanesRawTag()
+	);
+#else
+	return FloatLanes(_mm_max_ps(a._v, b._v), FloatLanesRawTag());
+#endif
+}
+
+// Returns a in the lanes set in m and b in the other lanes
+inline FloatLanes Select(FloatLanesMask m, FloatLanes a, FloatLanes b)
+{
+#if OGLPLUS_NO_SIMD
+	return FloatLanes(m._m?a._v:b._v, FloatLanesRawTag());
+#elif defined(__AVX__)
+	// the lanes of the masks are all ones or zeros, so this is
+	// the same as blendv, which is not lowered well without AVX2
+	return FloatLanes(
+		_mm256_or_ps(
+			_mm256_and_ps(m._m, a._v),
+			_mm256_andnot_ps(m._m, b._v)
+		),
+		FloatLanesRawTag()
+	);
+#else
+	return FloatLanes(
+		_mm_or_ps(_mm_and_ps(m._m, a._v), _mm_andnot_ps(m._m, b._v)),
+		FloatLanesRawTag()
+	);
+#endif
+}
+
+#if defined(__AVX__) && !defined(__AVX2__)
+// Applies a binary operation on 128-bit integer vectors to 256-bit ones
+/* AVX (without AVX2) has only the floating-point 256-bit operations.
+ */
+template <typename Op>
+inline __m256i IntLanesHalves(__m256i a, __m256i b, Op op)
+{
+	const __m128i lo = op(
+		_mm256_castsi256_si128(a),
+		_mm256_castsi256_si128(b)
+	);
+	const __m128i hi = op(
+		_mm256_extractf128_si256(a, 1),
+		_mm256_extractf128_si256(b, 1)
+	);
+	return _mm256_insertf128_si256(_mm256_castsi128_si256(lo), hi, 1);
+}
+#endif
+
+// A pack of 32-bit integers processed together by the SIMD instructions
+/* The arithmetic wraps around like that of std::uint32_t, the right shift
+ * is logical and the (less-than) comparison is signed. The results of
+ * the comparisons are FloatLanesMasks, which select both the float and
+ * the integer lanes.
+ */
+class IntLanes
+{
+private:
+#if OGLPLUS_NO_SIMD
+	typedef std::uint32_t _vec_t;
+#elif defined(__AVX__)
+	typedef __m256i _vec_t;
+#else
+	typedef __m128i _vec_t;
+#endif
+	_vec_t _v;
+
+	IntLanes(_vec_t v, FloatLanesRawTag)
+	 : _v(v)
+	{ }
+public:
+	enum { Width = FloatLanes::Width };
+
+	IntLanes(void)
+	{ }
+
+	// Sets all lanes to the same value
+	IntLanes(std::uint32_t value)
+#if OGLPLUS_NO_SIMD
+	 : _v(value)
+#elif defined(__AVX__)
+	 : _v(_mm256_set1_epi32(int(value)))
+#else
+	 : _v(_mm_set1_epi32(int(value)))
+#endif
+	{ }
+
+	// Sets the lanes to first, first+1, first+2, ...
+	static IntLanes Iota(std::uint32_t first)
+	{
+#if OGLPLUS_NO_SIMD
+		return IntLanes(first, FloatLanesRawTag());
+#elif defined(__AVX__)
+		return IntLanes(_mm256_setr_epi32(
+			int(first+0), int(first+1), int(first+2), int(first+3),
+			int(first+4), int(first+5), int(first+6), int(first+7)
+		), FloatLanesRawTag());
+#else
+		return IntLanes(_mm_setr_epi32(
+			int(first+0), int(first+1), int(first+2), int(first+3)
+		), FloatLanesRawTag());
+#endif
+	}
+
+	friend IntLanes operator + (IntLanes a, IntLanes b)
+	{
+#if OGLPLUS_NO_SIMD
+		return IntLanes(a._v + b._v, FloatLanesRawTag());
+#elif defined(__AVX2__)
+		return IntLanes(
+			_mm256_add_epi32(a._v, b._v),
+			FloatLanesRawTag()
+		);
+#elif defined(__AVX__)
+		return IntLanes(IntLanesHalves(
+			a._v, b._v,
+			[](__m128i x, __m128i y) { return _mm_add_epi32(x, y); }
+		), FloatLanesRawTag());
+#else
+		return IntLanes(_mm_add_epi32(a._v, b._v), FloatLanesRawTag());
+#endif
+	}
+
+	// Returns the low 32 bits of the products
+	friend IntLanes operator * (IntLanes a, IntLanes b)
+	{
+#if OGLPLUS_NO_SIMD
+		return IntLanes(a._v * b._v, FloatLanesRawTag());
+#elif defined(__AVX2__)
+		return IntLanes(
+			_mm256_mullo_epi32(a._v, b._v),
+			FloatLanesRawTag()
+		);
+#elif defined(__AVX__)
+		return IntLanes(IntLanesHalves(
+			a._v, b._v,
+			[](__m128i x, __m128i y) { return _mm_mullo_epi32(x, y); }
+		), FloatLanesRawTag());
+#else
+		// the products of the even and of the odd lanes
+		const __m128i even = _mm_mul_epu32(a._v, b._v);
+		const __m128i odd = _mm_mul_epu32(
+			_mm_srli_epi64(a._v, 32),
+			_mm_srli_epi64(b._v, 32)
+		);
+		return IntLanes(_mm_unpacklo_epi32(
+			_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+			_mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0))
+		), FloatLanesRawTag());
+#endif
+	}
+
+	friend IntLanes operator ^ (IntLanes a, IntLanes b)
+	{
+#if OGLPLUS_NO_SIMD
+		return IntLanes(a._v ^ b._v, FloatLanesRawTag());
+#elif defined(__AVX__)
+		return IntLanes(_mm256_castps_si256(_mm256_xor_ps(
+			_mm256_castsi256_ps(a._v),
+			_mm256_castsi256_ps(b._v)
+		)), FloatLanesRawTag());
+#else
+		return IntLanes(_mm_xor_si128(a._v, b._v), FloatLanesRawTag());
+#endif
+	}
+
+	friend IntLanes operator & (IntLanes a, IntLanes b)
+	{
+#if OGLPLUS_NO_SIMD
+		return IntLanes(a._v & b._v, FloatLanesRawTag());
+#elif defined(__AVX__)
+		return IntLanes(_mm256_castps_si256(_mm256_and_ps(
+			_mm256_castsi256_ps(a._v),
+			_mm256_castsi256_ps(b._v)
+		)), FloatLanesRawTag());
+#else
+		return IntLanes(_mm_and_si128(a._v, b._v), FloatLanesRawTag());
+#endif
+	}
+
+	friend IntLanes operator >> (IntLanes a, int n)
+	{
+#if OGLPLUS_NO_SIMD
+		return IntLanes(a._v >> n, FloatLanesRawTag());
+#elif defined(__AVX2__)
+		return IntLanes(
+			_mm256_srl_epi32(a._v, _mm_cvtsi32_si128(n)),
+			FloatLanesRawTag()
+		);
+#elif defined(__AVX__)
+		const __m128i c = _mm_cvtsi32_si128(n);
+		return IntLanes(IntLanesHalves(
+			a._v, a._v,
+			[c](__m128i x, __m128i) { return _mm_srl_epi32(x, c); }
+		), FloatLanesRawTag());
+#else
+		return IntLanes(
+			_mm_srl_epi32(a._v, _mm_cvtsi32_si128(n)),
+			FloatLanesRawTag()
+		);
+#endif
+	}
+
+	friend IntLanes operator << (IntLanes a, int n)
+	{
+#if OGLPLUS_NO_SIMD
+		return IntLanes(a._v << n, FloatLanesRawTag());
+#elif defined(__AVX2__)
+		return IntLanes(
+			_mm256_sll_epi32(a._v, _mm_cvtsi32_si128(n)),
+			FloatLanesRawTag()
+		);
+#elif defined(__AVX__)
+		const __m128i c = _mm_cvtsi32_si128(n);
+		return IntLanes(IntLanesHalves(
+			a._v, a._v,
+			[c](__m128i x, __m128i) { return _mm_sll_epi32(x, c); }
+		), FloatLanesRawTag());
+#else
+		return IntLanes(
+			_mm_sll_epi32(a._v, _mm_cvtsi32_si128(n)),
+			FloatLanesRawTag()
+		);
+#endif
+	}
+
+	friend FloatLanesMask operator <  (IntLanes a, IntLanes b);
+	friend FloatLanesMask operator == (IntLanes a, IntLanes b);
+
+	friend IntLanes Select(FloatLanesMask m, IntLanes a, IntLanes b);
+
+	friend IntLanes Truncate(FloatLanes a);
+	friend FloatLanes ToFloat(IntLanes a);
+	friend FloatLanes FlipSign(FloatLanes a, IntLanes b);
+};
+
+// Compares the lanes as signed integers
+inline FloatLanesMask operator < (IntLanes a, IntLanes b)
+{
+#if OGLPLUS_NO_SIMD
+	return FloatLanesMask(
+		std::int32_t(a._v) < std::int32_t(b._v),
+		FloatLanesRawTag()
+	);
+#elif defined(__AVX2__)
+	return FloatLanesMask(
+		_mm256_castsi256_ps(_mm256_cmpgt_epi32(b._v, a._v)),
+		FloatLanesRawTag()
+	);
+#elif defined(__AVX__)
+	return FloatLanesMask(_mm256_castsi256_ps(IntLanesHalves(
+		a._v, b._v,
+		[](__m128i x, __m128i y) { return _mm_cmplt_epi32(x, y); }
+	)), FloatLanesRawTag());
+#else
+	return FloatLanesMask(
+		_mm_castsi128_ps(_mm_cmplt_epi32(a._v, b._v)),
+		FloatLanesRawTag()
+	);
+#endif
+}
+
+inline FloatLanesMask operator == (IntLanes a, IntLanes b)
+{
+#if OGLPLUS_NO_SIMD
+	return FloatLanesMask(a._v == b._v, FloatLanesRawTag());
+#elif defined(__AVX2__)
+	return FloatLanesMask(
+		_mm256_castsi256_ps(_mm256_cmpeq_epi32(a._v, b._v)),
+		FloatLanesRawTag()
+	);
+#elif defined(__AVX__)
+	return FloatLanesMask(_mm256_castsi256_ps(IntLanesHalves(
+		a._v, b._v,
+		[](__m128i x, __m128i y) { return _mm_cmpeq_epi32(x, y); }
+	)), FloatLanesRawTag());
+#else
+	return FloatLanesMask(
+		_mm_castsi128_ps(_mm_cmpeq_epi32(a._v, b._v)),
+		FloatLanesRawTag()
+	);
+#endif
+}
+
+// Returns a in the lanes set in m and b in the other lanes
+inline IntLanes Select(FloatLanesMask m, IntLanes a, IntLanes b)
+{
+#if OGLPLUS_NO_SIMD
+	return IntLanes(m._m?a._v:b._v, FloatLanesRawTag());
+#elif defined(__AVX__)
+	return IntLanes(_mm256_castps_si256(_mm256_or_ps(
+		_mm256_and_ps(m._m, _mm256_castsi256_ps(a._v)),
+		_mm256_andnot_ps(m._m, _mm256_castsi256_ps(b._v))
+	)), FloatLanesRawTag());
+#else
+	const __m128i mi = _mm_castps_si128(m._m);
+	return IntLanes(
+		_mm_or_si128(_mm_and_si128(mi, a._v), _mm_andnot_si128(mi, b._v)),
+		FloatLanesRawTag()
+	);
+#endif
+}
+
+// Converts the lanes to (signed) integers, rounding toward zero
+inline IntLanes Truncate(FloatLanes a)
+{
+#if OGLPLUS_NO_SIMD
+	return IntLanes(
+		std::uint32_t(std::int32_t(a._v)),
+		FloatLanesRawTag()
+	);
+#elif defined(__AVX__)
+	return IntLanes(_mm256_cvttps_epi32(a._v), FloatLanesRawTag());
+#else
+	return IntLanes(_mm_cvttps_epi32(a._v), FloatLanesRawTag());
+#endif
+}
+
+// Converts the lanes (as signed integers) to floats
+inline FloatLanes ToFloat(IntLanes a)
+{
+#if OGLPLUS_NO_SIMD
+	return FloatLanes(float(std::int32_t(a._v)), FloatLanesRawTag());
+#elif defined(__AVX__)
+	return FloatLanes(_mm256_cvtepi32_ps(a._v), FloatLanesRawTag());
+#else
+	return FloatLanes(_mm_cvtepi32_ps(a._v), FloatLanesRawTag());
+#endif
+}
+
+// Negates the lanes of a in which the top bit of b is set
+inline FloatLanes FlipSign(FloatLanes a, IntLanes b)
+{
+#if OGLPLUS_NO_SIMD
+	return FloatLanes((b._v >> 31)?-a._v:a._v, FloatLanesRawTag());
+#elif defined(__AVX__)
+	return FloatLanes(_mm256_xor_ps(a._v, _mm256_and_ps(
+		_mm256_castsi256_ps(b._v),
+		_mm256_set1_ps(-0.0f)
+	)), FloatLanesRawTag());
+#else
+	return FloatLanes(_mm_xor_ps(a._v, _mm_and_ps(
+		_mm_castsi128_ps(b._v),
+		_mm_set1_ps(-0.0f)
+	)), FloatLanesRawTag());
+#endif
+}
+
+// Four floats processed together, for example the components of a pixel
+/* Unlike FloatLanes the width does not depend on the instruction set,
+ * the floats are in a SSE register (also with AVX) unless OGLPLUS_NO_SIMD
+ * is set. As with FloatLanes, the results are the same as those of
+ * the equivalent scalar expressions.
+ */
+class FloatQuad
+{
+private:
+#if OGLPLUS_NO_SIMD
+	struct _vec_t { float c[4]; };
+#else
+	typedef __m128 _vec_t;
+#endif
+	_vec_t _v;
+
+	FloatQuad(_vec_t v, FloatLanesRawTag)
+	 : _v(v)
+	{ }
+public:
+	FloatQuad(void)
+	{ }
+
+	// Sets all four floats to the same value
+	FloatQuad(float value)
+#if OGLPLUS_NO_SIMD
+	{
+		for(int i=0; i!=4; ++i) _v.c[i] = value;
+	}
+#else
+	 : _v(_mm_set1_ps(value))
+	{ }
+#endif
+
+	// Loads four values from (not necessarily aligned) memory
+	static FloatQuad Load(const float* ptr)
+	{
+#if OGLPLUS_NO_SIMD
+		_vec_t v = {{ptr[0], ptr[1], ptr[2], ptr[3]}};
+		return FloatQuad(v, FloatLanesRawTag());
+#else
+		return FloatQuad(_mm_loadu_ps(ptr), FloatLanesRawTag());
+#endif
+	}
+
+	// Stores four values into (not necessarily aligned) memory
+	void Store(float* ptr) const
+	{
+#if OGLPLUS_NO_SIMD
+		for(int i=0; i!=4; ++i) ptr[i] = _v.c[i];
+#else
+		_mm_storeu_ps(ptr, _v);
+#endif
+	}
+
+	friend FloatQuad operator + (FloatQuad a, FloatQuad b)
+	{
+#if OGLPLUS_NO_SIMD
+		for(int i=0; i!=4; ++i) a._v.c[i] += b._v.c[i];
+		return a;
+#else
+		return FloatQuad(_mm_add_ps(a._v, b._v), FloatLanesRawTag());
+#endif
+	}
+
+	friend FloatQuad operator * (FloatQuad a, FloatQuad b)
+	{
+#if OGLPLUS_NO_SIMD
+		for(int i=0; i!=4; ++i) a._v.c[i] *= b._v.c[i];
+		return a;
+#else
+		return FloatQuad(_mm_mul_ps(a._v, b._v), FloatLanesRawTag());
+#endif
+	}
+};
+
+} // namespace OGLPLUS_AUX_LANES_NAMESPACE
+using namespace OGLPLUS_AUX_LANES_NAMESPACE;
+} // namespace aux
+} // namespace oglplus
+
+#endif // include guard
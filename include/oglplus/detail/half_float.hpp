@@ -0,0 +1,99 @@
+/**
+ *  @file oglplus/detail/half_float.hpp
+ *  @brief Conversions between single and half-precision floating-point values
+ *
+ *  @author Matus Chochlik
+ *
+ *  Copyright 2010-2015 Matus Chochlik. Distributed under the Boost
+ *  Software License, Version 1.0. (See accompanying file
+ *  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#pragma once
+#ifndef OGLPLUS_AUX_HALF_FLOAT_1107121519_HPP
+#define OGLPLUS_AUX_HALF_FLOAT_1107121519_HPP
+
+#include <cstdint>
+#include <cstring>
+
+namespace oglplus {
+namespace aux {
+
+// Converts the bits of a half-precision value to a float
+/* NaNs are made quiet, like with the F16C instructions.
+ */
+inline float HalfToFloat(std::uint16_t h)
+{
+	const std::uint32_t sign = std::uint32_t(h & 0x8000) << 16;
+	const std::uint32_t e = (h >> 10) & 0x1F;
+	const std::uint32_t m = h & 0x3FF;
+	std::uint32_t f;
+
+	if(e == 0)
+	{
+		// zero or a denormal, which is a normal float
+		const float v = float(m)*(1.0f/16777216.0f);
+		std::memcpy(&f, &v, 4);
+		f |= sign;
+	}
+	else if(e == 31)
+	{
+		f = sign | 0x7F800000 | (m << 13);
+		if(m != 0) f |= 0x00400000;
+	}
+	else f = sign | ((e + 112) << 23) | (m << 13);
+
+	float result;
+	std::memcpy(&result, &f, 4);
+	return result;
+}
+
+// Converts a float to the bits of a half-precision value
+/* The value is rounded to the nearest even value, the values too large
+ * to be represented are converted to infinity and NaNs are made quiet,
+ * i.e. the results are the same as with the F16C instructions.
+ */
+inline std::uint16_t FloatToHalf(float value)
+{
+	std::uint32_t f;
+	std::memcpy(&f, &value, 4);
+	const std::uint32_t sign = (f >> 16) & 0x8000;
+	const std::uint32_t a = f & 0x7FFFFFFF;
+
+	if(a >= 0x7F800000)
+	{
+		if(a > 0x7F800000)
+		{
+			return std::uint16_t(sign | 0x7E00 | ((a >> 13) & 0x3FF));
+		}
+		return std::uint16_t(sign | 0x7C00);
+	}
+	// 65520 and larger values round to infinity
+	if(a >= 0x477FF000) return std::uint16_t(sign | 0x7C00);
+
+	std::uint32_t r, rem, half;
+	if(a < 0x38800000)
+	{
+		// the result is a denormal (or zero)
+		const std::uint32_t e = a >> 23;
+		if(e < 102) return std::uint16_t(sign);
+		const std::uint32_t m = (a & 0x7FFFFF) | 0x800000;
+		const std::uint32_t shift = 126 - e;
+		r = m >> shift;
+		rem = m & ((1u << shift) - 1);
+		half = 1u << (shift - 1);
+	}
+	else
+	{
+		r = (a >> 13) - (112u << 10);
+		rem = a & 0x1FFF;
+		half = 0x1000;
+	}
+	if((rem > half) || ((rem == half) && (r & 1))) ++r;
+	return std::uint16_t(sign | r);
+}
+
+} // namespace aux
+} // namespace oglplus
+
+#endif // include guard
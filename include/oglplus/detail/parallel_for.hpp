@@ -0,0 +1,272 @@
+/**
+ *  @file oglplus/detail/parallel_for.hpp
+ *  @brief Helper for splitting (image generator) loops between threads
+ *
+ *  @author Matus Chochlik
+ *
+ *  Copyright 2010-2015 Matus Chochlik. Distributed under the Boost
+ *  Software License, Version 1.0. (See accompanying file
+ *  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#pragma once
+#ifndef OGLPLUS_AUX_PARALLEL_FOR_1107121519_HPP
+#define OGLPLUS_AUX_PARALLEL_FOR_1107121519_HPP
+
+#include <oglplus/config/compiler.hpp>
+
+#include <cassert>
+#include <cstddef>
+
+#if !OGLPLUS_NO_THREADS
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+#endif
+
+namespace oglplus {
+namespace aux {
+
+// Returns the number of worker threads used by ParallelFor
+inline unsigned ParallelThreadCount(unsigned max_threads = 0)
+{
+#if !OGLPLUS_NO_THREADS
+	static const unsigned hw_threads = std::thread::hardware_concurrency();
+	unsigned result = (hw_threads != 0)?hw_threads:1;
+	if((max_threads != 0) && (result > max_threads))
+	{
+		result = max_threads;
+	}
+	return result;
+#else
+	OGLPLUS_FAKE_USE(max_threads);
+	return 1;
+#endif
+}
+
+#if !OGLPLUS_NO_THREADS
+// Pool of threads helping the calling threads of ParallelFor
+/* The pool is created on first use with one thread less than there are
+ * hardware threads (the calling thread does its share of the work) and
+ * it is shared by all ParallelFor loops, so concurrent loops do not
+ * start more threads than the hardware can run. If a thread cannot be
+ * started the pool just works with fewer threads.
+ */
+class ParallelPool
+{
+private:
+	std::mutex _mutex;
+	std::condition_variable _cv;
+	std::deque<std::function<void(void)>> _tasks;
+	std::vector<std::thread> _threads;
+	bool _done;
+
+	static bool& _busy(void)
+	{
+		static thread_local bool busy = false;
+		return busy;
+	}
+
+	void _work(void)
+	{
+		_busy() = true;
+		while(true)
+		{
+			std::function<void(void)> task;
+			{
+				std::unique_lock<std::mutex> lock(_mutex);
+				while(!_done && _tasks.empty()) _cv.wait(lock);
+				if(_tasks.empty()) break;
+				task = std::move(_tasks.front());
+				_tasks.pop_front();
+			}
+			task();
+		}
+	}
+
+	ParallelPool(void)
+	 : _done(false)
+	{
+		const unsigned n = ParallelThreadCount();
+		_threads.reserve(n-1);
+		try
+		{
+			for(unsigned t=1; t<n; ++t)
+			{
+				_threads.push_back(std::thread(&ParallelPool::_work, this));
+			}
+		}
+		catch(std::system_error&) { }
+	}
+
+	ParallelPool(const ParallelPool&);
+public:
+	~ParallelPool(void)
+	{
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_done = true;
+		}
+		_cv.notify_all();
+		for(auto& thread : _threads)
+		{
+			thread.join();
+		}
+	}
+
+	static ParallelPool& Instance(void)
+	{
+		static ParallelPool pool;
+		return pool;
+	}
+
+	// Indicates if the current thread is running a ParallelFor loop
+	/* Loops nested in another loop run on the calling thread, because
+	 * the hardware threads are already busy with the outer loop.
+	 */
+	static bool Busy(void)
+	{
+		return _busy();
+	}
+
+	static void SetBusy(bool busy)
+	{
+		_busy() = busy;
+	}
+
+	unsigned Size(void) const
+	{
+		return unsigned(_threads.size());
+	}
+
+	void Post(std::function<void(void)> task)
+	{
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_tasks.push_back(std::move(task));
+		}
+		_cv.notify_one();
+	}
+};
+#endif
+
+// Calls func(begin, end) for consecutive sub-ranges of [0, count)
+/* The sub-ranges are at most grain elements long and are handed out
+ * dynamically to the calling thread and to up to max_threads-1 threads
+ * from the shared ParallelPool (0 means as many as there are hardware
+ * threads). Every thread invokes its own copy of func so stateful
+ * functors do not need to be synchronized. The first exception thrown
+ * by any of the threads is re-thrown in the calling thread.
+ */
+template <typename Func>
+void ParallelFor(
+	std::size_t count,
+	std::size_t grain,
+	Func func,
+	unsigned max_threads = 0
+)
+{
+	if(count == 0) return;
+	if(grain == 0) grain = 1;
+
+	std::size_t chunks = (count + grain - 1) / grain;
+	unsigned nthreads = ParallelThreadCount(max_threads);
+	if(nthreads > chunks) nthreads = unsigned(chunks);
+
+#if !OGLPLUS_NO_THREADS
+	if((nthreads > 1) && !ParallelPool::Busy())
+	{
+		ParallelPool& pool = ParallelPool::Instance();
+		if(nthreads > pool.Size()+1) nthreads = pool.Size()+1;
+	}
+	else nthreads = 1;
+
+	if(nthreads > 1)
+	{
+		// the helpers which did not start before the calling thread
+		// finished all chunks are not waited for and do nothing
+		struct State
+		{
+			std::mutex mutex;
+			std::condition_variable cv;
+			unsigned running;
+			bool closed;
+		};
+		std::shared_ptr<State> state = std::make_shared<State>();
+		state->running = 0;
+		state->closed = false;
+
+		std::atomic<std::size_t> next(0);
+		std::atomic<bool> failed(false);
+		std::exception_ptr error;
+
+		std::function<void(void)> work = [&](void)
+		{
+			try
+			{
+				Func local(func);
+				while(!failed.load())
+				{
+					std::size_t begin = next.fetch_add(grain);
+					if(begin >= count) break;
+					std::size_t end = begin + grain;
+					if(end > count) end = count;
+					local(begin, end);
+				}
+			}
+			catch(...)
+			{
+				std::lock_guard<std::mutex> lock(state->mutex);
+				if(!error) error = std::current_exception();
+				failed.store(true);
+			}
+		};
+
+		std::function<void(void)>* pwork = &work;
+		ParallelPool& pool = ParallelPool::Instance();
+		try
+		{
+			for(unsigned t=1; t!=nthreads; ++t)
+			{
+				pool.Post([state, pwork](void)
+				{
+					{
+						std::lock_guard<std::mutex> lock(state->mutex);
+						if(state->closed) return;
+						++state->running;
+					}
+					(*pwork)();
+					std::lock_guard<std::mutex> lock(state->mutex);
+					if(--state->running == 0) state->cv.notify_all();
+				});
+			}
+		}
+		catch(...) { }
+
+		ParallelPool::SetBusy(true);
+		work();
+		ParallelPool::SetBusy(false);
+
+		std::unique_lock<std::mutex> lock(state->mutex);
+		state->closed = true;
+		while(state->running != 0) state->cv.wait(lock);
+		if(error) std::rethrow_exception(error);
+		return;
+	}
+#endif
+	assert(nthreads <= 1);
+	Func local(func);
+	local(std::size_t(0), count);
+}
+
+} // namespace aux
+} // namespace oglplus
+
+#endif // include guard
@@ -0,0 +1,118 @@
+/**
+ *  .file oglplus/detail/unpack_params.hpp
+ *  .brief Helper setting the pixel unpack parameters for image views
+ *
+ *  @author Matus Chochlik
+ *
+ *  Copyright 2010-2015 Matus Chochlik. Distributed under the Boost
+ *  Software License, Version 1.0. (See accompanying file
+ *  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#pragma once
+#ifndef OGLPLUS_AUX_UNPACK_PARAMS_1107121519_HPP
+#define OGLPLUS_AUX_UNPACK_PARAMS_1107121519_HPP
+
+#include <oglplus/glfunc.hpp>
+#include <oglplus/error/basic.hpp>
+#include <oglplus/images/view.hpp>
+
+#include <cassert>
+#include <stdexcept>
+
+namespace oglplus {
+namespace aux {
+
+// Sets a pixel storage parameter and restores its previous value
+// when it goes out of scope (if it was set)
+class PixelStoreParam
+{
+private:
+	GLenum _parameter;
+	GLint _value;
+	bool _set;
+
+	PixelStoreParam(const PixelStoreParam&);
+public:
+	PixelStoreParam(void)
+	 : _parameter(GL_UNPACK_ALIGNMENT)
+	 , _value(0)
+	 , _set(false)
+	{ }
+
+	PixelStoreParam(GLenum parameter, GLint value)
+	 : _parameter(parameter)
+	 , _value(0)
+	 , _set(false)
+	{
+		Set(parameter, value);
+	}
+
+	void Set(GLenum parameter, GLint value)
+	{
+		assert(!_set);
+		OGLPLUS_GLFUNC(GetIntegerv)(parameter, &_value);
+		OGLPLUS_VERIFY_SIMPLE(GetIntegerv);
+		_parameter = parameter;
+		_set = true;
+		OGLPLUS_GLFUNC(PixelStorei)(parameter, value);
+		OGLPLUS_VERIFY_SIMPLE(PixelStorei);
+	}
+
+	~PixelStoreParam(void)
+	{
+		if(_set) OGLPLUS_GLFUNC(PixelStorei)(_parameter, _value);
+	}
+};
+
+// Sets the pixel unpack parameters required for uploading an image view
+// and restores the previous values when it goes out of scope
+/* Each parameter is restored by its own member, so the parameters which
+ * were already set are restored also if setting one of the others throws.
+ */
+class ImageViewUnpackParams
+{
+private:
+	PixelStoreParam _row_length, _alignment, _image_height;
+
+	ImageViewUnpackParams(const ImageViewUnpackParams&);
+public:
+	ImageViewUnpackParams(const images::ImageView& view, bool three_d)
+	{
+		// contiguous views are uploaded the same way as images
+		if(view.IsContiguous()) return;
+
+		if(!view.HasPixelStrides())
+		{
+			throw std::runtime_error(
+				"The strides of the image view are not "
+				"whole multiples of pixels and rows"
+			);
+		}
+		_row_length.Set(GL_UNPACK_ROW_LENGTH, view.RowLength());
+		_alignment.Set(GL_UNPACK_ALIGNMENT, 1);
+		if(three_d)
+		{
+			_image_height.Set(
+				GL_UNPACK_IMAGE_HEIGHT,
+				view.ImageHeight()
+			);
+		}
+	}
+};
+
+// Sets the UNPACK_ALIGNMENT pixel storage parameter and restores
+// the previous value when it goes out of scope
+class UnpackAlignmentParam
+ : public PixelStoreParam
+{
+public:
+	UnpackAlignmentParam(GLint alignment)
+	 : PixelStoreParam(GL_UNPACK_ALIGNMENT, alignment)
+	{ }
+};
+
+} // namespace aux
+} // namespace oglplus
+
+#endif // include guard
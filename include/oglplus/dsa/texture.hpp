@@ -641,6 +641,23 @@ public:
 		GLint level = 0
 	);
 
+	/// Specifies a three dimensional texture sub image from an image view
+	/**
+	 *  @throws std::runtime_error if the view is not contiguous
+	 *  and !image.HasPixelStrides()
+	 *
+	 *  @glsymbols
+	 *  @glfunref{TexSubImage3D}
+	 *  @glfunref{PixelStore}
+	 */
+	ObjectOps& SubImage3D(
+		const images::ImageView& image,
+		GLint xoffs = 0,
+		GLint yoffs = 0,
+		GLint zoffs = 0,
+		GLint level = 0
+	);
+
 	/// Specifies a two dimensional texture sub image
 	/**
 	 *  @glsymbols
@@ -690,6 +707,22 @@ public:
 		GLint level = 0
 	);
 
+	/// Specifies a two dimensional texture sub image from an image view
+	/**
+	 *  @throws std::runtime_error if the view is not contiguous
+	 *  and !image.HasPixelStrides()
+	 *
+	 *  @glsymbols
+	 *  @glfunref{TexSubImage2D}
+	 *  @glfunref{PixelStore}
+	 */
+	ObjectOps& SubImage2D(
+		const images::ImageView& image,
+		GLint xoffs = 0,
+		GLint yoffs = 0,
+		GLint level = 0
+	);
+
 	/// Specifies a one dimensional texture sub image
 	/**
 	 *  @glsymbols
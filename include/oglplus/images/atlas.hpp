@@ -0,0 +1,346 @@
+/**
+ *  @file oglplus/images/atlas.hpp
+ *  @brief Packing of multiple images into the pages of a texture atlas
+ *
+ *  @author Matus Chochlik
+ *
+ *  Copyright 2010-2015 Matus Chochlik. Distributed under the Boost
+ *  Software License, Version 1.0. (See accompanying file
+ *  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#pragma once
+#ifndef OGLPLUS_IMAGES_ATLAS_1107121519_HPP
+#define OGLPLUS_IMAGES_ATLAS_1107121519_HPP
+
+#include <oglplus/images/image.hpp>
+#include <oglplus/images/view.hpp>
+#include <oglplus/detail/aligned_pod_array.hpp>
+#include <oglplus/math/vector.hpp>
+
+#include <vector>
+
+namespace oglplus {
+namespace images {
+
+/// Parameters of the ImageAtlas
+struct ImageAtlasParams
+{
+	/// The number of texels added around each image
+	/** The padding is filled by repeating the edge texels of the image,
+	 *  so that linear filtering near the edges of the image does not
+	 *  sample the neighboring images.
+	 */
+	GLsizei padding;
+
+	/// The alignment of the positions and sizes of the cells in the pages
+	/** The cells (images including the padding) are placed at multiples
+	 *  of the alignment and their sizes are rounded up to it. With the
+	 *  alignment of 2^L the first L mipmap levels of the pages do not mix
+	 *  texels of different images (use a padding of at least 2^(L-1)
+	 *  texels to keep also the linear filtering of these levels clean).
+	 */
+	GLsizei alignment;
+
+	/// The maximum number of pages, 0 means no limit
+	std::size_t max_pages;
+
+	ImageAtlasParams(void)
+	 : padding(0)
+	 , alignment(1)
+	 , max_pages(0)
+	{ }
+};
+
+/// The placement of an image in an ImageAtlas
+struct ImageAtlasEntry
+{
+	/// The index of the page or -1 if the image was removed
+	GLint page;
+
+	/// The position of the image (without the padding) in the page
+	GLsizei x, y;
+
+	/// The size of the image
+	GLsizei width, height;
+};
+
+/// Packs many small images into one or several larger pages
+/** The images (for example sprites or icons) are packed into pages
+ *  of the specified size with the skyline bottom-left algorithm and each
+ *  inserted image gets an id, which remains valid until the atlas is
+ *  destroyed. The entries (see Entry, UVRect and UVTable) tell where
+ *  the images were placed, so that the pages can be used as a single
+ *  texture (or as the layers of an array texture) instead of a texture
+ *  per image, saving the texture binds and draw calls.
+ *
+ *  The images are added incrementally and the removed images leave holes
+ *  in the pages which are not reused until the atlas is defragmented.
+ *  Defragment repacks the remaining images (sorted by their size, which
+ *  usually also packs them more tightly than the incremental insertion)
+ *  and moves their entries.
+ *
+ *  @code
+ *  images::ImageAtlasParams params;
+ *  params.padding = 2;
+ *  images::ImageAtlas atlas(
+ *      1024, 1024, 4,
+ *      (GLubyte*)nullptr,
+ *      PixelDataFormat::RGBA,
+ *      PixelDataInternalFormat::RGBA8,
+ *      params
+ *  );
+ *  std::size_t ship = atlas.Insert(images::LoadTexture("ship"));
+ *  std::size_t rock = atlas.Insert(images::LoadTexture("rock"));
+ *  // upload atlas.Page(i) into the i-th layer of a 2D array texture
+ *  // and use atlas.UVTable() to map the texture coordinates
+ *  @endcode
+ *
+ *  @ingroup image_load_gen
+ */
+class ImageAtlas
+{
+private:
+	GLsizei _width, _height, _channels;
+	std::size_t _pixel_size;
+	PixelDataType _type;
+	PixelDataFormat _format;
+	PixelDataInternalFormat _internal;
+	ImageAtlasParams _params;
+
+	// a horizontal segment of the skyline of a page
+	struct _segment
+	{
+		GLsizei x, y, width;
+	};
+	typedef std::vector<_segment> _skyline;
+
+	std::vector<oglplus::aux::AlignedPODArray> _pages;
+	std::vector<_skyline> _skylines;
+	std::vector<unsigned char> _modified;
+	std::vector<ImageAtlasEntry> _entries;
+	std::size_t _removed_area, _used_area;
+
+	void _init(void);
+
+	GLsizei _cell_size(GLsizei size) const
+	{
+		const GLsizei a = _params.alignment;
+		return ((size+2*_params.padding+a-1)/a)*a;
+	}
+
+	unsigned char* _texel(
+		const oglplus::aux::AlignedPODArray& page,
+		GLsizei x,
+		GLsizei y
+	) const
+	{
+		return static_cast<unsigned char*>(page.begin())+
+			std::size_t(y*_width+x)*_pixel_size;
+	}
+
+	oglplus::aux::AlignedPODArray _new_page(void) const;
+
+	bool _find(
+		const _skyline& skyline,
+		GLsizei w,
+		GLsizei h,
+		GLsizei& x,
+		GLsizei& y
+	) const;
+
+	static void _place(
+		_skyline& skyline,
+		GLsizei x,
+		GLsizei y,
+		GLsizei w,
+		GLsizei h
+	);
+
+	bool _allocate(
+		std::vector<oglplus::aux::AlignedPODArray>& pages,
+		std::vector<_skyline>& skylines,
+		GLsizei w,
+		GLsizei h,
+		GLint& page,
+		GLsizei& x,
+		GLsizei& y
+	) const;
+public:
+	/// Creates an empty atlas with pages of the specified size and format
+	template <typename T>
+	ImageAtlas(
+		SizeType page_width,
+		SizeType page_height,
+		SizeType channels,
+		const T*,
+		PixelDataFormat format,
+		PixelDataInternalFormat internal,
+		const ImageAtlasParams& params = ImageAtlasParams()
+	): _width(page_width)
+	 , _height(page_height)
+	 , _channels(channels)
+	 , _pixel_size(std::size_t(_channels)*sizeof(T))
+	 , _type(PixelDataType(GetDataType<T>()))
+	 , _format(format)
+	 , _internal(internal)
+	 , _params(params)
+	 , _removed_area(0)
+	 , _used_area(0)
+	{
+		_init();
+	}
+
+	/// Returns the width of the pages
+	SizeType Width(void) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		return MakeSizeType(_width, std::nothrow);
+	}
+
+	/// Returns the height of the pages
+	SizeType Height(void) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		return MakeSizeType(_height, std::nothrow);
+	}
+
+	/// Returns the number of channels
+	SizeType Channels(void) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		return MakeSizeType(_channels, std::nothrow);
+	}
+
+	/// Returns the pixel data type
+	PixelDataType Type(void) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		return _type;
+	}
+
+	/// Returns the pixel data format
+	PixelDataFormat Format(void) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		return _format;
+	}
+
+	/// Returns the pixel data internal format
+	PixelDataInternalFormat InternalFormat(void) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		return _internal;
+	}
+
+	/// Inserts a 2D @p image into the atlas and returns its id
+	/** The images with a different type or format are converted
+	 *  (see Convert). Throws @c std::runtime_error if the image (including
+	 *  the padding) is larger than a page or if it does not fit into
+	 *  the pages and the maximum number of pages was reached, in which case
+	 *  Defragment may make room for it.
+	 */
+	std::size_t Insert(const ImageView& image);
+
+	/// Removes the image with the specified @p id from the atlas
+	/** The space occupied by the image is reused after Defragment.
+	 */
+	void Remove(std::size_t id);
+
+	/// Repacks the remaining images, returns the new number of pages
+	/** The ids of the images do not change, but their entries do and all
+	 *  the pages are marked as modified. If the images would not fit into
+	 *  the maximum number of pages (which is possible, but unlikely),
+	 *  the function throws @c std::runtime_error and the atlas is
+	 *  left unchanged.
+	 */
+	std::size_t Defragment(void);
+
+	/// Returns the fraction of the used space occupied by removed images
+	GLfloat Fragmentation(void) const
+	{
+		return _used_area?GLfloat(_removed_area)/GLfloat(_used_area):0;
+	}
+
+	/// Returns the number of ids (including those of removed images)
+	std::size_t Count(void) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		return _entries.size();
+	}
+
+	/// Returns the placement of the image with the specified @p id
+	const ImageAtlasEntry& Entry(std::size_t id) const
+	{
+		assert(id < _entries.size());
+		return _entries[id];
+	}
+
+	/// Returns the texture coordinates (u0, v0, u1, v1) of an image
+	/** The coordinates of removed images are all zero.
+	 */
+	Vec4f UVRect(std::size_t id) const
+	{
+		const ImageAtlasEntry& e = Entry(id);
+		if(e.page < 0) return Vec4f();
+		return Vec4f(
+			GLfloat(e.x)/GLfloat(_width),
+			GLfloat(e.y)/GLfloat(_height),
+			GLfloat(e.x+e.width)/GLfloat(_width),
+			GLfloat(e.y+e.height)/GLfloat(_height)
+		);
+	}
+
+	/// Returns the UVRect of all images indexed by their ids
+	std::vector<Vec4f> UVTable(void) const;
+
+	/// Returns the number of pages
+	std::size_t PageCount(void) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		return _pages.size();
+	}
+
+	/// Returns a view of the specified page
+	/** The view is invalidated by Defragment.
+	 */
+	ImageView Page(std::size_t page) const
+	{
+		assert(page < _pages.size());
+		return ImageView(
+			_width, _height, 1,
+			_channels,
+			_pages[page].begin(),
+			_type,
+			_format,
+			_internal
+		);
+	}
+
+	/// Makes a copy of the specified page
+	Image PageImage(std::size_t page) const;
+
+	/// Returns true if the page was modified since ClearModified
+	/** This can be used to upload only the modified pages into a texture.
+	 */
+	bool PageModified(std::size_t page) const
+	{
+		assert(page < _modified.size());
+		return _modified[page] != 0;
+	}
+
+	/// Clears the modified flags of all pages
+	void ClearModified(void)
+	{
+		_modified.assign(_modified.size(), 0);
+	}
+};
+
+} // namespace images
+} // namespace oglplus
+
+#if !OGLPLUS_LINK_LIBRARY || defined(OGLPLUS_IMPLEMENTING_LIBRARY)
+#include <oglplus/images/atlas.ipp>
+#endif
+
+#endif // include guard
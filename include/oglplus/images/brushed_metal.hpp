@@ -14,6 +14,7 @@
 #define OGLPLUS_IMAGES_BRUSHED_METAL_1107121519_HPP
 
 #include <oglplus/images/image.hpp>
+#include <oglplus/images/counter_rng.hpp>
 
 namespace oglplus {
 namespace images {
@@ -35,7 +36,9 @@ private:
 		GLint y,
 		double /*c*/,
 		GLubyte r,
-		GLubyte g
+		GLubyte g,
+		GLint y_begin,
+		GLint y_end
 	);
 
 	static void _make_scratch(
@@ -46,9 +49,12 @@ private:
 		GLint x,
 		GLint y,
 		GLint dx,
-		GLint dy
+		GLint dy,
+		GLint y_begin,
+		GLint y_end
 	);
 public:
+	/// Creates the image using the global @c std::rand() generator
 	BrushedMetalUByte(
 		SizeType width,
 		SizeType height,
@@ -58,6 +64,24 @@ public:
 		int t_disp_min,
 		int t_disp_max
 	);
+
+	/// Creates a reproducible image using an explicit random @p seed
+	/** The parameters of each scratch are derived from the @p seed and
+	 *  from the index of the scratch. The image is split into horizontal
+	 *  bands drawn by multiple threads, each band drawing the parts
+	 *  of all the scratches passing through it in the same order, so the
+	 *  result does not depend on the number of threads.
+	 */
+	BrushedMetalUByte(
+		SizeType width,
+		SizeType height,
+		unsigned n_scratches,
+		int s_disp_min,
+		int s_disp_max,
+		int t_disp_min,
+		int t_disp_max,
+		RandomSeed seed
+	);
 };
 
 } // images
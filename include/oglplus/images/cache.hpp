@@ -0,0 +1,276 @@
+/**
+ *  @file oglplus/images/cache.hpp
+ *  @brief Persistent on-disk cache of generated images
+ *
+ *  @author Matus Chochlik
+ *
+ *  Copyright 2010-2015 Matus Chochlik. Distributed under the Boost
+ *  Software License, Version 1.0. (See accompanying file
+ *  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#pragma once
+#ifndef OGLPLUS_IMAGES_CACHE_1107121519_HPP
+#define OGLPLUS_IMAGES_CACHE_1107121519_HPP
+
+#include <oglplus/config/compiler.hpp>
+#include <oglplus/images/view.hpp>
+#include <oglplus/images/counter_rng.hpp>
+#include <oglplus/math/vector.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace oglplus {
+namespace images {
+
+/// The key identifying a generated image in the ImageCache
+/** The key is a 64-bit hash of the name of the generator and of all
+ *  the parameters which affect the generated image. The parameters
+ *  are hashed by their binary representation, so the key is only
+ *  valid on the same platform. Images (or image views) passed to
+ *  generators are hashed by their dimensions, format and contents.
+ *
+ *  @ingroup image_load_gen
+ */
+class ImageCacheKey
+{
+private:
+	std::uint64_t _hash;
+
+	void _add_word(std::uint64_t word)
+	{
+		_hash = CounterRNG::Mix(_hash ^ CounterRNG::Mix(word));
+	}
+
+	void _add_bytes(const void* data, std::size_t size)
+	{
+		const unsigned char* p = static_cast<const unsigned char*>(data);
+		_add_word(size);
+		while(size >= 8)
+		{
+			std::uint64_t word;
+			std::memcpy(&word, p, 8);
+			_add_word(word);
+			p += 8;
+			size -= 8;
+		}
+		if(size > 0)
+		{
+			std::uint64_t word = 0;
+			std::memcpy(&word, p, size);
+			_add_word(word);
+		}
+	}
+public:
+	/// Creates a key for the generator with the specified @p name
+	explicit
+	ImageCacheKey(const std::string& name)
+	 : _hash(0)
+	{
+		Add(name);
+	}
+
+	/// Adds a value of an arithmetic or enumeration type to the key
+	template <typename T>
+	typename std::enable_if<
+		std::is_arithmetic<T>::value ||
+		std::is_enum<T>::value,
+		ImageCacheKey&
+	>::type Add(T value)
+	{
+		_add_bytes(&value, sizeof(value));
+		return *this;
+	}
+
+	/// Adds a string to the key
+	ImageCacheKey& Add(const std::string& str)
+	{
+		_add_bytes(str.data(), str.size());
+		return *this;
+	}
+
+	/// Adds a string to the key
+	ImageCacheKey& Add(const char* str)
+	{
+		_add_bytes(str, std::strlen(str));
+		return *this;
+	}
+
+	/// Adds a size value to the key
+	ImageCacheKey& Add(SizeType size)
+	{
+		return Add(GLsizei(size));
+	}
+
+	/// Adds a random seed to the key
+	ImageCacheKey& Add(RandomSeed seed)
+	{
+		return Add(seed.Value());
+	}
+
+	/// Adds the components of a vector to the key
+	template <typename T, std::size_t N>
+	ImageCacheKey& Add(const Vector<T, N>& vec)
+	{
+		_add_bytes(vec.Data(), sizeof(T)*N);
+		return *this;
+	}
+
+	/// Adds an array of @p count values to the key
+	template <typename T>
+	ImageCacheKey& Add(const T* values, std::size_t count)
+	{
+		static_assert(
+			std::is_arithmetic<T>::value,
+			"Only arrays of arithmetic values can be hashed"
+		);
+		_add_bytes(values, sizeof(T)*count);
+		return *this;
+	}
+
+	/// Adds the dimensions, the format and the contents of an image
+	ImageCacheKey& Add(const ImageView& image);
+
+	/// Returns the hash value of the key
+	std::uint64_t Hash(void) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		return _hash;
+	}
+};
+
+/// Persistent on-disk cache of (procedurally) generated images
+/** Each image is stored in a separate file in the cache directory,
+ *  named by the hash of its ImageCacheKey and of the version tag of
+ *  the cache. The file contains a small header followed by the raw pixel
+ *  data, which is memory-mapped (where the system supports it) when
+ *  the image is found in the cache, instead of being generated again.
+ *
+ *  The cache is never invalidated implicitly. When the generators or
+ *  the meaning of their parameters change, the version tag passed
+ *  to the constructor must be changed too. Note that the images made
+ *  by generators using @c std::rand() (without an explicit RandomSeed)
+ *  are cached as well, i.e. they no longer change between runs.
+ *
+ *  Errors when writing to the cache directory are ignored and files
+ *  which cannot be read (or which have an unexpected header) are treated
+ *  as cache misses, so the cache can only make the images faster
+ *  to obtain, not unavailable.
+ *
+ *  @code
+ *  images::ImageCache cache("cache", "v1");
+ *  // the key is built from the arguments
+ *  images::Image cloud = cache.Make<images::Cloud>(
+ *      "Cloud", 128, 128, 128, images::RandomSeed(42)
+ *  );
+ *  // or explicitly, for parameters that cannot be hashed directly
+ *  images::Image balls = cache.Get(
+ *      images::ImageCacheKey("Metaballs").Add(512).Add(512).Add(data, n),
+ *      [&](void) { return images::Metaballs(512, 512, data, n); }
+ *  );
+ *  @endcode
+ *
+ *  @ingroup image_load_gen
+ */
+class ImageCache
+{
+private:
+	std::string _directory;
+	std::uint64_t _version;
+
+#if !OGLPLUS_NO_VARIADIC_TEMPLATES
+	static void _add_params(ImageCacheKey&) { }
+
+	template <typename P, typename ... R>
+	static void _add_params(ImageCacheKey& key, const P& p, const R& ... r)
+	{
+		key.Add(p);
+		_add_params(key, r...);
+	}
+#endif
+
+	// an initially empty image which is either loaded by _load
+	// or assigned the generated image
+	struct _image
+	 : Image
+	{
+		_image(void)
+		OGLPLUS_NOEXCEPT(true)
+		{ }
+	};
+
+	std::uint64_t _file_hash(const ImageCacheKey& key) const;
+	std::string _file_path(std::uint64_t hash) const;
+
+	bool _load(const ImageCacheKey& key, Image& image) const;
+public:
+	/// Creates a cache in the specified @p directory
+	/** The @p directory must exist. Images stored with a different
+	 *  @p version tag are not found in the cache.
+	 */
+	ImageCache(const std::string& directory, const std::string& version);
+
+	/// Returns the path of the file storing the image with a @p key
+	std::string FilePath(const ImageCacheKey& key) const;
+
+	/// Returns true if the image with the specified @p key is cached
+	bool Contains(const ImageCacheKey& key) const;
+
+	/// Stores the @p image in the cache under the specified @p key
+	/** Images with the integer and floating-point types, @c HalfFloat
+	 *  and the packed types with a single 32-bit component per pixel
+	 *  (see ImageView::IsPacked) can be stored. Returns false if
+	 *  the image could not be stored.
+	 */
+	bool Store(const ImageCacheKey& key, const ImageView& image) const;
+
+	/// Removes the image with the specified @p key from the cache
+	bool Remove(const ImageCacheKey& key) const;
+
+	/// Finds an image in the cache or generates and stores it
+	/** The @p generator is called without arguments if the image
+	 *  with the specified @p key is not found in the cache and it must
+	 *  return an Image (or a class derived from Image).
+	 */
+	template <typename Generator>
+	Image Get(const ImageCacheKey& key, Generator generator) const
+	{
+		_image image;
+		if(!_load(key, image))
+		{
+			static_cast<Image&>(image) = generator();
+			Store(key, image);
+		}
+		return Image(std::move(image));
+	}
+
+#if OGLPLUS_DOCUMENTATION_ONLY || !OGLPLUS_NO_VARIADIC_TEMPLATES
+	/// Finds or makes an image with the @p ImageGen(params...) generator
+	/** The key of the image consists of the specified @p name and of all
+	 *  the @p params, which must be hashable by ImageCacheKey::Add.
+	 *  The @p name identifies the generator in the files of the cache,
+	 *  so it must be stable between builds and runs (the name of
+	 *  the @p ImageGen class is usually a good choice).
+	 */
+	template <typename ImageGen, typename ... P>
+	Image Make(const std::string& name, const P& ... params) const
+	{
+		ImageCacheKey key(name);
+		_add_params(key, params...);
+		return Get(key, [&](void) { return ImageGen(params...); });
+	}
+#endif
+};
+
+} // namespace images
+} // namespace oglplus
+
+#if !OGLPLUS_LINK_LIBRARY || defined(OGLPLUS_IMPLEMENTING_LIBRARY)
+#include <oglplus/images/cache.ipp>
+#endif
+
+#endif // include guard
@@ -14,13 +14,22 @@
 #define OGLPLUS_IMAGES_CELL_1107121519_HPP
 
 #include <oglplus/images/image.hpp>
+#include <oglplus/images/view.hpp>
 #include <oglplus/assert.hpp>
+#include <oglplus/detail/parallel_for.hpp>
 
 #include <vector>
 
 namespace oglplus {
 namespace images {
 
+/// Base class for the cell (Voronoi/Worley) image generators
+/** The rows of the output image are calculated in parallel, every worker
+ *  thread uses its own copies of the distance and value functors.
+ *
+ *  @note Do not use this class directly, use the derived classes instead.
+ *  @ingroup image_load_gen
+ */
 template <typename T, unsigned CH>
 class CellImageGen
  : public Image
@@ -80,7 +89,7 @@ public:
 		SizeType cell_w,
 		SizeType cell_h,
 		SizeType cell_d,
-		const Image& input,
+		const ImageView& input,
 		GetDistance get_distance,
 		GetValue get_value
 	): Image(
@@ -93,17 +102,27 @@ public:
 	{
 		const T one = this->_one(TypeTag<T>());
 
-		const double i_w = 1.0/GLsizei(Width());
-		const double i_h = 1.0/GLsizei(Height());
-		const double i_d = 1.0/GLsizei(Depth());
+		const GLsizei w = Width();
+		const GLsizei h = Height();
+		const GLsizei d = Depth();
+
+		const double i_w = 1.0/w;
+		const double i_h = 1.0/h;
+		const double i_d = 1.0/d;
 
 		const GLsizei iw = input.Width();
 		const GLsizei ih = input.Height();
 		const GLsizei id = input.Depth();
 
+		// plain integers, because the neighbour cell coordinates
+		// multiplied by these can be negative
+		const GLsizei cw = cell_w;
+		const GLsizei ch = cell_h;
+		const GLsizei cd = cell_d;
+
 		std::size_t dims = 1;
-		if(ih*cell_h > 1) dims = 2;
-		if(id*cell_d > 1) dims = 3;
+		if(ih*ch > 1) dims = 2;
+		if(id*cd > 1) dims = 3;
 
 		const GLsizei kmin = (dims == 3)?-1:0;
 		const GLsizei kmax = (dims == 3)?+2:1;
@@ -112,67 +131,94 @@ public:
 		const GLsizei imin = -1;
 		const GLsizei imax = +2;
 
-		Vector<double, 3> colors[27];
-		double dists[27];
-
 		const Vector<double, 3> is(iw, ih, id);
 
-		auto pos = this->_begin<T>();
-
-		for(GLsizei z=0; z<Depth(); ++z)
+		// the feature points of the input cells are read only once
+		// instead of for every neighbour of every output texel
+		std::vector<Vector<double, 3>> points(std::size_t(iw*ih*id));
+		for(GLsizei z=0; z<id; ++z)
+		for(GLsizei y=0; y<ih; ++y)
+		for(GLsizei x=0; x<iw; ++x)
 		{
-			GLsizei cz = z/cell_d;
-
-			for(GLsizei y=0; y<Height(); ++y)
+			points[std::size_t((z*ih+y)*iw+x)] = input.Pixel(x, y, z).xyz();
+		}
+		const Vector<double, 3>* const pts = points.data();
+
+		T* const data = this->_begin<T>();
+		T* const data_end = this->_end<T>();
+		OGLPLUS_FAKE_USE(data_end);
+
+		// every worker gets its own copy of the lambda and thus also
+		// of the get_distance and get_value functors
+		oglplus::aux::ParallelFor(
+			std::size_t(h*d),
+			std::size_t(4),
+			[=](std::size_t row_begin, std::size_t row_end) mutable
 			{
-				GLsizei cy = y/cell_h;
+				Vector<double, 3> colors[27];
+				double dists[27];
 
-				for(GLsizei x=0; x<Width(); ++x)
+				for(std::size_t row=row_begin; row!=row_end; ++row)
 				{
-					GLsizei cx = x/cell_w;
-
-					Vector<double, 3> tc = Vector<double, 3>(x*i_w, y*i_h, z*i_d);
+					const GLsizei z = GLsizei(row)/h;
+					const GLsizei y = GLsizei(row)%h;
+					const GLsizei cz = z/cd;
+					const GLsizei cy = y/ch;
 
-					GLsizei l=0;
+					T* pos = data + row*std::size_t(w)*CH;
 
-					for(GLsizei k=kmin; k<kmax; ++k)
-					for(GLsizei j=jmin; j<jmax; ++j)
-					for(GLsizei i=imin; i<imax; ++i)
+					for(GLsizei x=0; x<w; ++x)
 					{
-						GLsizei ccz = cz+k;
-						GLsizei ccy = cy+j;
-						GLsizei ccx = cx+i;
+						GLsizei cx = x/cw;
 
-						Vector<double, 3> cc(
-							ccx*cell_w*i_w,
-							ccy*cell_h*i_h,
-							ccz*cell_d*i_d
-						);
+						Vector<double, 3> tc(x*i_w, y*i_h, z*i_d);
 
-						ccz = (ccz+id)%id;
-						ccy = (ccy+ih)%ih;
-						ccx = (ccx+iw)%iw;
+						GLsizei l=0;
 
-						colors[l] = input.Pixel(ccx, ccy, ccz).xyz();
-						Vector<double, 3> co = colors[l];
-
-						dists[l] = get_distance(dims, tc, cc, co, is);
-
-						++l;
-					}
+						for(GLsizei k=kmin; k<kmax; ++k)
+						for(GLsizei j=jmin; j<jmax; ++j)
+						for(GLsizei i=imin; i<imax; ++i)
+						{
+							GLsizei ccz = cz+k;
+							GLsizei ccy = cy+j;
+							GLsizei ccx = cx+i;
+
+							Vector<double, 3> cc(
+								ccx*cw*i_w,
+								ccy*ch*i_h,
+								ccz*cd*i_d
+							);
+
+							ccz = (ccz+id)%id;
+							ccy = (ccy+ih)%ih;
+							ccx = (ccx+iw)%iw;
+
+							colors[l] = pts[(ccz*ih+ccy)*iw+ccx];
+
+							dists[l] = get_distance(
+								dims,
+								tc,
+								cc,
+								colors[l],
+								is
+							);
+
+							++l;
+						}
 
-					Vector<double, CH> value = get_value(dists, colors, l);
+						Vector<double, CH> value =
+							get_value(dists, colors, l);
 
-					for(std::size_t c=0; c!=CH; ++c)
-					{
-						assert(pos != this->_end<T>());
-						double vc = value.At(c);
-						*pos++ = T(one*vc);
+						for(std::size_t c=0; c!=CH; ++c)
+						{
+							assert(pos != data_end);
+							double vc = value.At(c);
+							*pos++ = T(one*vc);
+						}
 					}
 				}
 			}
-		}
-		assert(pos == this->_end<T>());
+		);
 	}
 };
 
@@ -231,7 +277,7 @@ public:
 		SizeType cell_w,
 		SizeType cell_h,
 		SizeType cell_d,
-		const Image& input,
+		const ImageView& input,
 		ValueCalc calc_value,
 		unsigned order
 	): CellImageGen<GLubyte, 1>(
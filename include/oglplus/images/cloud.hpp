@@ -14,11 +14,172 @@
 #define OGLPLUS_IMAGES_CLOUD_1107121519_HPP
 
 #include <oglplus/images/image.hpp>
+#include <oglplus/images/tile_source.hpp>
+#include <oglplus/images/sparse.hpp>
+#include <oglplus/images/counter_rng.hpp>
 #include <oglplus/math/vector.hpp>
 
+#include <vector>
+
 namespace oglplus {
 namespace images {
 
+/// Tile source making regions of the (seeded) Cloud image on demand
+/** The source makes exactly the same image as the Cloud constructor
+ *  with an explicit RandomSeed, but only the requested regions of it,
+ *  so it can be used for clouds which do not fit into memory (see
+ *  ImageTileCache). The spheres forming the cloud are generated by the
+ *  constructor and each region is made by splatting only the spheres
+ *  intersecting it. The lower mipmap levels are the same cloud made with
+ *  lower resolution, not filtered versions of level 0.
+ *
+ *  @ingroup image_load_gen
+ */
+class CloudTileSource
+ : public ImageTileSource
+{
+private:
+	friend class Cloud;
+
+	GLsizei _width, _height, _depth;
+	GLfloat _sub_scale;
+	GLfloat _sub_variance;
+	GLfloat _min_radius;
+	std::vector<Vec4f> _spheres;
+
+	static void _adjust_sphere(Vec3f& center, GLfloat& radius);
+
+	static bool _texel_range(
+		GLfloat center,
+		GLfloat radius,
+		GLsizei size,
+		GLsizei& begin,
+		GLsizei& end
+	);
+
+	std::size_t _push_sphere(
+		Vec3f& center,
+		GLfloat& radius,
+		std::vector<Vec4f>& spheres
+	) const;
+
+	void _gen_sub_sphere(
+		const Vec3f& center,
+		GLfloat radius,
+		const CounterRNG& rng,
+		std::size_t index,
+		std::vector<Vec4f>& spheres
+	) const;
+
+	void _gen_spheres(
+		Vec3f center,
+		GLfloat radius,
+		const CounterRNG& rng,
+		std::vector<Vec4f>& spheres
+	) const;
+
+	// Splats a sphere into the specified region of a volume
+	static void _splat_sphere(
+		const Vec4f& sphere,
+		GLsizei w,
+		GLsizei h,
+		GLsizei d,
+		GLsizei xoffs,
+		GLsizei yoffs,
+		GLsizei zoffs,
+		GLsizei rw,
+		GLsizei rh,
+		GLsizei rd,
+		GLubyte* data
+	);
+
+	// Splats the spheres into the specified region of a volume
+	// with the specified size, the region must be zero-initialized
+	void _splat_spheres(
+		GLsizei w,
+		GLsizei h,
+		GLsizei d,
+		GLsizei xoffs,
+		GLsizei yoffs,
+		GLsizei zoffs,
+		GLsizei rw,
+		GLsizei rh,
+		GLsizei rd,
+		GLubyte* data
+	) const;
+public:
+	/// Creates a source of the cloud with the specified parameters
+	/** The parameters have the same meaning as those of the seeded
+	 *  Cloud constructor.
+	 */
+	CloudTileSource(
+		SizeType width,
+		SizeType height,
+		SizeType depth,
+		RandomSeed seed,
+		const Vec3f& origin = Vec3f(0.0f, -0.3f, 0.0f),
+		GLfloat init_radius = 0.7f,
+		GLfloat sub_scale = 0.333f,
+		GLfloat sub_variance = 0.5f,
+		GLfloat min_radius = 0.04f
+	);
+
+	SizeType Width(void) const
+	{
+		return MakeSizeType(_width, std::nothrow);
+	}
+
+	SizeType Height(void) const
+	{
+		return MakeSizeType(_height, std::nothrow);
+	}
+
+	SizeType Depth(void) const
+	{
+		return MakeSizeType(_depth, std::nothrow);
+	}
+
+	SizeType Channels(void) const
+	{
+		return MakeSizeType(1, std::nothrow);
+	}
+
+	PixelDataType Type(void) const
+	{
+		return PixelDataType::UnsignedByte;
+	}
+
+	PixelDataFormat Format(void) const
+	{
+		return PixelDataFormat::Red;
+	}
+
+	PixelDataInternalFormat InternalFormat(void) const
+	{
+		return PixelDataInternalFormat::Red;
+	}
+
+	GLint Levels(void) const;
+
+	Image MakeRegion(
+		GLint level,
+		GLint xoffs,
+		GLint yoffs,
+		GLint zoffs,
+		SizeType width,
+		SizeType height,
+		SizeType depth
+	) const;
+
+	/// Makes the specified @p level of the cloud as a SparseImage
+	/** Only the bricks intersected by the spheres are allocated
+	 *  and the spheres are splatted directly into them (the bricks
+	 *  in parallel), the bricks which remain empty are released.
+	 *  The texels are the same as those of the dense image.
+	 */
+	SparseImage MakeSparse(GLint level = 0, GLsizei brick_size = 32) const;
+};
+
 /// A simple generator of 3D textures which can be used to render cloud effects
 /** This class generates alpha (or RED, i.e. one component per pixel) textures
  *  which represent the density of a vapor cloud or smoke in 3D space.
@@ -33,7 +194,6 @@ private:
 	GLfloat _sub_variance;
 	GLfloat _min_radius;
 
-	void _adjust_sphere(Vec3f& center, GLfloat& radius) const;
 	bool _apply_sphere(const Vec3f& center, GLfloat radius);
 
 	static GLfloat _rand_u(void);
@@ -52,6 +212,28 @@ public:
 		GLfloat sub_variance = 0.5f,
 		GLfloat min_radius = 0.04f
 	);
+
+	/// Creates a reproducible cloud image using an explicit random @p seed
+	/** Unlike the constructor above, this one does not use the global
+	 *  @c std::rand() generator. Every branch of the recursive sphere
+	 *  placement has its own counter-based random number generator,
+	 *  so the branches are generated in parallel and the spheres are then
+	 *  splatted into separate z-slabs of the volume by multiple threads.
+	 *  The result depends only on the parameters and on the @p seed,
+	 *  not on the number of threads or on other uses of @c std::rand().
+	 *  CloudTileSource makes the same image by regions.
+	 */
+	Cloud(
+		SizeType width,
+		SizeType height,
+		SizeType depth,
+		RandomSeed seed,
+		const Vec3f& origin = Vec3f(0.0f, -0.3f, 0.0f),
+		GLfloat init_radius = 0.7f,
+		GLfloat sub_scale = 0.333f,
+		GLfloat sub_variance = 0.5f,
+		GLfloat min_radius = 0.04f
+	);
 };
 
 class Cloud2D
@@ -0,0 +1,164 @@
+/**
+ *  @file oglplus/images/compressed.hpp
+ *  @brief Block-compressed (BCn) image encoder
+ *
+ *  @author Matus Chochlik
+ *
+ *  Copyright 2010-2015 Matus Chochlik. Distributed under the Boost
+ *  Software License, Version 1.0. (See accompanying file
+ *  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#pragma once
+#ifndef OGLPLUS_IMAGES_COMPRESSED_1107121519_HPP
+#define OGLPLUS_IMAGES_COMPRESSED_1107121519_HPP
+
+#include <oglplus/images/view.hpp>
+
+#include <cstddef>
+
+namespace oglplus {
+namespace images {
+
+/// The block compression formats produced by CompressedImage
+enum class BlockCompression
+{
+	/// Opaque RGB, 4 bits per pixel (S3TC DXT1)
+	BC1,
+	/// RGBA, 8 bits per pixel (S3TC DXT5)
+	BC3,
+	/// Single channel, 4 bits per pixel (RGTC1)
+	BC4,
+	/// Two channels, 8 bits per pixel (RGTC2), suitable for normal maps
+	BC5,
+	/// RGBA, 8 bits per pixel (BPTC)
+	BC7
+};
+
+/// Parameters of the CompressedImage encoder
+struct BlockCompressionParams
+{
+	/// The compressed format
+	BlockCompression format;
+
+	/// Use the slower, higher-quality endpoint search
+	/** In the fast mode the endpoints of each block are taken from the
+	 *  extents of the block's pixels along their principal axis. In the
+	 *  high-quality mode the endpoints are further refined by least
+	 *  squares fitting and the best of several candidates is used.
+	 */
+	bool high_quality;
+
+	/// Use the sRGB variant of the internal format (BC1, BC3 and BC7)
+	bool srgb;
+
+	/// Encode signed values in the [-1, 1] range (BC4 and BC5)
+	/** This allows to compress for example the (signed) normal vectors
+	 *  produced by NormalMap without remapping them.
+	 */
+	bool snorm;
+
+	/// The maximum number of threads used, 0 means no limit
+	unsigned max_threads;
+
+	BlockCompressionParams(BlockCompression fmt = BlockCompression::BC7)
+	 : format(fmt)
+	 , high_quality(false)
+	 , srgb(false)
+	 , snorm(false)
+	 , max_threads(0)
+	{ }
+};
+
+/// An image compressed in one of the BCn block compression formats
+/** The image is split into blocks of 4x4 pixels which are compressed
+ *  in parallel. The last blocks in each row and column of images with
+ *  dimensions not divisible by 4 are padded by repeating the edge pixels.
+ *
+ *  The channels of the source image are mapped to the channels of
+ *  the compressed format like when the image is uploaded to GL, i.e.
+ *  the missing color channels are zero and the missing alpha is one.
+ *  BC4 compresses only the first and BC5 the first two channels.
+ *
+ *  The compressed image can be passed to @c Texture::CompressedImage2D.
+ *
+ *  @ingroup image_load_gen
+ */
+class CompressedImage
+{
+private:
+	GLsizei _width, _height;
+	BlockCompression _format;
+	PixelDataInternalFormat _internal;
+	oglplus::aux::AlignedPODArray _storage;
+
+	static
+	PixelDataInternalFormat _get_internal(const BlockCompressionParams&);
+public:
+	/// Compresses the specified @p image
+	explicit
+	CompressedImage(
+		const ImageView& image,
+		const BlockCompressionParams& params = BlockCompressionParams()
+	);
+
+	/// Returns the width of the image
+	SizeType Width(void) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		return MakeSizeType(_width, std::nothrow);
+	}
+
+	/// Returns the height of the image
+	SizeType Height(void) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		return MakeSizeType(_height, std::nothrow);
+	}
+
+	/// Returns the compression format
+	BlockCompression Format(void) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		return _format;
+	}
+
+	/// Returns the GL compressed internal format of the image
+	PixelDataInternalFormat InternalFormat(void) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		return _internal;
+	}
+
+	/// Returns the size of a compressed 4x4 block in bytes
+	static
+	std::size_t BlockSize(BlockCompression format)
+	OGLPLUS_NOEXCEPT(true)
+	{
+		return	((format == BlockCompression::BC1) ||
+			(format == BlockCompression::BC4))?8:16;
+	}
+
+	/// Returns the size of the compressed data in bytes
+	SizeType DataSize(void) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		return MakeSizeType(GLsizei(_storage.size()), std::nothrow);
+	}
+
+	/// Returns a pointer to the compressed data
+	const void* RawData(void) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		return _storage.begin();
+	}
+};
+
+} // namespace images
+} // namespace oglplus
+
+#if !OGLPLUS_LINK_LIBRARY || defined(OGLPLUS_IMPLEMENTING_LIBRARY)
+#include <oglplus/images/compressed.ipp>
+#endif
+
+#endif // include guard
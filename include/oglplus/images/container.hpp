@@ -0,0 +1,247 @@
+/**
+ *  @file oglplus/images/container.hpp
+ *  @brief Memory-mapped KTX and DDS texture container loader
+ *
+ *  @author Matus Chochlik
+ *
+ *  Copyright 2010-2015 Matus Chochlik. Distributed under the Boost
+ *  Software License, Version 1.0. (See accompanying file
+ *  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#pragma once
+#ifndef OGLPLUS_IMAGES_CONTAINER_1107121519_HPP
+#define OGLPLUS_IMAGES_CONTAINER_1107121519_HPP
+
+#include <oglplus/images/view.hpp>
+
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+namespace oglplus {
+namespace images {
+
+/// Texture images stored in a KTX or DDS container file
+/** The file is mapped into memory (where the system supports it) and
+ *  the individual images (mipmap levels, array layers and cube map faces)
+ *  refer directly to the mapped data, which can be passed to GL without
+ *  any intermediate copies, either through the @c Texture::Image2D and
+ *  @c Texture::Image3D overloads taking the whole container, or one
+ *  image at a time through @c RawData and @c View.
+ *
+ *  Both uncompressed and block-compressed images are supported. The type
+ *  of the file is detected from its contents. Big-endian KTX files are
+ *  converted to the native byte order in the (copy-on-write) mapping.
+ *
+ *  The rows of KTX images are aligned to 4 bytes, the rows of DDS images
+ *  are tightly packed (see @c RowAlignment). Note that DDS files store
+ *  the rows from the top of the image, so unlike with KTX the first row
+ *  of a DDS image is the top row when uploaded to GL.
+ *
+ *  @ingroup image_load_gen
+ */
+class TextureContainer
+{
+private:
+	oglplus::aux::AlignedPODArray _mapped;
+
+	GLsizei _width, _height, _depth;
+	GLsizei _layers, _faces, _levels;
+	GLsizei _channels;
+	GLint _alignment;
+	bool _is_array;
+	bool _compressed;
+	std::size_t _block_size;
+
+	PixelDataType _type;
+	PixelDataFormat _format;
+	PixelDataInternalFormat _internal;
+
+	// the offset and size of each image, the images are indexed
+	// by (level*_layers+layer)*_faces+face
+	std::vector<std::size_t> _offsets;
+	std::vector<std::size_t> _sizes;
+
+	std::size_t _index(GLsizei level, GLsizei layer, GLsizei face) const
+	{
+		assert(level >= 0 && level < _levels);
+		assert(layer >= 0 && layer < _layers);
+		assert(face >= 0 && face < _faces);
+		return std::size_t((level*_layers+layer)*_faces+face);
+	}
+
+	static GLsizei _mip(GLsizei size, GLsizei level)
+	{
+		size >>= level;
+		return (size > 0)?size:1;
+	}
+
+	std::size_t _image_size(GLsizei level) const;
+
+	void _add_image(std::size_t offset, std::size_t size);
+
+	void _load_ktx(const char* path);
+	void _load_dds(const char* path);
+public:
+	/// Maps the KTX or DDS file at the specified @p path
+	/** Throws @c std::runtime_error if the file cannot be opened or if
+	 *  its format is not supported.
+	 */
+	explicit
+	TextureContainer(const char* path);
+
+	/// Returns the number of mipmap levels
+	GLsizei Levels(void) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		return _levels;
+	}
+
+	/// Returns the number of array layers (1 for non-array textures)
+	GLsizei Layers(void) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		return _layers;
+	}
+
+	/// Returns the number of faces (6 for cube maps, 1 otherwise)
+	GLsizei Faces(void) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		return _faces;
+	}
+
+	/// Returns true if the container stores a cube map (array)
+	bool IsCubeMap(void) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		return _faces == 6;
+	}
+
+	/// Returns true if the container stores an array texture
+	bool IsArray(void) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		return _is_array;
+	}
+
+	/// Returns true if the images are block-compressed
+	bool IsCompressed(void) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		return _compressed;
+	}
+
+	/// Returns the width of the specified mipmap @p level
+	SizeType Width(GLsizei level = 0) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		return MakeSizeType(_mip(_width, level), std::nothrow);
+	}
+
+	/// Returns the height of the specified mipmap @p level
+	SizeType Height(GLsizei level = 0) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		return MakeSizeType(_mip(_height, level), std::nothrow);
+	}
+
+	/// Returns the depth of the specified mipmap @p level (of 3D textures)
+	SizeType Depth(GLsizei level = 0) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		return MakeSizeType(_mip(_depth, level), std::nothrow);
+	}
+
+	/// Returns the number of channels (of uncompressed images)
+	SizeType Channels(void) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		return MakeSizeType(_channels, std::nothrow);
+	}
+
+	/// Returns the alignment of the rows of uncompressed images
+	GLint RowAlignment(void) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		return _alignment;
+	}
+
+	/// Returns the pixel data type (of uncompressed images)
+	PixelDataType Type(void) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		return _type;
+	}
+
+	/// Returns the pixel data format (of uncompressed images)
+	PixelDataFormat Format(void) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		return _format;
+	}
+
+	/// Returns the (possibly compressed) internal format
+	PixelDataInternalFormat InternalFormat(void) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		return _internal;
+	}
+
+	/// Returns a pointer to the data of the specified image
+	const void* RawData(
+		GLsizei level,
+		GLsizei layer = 0,
+		GLsizei face = 0
+	) const
+	{
+		const unsigned char* data =
+			static_cast<const unsigned char*>(_mapped.begin());
+		return data+_offsets[_index(level, layer, face)];
+	}
+
+	/// Returns the size (in bytes) of the data of the specified image
+	SizeType DataSize(
+		GLsizei level,
+		GLsizei layer = 0,
+		GLsizei face = 0
+	) const
+	{
+		return MakeSizeType(
+			GLsizei(_sizes[_index(level, layer, face)]),
+			std::nothrow
+		);
+	}
+
+	/// Returns the size (in bytes) of all images of a mipmap @p level
+	SizeType LevelDataSize(GLsizei level) const
+	{
+		return MakeSizeType(
+			GLsizei(
+				_sizes[_index(level, 0, 0)]*
+				std::size_t(_layers*_faces)
+			),
+			std::nothrow
+		);
+	}
+
+	/// Returns a view of the specified (uncompressed) image
+	/** Throws @c std::runtime_error if the images are compressed
+	 *  or if they have a packed pixel data type.
+	 */
+	ImageView View(
+		GLsizei level,
+		GLsizei layer = 0,
+		GLsizei face = 0
+	) const;
+};
+
+} // namespace images
+} // namespace oglplus
+
+#if !OGLPLUS_LINK_LIBRARY || defined(OGLPLUS_IMPLEMENTING_LIBRARY)
+#include <oglplus/images/container.ipp>
+#endif
+
+#endif // include guard
@@ -0,0 +1,107 @@
+/**
+ *  @file oglplus/images/convert.hpp
+ *  @brief Conversion of images between pixel data types and formats
+ *
+ *  @author Matus Chochlik
+ *
+ *  Copyright 2010-2015 Matus Chochlik. Distributed under the Boost
+ *  Software License, Version 1.0. (See accompanying file
+ *  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#pragma once
+#ifndef OGLPLUS_IMAGES_CONVERT_1107121519_HPP
+#define OGLPLUS_IMAGES_CONVERT_1107121519_HPP
+
+#include <oglplus/images/view.hpp>
+
+namespace oglplus {
+namespace images {
+
+/// Parameters of the image Convert function
+struct ConvertParams
+{
+	/// Use the SIMD conversion kernels where available
+	/** The vectorized kernels produce the same values as the scalar
+	 *  ones, this option exists mainly for testing and benchmarking.
+	 */
+	bool vectorized;
+
+	/// The maximum number of threads used, 0 means no limit
+	unsigned max_threads;
+
+	ConvertParams(void)
+	 : vectorized(true)
+	 , max_threads(0)
+	{ }
+};
+
+/// Converts an image to the specified pixel data @p type and @p format
+/** The channels of the source image are matched by their meaning, i.e.
+ *  they are swizzled (for example from BGRA to RGBA) and dropped or added
+ *  as needed, the missing color channels are set to zero and a missing
+ *  alpha to one. Normalized integer components are converted to [0, 1]
+ *  (or [-1, 1] for signed types) and values out of range are clamped
+ *  when converting to normalized integers.
+ *
+ *  The following pixel data types are supported: @c UnsignedByte,
+ *  @c Byte, @c UnsignedShort, @c Short, @c UnsignedInt, @c Int,
+ *  @c HalfFloat, @c Float and the packed @c UnsignedInt_10f_11f_11f_Rev
+ *  (R11F_G11F_B10F), @c UnsignedInt_5_9_9_9_Rev (RGB9_E5) and
+ *  @c UnsignedInt_2_10_10_10_Rev (RGB10_A2). The images with a packed type
+ *  have a single 32-bit component per pixel, the format of RGB9_E5 and
+ *  R11F_G11F_B10F images must be @c RGB and the format of RGB10_A2
+ *  @c RGBA or @c BGRA. The formats @c Red, @c Green, @c Blue, @c RG,
+ *  @c RGB, @c BGR, @c RGBA and @c BGRA are supported. For other
+ *  types or formats the function throws @c std::runtime_error.
+ *
+ *  The source image is considered sRGB-encoded if its internal format
+ *  is @c SRGB8 or @c SRGB8Alpha8, and the color channels are converted
+ *  if the sRGB-ness of the destination internal format differs.
+ *  This overload picks a sized internal format matching the destination
+ *  type and format, which stays sRGB when converting an sRGB image
+ *  to 3 or 4 unsigned byte channels.
+ *
+ *  This can be used for example to store the output of the floating-point
+ *  generators, like NormalMap or SphereBumpMap, with half the memory:
+ *
+ *  @code
+ *  images::Image normals = images::Convert(
+ *      images::NormalMap(images::LoadTexture("bumps")),
+ *      PixelDataType::HalfFloat,
+ *      PixelDataFormat::RGBA
+ *  );
+ *  @endcode
+ *
+ *  @ingroup image_load_gen
+ */
+Image Convert(
+	const ImageView& image,
+	PixelDataType type,
+	PixelDataFormat format,
+	const ConvertParams& params = ConvertParams()
+);
+
+/// Converts an image to the specified type, format and internal format
+/** The same as the other overload except that the internal format
+ *  of the result (which determines if it is sRGB-encoded) is specified
+ *  explicitly.
+ *
+ *  @ingroup image_load_gen
+ */
+Image Convert(
+	const ImageView& image,
+	PixelDataType type,
+	PixelDataFormat format,
+	PixelDataInternalFormat internal,
+	const ConvertParams& params = ConvertParams()
+);
+
+} // namespace images
+} // namespace oglplus
+
+#if !OGLPLUS_LINK_LIBRARY || defined(OGLPLUS_IMPLEMENTING_LIBRARY)
+#include <oglplus/images/convert.ipp>
+#endif
+
+#endif // include guard
@@ -0,0 +1,211 @@
+/**
+ *  @file oglplus/images/convolution.hpp
+ *  @brief Separable convolution, Gaussian and box blur image filters
+ *
+ *  @author Matus Chochlik
+ *
+ *  Copyright 2010-2015 Matus Chochlik. Distributed under the Boost
+ *  Software License, Version 1.0. (See accompanying file
+ *  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#pragma once
+#ifndef OGLPLUS_IMAGES_CONVOLUTION_1107121519_HPP
+#define OGLPLUS_IMAGES_CONVOLUTION_1107121519_HPP
+
+#include <oglplus/images/image.hpp>
+#include <oglplus/images/view.hpp>
+
+#include <vector>
+
+namespace oglplus {
+namespace images {
+
+/// One dimensional kernel of a separable convolution
+/** The kernel has an odd number of weights, the middle one is applied
+ *  to the filtered texel itself.
+ *
+ *  @ingroup image_load_gen
+ */
+class ConvolutionKernel
+{
+private:
+	std::vector<GLfloat> _weights;
+	bool _is_box;
+
+	ConvolutionKernel(std::vector<GLfloat>&& weights, bool is_box);
+public:
+	/// Creates a kernel with the specified @p weights
+	/** The number of weights must be odd, the weights are used as they are
+	 *  (i.e. they are not normalized).
+	 */
+	explicit
+	ConvolutionKernel(const std::vector<GLfloat>& weights);
+
+	/// Creates a normalized Gaussian kernel with the specified @p sigma
+	/** If the @p radius is zero then it is determined from the sigma
+	 *  so that the kernel covers three standard deviations.
+	 */
+	static ConvolutionKernel Gaussian(GLfloat sigma, GLint radius = 0);
+
+	/// Creates a kernel averaging 2*radius+1 texels
+	/** Box kernels with larger radii are evaluated with a running sum,
+	 *  i.e. in constant time per texel regardless of the radius.
+	 */
+	static ConvolutionKernel Box(GLint radius);
+
+	/// Creates a kernel which leaves the image unchanged
+	static ConvolutionKernel Identity(void)
+	{
+		return ConvolutionKernel(std::vector<GLfloat>(1, 1.0f), true);
+	}
+
+	/// Returns the number of weights on each side of the middle one
+	GLint Radius(void) const
+	{
+		return GLint(_weights.size()/2);
+	}
+
+	/// Returns the weights of the kernel
+	const std::vector<GLfloat>& Weights(void) const
+	{
+		return _weights;
+	}
+
+	/// Returns true if this is a box kernel
+	bool IsBox(void) const
+	{
+		return _is_box;
+	}
+
+	/// Returns true if the kernel leaves the image unchanged
+	bool IsIdentity(void) const
+	{
+		return (_weights.size() == 1) && (_weights[0] == 1.0f);
+	}
+};
+
+/// Parameters of the separable convolution filters
+struct ConvolutionParams
+{
+	/// Wrap the coordinates around the edges (otherwise clamp them)
+	/** Wrapping is the default, like with the samplers of FilteredImage,
+	 *  so that tileable images remain tileable.
+	 */
+	bool repeat;
+
+	/// Use the SIMD kernels where available
+	bool vectorized;
+
+	/// The maximum number of threads used, 0 means no limit
+	unsigned max_threads;
+
+	ConvolutionParams(void)
+	 : repeat(true)
+	 , vectorized(true)
+	 , max_threads(0)
+	{ }
+};
+
+/// Filter convolving an image with separable kernels
+/** The image is convolved by one dimensional kernels, first along the rows,
+ *  then along the columns and in case of 3D images along the depth, so that
+ *  the cost per texel depends on the sum of the kernel sizes instead
+ *  of their product. The columns and the depth are processed in narrow
+ *  strips which are gathered into a contiguous buffer (which fits into
+ *  the cache), instead of being read with a large stride per tap.
+ *
+ *  The input is converted to floating-point by images::Convert,
+ *  so its type and format must be supported by it (sRGB-encoded images
+ *  are decoded to linear values). The result has the same format
+ *  and @c GLfloat components. It can be passed to other filters,
+ *  for example to make a normal map from a smoothed height map:
+ *
+ *  @code
+ *  images::NormalMap normals(images::GaussianBlur(height_map, 1.5f));
+ *  @endcode
+ *
+ *  @ingroup image_load_gen
+ */
+class SeparableConvolution
+ : public Image
+{
+private:
+	void _convolve(
+		const ConvolutionKernel& kx,
+		const ConvolutionKernel& ky,
+		const ConvolutionKernel& kz,
+		const ConvolutionParams& params
+	);
+public:
+	/// Convolves the @p input with the same @p kernel along all axes
+	SeparableConvolution(
+		const ImageView& input,
+		const ConvolutionKernel& kernel,
+		const ConvolutionParams& params = ConvolutionParams()
+	);
+
+	/// Convolves the @p input with a separate kernel for each axis
+	/** The @p kz kernel is used only with 3D images.
+	 */
+	SeparableConvolution(
+		const ImageView& input,
+		const ConvolutionKernel& kx,
+		const ConvolutionKernel& ky,
+		const ConvolutionKernel& kz,
+		const ConvolutionParams& params = ConvolutionParams()
+	);
+};
+
+/// Filter blurring an image with a Gaussian kernel
+/**
+ *  @see SeparableConvolution
+ *  @ingroup image_load_gen
+ */
+class GaussianBlur
+ : public SeparableConvolution
+{
+public:
+	/// Blurs the @p input with the specified standard deviation (in texels)
+	GaussianBlur(
+		const ImageView& input,
+		GLfloat sigma,
+		const ConvolutionParams& params = ConvolutionParams()
+	): SeparableConvolution(
+		input,
+		ConvolutionKernel::Gaussian(sigma),
+		params
+	)
+	{ }
+};
+
+/// Filter averaging 2*radius+1 texels along each axis
+/**
+ *  @see SeparableConvolution
+ *  @ingroup image_load_gen
+ */
+class BoxBlur
+ : public SeparableConvolution
+{
+public:
+	/// Blurs the @p input with a box filter with the specified @p radius
+	BoxBlur(
+		const ImageView& input,
+		GLint radius,
+		const ConvolutionParams& params = ConvolutionParams()
+	): SeparableConvolution(
+		input,
+		ConvolutionKernel::Box(radius),
+		params
+	)
+	{ }
+};
+
+} // namespace images
+} // namespace oglplus
+
+#if !OGLPLUS_LINK_LIBRARY || defined(OGLPLUS_IMPLEMENTING_LIBRARY)
+#include <oglplus/images/convolution.ipp>
+#endif
+
+#endif // include guard
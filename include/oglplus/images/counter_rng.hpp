@@ -0,0 +1,138 @@
+/**
+ *  @file oglplus/images/counter_rng.hpp
+ *  @brief Counter-based random number generator for image generators
+ *
+ *  @author Matus Chochlik
+ *
+ *  Copyright 2010-2015 Matus Chochlik. Distributed under the Boost
+ *  Software License, Version 1.0. (See accompanying file
+ *  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#pragma once
+#ifndef OGLPLUS_IMAGES_COUNTER_RNG_1107121519_HPP
+#define OGLPLUS_IMAGES_COUNTER_RNG_1107121519_HPP
+
+#include <oglplus/config/compiler.hpp>
+
+#include <cstdint>
+
+namespace oglplus {
+namespace images {
+
+/// Explicit seed for the reproducible random image generators
+/**
+ *  @ingroup image_load_gen
+ */
+class RandomSeed
+{
+private:
+	std::uint64_t _value;
+public:
+	explicit RandomSeed(std::uint64_t value)
+	OGLPLUS_NOEXCEPT(true)
+	 : _value(value)
+	{ }
+
+	/// Returns the value of the seed
+	std::uint64_t Value(void) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		return _value;
+	}
+};
+
+/// Stateless counter-based pseudo-random number generator
+/** The generated values depend only on the key of the generator and on
+ *  the counter passed to the member functions, not on the order in which
+ *  they are called. This allows to use the generator from multiple threads
+ *  and to derive independent sub-streams (for example one per branch
+ *  of a recursive generator or one per row of an image) with @c Branch.
+ *
+ *  The values are obtained by hashing the key and the counter with
+ *  the SplitMix64 finalizer.
+ *
+ *  @ingroup image_load_gen
+ */
+class CounterRNG
+{
+private:
+	std::uint64_t _key;
+
+	explicit CounterRNG(std::uint64_t key, int)
+	OGLPLUS_NOEXCEPT(true)
+	 : _key(key)
+	{ }
+public:
+	/// The SplitMix64 mixing function
+	static std::uint64_t Mix(std::uint64_t z)
+	OGLPLUS_NOEXCEPT(true)
+	{
+		z += 0x9E3779B97F4A7C15ull;
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+		return z ^ (z >> 31);
+	}
+
+	/// Creates the root generator for the specified @p seed
+	CounterRNG(RandomSeed seed)
+	OGLPLUS_NOEXCEPT(true)
+	 : _key(Mix(seed.Value()))
+	{ }
+
+	/// Returns the generator of the @p index-th independent sub-stream
+	CounterRNG Branch(std::uint64_t index) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		return CounterRNG(Mix(_key ^ Mix(~index)), 0);
+	}
+
+	/// Returns 64 random bits for the specified @p counter value
+	std::uint64_t Bits(std::uint64_t counter) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		return Mix(_key ^ Mix(counter));
+	}
+
+	/// Returns the counter value for the texel with the specified coordinates
+	/** The coordinates must be less than 2^21. The random values derived
+	 *  from the returned counter depend only on the coordinates of the texel
+	 *  (and on the key of the generator), not on the size of the image.
+	 */
+	static std::uint64_t TexelCounter(
+		std::uint32_t x,
+		std::uint32_t y,
+		std::uint32_t z = 0
+	) OGLPLUS_NOEXCEPT(true)
+	{
+		return	(std::uint64_t(x) & 0x1FFFFFull) |
+			((std::uint64_t(y) & 0x1FFFFFull) << 21) |
+			((std::uint64_t(z) & 0x1FFFFFull) << 42);
+	}
+
+	/// Returns a random value in the range [0, n) (n must not be zero)
+	std::uint32_t Below(std::uint64_t counter, std::uint32_t n) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		return std::uint32_t(((Bits(counter) >> 32) * n) >> 32);
+	}
+
+	/// Returns a uniformly distributed value in the range [0, 1)
+	float Unit(std::uint64_t counter) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		return float(Bits(counter) >> 40) * (1.0f / 16777216.0f);
+	}
+
+	/// Returns a uniformly distributed value in the range [-1, 1)
+	float Signed(std::uint64_t counter) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		return Unit(counter)*2.0f - 1.0f;
+	}
+};
+
+} // images
+} // oglplus
+
+#endif // include guard
@@ -0,0 +1,236 @@
+/**
+ *  @file oglplus/images/cube_map.hpp
+ *  @brief Equirectangular panorama and cube map conversions and filtering
+ *
+ *  @author Matus Chochlik
+ *
+ *  Copyright 2010-2015 Matus Chochlik. Distributed under the Boost
+ *  Software License, Version 1.0. (See accompanying file
+ *  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#pragma once
+#ifndef OGLPLUS_IMAGES_CUBE_MAP_1107121519_HPP
+#define OGLPLUS_IMAGES_CUBE_MAP_1107121519_HPP
+
+#include <oglplus/images/image.hpp>
+#include <oglplus/images/view.hpp>
+#include <oglplus/images/cache.hpp>
+
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+namespace oglplus {
+namespace images {
+
+/// The interpolation used when sampling the source image
+enum class CubeMapSampling
+{
+	/// Bilinear interpolation of 2x2 texels
+	Bilinear,
+	/// Bicubic (Catmull-Rom) interpolation of 4x4 texels
+	Bicubic
+};
+
+/// Parameters of the cube map generators
+struct CubeMapParams
+{
+	/// The interpolation used by the conversions, Bilinear by default
+	CubeMapSampling sampling;
+
+	/// The number of GGX samples per texel of the prefiltered levels
+	unsigned samples;
+
+	/// The maximum number of levels of PrefilteredCubeMap, 0 means all
+	unsigned max_levels;
+
+	/// Use the SIMD kernels where available
+	/** The vectorized kernels produce the same values as the scalar
+	 *  ones, this option exists mainly for testing and benchmarking.
+	 */
+	bool vectorized;
+
+	/// The maximum number of threads used, 0 means no limit
+	unsigned max_threads;
+
+	CubeMapParams(void)
+	 : sampling(CubeMapSampling::Bilinear)
+	 , samples(64)
+	 , max_levels(0)
+	 , vectorized(true)
+	 , max_threads(0)
+	{ }
+};
+
+/// Converts an equirectangular panorama into the six faces of a cube map
+/** The result is an image with the specified @p face_size and with depth
+ *  six, the slices being the faces in the order of the cube map targets
+ *  (+X, -X, +Y, -Y, +Z, -Z; see Texture::CubeMapFace), oriented as
+ *  expected by OpenGL, so that each slice can be passed to
+ *  Texture::ImageCM:
+ *
+ *  @code
+ *  images::Image sky = images::CubeMapFromEquirect(
+ *      images::LoadTexture("panorama"), 512
+ *  );
+ *  for(GLuint face=0; face!=6; ++face)
+ *  {
+ *      Texture::ImageCM(face, images::ImageView(sky).Slice(face));
+ *  }
+ *  @endcode
+ *
+ *  The horizontal axis of the panorama is the longitude (wrapping around)
+ *  with the -Z direction in the middle, the first row of the panorama
+ *  is the latitude of the -Y pole and the last one that of the +Y pole.
+ *  The panorama is sampled in linear space (sRGB images are decoded
+ *  and encoded again) and the result has the same type and format.
+ *  All the types and formats supported by Convert can be used.
+ *
+ *  @ingroup image_load_gen
+ */
+class CubeMapFromEquirect
+ : public Image
+{
+private:
+	static Image _make(
+		const ImageView& panorama,
+		SizeType face_size,
+		const CubeMapParams& params
+	);
+public:
+	CubeMapFromEquirect(
+		const ImageView& panorama,
+		SizeType face_size,
+		const CubeMapParams& params = CubeMapParams()
+	): Image(_make(panorama, face_size, params))
+	{ }
+};
+
+/// Converts a cube map into an equirectangular panorama
+/** The @p cube_map must be an image with depth six, with the faces
+ *  laid out as in the result of CubeMapFromEquirect. The texels near
+ *  the edges of the faces are interpolated only from the texels
+ *  of the same face.
+ *
+ *  @ingroup image_load_gen
+ */
+class EquirectFromCubeMap
+ : public Image
+{
+private:
+	static Image _make(
+		const ImageView& cube_map,
+		SizeType width,
+		SizeType height,
+		const CubeMapParams& params
+	);
+public:
+	EquirectFromCubeMap(
+		const ImageView& cube_map,
+		SizeType width,
+		SizeType height,
+		const CubeMapParams& params = CubeMapParams()
+	): Image(_make(cube_map, width, height, params))
+	{ }
+};
+
+/// A chain of cube maps prefiltered for image-based specular lighting
+/** Level @c i of the chain has faces of (face size of the source)/2^i
+ *  texels and contains the radiance of the source @p cube_map convolved
+ *  with the GGX distribution with the roughness Roughness(i), linearly
+ *  increasing from 0 at level 0 (which is a copy of the source) to 1
+ *  at the last level. The shaders pick the level by the roughness
+ *  of the surface and sample it in the direction of the reflected vector.
+ *
+ *  The convolution uses importance sampling of the GGX distribution
+ *  (with the assumption that the view, normal and reflection directions
+ *  are the same) and the samples are taken from the box-filtered mipmap
+ *  levels of the source according to their probability density, which
+ *  removes most of the noise even with a low number of samples.
+ *  The texels of the levels are computed in parallel.
+ *
+ *  The levels are images with depth six, like the results of
+ *  CubeMapFromEquirect, and have the same type and format as the source.
+ *  The whole chain can be passed to Texture::Image2D with the CubeMap
+ *  target. With an ImageCache the levels are stored in the cache
+ *  and they are computed only when the source or the parameters change:
+ *
+ *  @code
+ *  images::ImageCache cache("cache", "v1");
+ *  images::Image sky = cache.Make<images::CubeMapFromEquirect>(
+ *      "CubeMapFromEquirect", ...
+ *  );
+ *  images::PrefilteredCubeMap radiance(sky, cache);
+ *  Texture::Image2D(Texture::Target::CubeMap, radiance);
+ *  @endcode
+ *
+ *  @ingroup image_load_gen
+ */
+class PrefilteredCubeMap
+{
+private:
+	std::vector<Image> _levels;
+
+	void _build(
+		const ImageView& cube_map,
+		const ImageCache* cache,
+		const CubeMapParams& params
+	);
+public:
+	/// Prefilters the specified @p cube_map
+	explicit
+	PrefilteredCubeMap(
+		const ImageView& cube_map,
+		const CubeMapParams& params = CubeMapParams()
+	)
+	{
+		_build(cube_map, nullptr, params);
+	}
+
+	/// Prefilters the @p cube_map or gets the levels from the @p cache
+	PrefilteredCubeMap(
+		const ImageView& cube_map,
+		const ImageCache& cache,
+		const CubeMapParams& params = CubeMapParams()
+	)
+	{
+		_build(cube_map, &cache, params);
+	}
+
+	/// Returns the number of levels in the chain
+	std::size_t Levels(void) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		return _levels.size();
+	}
+
+	/// Returns the image at the specified @p level
+	/**
+	 *  @pre level < Levels()
+	 */
+	const Image& Level(std::size_t level) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		assert(level < _levels.size());
+		return _levels[level];
+	}
+
+	/// Returns the roughness of the specified @p level
+	GLfloat Roughness(std::size_t level) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		assert(level < _levels.size());
+		if(_levels.size() < 2) return 0.0f;
+		return GLfloat(level)/GLfloat(_levels.size()-1);
+	}
+};
+
+} // namespace images
+} // namespace oglplus
+
+#if !OGLPLUS_LINK_LIBRARY || defined(OGLPLUS_IMPLEMENTING_LIBRARY)
+#include <oglplus/images/cube_map.ipp>
+#endif
+
+#endif // include guard
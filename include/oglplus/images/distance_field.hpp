@@ -0,0 +1,103 @@
+/**
+ *  @file oglplus/images/distance_field.hpp
+ *  @brief Generator of signed distance fields from coverage images
+ *
+ *  @author Matus Chochlik
+ *
+ *  Copyright 2010-2015 Matus Chochlik. Distributed under the Boost
+ *  Software License, Version 1.0. (See accompanying file
+ *  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#pragma once
+#ifndef OGLPLUS_IMAGES_DISTANCE_FIELD_1107121519_HPP
+#define OGLPLUS_IMAGES_DISTANCE_FIELD_1107121519_HPP
+
+#include <oglplus/images/image.hpp>
+#include <oglplus/images/view.hpp>
+
+namespace oglplus {
+namespace images {
+
+/// Parameters of the DistanceField generator
+struct DistanceFieldParams
+{
+	/// The coverage above which (inclusive) the texels are inside
+	GLfloat threshold;
+
+	/// The distance (in output texels) mapped to the [0, 1] range
+	/** The edge is at 0.5, texels which are @c spread texels inside
+	 *  (or more) are 1 and the texels @c spread texels outside are 0.
+	 *  This is not used if the output is floating-point.
+	 */
+	GLfloat spread;
+
+	/// The input texels per output texel in each dimension
+	GLsizei downsample;
+
+	/// The index of the channel of the input used as the coverage
+	unsigned channel;
+
+	/// Store the signed distances (in output texels) as floats
+	/** By default the distances are mapped to unsigned bytes
+	 *  by the @c spread.
+	 */
+	bool floating;
+
+	/// The maximum number of threads used, 0 means no limit
+	unsigned max_threads;
+
+	DistanceFieldParams(void)
+	 : threshold(0.5f)
+	 , spread(4.0f)
+	 , downsample(1)
+	 , channel(0)
+	 , floating(false)
+	 , max_threads(0)
+	{ }
+};
+
+/// Generator of a signed distance field from a coverage (mask) image
+/** The distances from each texel to the nearest texel on the other side
+ *  of the edge are computed by the exact linear-time Euclidean distance
+ *  transform of Felzenszwalb and Huttenlocher, done separably along
+ *  the rows and then along the columns (both in parallel). Texels with
+ *  a fractional coverage (anti-aliased edges) are assumed to lie
+ *  on the edge and their distance is estimated from the coverage.
+ *  The distances are positive inside and negative outside.
+ *
+ *  The result has a single (Red) channel, either of unsigned bytes with
+ *  the edge at 0.5 or of floats with the signed distances. With the
+ *  @c downsample parameter the field is averaged over blocks of input
+ *  texels, so that a mask rasterized at a high resolution gives a small
+ *  texture which can be rendered sharply at any scale (by thresholding
+ *  the interpolated value in the shader). 3D images are processed
+ *  slice by slice.
+ *
+ *  @ingroup image_load_gen
+ */
+class DistanceField
+ : public Image
+{
+private:
+	static Image _make(
+		const ImageView& input,
+		const DistanceFieldParams& params
+	);
+public:
+	/// Makes the distance field of the @p input coverage image
+	DistanceField(
+		const ImageView& input,
+		const DistanceFieldParams& params = DistanceFieldParams()
+	): Image(_make(input, params))
+	{ }
+};
+
+} // namespace images
+} // namespace oglplus
+
+#if !OGLPLUS_LINK_LIBRARY || defined(OGLPLUS_IMPLEMENTING_LIBRARY)
+#include <oglplus/images/distance_field.ipp>
+#endif
+
+#endif // include guard
@@ -14,15 +14,17 @@
 #define OGLPLUS_IMAGES_FILTERED_1107121519_HPP
 
 #include <oglplus/images/image.hpp>
+#include <oglplus/images/view.hpp>
 #include <oglplus/math/vector.hpp>
 #include <oglplus/math/matrix.hpp>
+#include <oglplus/detail/parallel_for.hpp>
 
 #include <cassert>
+#include <cstddef>
 #include <cmath>
 
 namespace oglplus {
 namespace images {
-
 /// Base class for various image filters
 /**
  *  @note Do not use this class directly, use the derived filters instead.
@@ -37,37 +39,6 @@ private:
 		CH > 0 && CH <= 4,
 		"Number of channels must be between 1 and 4"
 	);
-private:
-	template <typename Filter, typename Sampler, typename Extractor>
-	void _calculate(
-		const Image& input,
-		Filter filter,
-		Sampler sampler,
-		Extractor extractor,
-		T one
-	)
-	{
-		sampler.SetInput(input);
-		auto p = this->_begin<T>();
-		GLsizei w = input.Width(), h = input.Height(), d = input.Depth();
-
-		for(GLsizei k=0; k<d; ++k)
-		for(GLsizei j=0; j<h; ++j)
-		for(GLsizei i=0; i<w; ++i)
-		{
-			sampler.SetOrigin(i, j, k);
-
-			Vector<T, CH> outv = filter(extractor, sampler, one);
-
-			for(unsigned ci=0; ci!=CH; ++ci)
-			{
-				assert(p != this->_end<T>());
-				*p = outv.At(ci);
-				++p;
-			}
-		}
-		assert(p == this->_end<T>());
-	}
 public:
 	struct DefaultFilter
 	{
@@ -115,7 +86,7 @@ public:
 	struct RepeatSample
 	{
 		Vector<double, 4> operator()(
-			const Image& image,
+			const ImageView& image,
 			unsigned width,
 			unsigned height,
 			unsigned depth,
@@ -148,7 +119,7 @@ public:
 		Transform _transf;
 		SampleFunc _sample;
 
-		const Image* _image;
+		const ImageView* _image;
 		int _ori_x, _ori_y, _ori_z;
 	public:
 		SamplerTpl(
@@ -162,11 +133,16 @@ public:
 		 , _ori_z(0)
 		{ }
 
-		void SetInput(const Image& image)
+		void SetInput(const ImageView& image)
 		{
 			_image = &image;
 		}
 
+		const Transform& CoordTransform(void) const
+		{
+			return _transf;
+		}
+
 		void SetOrigin(
 			GLsizei x,
 			GLsizei y,
@@ -238,6 +214,125 @@ public:
 		{ }
 	};
 
+	/// Sampler with repeat wrapping reading the typed input data directly
+	/** This sampler is used instead of the samplers based on RepeatSample
+	 *  when the type of the input image is known. Instead of going through
+	 *  ImageView::Pixel it reads the input data using the row and slice
+	 *  strides of the view and keeps pointers to the 3x3 window of
+	 *  (wrapped) rows around the current origin, which is only updated
+	 *  when the origin moves to another row. The components are normalized
+	 *  the same way as by ImageView::Pixel.
+	 */
+	template <typename IT, typename Transform>
+	class TypedRepeatSampler
+	{
+	private:
+		Transform _transf;
+
+		const unsigned char* _data;
+		double _one;
+		int _width, _height, _depth, _channels;
+		std::ptrdiff_t _row_stride, _slice_stride;
+		int _ori_x, _ori_y, _ori_z;
+
+		int _win_y, _win_z;
+		const IT* _rows[3][3];
+
+		static int _wrap(int pos, int size)
+		{
+			if((pos >= 0) && (pos < size)) return pos;
+			pos %= size;
+			if(pos < 0) pos += size;
+			assert((pos >= 0) && (pos < size));
+			return pos;
+		}
+
+		const IT* _row(int ypos, int zpos) const
+		{
+			return reinterpret_cast<const IT*>(_data +
+				_wrap(zpos, _depth)*_slice_stride+
+				_wrap(ypos, _height)*_row_stride
+			);
+		}
+
+		void _update_window(void)
+		{
+			for(int k=0; k!=3; ++k)
+			for(int j=0; j!=3; ++j)
+			{
+				_rows[k][j] = _row(_ori_y+j-1, _ori_z+k-1);
+			}
+			_win_y = _ori_y;
+			_win_z = _ori_z;
+		}
+	public:
+		TypedRepeatSampler(
+			const Transform& transf,
+			const ImageView& image,
+			IT one
+		): _transf(transf)
+		 , _data(static_cast<const unsigned char*>(image.RawData()))
+		 , _one(double(one))
+		 , _width(image.Width())
+		 , _height(image.Height())
+		 , _depth(image.Depth())
+		 , _channels(image.Channels())
+		 , _row_stride(image.RowStride())
+		 , _slice_stride(image.SliceStride())
+		 , _ori_x(0)
+		 , _ori_y(0)
+		 , _ori_z(0)
+		{
+			_update_window();
+		}
+
+		void SetOrigin(
+			GLsizei x,
+			GLsizei y,
+			GLsizei z
+		)
+		{
+			_ori_x = x;
+			_ori_y = y;
+			_ori_z = z;
+
+			_transf(
+				_ori_x,
+				_ori_y,
+				_ori_z,
+				unsigned(_width),
+				unsigned(_height),
+				unsigned(_depth)
+			);
+
+			if((_ori_y != _win_y) || (_ori_z != _win_z))
+			{
+				_update_window();
+			}
+		}
+
+		Vector<double, 4> operator()(
+			int xoffs,
+			int yoffs,
+			int zoffs
+		) const
+		{
+			const IT* row =
+				((yoffs >= -1) && (yoffs <= 1) &&
+				(zoffs >= -1) && (zoffs <= 1))?
+				_rows[zoffs+1][yoffs+1]:
+				_row(_ori_y+yoffs, _ori_z+zoffs);
+
+			const IT* p = row + _wrap(_ori_x+xoffs, _width)*_channels;
+			return Vector<double, 4>(
+				_channels>0?double(p[0])/_one:0.0,
+				_channels>1?double(p[1])/_one:0.0,
+				_channels>2?double(p[2])/_one:0.0,
+				_channels>3?double(p[3])/_one:0.0
+			);
+		}
+	};
+
 	/// Extractor that allows to specify which component to use as input
 	template <unsigned I>
 	struct FromComponentI
@@ -269,9 +364,166 @@ public:
 	typedef FirstNComponents<3> FromRGB;
 	typedef FirstNComponents<4> FromRGBA;
 
+private:
+	template <typename Filter, typename Sampler, typename Extractor>
+	void _calc_rows(
+		const ImageView& input,
+		Filter& filter,
+		Sampler& sampler,
+		Extractor& extractor,
+		T one,
+		std::size_t row_begin,
+		std::size_t row_end
+	)
+	{
+		GLsizei w = input.Width(), h = input.Height();
+		T* p = this->_begin<T>() + row_begin*std::size_t(w)*CH;
+
+		for(std::size_t row=row_begin; row!=row_end; ++row)
+		{
+			GLsizei k = GLsizei(row)/h;
+			GLsizei j = GLsizei(row)%h;
+			for(GLsizei i=0; i<w; ++i)
+			{
+				sampler.SetOrigin(i, j, k);
+
+				Vector<T, CH> outv = filter(extractor, sampler, one);
+
+				for(unsigned ci=0; ci!=CH; ++ci)
+				{
+					assert(p != this->_end<T>());
+					*p = outv.At(ci);
+					++p;
+				}
+			}
+		}
+	}
+
+	template <
+		typename IT,
+		typename Filter,
+		typename Transform,
+		typename Extractor
+	>
+	void _calc_typed(
+		const ImageView& input,
+		Filter filter,
+		const Transform& transf,
+		Extractor extractor,
+		T one
+	)
+	{
+		typedef TypedRepeatSampler<IT, Transform> Sampler;
+		assert(input.ComponentSize() == sizeof(IT));
+		Sampler sampler(
+			transf,
+			input,
+			this->_one(TypeTag<IT>())
+		);
+		// the rows are split between threads, each of them
+		// works with its own copy of the filter and sampler
+		oglplus::aux::ParallelFor(
+			std::size_t(input.Height()*input.Depth()),
+			std::size_t(8),
+			[=](std::size_t row_begin, std::size_t row_end) mutable
+			{
+				this->_calc_rows(
+					input,
+					filter,
+					sampler,
+					extractor,
+					one,
+					row_begin,
+					row_end
+				);
+			}
+		);
+	}
+
+	// generic samplers go through ImageView::Pixel
+	template <typename Filter, typename Sampler, typename Extractor>
+	void _calculate(
+		const ImageView& input,
+		Filter filter,
+		Sampler sampler,
+		Extractor extractor,
+		T one,
+		const void*
+	)
+	{
+		sampler.SetInput(input);
+		_calc_rows(
+			input,
+			filter,
+			sampler,
+			extractor,
+			one,
+			0, std::size_t(input.Height()*input.Depth())
+		);
+	}
+
+	// samplers using RepeatSample are replaced by typed samplers
+	template <
+		typename Filter,
+		typename Sampler,
+		typename Extractor,
+		typename Transform
+	>
+	void _calculate(
+		const ImageView& input,
+		Filter filter,
+		Sampler sampler,
+		Extractor extractor,
+		T one,
+		const SamplerTpl<Transform, RepeatSample>* base
+	)
+	{
+		const Transform& transf = base->CoordTransform();
+		switch(GLenum(input.Type()))
+		{
+			case GL_UNSIGNED_BYTE:
+				return _calc_typed<GLubyte>(
+					input, filter, transf, extractor, one
+				);
+			case GL_BYTE:
+				return _calc_typed<GLbyte>(
+					input, filter, transf, extractor, one
+				);
+			case GL_UNSIGNED_SHORT:
+				return _calc_typed<GLushort>(
+					input, filter, transf, extractor, one
+				);
+			case GL_SHORT:
+				return _calc_typed<GLshort>(
+					input, filter, transf, extractor, one
+				);
+			case GL_UNSIGNED_INT:
+				return _calc_typed<GLuint>(
+					input, filter, transf, extractor, one
+				);
+			case GL_INT:
+				return _calc_typed<GLint>(
+					input, filter, transf, extractor, one
+				);
+			case GL_FLOAT:
+				return _calc_typed<GLfloat>(
+					input, filter, transf, extractor, one
+				);
+			default:;
+		}
+		_calculate(
+			input,
+			filter,
+			sampler,
+			extractor,
+			one,
+			static_cast<const void*>(base)
+		);
+	}
+public:
 	template <typename Filter, typename Sampler, typename Extractor>
 	FilteredImage(
-		const Image& input,
+		const ImageView& input,
 		Filter filter,
 		Sampler sampler,
 		Extractor extractor
@@ -288,7 +540,8 @@ public:
 			filter,
 			sampler,
 			extractor,
-			this->_one(TypeTag<T>())
+			this->_one(TypeTag<T>()),
+			&sampler
 		);
 	}
 };
@@ -17,6 +17,24 @@ namespace oglplus {
 namespace images {
 
 class Image;
+class ImageView;
+class MipmapChain;
+class CompressedImage;
+struct ConvertParams;
+class ConvolutionKernel;
+struct ConvolutionParams;
+struct DistanceFieldParams;
+struct NoiseParams;
+class TextureContainer;
+class ImageCacheKey;
+class ImageCache;
+class ImageTileSource;
+class ImageTileCache;
+class SparseImage;
+struct ImageAtlasParams;
+class ImageAtlas;
+struct CubeMapParams;
+class PrefilteredCubeMap;
 struct ImageSpec;
 
 } // namespace images
@@ -22,6 +22,7 @@
 #include <oglplus/size_type.hpp>
 #include <oglplus/pixel_data.hpp>
 #include <oglplus/detail/aligned_pod_array.hpp>
+#include <oglplus/detail/half_float.hpp>
 #include <oglplus/utils/type_tag.hpp>
 
 namespace oglplus {
@@ -47,10 +48,13 @@ namespace images {
 class Image
 {
 private:
+	friend class ImageView;
+
 	GLsizei _width, _height, _depth, _channels;
 	PixelDataType _type;
 	oglplus::aux::AlignedPODArray _storage;
-	double (*_convert)(void*) OGLPLUS_NOEXCEPT(true);
+	typedef double (*_convert_func)(void*);
+	_convert_func _convert;
 
 	template <typename T>
 	static
@@ -63,6 +67,20 @@ private:
 		return v / n;
 	}
 
+	static
+	double _do_convert_half(void* ptr)
+	OGLPLUS_NOEXCEPT(true)
+	{
+		assert(ptr != nullptr);
+		return double(oglplus::aux::HalfToFloat(
+			*static_cast<std::uint16_t*>(ptr)
+		));
+	}
+
+	static
+	_convert_func _get_convert(PixelDataType type)
+	OGLPLUS_NOEXCEPT(true);
+
 	bool _is_initialized(void) const
 	OGLPLUS_NOEXCEPT(true);
 
@@ -227,6 +245,88 @@ public:
 	 , _internal(internal)
 	{ }
 
+	template <typename T>
+	Image(
+		SizeType width,
+		SizeType height,
+		SizeType depth,
+		SizeType channels,
+		const T*,
+		oglplus::aux::AlignedPODArray&& storage
+	): _width(width)
+	 , _height(height)
+	 , _depth(depth)
+	 , _channels(channels)
+	 , _type(PixelDataType(GetDataType<T>()))
+	 , _storage(std::move(storage))
+	 , _convert(&_do_convert<T>)
+	 , _format(_get_def_pdf(unsigned(channels)))
+	 , _internal(_get_def_pdif(unsigned(channels)))
+	{
+		assert(_storage.ElemSize() == sizeof(T));
+		assert(_storage.Count() == std::size_t(
+			_width*_height*_depth*_channels
+		));
+	}
+
+	template <typename T>
+	Image(
+		SizeType width,
+		SizeType height,
+		SizeType depth,
+		SizeType channels,
+		const T*,
+		oglplus::aux::AlignedPODArray&& storage,
+		PixelDataFormat format,
+		PixelDataInternalFormat internal
+	): _width(width)
+	 , _height(height)
+	 , _depth(depth)
+	 , _channels(channels)
+	 , _type(PixelDataType(GetDataType<T>()))
+	 , _storage(std::move(storage))
+	 , _convert(&_do_convert<T>)
+	 , _format(format)
+	 , _internal(internal)
+	{
+		assert(_storage.ElemSize() == sizeof(T));
+		assert(_storage.Count() == std::size_t(
+			_width*_height*_depth*_channels
+		));
+	}
+
+	/// Creates an image with the specified pixel data @p type
+	/** The @p storage must contain width*height*depth*channels elements
+	 *  of the size of a component of the specified @p type. This allows
+	 *  to make images with types that have no corresponding C++ type,
+	 *  i.e. @c HalfFloat and the packed types with a single 32-bit
+	 *  component per pixel (see ImageView::IsPacked).
+	 */
+	Image(
+		SizeType width,
+		SizeType height,
+		SizeType depth,
+		SizeType channels,
+		PixelDataType type,
+		oglplus::aux::AlignedPODArray&& storage,
+		PixelDataFormat format,
+		PixelDataInternalFormat internal
+	): _width(width)
+	 , _height(height)
+	 , _depth(depth)
+	 , _channels(channels)
+	 , _type(type)
+	 , _storage(std::move(storage))
+	 , _convert(_get_convert(type))
+	 , _format(format)
+	 , _internal(internal)
+	{
+		assert(_convert != nullptr);
+		assert(_storage.Count() == std::size_t(
+			_width*_height*_depth*_channels
+		));
+	}
+
 	Image& operator = (Image&& tmp)
 	OGLPLUS_NOEXCEPT(true)
 	{
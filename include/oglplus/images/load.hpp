@@ -14,6 +14,7 @@
 #define OGLPLUS_IMAGES_LOAD_1107121519_HPP
 
 #include <oglplus/images/image.hpp>
+#include <oglplus/images/container.hpp>
 
 #include <string>
 
@@ -27,6 +28,15 @@ Image LoadByName(
 	bool x_is_right
 );
 
+/// Finds and maps a KTX or DDS texture container by its name
+/**
+ *  @ingroup image_load_gen
+ */
+TextureContainer LoadContainerByName(
+	std::string category,
+	std::string name
+);
+
 /// Helper function for loading textures that come with @OGLplus in the examples
 /**
  *  @ingroup image_load_gen
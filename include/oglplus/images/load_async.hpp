@@ -0,0 +1,121 @@
+/**
+ *  @file oglplus/images/load_async.hpp
+ *  @brief Asynchronous loading of images by their names
+ *
+ *  @author Matus Chochlik
+ *
+ *  Copyright 2010-2015 Matus Chochlik. Distributed under the Boost
+ *  Software License, Version 1.0. (See accompanying file
+ *  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#pragma once
+#ifndef OGLPLUS_IMAGES_LOAD_ASYNC_1107121519_HPP
+#define OGLPLUS_IMAGES_LOAD_ASYNC_1107121519_HPP
+
+#include <oglplus/images/load.hpp>
+#include <oglplus/opt/resource_loader.hpp>
+
+namespace oglplus {
+namespace images {
+namespace aux {
+
+inline std::string LoadByNameAsyncKey(
+	const std::string& category,
+	const std::string& name,
+	bool y_is_up,
+	bool x_is_right
+)
+{
+	return	category+'/'+name+
+		(y_is_up?"/y_up":"/y_down")+
+		(x_is_right?"/x_right":"/x_left");
+}
+
+} // namespace aux
+
+/// Loads an image like LoadByName in one of the threads of the @p loader
+/**
+ *  @ingroup image_load_gen
+ */
+inline std::shared_future<Image> LoadByNameAsync(
+	ResourceLoader& loader,
+	const std::string& category,
+	const std::string& name,
+	bool y_is_up,
+	bool x_is_right,
+	int priority = 0
+)
+{
+	return loader.Request<Image>(
+		aux::LoadByNameAsyncKey(category, name, y_is_up, x_is_right),
+		priority,
+		[=](void) { return LoadByName(category, name, y_is_up, x_is_right); }
+	);
+}
+
+/// Loads an image asynchronously and calls @p done from loader.Dispatch()
+/** The @p done function is called with the @c std::shared_future<Image>
+ *  of the loaded image.
+ *
+ *  @ingroup image_load_gen
+ */
+template <typename Done>
+inline std::shared_future<Image> LoadByNameAsync(
+	ResourceLoader& loader,
+	const std::string& category,
+	const std::string& name,
+	bool y_is_up,
+	bool x_is_right,
+	int priority,
+	Done done
+)
+{
+	return loader.Request<Image>(
+		aux::LoadByNameAsyncKey(category, name, y_is_up, x_is_right),
+		priority,
+		[=](void) { return LoadByName(category, name, y_is_up, x_is_right); },
+		done
+	);
+}
+
+/// Asynchronously loads a texture that comes with @OGLplus in the examples
+/**
+ *  @ingroup image_load_gen
+ */
+inline std::shared_future<Image> LoadTextureAsync(
+	ResourceLoader& loader,
+	const std::string& name,
+	int priority = 0
+)
+{
+	return LoadByNameAsync(loader, "textures", name, true, true, priority);
+}
+
+/// Asynchronously loads a texture and calls @p done from loader.Dispatch()
+/**
+ *  @ingroup image_load_gen
+ */
+template <typename Done>
+inline std::shared_future<Image> LoadTextureAsync(
+	ResourceLoader& loader,
+	const std::string& name,
+	int priority,
+	Done done
+)
+{
+	return LoadByNameAsync(
+		loader,
+		"textures",
+		name,
+		true,
+		true,
+		priority,
+		done
+	);
+}
+
+} // images
+} // oglplus
+
+#endif // include guard
@@ -14,6 +14,9 @@
 #define OGLPLUS_IMAGES_METABALLS_1107121519_HPP
 
 #include <oglplus/images/image.hpp>
+#include <oglplus/images/counter_rng.hpp>
+
+#include <vector>
 
 namespace oglplus {
 namespace images {
@@ -41,6 +44,13 @@ public:
 	 *  @param size the number of values in the balls array.
 	 *  @param n_per_ball the number of values per single ball in the balls
 	 *   array.
+	 *  @param vectorized if false then the SIMD evaluation of the (non-star)
+	 *   balls is not used. The results are the same, the scalar path is
+	 *   kept mainly for verification.
+	 *
+	 *  The image is split into tiles, which are evaluated in parallel,
+	 *  and each tile is evaluated only for the balls (and their seamless
+	 *  repetitions) whose area of influence overlaps with the tile.
 	 *
 	 *  @pre (balls) && (size) && (size % n_per_ball == 0)
 	 */
@@ -49,7 +59,8 @@ public:
 		SizeType height,
 		const GLfloat* balls,
 		std::size_t size,
-		std::size_t n_per_ball
+		std::size_t n_per_ball,
+		bool vectorized = true
 	);
 };
 
@@ -95,6 +106,13 @@ private:
 		GLfloat rad_min,
 		GLfloat rad_max
 	);
+
+	static std::vector<GLfloat> _make_balls(
+		std::size_t count,
+		GLfloat rad_min,
+		GLfloat rad_max,
+		RandomSeed seed
+	);
 public:
 	/// Creates an image with the specified dimensions and params
 	/**
@@ -111,6 +129,19 @@ public:
 		GLfloat rad_min,
 		GLfloat rad_max
 	);
+
+	/// Creates a reproducible image using an explicit random @p seed
+	/** The balls are placed using a counter-based generator instead
+	 *  of the global @c std::rand() generator.
+	 */
+	RandomMetaballs(
+		SizeType width,
+		SizeType height,
+		std::size_t count,
+		GLfloat rad_min,
+		GLfloat rad_max,
+		RandomSeed seed
+	);
 };
 
 /// Creates a Red (one components per pixel) seamless 2D metastars image
@@ -160,6 +191,17 @@ private:
 		GLuint pt_min,
 		GLuint pt_max
 	);
+
+	static std::vector<GLfloat> _make_stars(
+		std::size_t count,
+		GLfloat rad_min,
+		GLfloat rad_max,
+		GLfloat dif_min,
+		GLfloat dif_max,
+		GLuint pt_min,
+		GLuint pt_max,
+		RandomSeed seed
+	);
 public:
 	/// Creates an image with the specified dimensions and params
 	/**
@@ -180,6 +222,20 @@ public:
 		GLuint ptc_min,
 		GLuint ptc_max
 	);
+
+	/// Creates a reproducible image using an explicit random @p seed
+	RandomMetastars(
+		SizeType width,
+		SizeType height,
+		std::size_t count,
+		GLfloat rad_min,
+		GLfloat rad_max,
+		GLfloat dif_min,
+		GLfloat dif_max,
+		GLuint ptc_min,
+		GLuint ptc_max,
+		RandomSeed seed
+	);
 };
 
 } // images
@@ -0,0 +1,146 @@
+/**
+ *  @file oglplus/images/mipmap.hpp
+ *  @brief Generator of mipmap chains of images
+ *
+ *  @author Matus Chochlik
+ *
+ *  Copyright 2010-2015 Matus Chochlik. Distributed under the Boost
+ *  Software License, Version 1.0. (See accompanying file
+ *  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#pragma once
+#ifndef OGLPLUS_IMAGES_MIPMAP_1107121519_HPP
+#define OGLPLUS_IMAGES_MIPMAP_1107121519_HPP
+
+#include <oglplus/images/view.hpp>
+
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+namespace oglplus {
+namespace images {
+
+/// The filters used to resample the levels of a MipmapChain
+enum class MipmapFilter
+{
+	/// Averages 2x2 blocks of pixels (fast, slightly blurry)
+	Box,
+	/// Kaiser-windowed sinc with the support of 3 pixels
+	Kaiser,
+	/// Lanczos (3-lobe windowed sinc), the sharpest of the filters
+	Lanczos
+};
+
+/// Parameters of the MipmapChain generator
+struct MipmapParams
+{
+	/// The resampling filter, Box by default
+	MipmapFilter filter;
+
+	/// Indicates that the color channels are sRGB-encoded
+	/** If true, the color (non-alpha) channels are converted to linear
+	 *  values before filtering and back to sRGB afterwards. The alpha
+	 *  channel (the last channel of 2 and 4-channel images) is always
+	 *  filtered as linear.
+	 */
+	bool srgb;
+
+	/// Indicates that the first three channels are a normal vector
+	/** If true, the normal in the first three channels is renormalized
+	 *  after filtering. The components of unsigned integer images are
+	 *  expected to be encoded in the [0, 1] range (i.e. n*0.5+0.5),
+	 *  floating-point images (like those made by NormalMap) may contain
+	 *  signed components.
+	 */
+	bool normal_map;
+
+	/// The maximum number of levels (including level 0), 0 means all
+	unsigned max_levels;
+
+	/// The maximum number of threads used, 0 means no limit
+	unsigned max_threads;
+
+	MipmapParams(void)
+	 : filter(MipmapFilter::Box)
+	 , srgb(false)
+	 , normal_map(false)
+	 , max_levels(0)
+	 , max_threads(0)
+	{ }
+};
+
+/// A chain of successively downsampled levels of a 2D image
+/** The levels are computed on the CPU with the selected filter, each
+ *  from the previous (higher-resolution) level, until the level with
+ *  1x1 pixels, or until the specified maximum number of levels is
+ *  reached. Level 0 is a copy of the original image. All levels have
+ *  the same pixel data type, format and number of channels as the
+ *  original.
+ *
+ *  Images with @c GLubyte, @c GLushort and @c GLfloat components and
+ *  with depth 1 are supported, for other images the constructor throws
+ *  @c std::runtime_error.
+ *
+ *  The whole chain can be passed to @c Texture::Image2D.
+ *
+ *  @ingroup image_load_gen
+ */
+class MipmapChain
+{
+private:
+	std::vector<Image> _levels;
+
+	template <typename T>
+	void _build(const ImageView& image, const MipmapParams& params);
+public:
+	/// Builds the mipmap chain for the specified @p image
+	explicit
+	MipmapChain(
+		const ImageView& image,
+		const MipmapParams& params = MipmapParams()
+	);
+
+	/// Returns the number of levels in the chain
+	std::size_t Levels(void) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		return _levels.size();
+	}
+
+	/// Returns the image at the specified @p level
+	/**
+	 *  @pre level < Levels()
+	 */
+	const Image& Level(std::size_t level) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		assert(level < _levels.size());
+		return _levels[level];
+	}
+
+	/// Returns the number of levels of the full chain for an image
+	static std::size_t FullLevelCount(SizeType width, SizeType height)
+	OGLPLUS_NOEXCEPT(true)
+	{
+		GLsizei size = GLsizei(width);
+		if(size < GLsizei(height)) size = GLsizei(height);
+		std::size_t result = 1;
+		while(size > 1)
+		{
+			size /= 2;
+			++result;
+		}
+		return result;
+	}
+};
+
+} // namespace images
+} // namespace oglplus
+
+#if !OGLPLUS_LINK_LIBRARY || defined(OGLPLUS_IMPLEMENTING_LIBRARY)
+#include <oglplus/images/mipmap.ipp>
+#endif
+
+#endif // include guard
@@ -15,8 +15,14 @@
 
 #include <oglplus/images/image.hpp>
 #include <oglplus/math/vector.hpp>
+#include <oglplus/detail/float_lanes.hpp>
+#include <oglplus/detail/parallel_for.hpp>
 
 #include <cassert>
+#include <cmath>
+#include <cstring>
+#include <type_traits>
+#include <utility>
 
 namespace oglplus {
 namespace images {
@@ -40,12 +46,31 @@ namespace images {
  *  };
  *  @endcode
  *
+ *  The image is rendered in tiles which are processed in parallel. If the
+ *  polynomial class additionally implements @c f and @c df as templates
+ *  working with the real and imaginary parts separately (like the built-in
+ *  X3Minus1 and X4Minus1 do), then several pixels are iterated at once
+ *  using SIMD instructions:
+ *  @code
+ *  struct MyPoly
+ *  {
+ *    template <typename T>
+ *    static void f(const T& x, const T& y, T& fx, T& fy);
+ *    template <typename T>
+ *    static void df(const T& x, const T& y, T& dfx, T& dfy);
+ *  };
+ *  @endcode
+ *
  *  @ingroup image_load_gen
  */
 class NewtonFractal
  : public Image
 {
 private:
+	// the viewport and the colors of the currently rendered fractal
+	Vec2f _lb, _rt;
+	Vec3f _c1, _c2;
+
 	// complex number division
 	static Vec2f _cdiv(Vec2f a, Vec2f b)
 	{
@@ -63,92 +88,389 @@ private:
 		return a*(1.0f - coef) + b*coef;
 	}
 
-	template <typename Function, typename Mixer, std::size_t N>
-	void _make(
-		GLsizei width,
-		GLsizei height,
-		Function,
-		Mixer mixer,
+	static std::size_t _max_iters(void)
+	{
+		return 256;
+	}
+
+	// checks if the Function implements f and df for separate components
+	/* The type is FloatLanesRawTag if it does (and std::false_type
+	 * otherwise), which is declared in the namespace of the instruction
+	 * set, so the SIMD versions of _iterate_column for different
+	 * instruction sets have different names.
+	 */
+	template <typename Function>
+	struct _has_lanes
+	{
+		template <typename F>
+		static auto _chk(F*) -> decltype(
+			F::f(
+				std::declval<const oglplus::aux::FloatLanes&>(),
+				std::declval<const oglplus::aux::FloatLanes&>(),
+				std::declval<oglplus::aux::FloatLanes&>(),
+				std::declval<oglplus::aux::FloatLanes&>()
+			),
+			F::df(
+				std::declval<const oglplus::aux::FloatLanes&>(),
+				std::declval<const oglplus::aux::FloatLanes&>(),
+				std::declval<oglplus::aux::FloatLanes&>(),
+				std::declval<oglplus::aux::FloatLanes&>()
+			),
+			oglplus::aux::FloatLanesRawTag()
+		);
+
+		template <typename F>
+		static std::false_type _chk(...);
+
+		typedef decltype(_chk<Function>((Function*)nullptr)) type;
+	};
+
+	// returns the number of iterations for a single point
+	template <typename Function>
+	static std::size_t _iterate(Vec2f z)
+	{
+		std::size_t n, max = _max_iters();
+		for(n = 0; n != max; ++n)
+		{
+			Vec2f zn = z - _cdiv(
+				Function::f(z),
+				Function::df(z)
+			);
+			if(Distance(zn, z) < 0.00001f) break;
+			z = zn;
+		}
+		return n;
+	}
+
+	// calculates the number of iterations for pixels [j0, j1)
+	// of the i-th column
+	template <typename Function>
+	void _iterate_column(
+		GLsizei i,
+		GLsizei j0,
+		GLsizei j1,
 		Vec2f lb,
 		Vec2f rt,
-		Vector<float, N> c1,
-		Vector<float, N> c2
-	)
+		float* iters,
+		std::false_type
+	) const
 	{
-		auto p = this->_begin<GLfloat>();
-
-		for(GLsizei i=0; i!=width; ++i)
-		for(GLsizei j=0; j!=height; ++j)
+		const GLsizei width = GLsizei(Width());
+		const GLsizei height = GLsizei(Height());
+		for(GLsizei j=j0; j!=j1; ++j)
 		{
 			Vec2f z(
 				_mix(lb.x(), rt.x(), float(i)/float(width-1)),
 				_mix(lb.y(), rt.y(), float(j)/float(height-1))
 			);
-			std::size_t n, max = 256;
-			for(n = 0; n != max; ++n)
+			*iters++ = float(_iterate<Function>(z));
+		}
+	}
+
+	// calculates the number of iterations for pixels [j0, j1)
+	// of the i-th column, aux::FloatLanes::Width pixels at a time
+	template <typename Function>
+	void _iterate_column(
+		GLsizei i,
+		GLsizei j0,
+		GLsizei j1,
+		Vec2f lb,
+		Vec2f rt,
+		float* iters,
+		oglplus::aux::FloatLanesRawTag
+	) const
+	{
+		typedef oglplus::aux::FloatLanes L;
+		typedef oglplus::aux::FloatLanesMask M;
+		const GLsizei width = GLsizei(Width());
+		const GLsizei height = GLsizei(Height());
+		const std::size_t max = _max_iters();
+
+		const L zx0(_mix(lb.x(), rt.x(), float(i)/float(width-1)));
+
+		for(GLsizei j=j0; j<j1; j+=GLsizei(L::Width))
+		{
+			float tmp[L::Width];
+			for(GLsizei l=0; l!=GLsizei(L::Width); ++l)
 			{
-				Vec2f zn = z - _cdiv(
-					Function::f(z),
-					Function::df(z)
+				// the lanes past the end repeat the last pixel
+				const GLsizei jl = (j+l < j1)?j+l:j1-1;
+				tmp[l] = _mix(
+					lb.y(), rt.y(),
+					float(jl)/float(height-1)
 				);
-				if(Distance(zn, z) < 0.00001f) break;
-				z = zn;
 			}
+			L zx = zx0;
+			L zy = L::Load(tmp);
+			L nn = L(float(max));
+			M active(true);
+
+			for(std::size_t n=0; n!=max; ++n)
+			{
+				L fx, fy, dfx, dfy;
+				Function::f(zx, zy, fx, fy);
+				Function::df(zx, zy, dfx, dfy);
+
+				// the same operations as in _cdiv and Distance
+				const L d = dfx*dfx + dfy*dfy;
+				const M dz = (d == L(0.0f));
+				const L qx = Select(dz, fx, (fx*dfx+fy*dfy)/d);
+				const L qy = Select(dz, fy, (fy*dfx-fx*dfy)/d);
+				const L znx = zx - qx;
+				const L zny = zy - qy;
+				const L ex = znx - zx;
+				const L ey = zny - zy;
+
+				const L dist = Sqrt(ex*ex + ey*ey);
+				const M done = active & (dist < L(0.00001f));
+				nn = Select(done, L(float(n)), nn);
+				active = AndNot(active, done);
+				if(!Any(active)) break;
+
+				zx = Select(active, znx, zx);
+				zy = Select(active, zny, zy);
+			}
+			nn.Store(tmp);
+			const GLsizei w = GLsizei(L::Width);
+			for(GLsizei l=0; (l!=w) && (j+l<j1); ++l)
+			{
+				*iters++ = tmp[l];
+			}
+		}
+	}
+
+	// writes the colors of count pixels with the specified iteration counts
+	template <typename Mixer, std::size_t N>
+	static void _colorize(
+		GLfloat* p,
+		const float* iters,
+		GLsizei count,
+		const Mixer& mixer,
+		const Vector<float, N>& c1,
+		const Vector<float, N>& c2
+	)
+	{
+		const float max = float(_max_iters()-1);
+		for(GLsizei j=0; j!=count; ++j)
+		{
 			Vector<float, N> c = _mix(
 				c1,
 				c2,
-				float(mixer(float(n) / float(max-1)))
+				float(mixer(iters[j] / max))
 			);
-			for(n=0; n!=N; ++n)
+			for(std::size_t k=0; k!=N; ++k)
 			{
-				assert(p != this->_end<GLfloat>());
-				*p = c.At(n);
-				++p;
+				*p++ = c.At(k);
 			}
 		}
-		assert(p == this->_end<GLfloat>());
+	}
+
+	// renders the pixels in the [i0, i1) x [j0, j1) rectangle
+	template <typename Function, typename Mixer, std::size_t N>
+	void _render(
+		GLsizei i0,
+		GLsizei i1,
+		GLsizei j0,
+		GLsizei j1,
+		Mixer mixer,
+		Vec2f lb,
+		Vec2f rt,
+		Vector<float, N> c1,
+		Vector<float, N> c2
+	)
+	{
+		if((i0 >= i1) || (j0 >= j1)) return;
+
+		// the pixels are stored column after column
+		const GLsizei height = GLsizei(Height());
+		const GLsizei ts = 32;
+		const GLsizei tiles_i = (i1-i0+ts-1)/ts;
+		const GLsizei tiles_j = (j1-j0+ts-1)/ts;
+		GLfloat* const data = this->_begin<GLfloat>();
+		typedef typename _has_lanes<Function>::type lanes;
+
+		oglplus::aux::ParallelFor(
+			std::size_t(tiles_i*tiles_j),
+			1,
+			[&](std::size_t begin, std::size_t end)
+			{
+				float iters[ts];
+				for(std::size_t t=begin; t!=end; ++t)
+				{
+					const GLsizei ti = i0+GLsizei(t)/tiles_j*ts;
+					const GLsizei ie = (ti+ts<i1)?ti+ts:i1;
+					const GLsizei tj = j0+GLsizei(t)%tiles_j*ts;
+					const GLsizei je = (tj+ts<j1)?tj+ts:j1;
+
+					for(GLsizei i=ti; i!=ie; ++i)
+					{
+						_iterate_column<Function>(
+							i, tj, je,
+							lb, rt,
+							iters,
+							lanes()
+						);
+						_colorize(
+							data+std::size_t(i*height+tj)*N,
+							iters, je-tj,
+							mixer,
+							c1, c2
+						);
+					}
+				}
+			}
+		);
+	}
+
+	template <typename Function, typename Mixer, std::size_t N>
+	void _make(
+		GLsizei width,
+		GLsizei height,
+		Function,
+		Mixer mixer,
+		Vec2f lb,
+		Vec2f rt,
+		Vector<float, N> c1,
+		Vector<float, N> c2
+	)
+	{
+		_render<Function>(0, width, 0, height, mixer, lb, rt, c1, c2);
+	}
+
+	template <typename Function, typename Mixer, std::size_t N>
+	void _pan(
+		Function,
+		Mixer mixer,
+		Vec2f lb,
+		Vec2f rt,
+		Vector<float, N> c1,
+		Vector<float, N> c2
+	)
+	{
+		const GLsizei width = GLsizei(Width());
+		const GLsizei height = GLsizei(Height());
+
+		// the distance between the pixels in the complex space
+		const Vec2f step(
+			(_rt.x()-_lb.x())/float(width-1),
+			(_rt.y()-_lb.y())/float(height-1)
+		);
+		const Vec2f shift(
+			(lb.x()-_lb.x())/step.x(),
+			(lb.y()-_lb.y())/step.y()
+		);
+		const GLsizei di = GLsizei(std::floor(shift.x()+0.5f));
+		const GLsizei dj = GLsizei(std::floor(shift.y()+0.5f));
+
+		// the pixels can be reused only if the size of the viewport
+		// did not change and it moved by a whole number of pixels
+		const Vec2f size_diff = (rt-lb)-(_rt-_lb);
+		const bool reusable =
+			(width > 1) && (height > 1) &&
+			(std::abs(size_diff.x()) <= 1e-5f*std::abs(step.x())) &&
+			(std::abs(size_diff.y()) <= 1e-5f*std::abs(step.y())) &&
+			(std::abs(shift.x()-float(di)) < 1e-3f) &&
+			(std::abs(shift.y()-float(dj)) < 1e-3f) &&
+			(std::abs(di) < width) &&
+			(std::abs(dj) < height);
+
+		if(!reusable)
+		{
+			_render<Function>(0, width, 0, height, mixer, lb, rt, c1, c2);
+			return;
+		}
+
+		// the new pixel [i, j] is the old pixel [i+di, j+dj]
+		GLfloat* const data = this->_begin<GLfloat>();
+		const GLsizei ib = (di < 0)?-di:0;
+		const GLsizei ie = (di > 0)?width-di:width;
+		const GLsizei jb = (dj < 0)?-dj:0;
+		const GLsizei je = (dj > 0)?height-dj:height;
+		const std::size_t col_size = std::size_t(je-jb)*N*sizeof(GLfloat);
+
+		for(GLsizei k=0; k!=ie-ib; ++k)
+		{
+			// the columns are moved in the direction of the shift
+			// so that no source column is overwritten before it is used
+			const GLsizei i = (di < 0)?ie-1-k:ib+k;
+			std::memmove(
+				data+std::size_t(i*height+jb)*N,
+				data+std::size_t((i+di)*height+jb+dj)*N,
+				col_size
+			);
+		}
+
+		// render the newly exposed columns and rows
+		_render<Function>(0, ib, 0, height, mixer, lb, rt, c1, c2);
+		_render<Function>(ie, width, 0, height, mixer, lb, rt, c1, c2);
+		_render<Function>(ib, ie, 0, jb, mixer, lb, rt, c1, c2);
+		_render<Function>(ib, ie, je, height, mixer, lb, rt, c1, c2);
 	}
 public:
 	/// The X^3-1 function and its derivation
 	struct X3Minus1
 	{
+		template <typename T>
+		static void f(const T& x, const T& y, T& fx, T& fy)
+		{
+			fx = x*x*x - 3.f*x*y*y - 1.f;
+			fy = -y*y*y + 3.f*x*x*y;
+		}
+
+		template <typename T>
+		static void df(const T& x, const T& y, T& dfx, T& dfy)
+		{
+			dfx = 3.0f * (x*x - y*y);
+			dfy = 3.0f * (2.0f * x * y);
+		}
+
 		static Vec2f f(Vec2f n)
 		{
-			return Vec2f(
-				n.x()*n.x()*n.x() - 3.f*n.x()*n.y()*n.y() - 1.f,
-				-n.y()*n.y()*n.y() + 3.f*n.x()*n.x()*n.y()
-			);
+			Vec2f r;
+			f(n.x(), n.y(), r[0], r[1]);
+			return r;
 		}
 
 		static Vec2f df(Vec2f n)
 		{
-			return 3.0f * Vec2f(
-				n.x()*n.x() - n.y()*n.y(),
-				2.0f * n.x() * n.y()
-			);
+			Vec2f r;
+			df(n.x(), n.y(), r[0], r[1]);
+			return r;
 		}
 	};
 
 	/// The X^4-1 function and its derivation
 	struct X4Minus1
 	{
+		template <typename T>
+		static void f(const T& x, const T& y, T& fx, T& fy)
+		{
+			fx =	x*x*x*x +
+				y*y*y*y -
+				6.f*x*x*y*y - 1.f;
+			fy =	4.f*x*x*x*y -
+				4.f*x*y*y*y;
+		}
+
+		template <typename T>
+		static void df(const T& x, const T& y, T& dfx, T& dfy)
+		{
+			dfx = 4.0f * (x*x*x - 3.f*x*y*y);
+			dfy = 4.0f * (-y*y*y + 3.f*x*x*y);
+		}
+
 		static Vec2f f(Vec2f n)
 		{
-			return Vec2f(
-				n.x()*n.x()*n.x()*n.x() +
-				n.y()*n.y()*n.y()*n.y() -
-				6.f*n.x()*n.x()*n.y()*n.y() - 1.f,
-				4.f*n.x()*n.x()*n.x()*n.y() -
-				4.f*n.x()*n.y()*n.y()*n.y()
-			);
+			Vec2f r;
+			f(n.x(), n.y(), r[0], r[1]);
+			return r;
 		}
 
 		static Vec2f df(Vec2f n)
 		{
-			return 4.0f * Vec2f(
-				n.x()*n.x()*n.x() - 3.f*n.x()*n.y()*n.y(),
-				-n.y()*n.y()*n.y() + 3.f*n.x()*n.x()*n.y()
-			);
+			Vec2f r;
+			df(n.x(), n.y(), r[0], r[1]);
+			return r;
 		}
 	};
 
@@ -212,6 +534,10 @@ public:
 		Function func = Function(),
 		Mixer mixer = Mixer()
 	): Image(width, height, 1, 3, &TypeTag<GLfloat>())
+	 , _lb(lb)
+	 , _rt(rt)
+	 , _c1(c1)
+	 , _c2(c2)
 	{
 		_make(width, height, func, mixer, lb, rt, c1, c2);
 	}
@@ -235,6 +561,10 @@ public:
 		Function func = Function(),
 		Mixer mixer = Mixer()
 	): Image(width, height, 1, 1, &TypeTag<GLfloat>())
+	 , _lb(-1.0f, -1.0f)
+	 , _rt( 1.0f,  1.0f)
+	 , _c1(0.0f, 0.0f, 0.0f)
+	 , _c2(1.0f, 0.0f, 0.0f)
 	{
 		_make(
 			width, height,
@@ -256,6 +586,10 @@ public:
 		Function func,
 		Mixer mixer
 	): Image(width, height, 1, 3, (GLfloat*)0)
+	 , _lb(lb)
+	 , _rt(rt)
+	 , _c1(c1)
+	 , _c2(c2)
 	{
 		_make(width, height, func, mixer, lb, rt, c1, c2);
 	}
@@ -267,6 +601,10 @@ public:
 		Function func,
 		Mixer mixer
 	): Image(width, height, 1, 1, (GLfloat*)0)
+	 , _lb(-1.0f, -1.0f)
+	 , _rt( 1.0f,  1.0f)
+	 , _c1(0.0f, 0.0f, 0.0f)
+	 , _c2(1.0f, 0.0f, 0.0f)
 	{
 		_make(
 			width, height,
@@ -277,6 +615,36 @@ public:
 		);
 	}
 #endif
+
+	/// Moves the viewport to [lb, rt] and re-renders the image
+	/** If the viewport moved by a whole number of pixels, without changing
+	 *  its size, then the pixels which remain visible are moved and only
+	 *  the newly exposed ones are rendered. Otherwise the whole image
+	 *  is rendered again. The @p func and @p mixer must be the same as
+	 *  those used for rendering of the original image, the colors are
+	 *  kept.
+	 */
+	template <typename Function, typename Mixer>
+	void Pan(Vec2f lb, Vec2f rt, Function func, Mixer mixer)
+	{
+		if(GLsizei(Channels()) == 1)
+		{
+			_pan(
+				func, mixer,
+				lb, rt,
+				Vec1f(_c1.x()), Vec1f(_c2.x())
+			);
+		}
+		else _pan(func, mixer, lb, rt, _c1, _c2);
+		_lb = lb;
+		_rt = rt;
+	}
+
+	/// Moves the viewport of an image made with the default function
+	void Pan(Vec2f lb, Vec2f rt)
+	{
+		Pan(lb, rt, DefaultFunction(), DefaultMixer());
+	}
 };
 
 } // images
@@ -0,0 +1,154 @@
+/**
+ *  @file oglplus/images/noise.hpp
+ *  @brief Simplex and fractal (fBm) gradient noise image generators
+ *
+ *  @author Matus Chochlik
+ *
+ *  Copyright 2010-2015 Matus Chochlik. Distributed under the Boost
+ *  Software License, Version 1.0. (See accompanying file
+ *  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#pragma once
+#ifndef OGLPLUS_IMAGES_NOISE_1107121519_HPP
+#define OGLPLUS_IMAGES_NOISE_1107121519_HPP
+
+#include <oglplus/images/image.hpp>
+#include <oglplus/images/counter_rng.hpp>
+
+namespace oglplus {
+namespace images {
+
+/// Parameters of the noise image generators
+struct NoiseParams
+{
+	/// The size (in texels) of the lattice cells of the first octave
+	GLfloat scale;
+
+	/// The number of summed octaves (used only by FractalNoise)
+	unsigned octaves;
+
+	/// The ratio of the frequencies of the subsequent octaves
+	GLfloat lacunarity;
+
+	/// The ratio of the amplitudes of the subsequent octaves
+	GLfloat gain;
+
+	/// Make the noise periodic with the size of the image
+	/** The number of the lattice cells of each octave along each axis
+	 *  is rounded to an integer, so that the image can be repeated
+	 *  seamlessly. Since the lattice of the simplex noise is skewed,
+	 *  it cannot be periodic along the axes and tileable images use
+	 *  gradient noise on a periodic cubic lattice instead.
+	 */
+	bool tiling;
+
+	/// The type of the image data
+	/** @c Float, @c HalfFloat (with values in the [-1, 1] range)
+	 *  or @c UnsignedByte (with the values mapped to [0, 1]).
+	 */
+	PixelDataType type;
+
+	/// Use the SIMD kernels where available
+	bool vectorized;
+
+	/// The maximum number of threads used, 0 means no limit
+	unsigned max_threads;
+
+	NoiseParams(void)
+	 : scale(32.0f)
+	 , octaves(5)
+	 , lacunarity(2.0f)
+	 , gain(0.5f)
+	 , tiling(false)
+	 , type(PixelDataType::Float)
+	 , vectorized(true)
+	 , max_threads(0)
+	{ }
+};
+
+/// Generator of fractal Brownian motion of gradient noise
+/** Each of the 1-4 channels of the image is an independent sum of
+ *  the octaves of the noise with increasing frequencies (by the lacunarity)
+ *  and decreasing amplitudes (by the gain), normalized so that the result
+ *  is approximately in the [-1, 1] range. 2D images are a slice of the
+ *  3D noise. The value of each texel depends only on the @p seed,
+ *  the parameters and on the coordinates of the texel (and on the size
+ *  of the image if it is tiling).
+ *
+ *  The noise is evaluated by SIMD kernels (which give the same results
+ *  as the scalar code) and the rows of the image are generated in parallel,
+ *  so that large 3D noise volumes can be generated at load time instead
+ *  of being stored with the application.
+ *
+ *  @code
+ *  images::NoiseParams params;
+ *  params.tiling = true;
+ *  params.type = PixelDataType::HalfFloat;
+ *  images::FractalNoise noise(128, 128, 128, 1, images::RandomSeed(1), params);
+ *  @endcode
+ *
+ *  @ingroup image_load_gen
+ */
+class FractalNoise
+ : public Image
+{
+private:
+	static Image _make(
+		SizeType width,
+		SizeType height,
+		SizeType depth,
+		SizeType channels,
+		RandomSeed seed,
+		const NoiseParams& params
+	);
+public:
+	/// Creates a noise image with the specified dimensions
+	FractalNoise(
+		SizeType width,
+		SizeType height,
+		SizeType depth,
+		SizeType channels,
+		RandomSeed seed,
+		const NoiseParams& params = NoiseParams()
+	): Image(_make(width, height, depth, channels, seed, params))
+	{ }
+};
+
+/// Generator of a single octave of simplex noise
+/** This is a FractalNoise with a single octave, i.e. band-limited noise
+ *  with features about the size of the @c scale of the parameters.
+ *
+ *  @ingroup image_load_gen
+ */
+class SimplexNoise
+ : public FractalNoise
+{
+private:
+	static NoiseParams _single(const NoiseParams& params)
+	{
+		NoiseParams result(params);
+		result.octaves = 1;
+		return result;
+	}
+public:
+	/// Creates a noise image with the specified dimensions
+	SimplexNoise(
+		SizeType width,
+		SizeType height,
+		SizeType depth,
+		SizeType channels,
+		RandomSeed seed,
+		const NoiseParams& params = NoiseParams()
+	): FractalNoise(width, height, depth, channels, seed, _single(params))
+	{ }
+};
+
+} // images
+} // oglplus
+
+#if !OGLPLUS_LINK_LIBRARY || defined(OGLPLUS_IMPLEMENTING_LIBRARY)
+#include <oglplus/images/noise.ipp>
+#endif
+
+#endif // include guard
@@ -37,11 +37,11 @@ public:
 	 *    value used in normal-map calculation).
 	 */
 	template <typename Extractor>
-	NormalMap(const Image& input, Extractor extractor = Extractor());
+	NormalMap(const ImageView& input, Extractor extractor = Extractor());
 #endif
-	NormalMap(const Image& input);
-	NormalMap(const Image& input, Filtered::FromRed);
-	NormalMap(const Image& input, Filtered::FromAlpha);
+	NormalMap(const ImageView& input);
+	NormalMap(const ImageView& input, Filtered::FromRed);
+	NormalMap(const ImageView& input, Filtered::FromAlpha);
 };
 
 } // images
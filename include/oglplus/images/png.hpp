@@ -16,9 +16,113 @@
 #include <oglplus/images/image.hpp>
 
 #include <istream>
+#include <memory>
+#include <vector>
 
 namespace oglplus {
 namespace images {
+namespace aux {
+
+class PNGDecoderImpl;
+
+} // namespace aux
+
+/// Streaming decoder of images in the PNG (Portable network graphics) format
+/** The decoder reads the PNG header when constructed and then decodes
+ *  the image one row at a time into memory supplied by the caller, for
+ *  example into a mapped pixel-unpack buffer or a preallocated array.
+ *  This way only a single row (plus the compressed input) is kept in
+ *  memory by the decoder, except for interlaced images which have to be
+ *  decoded completely before the first row is available.
+ *
+ *  The rows are decoded from the top of the image, palette and grayscale
+ *  images with less than 8 bits per pixel are expanded and 16-bit values
+ *  are stripped to 8 bits, the same way as by @c PNGImage.
+ *
+ *  @ingroup image_load_gen
+ */
+class PNGDecoder
+{
+private:
+	std::unique_ptr<aux::PNGDecoderImpl> _pimpl;
+	std::vector<GLubyte> _row;
+public:
+	/// Decodes the image from the specified @p input stream
+	PNGDecoder(std::istream& input);
+
+	/// Decodes the image from a memory buffer of the specified @p size
+	/** The buffer must outlive the decoder.
+	 */
+	PNGDecoder(const void* data, std::size_t size);
+
+	/// Decodes the image from a file with the specified @p file_path
+	/** The file is mapped into memory (if the system supports it)
+	 *  instead of being read through a stream.
+	 */
+	PNGDecoder(const char* file_path);
+
+	PNGDecoder(PNGDecoder&& tmp);
+
+	~PNGDecoder(void);
+
+	/// Returns the width of the image
+	SizeType Width(void) const;
+
+	/// Returns the height of the image
+	SizeType Height(void) const;
+
+	/// Returns the number of channels of the decoded pixels
+	SizeType Channels(void) const;
+
+	/// Returns the pixel data format of the decoded rows
+	PixelDataFormat Format(void) const;
+
+	/// Returns a suitable pixel data internal format
+	PixelDataInternalFormat InternalFormat(void) const;
+
+	/// Returns the size of a single decoded row in bytes
+	std::size_t RowSize(void) const;
+
+	/// Returns the number of rows decoded so far
+	GLuint RowsDecoded(void) const;
+
+	/// Decodes the next row (from the top) into @p dest
+	/** The @p dest buffer must be at least RowSize() bytes long.
+	 *  Returns false (without writing to @p dest) if all rows have
+	 *  already been decoded.
+	 */
+	bool ReadRow(void* dest, bool x_is_right = true);
+
+	/// Decodes the remaining rows and passes them to the @p sink
+	/** The sink is called as sink(y, data) where @c y is the index
+	 *  of the row in the image (counted from the bottom if @p y_is_up
+	 *  is true) and @c data points to RowSize() bytes of pixel data,
+	 *  which are valid only during the call.
+	 */
+	template <typename Sink>
+	void ReadRows(Sink sink, bool y_is_up = true, bool x_is_right = true)
+	{
+		const GLuint height = GLuint(Height());
+		_row.resize(RowSize());
+		while(RowsDecoded() < height)
+		{
+			const GLuint r = RowsDecoded();
+			ReadRow(_row.data(), x_is_right);
+			sink(y_is_up?height-r-1:r, _row.data());
+		}
+	}
+
+	/// Decodes the remaining rows into the @p dest buffer
+	/** The rows are stored @p row_stride bytes apart, which must
+	 *  be at least RowSize().
+	 */
+	void ReadImage(
+		void* dest,
+		std::ptrdiff_t row_stride,
+		bool y_is_up = true,
+		bool x_is_right = true
+	);
+};
 
 /// Loader of images in the PNG (Portable network graphics) format
 /**
@@ -41,6 +145,25 @@ public:
 		bool y_is_up = true,
 		bool x_is_right = true
 	);
+
+	/// Load the image from a memory buffer of the specified @p size
+	PNGImage(
+		const void* data,
+		std::size_t size,
+		bool y_is_up = true,
+		bool x_is_right = true
+	);
+
+	/// Load the image from the specified @p decoder
+	/** The rows are decoded directly into the storage of the image.
+	 *
+	 *  @pre decoder.RowsDecoded() == 0
+	 */
+	PNGImage(
+		PNGDecoder& decoder,
+		bool y_is_up = true,
+		bool x_is_right = true
+	);
 };
 
 } // images
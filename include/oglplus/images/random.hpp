@@ -14,6 +14,7 @@
 #define OGLPLUS_IMAGES_RANDOM_1107121519_HPP
 
 #include <oglplus/images/image.hpp>
+#include <oglplus/images/counter_rng.hpp>
 
 namespace oglplus {
 namespace images {
@@ -26,7 +27,20 @@ class RandomRedUByte
  : public Image
 {
 public:
+	/// Creates the image using the global @c std::rand() generator
 	RandomRedUByte(SizeType width, SizeType height = 1, SizeType depth = 1);
+
+	/// Creates a reproducible image using an explicit random @p seed
+	/** The value of each texel depends only on the @p seed and on its
+	 *  coordinates, so the rows are generated in parallel and the same
+	 *  region of the noise is generated for every image size.
+	 */
+	RandomRedUByte(
+		SizeType width,
+		SizeType height,
+		SizeType depth,
+		RandomSeed seed
+	);
 };
 
 
@@ -38,7 +52,19 @@ class RandomRGBUByte
  : public Image
 {
 public:
+	/// Creates the image using the global @c std::rand() generator
 	RandomRGBUByte(SizeType width, SizeType height = 1, SizeType depth = 1);
+
+	/// Creates a reproducible image using an explicit random @p seed
+	/** The value of each texel component depends only on the @p seed,
+	 *  on the coordinates of the texel and on the index of the component.
+	 */
+	RandomRGBUByte(
+		SizeType width,
+		SizeType height,
+		SizeType depth,
+		RandomSeed seed
+	);
 };
 
 } // images
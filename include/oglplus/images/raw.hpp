@@ -0,0 +1,92 @@
+/**
+ *  @file oglplus/images/raw.hpp
+ *  @brief Image with raw pixel data mapped from a file
+ *
+ *  @author Matus Chochlik
+ *
+ *  Copyright 2010-2015 Matus Chochlik. Distributed under the Boost
+ *  Software License, Version 1.0. (See accompanying file
+ *  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#pragma once
+#ifndef OGLPLUS_IMAGES_RAW_1107121519_HPP
+#define OGLPLUS_IMAGES_RAW_1107121519_HPP
+
+#include <oglplus/images/image.hpp>
+
+#include <cstddef>
+
+namespace oglplus {
+namespace images {
+
+/// Image with headerless pixel data mapped (or read) from a file
+/** The file must contain at least @c width * @c height * @c depth *
+ *  @c channels values of type @c T (in the native byte order) starting
+ *  at the specified @c offset. Where the system supports it, the file
+ *  is mapped into memory instead of being read, which allows to use
+ *  very large (3D) images without allocating their storage on the heap.
+ *  The file itself is never modified.
+ *
+ *  @ingroup image_load_gen
+ */
+template <typename T>
+class RawImage
+ : public Image
+{
+private:
+	static oglplus::aux::AlignedPODArray _map(
+		const char* path,
+		SizeType width,
+		SizeType height,
+		SizeType depth,
+		SizeType channels,
+		std::size_t offset
+	)
+	{
+		return oglplus::aux::AlignedPODArray::MapFile<T>(
+			path,
+			offset,
+			std::size_t(width*height*depth*channels)
+		);
+	}
+public:
+	/// Maps the raw pixel data from the file at the specified path
+	RawImage(
+		const char* path,
+		SizeType width,
+		SizeType height,
+		SizeType depth,
+		SizeType channels,
+		std::size_t offset = 0
+	): Image(
+		width, height, depth, channels,
+		&TypeTag<T>(),
+		_map(path, width, height, depth, channels, offset)
+	)
+	{ }
+
+	/// Maps the raw pixel data from the file at the specified path
+	RawImage(
+		const char* path,
+		SizeType width,
+		SizeType height,
+		SizeType depth,
+		SizeType channels,
+		PixelDataFormat format,
+		PixelDataInternalFormat internal,
+		std::size_t offset = 0
+	): Image(
+		width, height, depth, channels,
+		&TypeTag<T>(),
+		_map(path, width, height, depth, channels, offset),
+		format,
+		internal
+	)
+	{ }
+};
+
+} // images
+} // oglplus
+
+#endif // include guard
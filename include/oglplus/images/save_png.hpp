@@ -0,0 +1,103 @@
+/**
+ *  @file oglplus/images/save_png.hpp
+ *  @brief Parallel PNG image writer (based on zlib)
+ *
+ *  @author Matus Chochlik
+ *
+ *  Copyright 2010-2015 Matus Chochlik. Distributed under the Boost
+ *  Software License, Version 1.0. (See accompanying file
+ *  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#pragma once
+#ifndef OGLPLUS_IMAGES_SAVE_PNG_1107121519_HPP
+#define OGLPLUS_IMAGES_SAVE_PNG_1107121519_HPP
+
+#include <oglplus/images/view.hpp>
+
+#include <ostream>
+
+namespace oglplus {
+namespace images {
+
+/// The row filters (and filter selection heuristics) used by SavePNG
+enum class PNGRowFilter
+{
+	None,
+	Sub,
+	Up,
+	Average,
+	Paeth,
+	/// Select for each row the filter with minimal sum of absolute values
+	Adaptive
+};
+
+/// Parameters of the SavePNG function
+struct PNGSaveParams
+{
+	/// The row filter, adaptive by default
+	PNGRowFilter filter;
+
+	/// The zlib compression level (0-9), 6 by default
+	int compression_level;
+
+	/// If true, the first row of the image is the bottom row of the PNG
+	/** This is the case for images loaded by the PNGImage and for data
+	 *  read back from a framebuffer.
+	 */
+	bool y_is_up;
+
+	/// The maximum number of threads used, 0 means no limit
+	unsigned max_threads;
+
+	/// The number of rows compressed as a single block, 0 means automatic
+	unsigned band_rows;
+
+	PNGSaveParams(void)
+	 : filter(PNGRowFilter::Adaptive)
+	 , compression_level(6)
+	 , y_is_up(true)
+	 , max_threads(0)
+	 , band_rows(0)
+	{ }
+};
+
+/// Writes the @p image in the PNG format into the @p output stream
+/** The rows of the image are filtered and bands of rows are compressed
+ *  in parallel. Each band is compressed as an independent sequence of
+ *  deflate blocks, primed with the preceding 32KB of (filtered) data,
+ *  and the bands are joined into a single zlib stream, so the result is
+ *  a regular PNG file readable by any decoder.
+ *
+ *  Images with 1 (gray), 2 (gray-alpha), 3 (RGB) or 4 (RGBA) channels
+ *  of the @c GLubyte or @c GLushort type and with depth 1 are supported,
+ *  for other images this function throws @c std::runtime_error.
+ *
+ *  @ingroup image_load_gen
+ */
+void SavePNG(
+	const ImageView& image,
+	std::ostream& output,
+	const PNGSaveParams& params = PNGSaveParams()
+);
+
+/// Writes the @p image in the PNG format into the file at @p file_path
+/**
+ *  @see SavePNG(const ImageView&, std::ostream&, const PNGSaveParams&)
+ *
+ *  @ingroup image_load_gen
+ */
+void SavePNG(
+	const ImageView& image,
+	const char* file_path,
+	const PNGSaveParams& params = PNGSaveParams()
+);
+
+} // namespace images
+} // namespace oglplus
+
+#if !OGLPLUS_LINK_LIBRARY || defined(OGLPLUS_IMPLEMENTING_LIBRARY)
+#include <oglplus/images/save_png.ipp>
+#endif
+
+#endif // include guard
@@ -0,0 +1,347 @@
+/**
+ *  @file oglplus/images/sparse.hpp
+ *  @brief Sparse 3D images storing only the non-empty bricks of texels
+ *
+ *  @author Matus Chochlik
+ *
+ *  Copyright 2010-2015 Matus Chochlik. Distributed under the Boost
+ *  Software License, Version 1.0. (See accompanying file
+ *  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#pragma once
+#ifndef OGLPLUS_IMAGES_SPARSE_1107121519_HPP
+#define OGLPLUS_IMAGES_SPARSE_1107121519_HPP
+
+#include <oglplus/images/image.hpp>
+#include <oglplus/images/view.hpp>
+#include <oglplus/detail/aligned_pod_array.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace oglplus {
+namespace images {
+
+/// A 3D image which stores only the non-empty cubic bricks of texels
+/** The image is divided into bricks of BrickSize^3 texels (the bricks
+ *  at the far edges are partially outside of the image) and only
+ *  the occupied bricks are stored. The texels of the empty bricks
+ *  are zero. This is suitable for large volumes which are mostly empty,
+ *  like clouds (see CloudTileSource::MakeSparse) or medical scans.
+ *
+ *  The occupied bricks are stored in chunks of memory which are never
+ *  moved when other bricks are allocated (but Compact can move them).
+ *  The chunks grow geometrically as the bricks are allocated, so that
+ *  at most half of the memory is unused (see also Reserve and Compact).
+ *  The bricks can be filled in parallel once they are allocated,
+ *  the allocation itself is not thread-safe.
+ *
+ *  The image can be converted to a dense Image (ToImage) or uploaded
+ *  to a 3D texture brick by brick (see Texture::SubImage3D).
+ *
+ *  @ingroup image_load_gen
+ */
+class SparseImage
+{
+private:
+	GLsizei _width, _height, _depth, _channels;
+	GLsizei _brick_size;
+	GLsizei _bricks_x, _bricks_y, _bricks_z;
+	std::size_t _comp_size;
+	PixelDataType _type;
+	PixelDataFormat _format;
+	PixelDataInternalFormat _internal;
+
+	// the slot of each brick of the grid plus one, zero if it is empty
+	std::vector<std::uint32_t> _index;
+	// the index (in the grid) of the brick in each slot
+	std::vector<std::uint32_t> _slots;
+	// the memory of the slots
+	std::vector<oglplus::aux::AlignedPODArray> _chunks;
+	// the end (the first following slot) of each chunk
+	std::vector<std::size_t> _chunk_ends;
+
+	void _init(void);
+
+	std::size_t _capacity(void) const
+	{
+		return _chunk_ends.empty()?0:_chunk_ends.back();
+	}
+
+	void _add_chunk(std::size_t slots);
+
+	std::size_t _brick_index(GLsizei bx, GLsizei by, GLsizei bz) const
+	{
+		assert(bx >= 0 && bx < _bricks_x);
+		assert(by >= 0 && by < _bricks_y);
+		assert(bz >= 0 && bz < _bricks_z);
+		return std::size_t((bz*_bricks_y+by)*_bricks_x+bx);
+	}
+
+	std::size_t _brick_texels(void) const
+	{
+		return std::size_t(_brick_size*_brick_size*_brick_size);
+	}
+
+	std::size_t _brick_bytes(void) const
+	{
+		return _brick_texels()*std::size_t(_channels)*_comp_size;
+	}
+
+	unsigned char* _slot_data(std::size_t slot) const
+	{
+		const std::size_t chunk = std::size_t(std::upper_bound(
+			_chunk_ends.begin(),
+			_chunk_ends.end(),
+			slot
+		)-_chunk_ends.begin());
+		assert(chunk < _chunks.size());
+		const std::size_t first = chunk?_chunk_ends[chunk-1]:0;
+		return static_cast<unsigned char*>(
+			_chunks[chunk].begin()
+		)+(slot-first)*_brick_bytes();
+	}
+
+	unsigned char* _alloc(std::size_t index);
+
+	template <typename T>
+	bool _type_ok(void) const
+	{
+		return _type == PixelDataType(GetDataType<T>());
+	}
+public:
+	/// Creates an empty sparse image with the specified dimensions
+	/** All texels of the image are zero until some bricks are allocated.
+	 */
+	template <typename T>
+	SparseImage(
+		SizeType width,
+		SizeType height,
+		SizeType depth,
+		SizeType channels,
+		const T*,
+		PixelDataFormat format,
+		PixelDataInternalFormat internal,
+		GLsizei brick_size = 32
+	): _width(width)
+	 , _height(height)
+	 , _depth(depth)
+	 , _channels(channels)
+	 , _brick_size(brick_size)
+	 , _comp_size(sizeof(T))
+	 , _type(PixelDataType(GetDataType<T>()))
+	 , _format(format)
+	 , _internal(internal)
+	{
+		_init();
+	}
+
+	/// Creates a sparse copy of a dense @p image
+	/** Only the bricks containing non-zero texels are stored.
+	 *  The bricks are checked and copied in parallel.
+	 */
+	explicit
+	SparseImage(const ImageView& image, GLsizei brick_size = 32);
+
+	/// Returns the width of the image
+	SizeType Width(void) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		return MakeSizeType(_width, std::nothrow);
+	}
+
+	/// Returns the height of the image
+	SizeType Height(void) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		return MakeSizeType(_height, std::nothrow);
+	}
+
+	/// Returns the depth of the image
+	SizeType Depth(void) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		return MakeSizeType(_depth, std::nothrow);
+	}
+
+	/// Returns the number of channels
+	SizeType Channels(void) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		return MakeSizeType(_channels, std::nothrow);
+	}
+
+	/// Returns the pixel data type
+	PixelDataType Type(void) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		return _type;
+	}
+
+	/// Returns the pixel data format
+	PixelDataFormat Format(void) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		return _format;
+	}
+
+	/// Returns the pixel data internal format
+	PixelDataInternalFormat InternalFormat(void) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		return _internal;
+	}
+
+	/// Returns the number of texels along each edge of the bricks
+	GLsizei BrickSize(void) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		return _brick_size;
+	}
+
+	/// Returns the number of bricks along the x axis
+	GLsizei BricksX(void) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		return _bricks_x;
+	}
+
+	/// Returns the number of bricks along the y axis
+	GLsizei BricksY(void) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		return _bricks_y;
+	}
+
+	/// Returns the number of bricks along the z axis
+	GLsizei BricksZ(void) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		return _bricks_z;
+	}
+
+	/// Returns the number of the occupied (stored) bricks
+	std::size_t OccupiedCount(void) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		return _slots.size();
+	}
+
+	/// Returns the size (in bytes) of the memory used by the bricks
+	/** This includes the unused slots at the end of the last chunk.
+	 */
+	std::size_t DataSize(void) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		return _capacity()*_brick_bytes();
+	}
+
+	/// Returns true if the specified brick is stored
+	bool IsOccupied(GLsizei bx, GLsizei by, GLsizei bz) const
+	{
+		return _index[_brick_index(bx, by, bz)] != 0;
+	}
+
+	/// Gets the coordinates of the i-th occupied brick
+	/**
+	 *  @pre i < OccupiedCount()
+	 */
+	void OccupiedBrick(
+		std::size_t i,
+		GLsizei& bx,
+		GLsizei& by,
+		GLsizei& bz
+	) const
+	{
+		assert(i < _slots.size());
+		const GLsizei index = GLsizei(_slots[i]);
+		bx = index % _bricks_x;
+		by = (index / _bricks_x) % _bricks_y;
+		bz = index / (_bricks_x*_bricks_y);
+	}
+
+	/// Returns the data of the specified brick or nullptr if it is empty
+	/** The bricks contain BrickSize^3 texels (also those at the edges
+	 *  of the image) in the same layout as an Image.
+	 */
+	template <typename T>
+	const T* BrickData(GLsizei bx, GLsizei by, GLsizei bz) const
+	{
+		assert(_type_ok<T>());
+		const std::uint32_t slot = _index[_brick_index(bx, by, bz)];
+		if(slot == 0) return nullptr;
+		return reinterpret_cast<const T*>(_slot_data(slot-1));
+	}
+
+	/// Returns the data of the specified brick, allocating it if necessary
+	/** The newly allocated bricks are zero-initialized.
+	 */
+	template <typename T>
+	T* Brick(GLsizei bx, GLsizei by, GLsizei bz)
+	{
+		assert(_type_ok<T>());
+		return reinterpret_cast<T*>(_alloc(_brick_index(bx, by, bz)));
+	}
+
+	/// Returns a view of the texels of an occupied brick inside the image
+	/**
+	 *  @pre IsOccupied(bx, by, bz)
+	 */
+	ImageView BrickView(GLsizei bx, GLsizei by, GLsizei bz) const;
+
+	/// Calls func(bx, by, bz, view) for each occupied brick
+	/** The @c view is the BrickView of the brick.
+	 */
+	template <typename Func>
+	void ForEachBrick(Func func) const
+	{
+		for(std::size_t i=0; i!=_slots.size(); ++i)
+		{
+			GLsizei bx, by, bz;
+			OccupiedBrick(i, bx, by, bz);
+			func(bx, by, bz, BrickView(bx, by, bz));
+		}
+	}
+
+	/// Returns the c-th component of the texel at x, y, z
+	template <typename T>
+	T Component(GLsizei x, GLsizei y, GLsizei z, GLsizei c = 0) const
+	{
+		assert(x >= 0 && x < _width);
+		assert(y >= 0 && y < _height);
+		assert(z >= 0 && z < _depth);
+		assert(c >= 0 && c < _channels);
+		const GLsizei s = _brick_size;
+		const T* brick = BrickData<T>(x/s, y/s, z/s);
+		if(!brick) return T(0);
+		x %= s; y %= s; z %= s;
+		return brick[((z*s+y)*s+x)*_channels+c];
+	}
+
+	/// Reserves the memory for @p count occupied bricks
+	/** The following allocations of bricks do not allocate new memory
+	 *  until the image has @p count occupied bricks.
+	 */
+	void Reserve(std::size_t count);
+
+	/// Releases the bricks which contain only zeros
+	/** The remaining bricks may be moved in the memory and the unused
+	 *  memory is released, the function returns the number
+	 *  of the released bricks.
+	 */
+	std::size_t Compact(void);
+
+	/// Makes a dense image with the same contents
+	Image ToImage(void) const;
+};
+
+} // namespace images
+} // namespace oglplus
+
+#if !OGLPLUS_LINK_LIBRARY || defined(OGLPLUS_IMPLEMENTING_LIBRARY)
+#include <oglplus/images/sparse.ipp>
+#endif
+
+#endif // include guard
@@ -0,0 +1,208 @@
+/**
+ *  @file oglplus/images/tile_cache.hpp
+ *  @brief Cache of image tiles made on demand by an ImageTileSource
+ *
+ *  @author Matus Chochlik
+ *
+ *  Copyright 2010-2015 Matus Chochlik. Distributed under the Boost
+ *  Software License, Version 1.0. (See accompanying file
+ *  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#pragma once
+#ifndef OGLPLUS_IMAGES_TILE_CACHE_1107121519_HPP
+#define OGLPLUS_IMAGES_TILE_CACHE_1107121519_HPP
+
+#include <oglplus/images/tile_source.hpp>
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+
+#if !OGLPLUS_NO_THREADS
+#include <mutex>
+#endif
+
+namespace oglplus {
+namespace images {
+
+/// Cache of the tiles of an image made on demand by an ImageTileSource
+/** The image (and each of its mipmap levels) is split into a grid of tiles
+ *  of the specified size, the tiles on the right, top and back edges may
+ *  be smaller. The tiles are made by the source when they are requested
+ *  for the first time and the least recently used tiles are dropped when
+ *  the total size of the cached tiles exceeds the budget (the most recently
+ *  made tile is always kept). The tiles are shared, so a tile which
+ *  is still used after being dropped remains valid.
+ *
+ *  The member functions can be called concurrently from multiple threads.
+ *  The source must outlive the cache.
+ *
+ *  The Texture::SubImage2D and Texture::SubImage3D overloads taking
+ *  a tile cache stream the requested region into a texture tile by tile,
+ *  so the peak memory use depends on the size of the region and on the
+ *  budget, not on the size of the whole image.
+ *
+ *  @code
+ *  images::CloudTileSource source(4096, 4096, 512, images::RandomSeed(1));
+ *  images::ImageTileCache cache(source, 256, 256, 64, 256*1024*1024);
+ *  // allocate the texture storage without data, then stream the
+ *  // region that is currently visible
+ *  Texture::SubImage3D(TextureTarget::_3D, cache, 0, x, y, z, w, h, d);
+ *  @endcode
+ *
+ *  @ingroup image_load_gen
+ */
+class ImageTileCache
+{
+public:
+	/// Shared pointer to a cached tile
+	typedef std::shared_ptr<const Image> TilePtr;
+private:
+	const ImageTileSource& _source;
+	GLsizei _tile_width, _tile_height, _tile_depth;
+	std::size_t _budget;
+	std::size_t _size;
+
+	typedef std::uint64_t _key_t;
+	typedef std::list<std::pair<_key_t, TilePtr>> _lru_list;
+	_lru_list _lru;
+	std::unordered_map<_key_t, _lru_list::iterator> _index;
+#if !OGLPLUS_NO_THREADS
+	mutable std::mutex _mutex;
+#endif
+
+	struct _lock
+	{
+#if !OGLPLUS_NO_THREADS
+		std::lock_guard<std::mutex> _guard;
+
+		_lock(const ImageTileCache& cache)
+		 : _guard(cache._mutex)
+		{ }
+#else
+		_lock(const ImageTileCache&) { }
+#endif
+	};
+
+	static _key_t _key(GLint level, GLsizei x, GLsizei y, GLsizei z);
+
+	TilePtr _find(_key_t key);
+	TilePtr _insert(_key_t key, TilePtr tile);
+	void _evict(void);
+
+	static GLsizei _count(GLsizei size, GLsizei tile)
+	{
+		return (size+tile-1)/tile;
+	}
+public:
+	/// Creates a cache of tiles of the specified size made by @p source
+	/** The @p budget is the size (in bytes) of the cached tiles
+	 *  above which the least recently used tiles are dropped.
+	 */
+	ImageTileCache(
+		const ImageTileSource& source,
+		SizeType tile_width,
+		SizeType tile_height,
+		SizeType tile_depth,
+		std::size_t budget
+	);
+
+	ImageTileCache(const ImageTileCache&) = delete;
+
+	/// Returns the source of the tiles
+	const ImageTileSource& Source(void) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		return _source;
+	}
+
+	/// Returns the width of the (non-edge) tiles
+	SizeType TileWidth(void) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		return MakeSizeType(_tile_width, std::nothrow);
+	}
+
+	/// Returns the height of the (non-edge) tiles
+	SizeType TileHeight(void) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		return MakeSizeType(_tile_height, std::nothrow);
+	}
+
+	/// Returns the depth of the (non-edge) tiles
+	SizeType TileDepth(void) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		return MakeSizeType(_tile_depth, std::nothrow);
+	}
+
+	/// Returns the number of tiles in a row of the specified @p level
+	GLsizei TilesX(GLint level) const
+	{
+		return _count(_source.LevelWidth(level), _tile_width);
+	}
+
+	/// Returns the number of tiles in a column of the specified @p level
+	GLsizei TilesY(GLint level) const
+	{
+		return _count(_source.LevelHeight(level), _tile_height);
+	}
+
+	/// Returns the number of tile slices of the specified @p level
+	GLsizei TilesZ(GLint level) const
+	{
+		return _count(_source.LevelDepth(level), _tile_depth);
+	}
+
+	/// Returns the tile at the specified tile coordinates
+	/** The tile is made by the source if it is not cached.
+	 *
+	 *  @pre tx < TilesX(level) && ty < TilesY(level) && tz < TilesZ(level)
+	 */
+	TilePtr Tile(GLint level, GLsizei tx, GLsizei ty, GLsizei tz = 0);
+
+	/// Returns true if the specified tile is cached
+	bool Contains(GLint level, GLsizei tx, GLsizei ty, GLsizei tz = 0) const;
+
+	/// Makes all the tiles intersecting the specified region in parallel
+	/** Only as many tiles as fit into the budget are kept.
+	 */
+	void Prefetch(
+		GLint level,
+		GLint xoffs,
+		GLint yoffs,
+		GLint zoffs,
+		SizeType width,
+		SizeType height,
+		SizeType depth,
+		unsigned max_threads = 0
+	);
+
+	/// Returns the total size of the cached tiles in bytes
+	std::size_t Size(void) const;
+
+	/// Returns the number of cached tiles
+	std::size_t TileCount(void) const;
+
+	/// Returns the budget of the cache in bytes
+	std::size_t Budget(void) const;
+
+	/// Changes the budget, dropping tiles if necessary
+	void Budget(std::size_t budget);
+
+	/// Drops all cached tiles
+	void Clear(void);
+};
+
+} // namespace images
+} // namespace oglplus
+
+#if !OGLPLUS_LINK_LIBRARY || defined(OGLPLUS_IMPLEMENTING_LIBRARY)
+#include <oglplus/images/tile_cache.ipp>
+#endif
+
+#endif // include guard
@@ -0,0 +1,160 @@
+/**
+ *  @file oglplus/images/tile_source.hpp
+ *  @brief Interface of sources making regions of (large) images on demand
+ *
+ *  @author Matus Chochlik
+ *
+ *  Copyright 2010-2015 Matus Chochlik. Distributed under the Boost
+ *  Software License, Version 1.0. (See accompanying file
+ *  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#pragma once
+#ifndef OGLPLUS_IMAGES_TILE_SOURCE_1107121519_HPP
+#define OGLPLUS_IMAGES_TILE_SOURCE_1107121519_HPP
+
+#include <oglplus/images/view.hpp>
+
+#include <cassert>
+
+namespace oglplus {
+namespace images {
+
+/// Interface of sources producing regions of (large) images on demand
+/** Unlike the image generators, which make the whole image in their
+ *  constructor, tile sources make only the requested regions (tiles)
+ *  of the image or of its mipmap levels, so the whole image never has to
+ *  fit into memory. Tile sources are usually used through ImageTileCache.
+ *
+ *  @ingroup image_load_gen
+ */
+class ImageTileSource
+{
+public:
+	virtual ~ImageTileSource(void) { }
+
+	/// Returns the width of the image (level 0)
+	virtual SizeType Width(void) const = 0;
+
+	/// Returns the height of the image (level 0)
+	virtual SizeType Height(void) const = 0;
+
+	/// Returns the depth of the image (level 0)
+	virtual SizeType Depth(void) const = 0;
+
+	/// Returns the number of channels
+	virtual SizeType Channels(void) const = 0;
+
+	/// Returns the pixel data type
+	virtual PixelDataType Type(void) const = 0;
+
+	/// Returns the pixel data format
+	virtual PixelDataFormat Format(void) const = 0;
+
+	/// Returns a suitable pixel data internal format
+	virtual PixelDataInternalFormat InternalFormat(void) const = 0;
+
+	/// Returns the number of mipmap levels the source can make
+	virtual GLint Levels(void) const
+	{
+		return 1;
+	}
+
+	/// Makes the specified region of the specified mipmap @p level
+	/** The returned image must have the requested dimensions and the type,
+	 *  format and number of channels of the source. This function may be
+	 *  called concurrently from multiple threads.
+	 *
+	 *  @pre level < Levels()
+	 *  @pre xoffs+width <= LevelWidth(level)
+	 *  @pre yoffs+height <= LevelHeight(level)
+	 *  @pre zoffs+depth <= LevelDepth(level)
+	 */
+	virtual Image MakeRegion(
+		GLint level,
+		GLint xoffs,
+		GLint yoffs,
+		GLint zoffs,
+		SizeType width,
+		SizeType height,
+		SizeType depth
+	) const = 0;
+
+	/// Returns the width of the specified mipmap @p level
+	SizeType LevelWidth(GLint level) const
+	{
+		return _level_size(Width(), level);
+	}
+
+	/// Returns the height of the specified mipmap @p level
+	SizeType LevelHeight(GLint level) const
+	{
+		return _level_size(Height(), level);
+	}
+
+	/// Returns the depth of the specified mipmap @p level
+	SizeType LevelDepth(GLint level) const
+	{
+		return _level_size(Depth(), level);
+	}
+private:
+	static SizeType _level_size(SizeType size, GLint level)
+	{
+		assert(level >= 0);
+		const GLsizei s = GLsizei(size) >> level;
+		return MakeSizeType((s > 0)?s:1, std::nothrow);
+	}
+};
+
+/// Tile source making regions of an existing image (view)
+/** This is useful for images which are not made on demand but are
+ *  (memory-mapped) in a texture container or a cache, so that they can
+ *  be streamed with the same code as the procedural tile sources.
+ *  The source has a single level, the pixel data type and format
+ *  of the @p image must be supported by images::Convert.
+ *
+ *  The viewed data must outlive the source.
+ *
+ *  @ingroup image_load_gen
+ */
+class ImageViewTileSource
+ : public ImageTileSource
+{
+private:
+	ImageView _image;
+public:
+	ImageViewTileSource(const ImageView& image)
+	 : _image(image)
+	{ }
+
+	SizeType Width(void) const { return _image.Width(); }
+	SizeType Height(void) const { return _image.Height(); }
+	SizeType Depth(void) const { return _image.Depth(); }
+	SizeType Channels(void) const { return _image.Channels(); }
+	PixelDataType Type(void) const { return _image.Type(); }
+	PixelDataFormat Format(void) const { return _image.Format(); }
+
+	PixelDataInternalFormat InternalFormat(void) const
+	{
+		return _image.InternalFormat();
+	}
+
+	Image MakeRegion(
+		GLint level,
+		GLint xoffs,
+		GLint yoffs,
+		GLint zoffs,
+		SizeType width,
+		SizeType height,
+		SizeType depth
+	) const;
+};
+
+} // namespace images
+} // namespace oglplus
+
+#if !OGLPLUS_LINK_LIBRARY || defined(OGLPLUS_IMPLEMENTING_LIBRARY)
+#include <oglplus/images/tile_source.ipp>
+#endif
+
+#endif // include guard
@@ -54,7 +54,7 @@ private:
 public:
 	typedef FilteredImage<T, N> Filtered;
 
-	TransformComponents(const Image& input, const Mat4d& matrix)
+	TransformComponents(const ImageView& input, const Mat4d& matrix)
 	 : Filtered(
 		input,
 		_filter(matrix),
@@ -97,7 +97,7 @@ private:
 		);
 	}
 public:
-	FlipImageAxes(const Image& image, int x_axis, int y_axis, int z_axis)
+	FlipImageAxes(const ImageView& image, int x_axis, int y_axis, int z_axis)
 	 : Filtered(
 		image,
 		typename Filtered::DefaultFilter(),
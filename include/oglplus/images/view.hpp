@@ -0,0 +1,452 @@
+/**
+ *  @file oglplus/images/view.hpp
+ *  @brief Non-owning view of (a region of) image data
+ *
+ *  @author Matus Chochlik
+ *
+ *  Copyright 2010-2015 Matus Chochlik. Distributed under the Boost
+ *  Software License, Version 1.0. (See accompanying file
+ *  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#pragma once
+#ifndef OGLPLUS_IMAGES_VIEW_1107121519_HPP
+#define OGLPLUS_IMAGES_VIEW_1107121519_HPP
+
+#include <oglplus/images/image.hpp>
+
+#include <cassert>
+#include <cstddef>
+
+namespace oglplus {
+namespace images {
+
+/// Non-owning view of a (sub-)region of image data
+/** An ImageView refers to pixel data owned by an @c Image or by some
+ *  other storage without copying it. Besides the dimensions, the number
+ *  of channels and the pixel data type, the view has a row stride and
+ *  a slice stride (both in bytes) so it can describe a rectangle or
+ *  a range of slices of a larger image, for example a single face or
+ *  a cell of an atlas.
+ *
+ *  The viewed data must outlive the view.
+ *
+ *  @ingroup image_load_gen
+ */
+class ImageView
+{
+private:
+	const unsigned char* _data;
+	GLsizei _width, _height, _depth, _channels;
+	std::size_t _comp_size;
+	std::ptrdiff_t _row_stride, _slice_stride;
+	PixelDataType _type;
+	PixelDataFormat _format;
+	PixelDataInternalFormat _internal;
+	typedef double (*_convert_func)(const void*);
+	_convert_func _convert;
+
+	template <typename T>
+	static
+	double _do_convert(const void* ptr)
+	OGLPLUS_NOEXCEPT(true)
+	{
+		assert(ptr != nullptr);
+		const double v = double(*static_cast<const T*>(ptr));
+		const double n = double(Image::_one(TypeTag<T>()));
+		return v / n;
+	}
+
+	static
+	double _do_convert_half(const void* ptr)
+	OGLPLUS_NOEXCEPT(true)
+	{
+		assert(ptr != nullptr);
+		return double(oglplus::aux::HalfToFloat(
+			*static_cast<const std::uint16_t*>(ptr)
+		));
+	}
+
+	static
+	_convert_func _get_convert(PixelDataType type)
+	OGLPLUS_NOEXCEPT(true);
+
+	void _init_strides(
+		std::ptrdiff_t row_stride,
+		std::ptrdiff_t slice_stride
+	)
+	{
+		_row_stride = (row_stride != 0)?
+			row_stride:
+			std::ptrdiff_t(_width*_channels*GLsizei(_comp_size));
+		_slice_stride = (slice_stride != 0)?
+			slice_stride:
+			_row_stride*_height;
+	}
+public:
+	/// Creates a view of the whole @p image
+	ImageView(const Image& image)
+	 : _data(static_cast<const unsigned char*>(image.RawData()))
+	 , _width(image.Width())
+	 , _height(image.Height())
+	 , _depth(image.Depth())
+	 , _channels(image.Channels())
+	 , _comp_size(image._storage.ElemSize())
+	 , _type(image.Type())
+	 , _format(image.Format())
+	 , _internal(image.InternalFormat())
+	 , _convert(_get_convert(image.Type()))
+	{
+		_init_strides(0, 0);
+	}
+
+	/// Creates a view of the specified region of the @p image
+	/**
+	 *  @pre xoffs+width <= image.Width()
+	 *  @pre yoffs+height <= image.Height()
+	 *  @pre zoffs+depth <= image.Depth()
+	 */
+	ImageView(
+		const Image& image,
+		GLsizei xoffs,
+		GLsizei yoffs,
+		GLsizei zoffs,
+		SizeType width,
+		SizeType height,
+		SizeType depth
+	)
+	{
+		*this = ImageView(image).Region(
+			xoffs, yoffs, zoffs,
+			width, height, depth
+		);
+	}
+
+	/// Creates a view of externally owned data
+	/** If @p row_stride or @p slice_stride is zero then the rows
+	 *  or the slices are assumed to be tightly packed.
+	 */
+	template <typename T>
+	ImageView(
+		SizeType width,
+		SizeType height,
+		SizeType depth,
+		SizeType channels,
+		const T* data,
+		PixelDataFormat format,
+		PixelDataInternalFormat internal,
+		std::ptrdiff_t row_stride = 0,
+		std::ptrdiff_t slice_stride = 0
+	): _data(reinterpret_cast<const unsigned char*>(data))
+	 , _width(width)
+	 , _height(height)
+	 , _depth(depth)
+	 , _channels(channels)
+	 , _comp_size(sizeof(T))
+	 , _type(PixelDataType(GetDataType<T>()))
+	 , _format(format)
+	 , _internal(internal)
+	 , _convert(&_do_convert<T>)
+	{
+		_init_strides(row_stride, slice_stride);
+	}
+
+	/// Creates a view of externally owned data of the specified @p type
+	/** If @p row_stride or @p slice_stride is zero then the rows
+	 *  or the slices are assumed to be tightly packed.
+	 *
+	 *  @pre ComponentSize(type) != 0
+	 */
+	ImageView(
+		SizeType width,
+		SizeType height,
+		SizeType depth,
+		SizeType channels,
+		const void* data,
+		PixelDataType type,
+		PixelDataFormat format,
+		PixelDataInternalFormat internal,
+		std::ptrdiff_t row_stride = 0,
+		std::ptrdiff_t slice_stride = 0
+	): _data(static_cast<const unsigned char*>(data))
+	 , _width(width)
+	 , _height(height)
+	 , _depth(depth)
+	 , _channels(channels)
+	 , _comp_size(ComponentSize(type))
+	 , _type(type)
+	 , _format(format)
+	 , _internal(internal)
+	 , _convert(_get_convert(type))
+	{
+		assert(_comp_size != 0);
+		_init_strides(row_stride, slice_stride);
+	}
+
+	/// Returns the size of a single component of the specified type
+	/** Returns 4 for the packed types storing a whole pixel in a 32-bit
+	 *  integer (see IsPacked) and zero for the other packed types.
+	 */
+	static
+	std::size_t ComponentSize(PixelDataType type)
+	OGLPLUS_NOEXCEPT(true);
+
+	/// Returns true if the type packs a whole pixel into a 32-bit integer
+	/** This is true for the @c UnsignedInt_10f_11f_11f_Rev,
+	 *  @c UnsignedInt_5_9_9_9_Rev and @c UnsignedInt_2_10_10_10_Rev types.
+	 *  Images with these types have a single channel (component) per pixel
+	 *  and a three or four-component format.
+	 */
+	static
+	bool IsPacked(PixelDataType type)
+	OGLPLUS_NOEXCEPT(true);
+
+	/// Returns a view of a region of this view
+	/**
+	 *  @pre xoffs+width <= Width()
+	 *  @pre yoffs+height <= Height()
+	 *  @pre zoffs+depth <= Depth()
+	 */
+	ImageView Region(
+		GLsizei xoffs,
+		GLsizei yoffs,
+		GLsizei zoffs,
+		SizeType width,
+		SizeType height,
+		SizeType depth
+	) const
+	{
+		assert(xoffs >= 0 && xoffs+GLsizei(width) <= _width);
+		assert(yoffs >= 0 && yoffs+GLsizei(height) <= _height);
+		assert(zoffs >= 0 && zoffs+GLsizei(depth) <= _depth);
+
+		ImageView result(*this);
+		result._data = static_cast<const unsigned char*>(
+			RawPixel(xoffs, yoffs, zoffs)
+		);
+		result._width = width;
+		result._height = height;
+		result._depth = depth;
+		return result;
+	}
+
+	/// Returns a view of the specified slice of this view
+	ImageView Slice(GLsizei zoffs) const
+	{
+		return Region(0, 0, zoffs, Width(), Height(), 1);
+	}
+
+	/// Returns the width of the view
+	SizeType Width(void) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		return MakeSizeType(_width, std::nothrow);
+	}
+
+	/// Returns the height of the view
+	SizeType Height(void) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		return MakeSizeType(_height, std::nothrow);
+	}
+
+	/// Returns the depth of the view
+	SizeType Depth(void) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		return MakeSizeType(_depth, std::nothrow);
+	}
+
+	/// Returns the number of channels
+	SizeType Channels(void) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		return MakeSizeType(_channels, std::nothrow);
+	}
+
+	/// Returns the pixel data type
+	PixelDataType Type(void) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		return _type;
+	}
+
+	/// Return the pixel data format
+	PixelDataFormat Format(void) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		return _format;
+	}
+
+	/// Return a suitable pixel data internal format
+	PixelDataInternalFormat InternalFormat(void) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		return _internal;
+	}
+
+	/// Returns the size of a single pixel component in bytes
+	std::size_t ComponentSize(void) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		return _comp_size;
+	}
+
+	/// Returns the size of a single pixel in bytes
+	std::size_t PixelSize(void) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		return _comp_size*std::size_t(_channels);
+	}
+
+	/// Returns the distance between the starts of two rows in bytes
+	std::ptrdiff_t RowStride(void) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		return _row_stride;
+	}
+
+	/// Returns the distance between the starts of two slices in bytes
+	std::ptrdiff_t SliceStride(void) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		return _slice_stride;
+	}
+
+	/// Returns true if the viewed rows and slices are tightly packed
+	bool IsContiguous(void) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		return	(_row_stride == std::ptrdiff_t(PixelSize())*_width) &&
+			((_depth <= 1) || (_slice_stride == _row_stride*_height));
+	}
+
+	/// Returns true if the strides are whole multiples of pixels and rows
+	/** This is required when the view is passed directly to GL
+	 *  (with the UNPACK_ROW_LENGTH and UNPACK_IMAGE_HEIGHT pixel
+	 *  storage parameters).
+	 */
+	bool HasPixelStrides(void) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		const std::ptrdiff_t ps = std::ptrdiff_t(PixelSize());
+		return	(_row_stride > 0) && (_row_stride % ps == 0) &&
+			(_slice_stride % _row_stride == 0);
+	}
+
+	/// Returns the row stride in pixels
+	/**
+	 *  @pre HasPixelStrides()
+	 */
+	GLint RowLength(void) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		assert(HasPixelStrides());
+		return GLint(_row_stride / std::ptrdiff_t(PixelSize()));
+	}
+
+	/// Returns the slice stride in rows
+	/**
+	 *  @pre HasPixelStrides()
+	 */
+	GLint ImageHeight(void) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		assert(HasPixelStrides());
+		return GLint(_slice_stride / _row_stride);
+	}
+
+	/// Returns an untyped pointer to the first viewed pixel
+	const void* RawData(void) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		return _data;
+	}
+
+	/// Returns a pointer to the first viewed pixel
+	template <typename T>
+	const T* Data(void) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		assert(_type == PixelDataType(GetDataType<T>()));
+		return reinterpret_cast<const T*>(_data);
+	}
+
+	/// Returns an untyped pointer to the pixel at the specified coordinates
+	const void* RawPixel(
+		GLsizei xpos,
+		GLsizei ypos,
+		GLsizei zpos
+	) const
+	OGLPLUS_NOEXCEPT(true)
+	{
+		return	_data+
+			zpos*_slice_stride+
+			ypos*_row_stride+
+			std::ptrdiff_t(xpos)*std::ptrdiff_t(PixelSize());
+	}
+
+	/// Returns the pixel at the specified coordinates
+	Vector<double, 4> Pixel(
+		SizeType width,
+		SizeType height,
+		SizeType depth
+	) const
+	{
+		assert(width < Width());
+		assert(height < Height());
+		assert(depth < Depth());
+		assert(_convert);
+
+		const unsigned char* p = static_cast<const unsigned char*>(
+			RawPixel(width, height, depth)
+		);
+		return Vector<double, 4>(
+			_channels>0?_convert(p+0*_comp_size):0.0,
+			_channels>1?_convert(p+1*_comp_size):0.0,
+			_channels>2?_convert(p+2*_comp_size):0.0,
+			_channels>3?_convert(p+3*_comp_size):0.0
+		);
+	}
+
+	/// Returns the component of the pixel at the specified coordinates
+	double Component(
+		SizeType width,
+		SizeType height,
+		SizeType depth,
+		SizeType component
+	) const
+	{
+		if(component >= Channels()) return 0.0;
+		assert(_convert);
+		const unsigned char* p = static_cast<const unsigned char*>(
+			RawPixel(width, height, depth)
+		);
+		return _convert(p+std::size_t(component)*_comp_size);
+	}
+
+	/// Returns the component of the pixel at the specified coordinates
+	template <typename T>
+	T ComponentAs(
+		SizeType width,
+		SizeType height,
+		SizeType depth,
+		SizeType component
+	) const
+	{
+		assert(_type == PixelDataType(GetDataType<T>()));
+		if(component >= Channels()) return T(0);
+		return static_cast<const T*>(
+			RawPixel(width, height, depth)
+		)[GLsizei(component)];
+	}
+};
+
+} // namespace images
+} // namespace oglplus
+
+#if !OGLPLUS_LINK_LIBRARY || defined(OGLPLUS_IMPLEMENTING_LIBRARY)
+#include <oglplus/images/view.ipp>
+#endif
+
+#endif // include guard
@@ -14,6 +14,7 @@
 #define OGLPLUS_IMAGES_VORONOI_1107121519_HPP
 
 #include <oglplus/images/image.hpp>
+#include <oglplus/images/view.hpp>
 
 namespace oglplus {
 namespace images {
@@ -26,7 +27,7 @@ public:
 		SizeType cell_w,
 		SizeType cell_h,
 		SizeType cell_d,
-		const Image& input
+		const ImageView& input
 	);
 };
 
@@ -38,7 +39,7 @@ public:
 		SizeType cell_w,
 		SizeType cell_h,
 		SizeType cell_d,
-		const Image& input
+		const ImageView& input
 	);
 };
 
@@ -14,6 +14,7 @@
 #define OGLPLUS_IMAGES_WORLEY_1107121519_HPP
 
 #include <oglplus/images/image.hpp>
+#include <oglplus/images/view.hpp>
 #include <functional>
 
 namespace oglplus {
@@ -27,14 +28,14 @@ public:
 		SizeType cell_w,
 		SizeType cell_h,
 		SizeType cell_d,
-		const Image& input
+		const ImageView& input
 	);
 
 	WorleyCells(
 		SizeType cell_w,
 		SizeType cell_h,
 		SizeType cell_d,
-		const Image& input,
+		const ImageView& input,
 		std::function<double(const std::vector<double>&)> calc_val,
 		unsigned order
 	);
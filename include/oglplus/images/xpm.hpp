@@ -16,12 +16,16 @@
 #include <oglplus/images/image.hpp>
 
 #include <istream>
+#include <cstddef>
 
 namespace oglplus {
 namespace images {
 
 /// Loader of images in the XPM (X Pix Map) format
-/**
+/** Both the XPM2 images and the XPM3D volumes (having the depth
+ *  in the dimensions line between the height and the number of colors)
+ *  are supported. The color codes can have up to 8 characters.
+ *
  *  @ingroup image_load_gen
  */
 class XPMImage
@@ -34,6 +38,14 @@ public:
 		bool y_is_up = true,
 		bool x_is_right = true
 	);
+
+	/// Load the image from the XPM @p data of the specified @p size
+	XPMImage(
+		const char* data,
+		std::size_t size,
+		bool y_is_up = true,
+		bool x_is_right = true
+	);
 };
 
 } // images
@@ -0,0 +1,263 @@
+/**
+ *  @file oglplus/opt/resource_loader.hpp
+ *  @brief Asynchronous loading of resource files and other data
+ *
+ *  @author Matus Chochlik
+ *
+ *  Copyright 2010-2015 Matus Chochlik. Distributed under the Boost
+ *  Software License, Version 1.0. (See accompanying file
+ *  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#pragma once
+#ifndef OGLPLUS_OPT_RESOURCE_LOADER_1107121519_HPP
+#define OGLPLUS_OPT_RESOURCE_LOADER_1107121519_HPP
+
+#include <oglplus/config/basic.hpp>
+#include <oglplus/config/compiler.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <queue>
+#include <string>
+#include <typeinfo>
+#include <unordered_map>
+#include <vector>
+
+#if !OGLPLUS_NO_THREADS
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
+namespace oglplus {
+
+/// Loads resources (files, images, etc.) asynchronously in a thread pool
+/** The resources are requested by a name and a load function, which is
+ *  called by one of the worker threads, and the result is returned through
+ *  a @c std::shared_future. Requests with a higher priority are started
+ *  first, requests with the same priority in the order in which they were
+ *  made. Concurrent requests for the same name (and result type) are
+ *  merged, i.e. the load function is called only once, all of them get
+ *  the same future and the priority is raised to the highest one requested.
+ *  Exceptions thrown by the load function are re-thrown by the future.
+ *
+ *  The optional completion callbacks are not called by the worker threads,
+ *  but by the thread calling Dispatch, typically the thread with the GL
+ *  context, which can then upload the loaded data to textures or buffers.
+ *
+ *  When threads are disabled (@c OGLPLUS_NO_THREADS) the resources are
+ *  loaded synchronously when they are requested, the callbacks are still
+ *  called only from Dispatch.
+ *
+ *  @code
+ *  ResourceLoader loader;
+ *  // the visible assets first
+ *  auto wall = images::LoadTextureAsync(loader, "wall", 10);
+ *  images::LoadTextureAsync(loader, "sky", 0,
+ *      [&](const std::shared_future<images::Image>& image)
+ *      {
+ *          Texture::Image2D(TextureTarget::_2D, image.get());
+ *      }
+ *  );
+ *  // in the rendering loop
+ *  loader.Dispatch();
+ *  @endcode
+ *
+ *  @ingroup utility_classes
+ */
+class ResourceLoader
+{
+private:
+	typedef std::function<void(const std::shared_ptr<void>&)> _callback;
+
+	// the type-erased state of a request
+	struct _task
+	{
+		std::string key;
+		int priority;
+		bool started;
+		std::function<void(void)> run;
+		std::shared_ptr<void> future;
+		std::vector<_callback> callbacks;
+	};
+	typedef std::shared_ptr<_task> _task_ptr;
+
+	struct _entry
+	{
+		int priority;
+		std::uint64_t sequence;
+		_task_ptr task;
+	};
+
+	struct _entry_less
+	{
+		bool operator()(const _entry& a, const _entry& b) const
+		{
+			if(a.priority != b.priority)
+			{
+				return a.priority < b.priority;
+			}
+			return a.sequence > b.sequence;
+		}
+	};
+
+	std::priority_queue<
+		_entry,
+		std::vector<_entry>,
+		_entry_less
+	> _queue;
+	std::unordered_map<std::string, _task_ptr> _tasks;
+	std::vector<std::function<void(void)>> _completed;
+	std::uint64_t _sequence;
+#if !OGLPLUS_NO_THREADS
+	bool _stop;
+	mutable std::mutex _mutex;
+	std::condition_variable _wake;
+	std::condition_variable _idle;
+	std::vector<std::thread> _threads;
+
+	void _work(void);
+	void _stop_threads(void);
+
+	// stops the started workers if the constructor does not finish
+	struct _stop_on_scope_exit
+	{
+		ResourceLoader* loader;
+
+		~_stop_on_scope_exit(void)
+		{
+			if(loader) loader->_stop_threads();
+		}
+	};
+#endif
+
+	void _finish(const _task_ptr& task);
+
+	_task_ptr _submit(
+		const std::string& key,
+		int priority,
+		const std::function<_task_ptr(void)>& make,
+		const _callback& callback
+	);
+
+	template <typename T, typename Load>
+	std::shared_future<T> _request(
+		const std::string& name,
+		int priority,
+		Load load,
+		const _callback& callback
+	)
+	{
+		auto make = [&](void) -> _task_ptr
+		{
+			auto job = std::make_shared<std::packaged_task<T(void)>>(
+				load
+			);
+			_task_ptr task = std::make_shared<_task>();
+			task->run = [job](void) { (*job)(); };
+			task->future = std::make_shared<std::shared_future<T>>(
+				job->get_future().share()
+			);
+			return task;
+		};
+		_task_ptr task = _submit(
+			std::string(typeid(T).name())+':'+name,
+			priority,
+			make,
+			callback
+		);
+		return *std::static_pointer_cast<std::shared_future<T>>(
+			task->future
+		);
+	}
+public:
+	/// Starts a loader with up to @p max_threads worker threads
+	/** Zero means as many threads as there are hardware threads.
+	 */
+	explicit
+	ResourceLoader(unsigned max_threads = 0);
+
+	ResourceLoader(const ResourceLoader&) = delete;
+
+	/// Stops the worker threads
+	/** The requests which were not started yet are dropped and their
+	 *  futures get a @c broken_promise error, the running ones are finished.
+	 */
+	~ResourceLoader(void);
+
+	/// Requests a resource made by @p load, a function returning a @c T
+	/** Requests with the same @p name and type @c T made while the first
+	 *  one is queued or running share its result.
+	 */
+	template <typename T, typename Load>
+	std::shared_future<T> Request(
+		const std::string& name,
+		int priority,
+		Load load
+	)
+	{
+		return _request<T>(name, priority, load, _callback());
+	}
+
+	/// Requests a resource and calls @p done from Dispatch when it is ready
+	/** The @p done function is called with the @c std::shared_future<T>
+	 *  of the result, also when the loading failed.
+	 */
+	template <typename T, typename Load, typename Done>
+	std::shared_future<T> Request(
+		const std::string& name,
+		int priority,
+		Load load,
+		Done done
+	)
+	{
+		return _request<T>(
+			name,
+			priority,
+			load,
+			[done](const std::shared_ptr<void>& future)
+			{
+				done(*std::static_pointer_cast<
+					std::shared_future<T>
+				>(future));
+			}
+		);
+	}
+
+	/// Requests the contents of a resource file
+	/** The resource is taken from the packs added to the global
+	 *  ResourceIndex if it is found there, otherwise the file is found
+	 *  in the same way as by ResourceFile.
+	 */
+	std::shared_future<std::vector<char>> RequestFile(
+		const std::string& category,
+		const std::string& name,
+		const char* ext,
+		int priority = 0
+	);
+
+	/// Calls the completion callbacks of the finished requests
+	/** At most @p max_count callbacks are called (zero means all of them),
+	 *  the function returns the number of called callbacks.
+	 */
+	std::size_t Dispatch(std::size_t max_count = 0);
+
+	/// Returns the number of queued and running requests
+	std::size_t PendingCount(void) const;
+
+	/// Waits until all requests are finished
+	/** The completion callbacks are not called, use Dispatch.
+	 */
+	void Wait(void);
+};
+
+} // namespace oglplus
+
+#if !OGLPLUS_LINK_LIBRARY || defined(OGLPLUS_IMPLEMENTING_LIBRARY)
+# include <oglplus/opt/resource_loader.ipp>
+#endif
+
+#endif // include guard
@@ -16,8 +16,18 @@
 #include <oglplus/config/basic.hpp>
 #include <oglplus/opt/application.hpp>
 #include <oglplus/utils/filesystem.hpp>
+#include <oglplus/detail/aligned_pod_array.hpp>
 
+# include <cstdint>
 # include <fstream>
+# include <memory>
+# include <string>
+# include <unordered_map>
+# include <vector>
+
+#if !OGLPLUS_NO_THREADS
+# include <mutex>
+#endif
 
 namespace oglplus {
 namespace aux {
@@ -31,6 +41,14 @@ std::size_t FindResourceFile(
 
 } // namespace aux
 
+std::size_t FindResourceFile(
+	std::string& path,
+	const std::string& category,
+	const std::string& name,
+	const char** exts,
+	std::size_t nexts
+);
+
 std::size_t FindResourceFile(
 	std::ifstream& file,
 	const std::string& category,
@@ -68,6 +86,151 @@ public:
 	);
 };
 
+/// Archive of many resource files in a single memory-mapped file
+/** The resources are identified by their path relative to the resource
+ *  root directory, i.e. @c category/name.ext, with @c / as the separator
+ *  on all systems. A pack is made by the Write function and its
+ *  resources can be found by ResourceIndex::FindData and are used by
+ *  ResourceLoader::RequestFile.
+ *
+ *  @ingroup utility_classes
+ */
+class ResourcePack
+{
+private:
+	struct _entry
+	{
+		std::size_t offset;
+		std::size_t size;
+	};
+	aux::AlignedPODArray _data;
+	std::unordered_map<std::string, _entry> _entries;
+public:
+	/// Maps the pack file at the specified @p path
+	/** Throws @c std::runtime_error if the file cannot be read
+	 *  or is not a valid pack file.
+	 */
+	explicit
+	ResourcePack(const std::string& path);
+
+	/// Finds the resource with the specified relative @p path
+	/** Returns true and sets the @p data and @p size if found.
+	 */
+	bool Find(
+		const std::string& path,
+		const char*& data,
+		std::size_t& size
+	) const;
+
+	/// Returns the number of resources in the pack
+	std::size_t Count(void) const
+	{
+		return _entries.size();
+	}
+
+	/// Writes the listed @p files from the @p root directory into a pack
+	/** The @p files are relative to the @p root and use @c / as the
+	 *  separator (for example a list from ResourceIndex::ListFiles).
+	 */
+	static void Write(
+		const std::string& path,
+		const std::string& root,
+		const std::vector<std::string>& files
+	);
+};
+
+/// Index of the resource files used by FindResourceFile
+/** Instead of probing the file system with every combination of the
+ *  resource root directories (the application directory and up to four
+ *  of its parents) and file extensions, the files of a category are
+ *  listed once, when the category is looked up for the first time.
+ *  If a category directory contains a @c resources.manifest file,
+ *  the files listed in it (one relative path per line) are used instead
+ *  of scanning the directory. Lookups of files which are not in the index
+ *  (or which were removed after the index was built) fall back to probing
+ *  the file system, so files created after the index was built are found
+ *  too.
+ *
+ *  The resources in the added packs are found by FindData.
+ *
+ *  @ingroup utility_classes
+ */
+class ResourceIndex
+{
+private:
+	struct _file
+	{
+		std::size_t root;
+		std::string path;
+	};
+	typedef std::unordered_map<std::string, _file> _category;
+	std::string _app_path;
+	std::unordered_map<std::string, _category> _categories;
+	std::vector<std::shared_ptr<const ResourcePack>> _packs;
+#if !OGLPLUS_NO_THREADS
+	mutable std::mutex _mutex;
+#endif
+
+	static std::vector<std::string> _roots(void);
+	const _category& _get(const std::string& category);
+public:
+	/// Returns the index used by FindResourceFile
+	static ResourceIndex& Global(void);
+
+	/// Returns the name of the category manifest files
+	static const char* ManifestName(void)
+	{
+		return "resources.manifest";
+	}
+
+	/// Finds the first of the files @c category/name+exts[i] in the index
+	/** Returns the index of the found extension and sets the @p path
+	 *  of the found file or returns @p nexts if none of the files
+	 *  is indexed. Like FindResourceFile the files in the root directories
+	 *  closer to the application are preferred, then the extensions
+	 *  in the specified order.
+	 */
+	std::size_t Find(
+		std::string& path,
+		const std::string& category,
+		const std::string& name,
+		const char** exts,
+		std::size_t nexts
+	);
+
+	/// Finds the first of the resources @c category/name+exts[i] in the packs
+	/** Returns the index of the found extension and sets the @p data
+	 *  and @p size, or returns @p nexts if none of them is found.
+	 */
+	std::size_t FindData(
+		const char*& data,
+		std::size_t& size,
+		const std::string& category,
+		const std::string& name,
+		const char** exts,
+		std::size_t nexts
+	) const;
+
+	/// Maps the pack file at the specified @p path and adds it to the index
+	void AddPack(const std::string& path);
+
+	/// Drops the indices of the categories, they are built again when used
+	void Refresh(void);
+
+	/// Lists the files in the @p directory and in its subdirectories
+	/** The paths are relative to the @p directory and use @c / as the
+	 *  separator. Symbolic links to files are listed, but the links
+	 *  to directories are not followed.
+	 */
+	static void ListFiles(
+		const std::string& directory,
+		std::vector<std::string>& files
+	);
+
+	/// Writes the manifest listing the files in the @p category_dir
+	static void WriteManifest(const std::string& category_dir);
+};
+
 } // namespace oglplus
 
 #if !OGLPLUS_LINK_LIBRARY || defined(OGLPLUS_IMPLEMENTING_LIBRARY)
@@ -21,6 +21,9 @@
 #include <oglplus/utils/filesystem.hpp>
 #include <oglplus/opt/resources.hpp>
 
+#include <algorithm>
+#include <vector>
+
 namespace oglplus {
 namespace text {
 
@@ -51,6 +54,8 @@ private:
 	const GLuint _initial_frame;
 	BitmapGlyphPageStorage _page_storage;
 
+	void _load_pages(const std::vector<GLuint>& pages);
+
 	template <typename PageGetter, typename Element>
 	void _do_load_pages(
 		PageGetter get_page,
@@ -60,6 +65,8 @@ private:
 	{
 		_page_storage.Bind();
 		// go through the list of code-points
+		// and collect the pages which are not active
+		std::vector<GLuint> missing;
 		for(GLsizei i=0; i!=size; ++i)
 		{
 			// get the page number for the glyph
@@ -67,20 +74,21 @@ private:
 			// check if the page is active
 			if(!_pager.UsePage(page))
 			{
-				// if not let the pager find
-				// a frame for the new page
-				auto frame = _pager.FindFrame();
-				// load the bitmap image
-				_page_storage.LoadPage(
-					frame,
-					_load_page_bitmap(page),
-					_load_page_metric(page)
+				auto pos = std::find(
+					missing.begin(),
+					missing.end(),
+					page
 				);
-				// tell the pages that the page
-				// is successfully loaded in the frame
-				_pager.SwapPageIn(frame, page);
+				if(pos == missing.end())
+				{
+					missing.push_back(page);
+				}
 			}
 		}
+		if(!missing.empty())
+		{
+			_load_pages(missing);
+		}
 	}
 
 	struct _page_to_page
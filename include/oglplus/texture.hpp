@@ -1136,6 +1136,44 @@ public:
 		GLint border = 0
 	);
 
+	/// Specifies a three dimensional texture image from an image view
+	/** The rows and slices of the view do not have to be contiguous,
+	 *  the UNPACK_ROW_LENGTH, UNPACK_IMAGE_HEIGHT and UNPACK_ALIGNMENT
+	 *  pixel storage parameters are adjusted for the duration of the call.
+	 *
+	 *  @throws std::runtime_error if the view is not contiguous
+	 *  and !image.HasPixelStrides()
+	 *
+	 *  @glsymbols
+	 *  @glfunref{TexImage3D}
+	 *  @glfunref{PixelStore}
+	 */
+	static void Image3D(
+		Target target,
+		const images::ImageView& image,
+		GLint level = 0,
+		GLint border = 0
+	);
+
+	/// Specifies all images of a 3D or array texture from a container
+	/** The storage of each mipmap level is specified first and then
+	 *  the mapped data of each layer (and of each face of cube map arrays,
+	 *  at the depth layer*6+face) of the @p container is passed directly
+	 *  to SubImage3D or, if it is compressed, to CompressedSubImage3D.
+	 *  The TEXTURE_MAX_LEVEL parameter is set to the last level.
+	 *
+	 *  @glsymbols
+	 *  @glfunref{TexImage3D}
+	 *  @glfunref{TexSubImage3D}
+	 *  @glfunref{CompressedTexImage3D}
+	 *  @glfunref{CompressedTexSubImage3D}
+	 *  @glfunref{TexParameter}
+	 */
+	static void Image3D(
+		Target target,
+		const images::TextureContainer& container
+	);
+
 	/// Specifies a three dimensional texture sub image
 	/**
 	 *  @glsymbols
@@ -1191,6 +1229,65 @@ public:
 		GLint level = 0
 	);
 
+	/// Specifies a three dimensional texture sub image from an image view
+	/**
+	 *  @throws std::runtime_error if the view is not contiguous
+	 *  and !image.HasPixelStrides()
+	 *
+	 *  @glsymbols
+	 *  @glfunref{TexSubImage3D}
+	 *  @glfunref{PixelStore}
+	 */
+	static void SubImage3D(
+		Target target,
+		const images::ImageView& image,
+		GLint xoffs,
+		GLint yoffs,
+		GLint zoffs,
+		GLint level = 0
+	);
+
+	/// Streams a region of an image made by tiles into a 3D texture
+	/** The tiles of the specified @p level of the image, which intersect
+	 *  the region, are obtained from the @p cache (a row of tiles at a time,
+	 *  the missing tiles are made in parallel) and their parts inside
+	 *  of the region are uploaded to the same position in the texture.
+	 *  The texture storage must be already specified.
+	 *
+	 *  @glsymbols
+	 *  @glfunref{TexSubImage3D}
+	 *  @glfunref{PixelStore}
+	 */
+	static void SubImage3D(
+		Target target,
+		images::ImageTileCache& cache,
+		GLint level,
+		GLint xoffs,
+		GLint yoffs,
+		GLint zoffs,
+		SizeType width,
+		SizeType height,
+		SizeType depth
+	);
+
+	/// Uploads the occupied bricks of a sparse image into a 3D texture
+	/** The bricks are uploaded to the texture at the specified offsets,
+	 *  the regions of the empty bricks are not changed (they should be
+	 *  cleared in advance). The texture storage must be already specified.
+	 *
+	 *  @glsymbols
+	 *  @glfunref{TexSubImage3D}
+	 *  @glfunref{PixelStore}
+	 */
+	static void SubImage3D(
+		Target target,
+		const images::SparseImage& image,
+		GLint xoffs,
+		GLint yoffs,
+		GLint zoffs,
+		GLint level = 0
+	);
+
 	/// Specifies a two dimensional texture image
 	/**
 	 *  @glsymbols
@@ -1240,6 +1337,77 @@ public:
 		GLint border = 0
 	);
 
+	/// Specifies a two dimensional texture image from an image view
+	/** The rows of the view do not have to be contiguous, the
+	 *  UNPACK_ROW_LENGTH and UNPACK_ALIGNMENT pixel storage parameters
+	 *  are adjusted for the duration of the call.
+	 *
+	 *  @throws std::runtime_error if the view is not contiguous
+	 *  and !image.HasPixelStrides()
+	 *
+	 *  @glsymbols
+	 *  @glfunref{TexImage2D}
+	 *  @glfunref{PixelStore}
+	 */
+	static void Image2D(
+		Target target,
+		const images::ImageView& image,
+		GLint level = 0,
+		GLint border = 0
+	);
+
+	/// Specifies all levels of a two dimensional texture from a mipmap chain
+	/** The levels of the chain are specified with Image2D and the
+	 *  TEXTURE_MAX_LEVEL parameter is set to the last level of the chain,
+	 *  so there is no need to call GenerateMipmap.
+	 *
+	 *  @glsymbols
+	 *  @glfunref{TexImage2D}
+	 *  @glfunref{TexParameter}
+	 *  @gldefref{TEXTURE_MAX_LEVEL}
+	 */
+	static void Image2D(
+		Target target,
+		const images::MipmapChain& chain,
+		GLint border = 0
+	);
+
+	/// Specifies all levels of a cube map from a prefiltered cube map chain
+	/** The faces of each level of the chain are specified with ImageCM
+	 *  and the TEXTURE_MAX_LEVEL parameter is set to the last level.
+	 *
+	 *  @pre target == Target::CubeMap
+	 *
+	 *  @glsymbols
+	 *  @glfunref{TexImage2D}
+	 *  @glfunref{TexParameter}
+	 *  @gldefref{TEXTURE_MAX_LEVEL}
+	 */
+	static void Image2D(
+		Target target,
+		const images::PrefilteredCubeMap& cube_map
+	);
+
+	/// Specifies all images of a two dimensional texture from a container
+	/** The mapped data of each mipmap level (and of each face of cube
+	 *  maps) of the @p container is passed directly to Image2D or, if
+	 *  it is compressed, to CompressedImage2D. For cube maps the @p target
+	 *  must be @c TextureTarget::CubeMap. The TEXTURE_MAX_LEVEL parameter
+	 *  is set to the last level of the container.
+	 *
+	 *  @pre !container.IsArray() && (container.Depth() == 1)
+	 *
+	 *  @glsymbols
+	 *  @glfunref{TexImage2D}
+	 *  @glfunref{CompressedTexImage2D}
+	 *  @glfunref{TexParameter}
+	 *  @gldefref{TEXTURE_MAX_LEVEL}
+	 */
+	static void Image2D(
+		Target target,
+		const images::TextureContainer& container
+	);
+
 	/// Specifies the image of the specified cube-map face
 	/**
 	 *  @pre (face >= 0) && (face <= 5)
@@ -1307,6 +1475,23 @@ public:
 		GLint border = 0
 	);
 
+	/// Specifies the image of the specified cube-map face from a view
+	/**
+	 *  @pre (face >= 0) && (face <= 5)
+	 *  @throws std::runtime_error if the view is not contiguous
+	 *  and !image.HasPixelStrides()
+	 *
+	 *  @glsymbols
+	 *  @glfunref{TexImage2D}
+	 *  @glfunref{PixelStore}
+	 */
+	static void ImageCM(
+		GLuint face,
+		const images::ImageView& image,
+		GLint level = 0,
+		GLint border = 0
+	);
+
 	/// Specifies a two dimensional texture sub image
 	/**
 	 *  @glsymbols
@@ -1357,6 +1542,41 @@ public:
 		GLint level = 0
 	);
 
+	/// Specifies a two dimensional texture sub image from an image view
+	/**
+	 *  @throws std::runtime_error if the view is not contiguous
+	 *  and !image.HasPixelStrides()
+	 *
+	 *  @glsymbols
+	 *  @glfunref{TexSubImage2D}
+	 *  @glfunref{PixelStore}
+	 */
+	static void SubImage2D(
+		Target target,
+		const images::ImageView& image,
+		GLint xoffs,
+		GLint yoffs,
+		GLint level = 0
+	);
+
+	/// Streams a region of an image made by tiles into a 2D texture
+	/** Like the SubImage3D overload taking an images::ImageTileCache,
+	 *  but for two dimensional images (the first slice of the image).
+	 *
+	 *  @glsymbols
+	 *  @glfunref{TexSubImage2D}
+	 *  @glfunref{PixelStore}
+	 */
+	static void SubImage2D(
+		Target target,
+		images::ImageTileCache& cache,
+		GLint level,
+		GLint xoffs,
+		GLint yoffs,
+		SizeType width,
+		SizeType height
+	);
+
 #if OGLPLUS_DOCUMENTATION_ONLY || GL_VERSION_3_0
 	/// Specifies a one dimensional texture image
 	/**
@@ -1723,6 +1943,18 @@ public:
 		);
 	}
 
+	/// Specifies a two dimensional compressed texture image
+	/**
+	 *  @glsymbols
+	 *  @glfunref{CompressedTexImage2D}
+	 */
+	static void CompressedImage2D(
+		Target target,
+		const images::CompressedImage& image,
+		GLint level = 0,
+		GLint border = 0
+	);
+
 #if OGLPLUS_DOCUMENTATION_ONLY || GL_VERSION_3_0
 	/// Specifies a one dimensional compressed texture image
 	/**
@@ -19,15 +19,27 @@
 #include "implement.ipp"
 
 #include <oglplus/images/image.hpp>
+#include <oglplus/images/view.hpp>
 #include <oglplus/images/brushed_metal.hpp>
 #include <oglplus/images/checker.hpp>
+#include <oglplus/images/compressed.hpp>
+#include <oglplus/images/convert.hpp>
+#include <oglplus/images/convolution.hpp>
+#include <oglplus/images/distance_field.hpp>
 #include <oglplus/images/metaballs.hpp>
+#include <oglplus/images/mipmap.hpp>
+#include <oglplus/images/cube_map.hpp>
 #include <oglplus/images/cloud.hpp>
 #include <oglplus/images/squares.hpp>
 #include <oglplus/images/sphere_bmap.hpp>
 #include <oglplus/images/normal_map.hpp>
+#include <oglplus/images/noise.hpp>
 #include <oglplus/images/random.hpp>
 #include <oglplus/images/sort_nw.hpp>
 #include <oglplus/images/voronoi.hpp>
 #include <oglplus/images/worley.hpp>
+#include <oglplus/images/tile_source.hpp>
+#include <oglplus/images/tile_cache.hpp>
+#include <oglplus/images/sparse.hpp>
+#include <oglplus/images/atlas.hpp>
 #include "epilogue.ipp"
@@ -16,12 +16,17 @@
 #include <oglplus/data_type.hpp>
 #include <oglplus/pixel_data.hpp>
 #include <oglplus/images/image.hpp>
+#include <oglplus/images/view.hpp>
+// the ImageCache is implemented in images_base.cpp with the cube maps
+#include <oglplus/images/cache.hpp>
 
 #include "implement.ipp"
 
 #include <oglplus/images/xpm.hpp>
+#include <oglplus/images/container.hpp>
 #if OGLPLUS_PNG_FOUND
 #include <oglplus/images/png.hpp>
+#include <oglplus/images/save_png.hpp>
 #endif
 #include <oglplus/images/load.hpp>
 #include "epilogue.ipp"
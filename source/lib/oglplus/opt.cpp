@@ -10,6 +10,12 @@
  */
 
 #include "prologue.ipp"
+// aligned_pod_array.ipp is compiled into images_base.cpp (through
+// image.hpp). resources.hpp includes the header too, so it must stay
+// above implement.ipp, otherwise opt.cpp would define the functions
+// of AlignedPODArray again
+#include <oglplus/detail/aligned_pod_array.hpp>
 #include "implement.ipp"
 #include <oglplus/opt/resources.hpp>
+#include <oglplus/opt/resource_loader.hpp>
 #include "epilogue.ipp"
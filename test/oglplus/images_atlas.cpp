@@ -0,0 +1,227 @@
+/**
+ *  .file test/oglplus/images_atlas.cpp
+ *  .brief Test case for the ImageAtlas class.
+ *
+ *  .author Matus Chochlik
+ *
+ *  Copyright 2011-2015 Matus Chochlik. Distributed under the Boost
+ *  Software License, Version 1.0. (See accompanying file
+ *  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE OGLPLUS_images_Atlas
+#include <boost/test/unit_test.hpp>
+
+#include <oglplus/gl.hpp>
+#include <oglplus/images/atlas.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(images_Atlas)
+
+typedef std::vector<GLubyte> texels;
+
+static texels make_texels(GLsizei w, GLsizei h, std::size_t id)
+{
+	texels data(std::size_t(w*h*2));
+	for(std::size_t i=0; i!=data.size(); ++i)
+	{
+		data[i] = GLubyte((i*31+id*97+1)%253);
+	}
+	return data;
+}
+
+static oglplus::images::ImageView make_view(
+	const texels& data,
+	GLsizei w,
+	GLsizei h
+)
+{
+	using namespace oglplus;
+	return images::ImageView(
+		w, h, 1, 2,
+		data.data(),
+		PixelDataFormat::RG,
+		PixelDataInternalFormat::RG8
+	);
+}
+
+static oglplus::images::ImageAtlas make_atlas(
+	GLsizei padding,
+	GLsizei alignment,
+	std::size_t max_pages
+)
+{
+	using namespace oglplus;
+	images::ImageAtlasParams params;
+	params.padding = padding;
+	params.alignment = alignment;
+	params.max_pages = max_pages;
+	return images::ImageAtlas(
+		64, 64, 2,
+		static_cast<const GLubyte*>(nullptr),
+		PixelDataFormat::RG,
+		PixelDataInternalFormat::RG8,
+		params
+	);
+}
+
+static GLsizei cell_size(GLsizei size, GLsizei padding, GLsizei alignment)
+{
+	return ((size+2*padding+alignment-1)/alignment)*alignment;
+}
+
+// checks the placement and the contents of all images in the atlas
+static void check_atlas(
+	const oglplus::images::ImageAtlas& atlas,
+	const std::vector<texels>& images,
+	GLsizei padding,
+	GLsizei alignment
+)
+{
+	using namespace oglplus;
+	const GLsizei p = padding;
+	const GLsizei pw = atlas.Width(), ph = atlas.Height();
+	BOOST_CHECK_EQUAL(atlas.Count(), images.size());
+
+	for(std::size_t id=0; id!=atlas.Count(); ++id)
+	{
+		const images::ImageAtlasEntry& e = atlas.Entry(id);
+		if(e.page < 0) continue;
+		BOOST_CHECK(std::size_t(e.page) < atlas.PageCount());
+
+		const GLsizei cx = e.x-p, cy = e.y-p;
+		const GLsizei cw = cell_size(e.width, p, alignment);
+		const GLsizei ch = cell_size(e.height, p, alignment);
+		BOOST_CHECK(cx >= 0 && cy >= 0);
+		BOOST_CHECK(cx+cw <= pw && cy+ch <= ph);
+		BOOST_CHECK_EQUAL(cx%alignment, 0);
+		BOOST_CHECK_EQUAL(cy%alignment, 0);
+
+		// the cells on the same page do not overlap
+		for(std::size_t other=0; other!=id; ++other)
+		{
+			const images::ImageAtlasEntry& o = atlas.Entry(other);
+			if(o.page != e.page) continue;
+			const GLsizei ox = o.x-p, oy = o.y-p;
+			const GLsizei ow = cell_size(o.width, p, alignment);
+			const GLsizei oh = cell_size(o.height, p, alignment);
+			BOOST_CHECK(
+				(cx+cw <= ox) || (ox+ow <= cx) ||
+				(cy+ch <= oy) || (oy+oh <= cy)
+			);
+		}
+
+		// the image and its padding (the clamped edge texels)
+		const images::ImageView page = atlas.Page(std::size_t(e.page));
+		const texels& image = images[id];
+		for(GLsizei y=-p; y!=e.height+p; ++y)
+		for(GLsizei x=-p; x!=e.width+p; ++x)
+		{
+			const GLsizei sx = std::min(std::max(x, 0), e.width-1);
+			const GLsizei sy = std::min(std::max(y, 0), e.height-1);
+			BOOST_CHECK(std::memcmp(
+				page.RawPixel(e.x+x, e.y+y, 0),
+				image.data()+(sy*e.width+sx)*2,
+				2
+			) == 0);
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(images_Atlas_insert_remove)
+{
+	using namespace oglplus;
+	for(GLsizei padding=0; padding!=3; ++padding)
+	for(GLsizei alignment=1; alignment<=4; alignment*=2)
+	{
+		images::ImageAtlas atlas = make_atlas(padding, alignment, 0);
+		std::vector<texels> images;
+		for(std::size_t id=0; id!=60; ++id)
+		{
+			const GLsizei w = GLsizei(3+(id*7)%13);
+			const GLsizei h = GLsizei(2+(id*5)%11);
+			images.push_back(make_texels(w, h, id));
+			BOOST_CHECK_EQUAL(
+				atlas.Insert(make_view(images.back(), w, h)),
+				id
+			);
+			const images::ImageAtlasEntry& e = atlas.Entry(id);
+			BOOST_CHECK_EQUAL(e.width, w);
+			BOOST_CHECK_EQUAL(e.height, h);
+			BOOST_CHECK(atlas.PageModified(std::size_t(e.page)));
+		}
+		BOOST_CHECK(atlas.PageCount() > 1);
+		check_atlas(atlas, images, padding, alignment);
+		BOOST_CHECK_EQUAL(atlas.Fragmentation(), 0.0f);
+
+		for(std::size_t id=0; id!=images.size(); id+=3)
+		{
+			atlas.Remove(id);
+			BOOST_CHECK_EQUAL(atlas.Entry(id).page, -1);
+			BOOST_CHECK(atlas.UVRect(id) == Vec4f());
+		}
+		BOOST_CHECK(atlas.Fragmentation() > 0.0f);
+		check_atlas(atlas, images, padding, alignment);
+
+		const std::size_t pages = atlas.PageCount();
+		atlas.ClearModified();
+		BOOST_CHECK(atlas.Defragment() <= pages);
+		BOOST_CHECK_EQUAL(atlas.Fragmentation(), 0.0f);
+		for(std::size_t page=0; page!=atlas.PageCount(); ++page)
+		{
+			BOOST_CHECK(atlas.PageModified(page));
+		}
+		for(std::size_t id=0; id!=images.size(); ++id)
+		{
+			BOOST_CHECK_EQUAL(atlas.Entry(id).page < 0, id%3 == 0);
+		}
+		// the ids keep their images after the repacking
+		check_atlas(atlas, images, padding, alignment);
+
+		// new images are placed after the defragmentation
+		images.push_back(make_texels(9, 7, images.size()));
+		atlas.Insert(make_view(images.back(), 9, 7));
+		check_atlas(atlas, images, padding, alignment);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(images_Atlas_limits)
+{
+	using namespace oglplus;
+	images::ImageAtlas atlas = make_atlas(2, 4, 1);
+
+	// the image with the padding is larger than the page
+	const texels wide = make_texels(61, 4, 0);
+	BOOST_CHECK_THROW(
+		atlas.Insert(make_view(wide, 61, 4)),
+		std::runtime_error
+	);
+	BOOST_CHECK_EQUAL(atlas.Count(), 0u);
+
+	// the only page is filled and then defragmented
+	const texels block = make_texels(28, 28, 1);
+	std::vector<std::size_t> ids;
+	for(int i=0; i!=4; ++i)
+	{
+		ids.push_back(atlas.Insert(make_view(block, 28, 28)));
+	}
+	BOOST_CHECK_EQUAL(atlas.PageCount(), 1u);
+	BOOST_CHECK_THROW(
+		atlas.Insert(make_view(block, 28, 28)),
+		std::runtime_error
+	);
+	atlas.Remove(ids[1]);
+	BOOST_CHECK_THROW(
+		atlas.Insert(make_view(block, 28, 28)),
+		std::runtime_error
+	);
+	BOOST_CHECK_EQUAL(atlas.Defragment(), 1u);
+	atlas.Insert(make_view(block, 28, 28));
+	BOOST_CHECK_EQUAL(atlas.PageCount(), 1u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
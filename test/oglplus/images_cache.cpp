@@ -0,0 +1,171 @@
+/**
+ *  .file test/oglplus/images_cache.cpp
+ *  .brief Test case for the ImageCache class.
+ *
+ *  .author Matus Chochlik
+ *
+ *  Copyright 2011-2015 Matus Chochlik. Distributed under the Boost
+ *  Software License, Version 1.0. (See accompanying file
+ *  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE OGLPLUS_images_Cache
+#include <boost/test/unit_test.hpp>
+
+#include <oglplus/gl.hpp>
+#include <oglplus/images/cache.hpp>
+#include <oglplus/images/random.hpp>
+
+#include <cstring>
+
+BOOST_AUTO_TEST_SUITE(images_Cache)
+
+template <typename T>
+static oglplus::images::Image make_image(
+	oglplus::PixelDataType type,
+	oglplus::PixelDataFormat format,
+	oglplus::PixelDataInternalFormat internal,
+	GLsizei channels
+)
+{
+	using namespace oglplus;
+	const GLsizei w = 7, h = 5, d = 3;
+	aux::AlignedPODArray storage(
+		static_cast<const T*>(nullptr),
+		std::size_t(w*h*d*channels)
+	);
+	unsigned char* data = static_cast<unsigned char*>(storage.begin());
+	for(std::size_t i=0; i!=storage.size(); ++i)
+	{
+		data[i] = (unsigned char)((i*37+11)%253);
+	}
+	return images::Image(
+		w, h, d, channels,
+		type,
+		std::move(storage),
+		format,
+		internal
+	);
+}
+
+template <typename T>
+static void check_round_trip(
+	oglplus::PixelDataType type,
+	oglplus::PixelDataFormat format,
+	oglplus::PixelDataInternalFormat internal,
+	GLsizei channels
+)
+{
+	using namespace oglplus;
+	images::ImageCache cache(".", "test-images_cache");
+	images::ImageCacheKey key("images_Cache");
+	key.Add(GLenum(type)).Add(GLenum(format));
+
+	const images::Image original = make_image<T>(type, format, internal, channels);
+	cache.Remove(key);
+	BOOST_CHECK(!cache.Contains(key));
+	BOOST_CHECK(cache.Store(key, original));
+	BOOST_CHECK(cache.Contains(key));
+
+	bool generated = false;
+	const images::Image cached = cache.Get(
+		key,
+		[&](void)
+		{
+			generated = true;
+			return make_image<T>(type, format, internal, channels);
+		}
+	);
+	BOOST_CHECK(!generated);
+	BOOST_CHECK(cached.Type() == type);
+	BOOST_CHECK(cached.Format() == format);
+	BOOST_CHECK(cached.InternalFormat() == original.InternalFormat());
+	BOOST_CHECK_EQUAL(GLsizei(cached.Width()), GLsizei(original.Width()));
+	BOOST_CHECK_EQUAL(GLsizei(cached.Height()), GLsizei(original.Height()));
+	BOOST_CHECK_EQUAL(GLsizei(cached.Depth()), GLsizei(original.Depth()));
+	BOOST_CHECK_EQUAL(GLsizei(cached.Channels()), GLsizei(original.Channels()));
+	BOOST_CHECK_EQUAL(cached.DataSize(), original.DataSize());
+	BOOST_CHECK(std::memcmp(
+		cached.RawData(),
+		original.RawData(),
+		original.DataSize()
+	) == 0);
+	BOOST_CHECK(cache.Remove(key));
+}
+
+BOOST_AUTO_TEST_CASE(images_Cache_plain_types)
+{
+	using namespace oglplus;
+	typedef PixelDataType PDT;
+	typedef PixelDataFormat PDF;
+	typedef PixelDataInternalFormat PDIF;
+
+	check_round_trip<GLubyte>(PDT::UnsignedByte, PDF::RGBA, PDIF::RGBA8, 4);
+	check_round_trip<GLubyte>(PDT::UnsignedByte, PDF::Red, PDIF::R8, 1);
+	check_round_trip<GLbyte>(PDT::Byte, PDF::RGBA, PDIF::RGBA8SNorm, 4);
+	check_round_trip<GLushort>(PDT::UnsignedShort, PDF::RGBA, PDIF::RGBA16, 4);
+	check_round_trip<GLshort>(PDT::Short, PDF::RG, PDIF::RG16SNorm, 2);
+	check_round_trip<GLuint>(PDT::UnsignedInt, PDF::RGB, PDIF::RGB32UI, 3);
+	check_round_trip<GLint>(PDT::Int, PDF::RedInteger, PDIF::R32I, 1);
+	check_round_trip<GLfloat>(PDT::Float, PDF::RGBA, PDIF::RGBA32F, 4);
+	check_round_trip<GLfloat>(PDT::Float, PDF::Red, PDIF::R32F, 1);
+	check_round_trip<GLushort>(PDT::HalfFloat, PDF::RGBA, PDIF::RGBA16F, 4);
+	check_round_trip<GLushort>(PDT::HalfFloat, PDF::RGB, PDIF::RGB16F, 3);
+}
+
+BOOST_AUTO_TEST_CASE(images_Cache_packed_types)
+{
+	using namespace oglplus;
+	check_round_trip<GLuint>(
+		PixelDataType::UnsignedInt_10f_11f_11f_Rev,
+		PixelDataFormat::RGB,
+		PixelDataInternalFormat::R11FG11FB10F,
+		1
+	);
+	check_round_trip<GLuint>(
+		PixelDataType::UnsignedInt_5_9_9_9_Rev,
+		PixelDataFormat::RGB,
+		PixelDataInternalFormat::RGB9E5,
+		1
+	);
+	check_round_trip<GLuint>(
+		PixelDataType::UnsignedInt_2_10_10_10_Rev,
+		PixelDataFormat::RGBA,
+		PixelDataInternalFormat::RGB10A2,
+		1
+	);
+}
+
+BOOST_AUTO_TEST_CASE(images_Cache_make)
+{
+	using namespace oglplus;
+	images::ImageCache cache(".", "test-images_cache");
+	const images::ImageCacheKey key = images::ImageCacheKey("RandomRedUByte")
+		.Add(9).Add(4).Add(1).Add(images::RandomSeed(7));
+	cache.Remove(key);
+
+	// the key of Make consists of the name and of the parameters
+	const images::Image made = cache.Make<images::RandomRedUByte>(
+		"RandomRedUByte", 9, 4, 1, images::RandomSeed(7)
+	);
+	BOOST_CHECK(cache.Contains(key));
+	const images::Image cached = cache.Make<images::RandomRedUByte>(
+		"RandomRedUByte", 9, 4, 1, images::RandomSeed(7)
+	);
+	const images::RandomRedUByte expected(9, 4, 1, images::RandomSeed(7));
+	BOOST_CHECK_EQUAL(made.DataSize(), expected.DataSize());
+	BOOST_CHECK_EQUAL(cached.DataSize(), expected.DataSize());
+	BOOST_CHECK(std::memcmp(
+		made.RawData(),
+		expected.RawData(),
+		expected.DataSize()
+	) == 0);
+	BOOST_CHECK(std::memcmp(
+		cached.RawData(),
+		expected.RawData(),
+		expected.DataSize()
+	) == 0);
+	BOOST_CHECK(cache.Remove(key));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,125 @@
+/**
+ *  .file test/oglplus/images_cloud.cpp
+ *  .brief Test case for the seeded Cloud generator.
+ *
+ *  .author Matus Chochlik
+ *
+ *  Copyright 2011-2015 Matus Chochlik. Distributed under the Boost
+ *  Software License, Version 1.0. (See accompanying file
+ *  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE OGLPLUS_images_Cloud
+#include <boost/test/unit_test.hpp>
+
+#include <oglplus/gl.hpp>
+#include <oglplus/images/cloud.hpp>
+#include <oglplus/detail/parallel_for.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(images_Cloud)
+
+static const GLsizei cloud_w = 40, cloud_h = 32, cloud_d = 24;
+// larger than the default to keep the number of spheres small
+static const GLfloat cloud_min_radius = 0.08f;
+
+static std::vector<GLubyte> cloud_texels(std::uint64_t seed)
+{
+	using namespace oglplus;
+	const images::Cloud cloud(
+		cloud_w, cloud_h, cloud_d,
+		images::RandomSeed(seed),
+		Vec3f(0.0f, -0.3f, 0.0f),
+		0.7f, 0.333f, 0.5f,
+		cloud_min_radius
+	);
+	const GLubyte* p = cloud.Data<GLubyte>();
+	return std::vector<GLubyte>(p, p+cloud_w*cloud_h*cloud_d);
+}
+
+BOOST_AUTO_TEST_CASE(images_Cloud_seeded_repeatable)
+{
+	std::srand(1);
+	const std::vector<GLubyte> a = cloud_texels(3);
+	// the seeded mode does not use the std::rand generator
+	std::srand(2);
+	std::rand();
+	const std::vector<GLubyte> b = cloud_texels(3);
+	const std::vector<GLubyte> c = cloud_texels(4);
+
+	BOOST_CHECK(a == b);
+	BOOST_CHECK(a != c);
+	BOOST_CHECK(
+		std::size_t(std::count(a.begin(), a.end(), GLubyte(0))) <
+		a.size()
+	);
+}
+
+BOOST_AUTO_TEST_CASE(images_Cloud_seeded_threads)
+{
+	const std::vector<GLubyte> parallel = cloud_texels(7);
+
+	// the loops nested in a ParallelFor loop run on a single thread
+	std::vector<std::vector<GLubyte>> serial(2);
+	oglplus::aux::ParallelFor(
+		serial.size(), 1,
+		[&serial](std::size_t b, std::size_t e)
+		{
+			for(std::size_t i=b; i!=e; ++i)
+			{
+				serial[i] = cloud_texels(7);
+			}
+		}
+	);
+	for(std::size_t i=0; i!=serial.size(); ++i)
+	{
+		BOOST_CHECK(serial[i] == parallel);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(images_Cloud_seeded_regions)
+{
+	using namespace oglplus;
+
+	const std::vector<GLubyte> whole = cloud_texels(11);
+	const images::CloudTileSource source(
+		cloud_w, cloud_h, cloud_d,
+		images::RandomSeed(11),
+		Vec3f(0.0f, -0.3f, 0.0f),
+		0.7f, 0.333f, 0.5f,
+		cloud_min_radius
+	);
+	BOOST_CHECK_EQUAL(source.Levels(), 6);
+
+	// regions which do not line up with the z-slabs of the Cloud
+	const GLsizei tw = 17, th = 13, td = 7;
+	for(GLsizei z=0; z<cloud_d; z+=td)
+	for(GLsizei y=0; y<cloud_h; y+=th)
+	for(GLsizei x=0; x<cloud_w; x+=tw)
+	{
+		const GLsizei rw = std::min(tw, cloud_w-x);
+		const GLsizei rh = std::min(th, cloud_h-y);
+		const GLsizei rd = std::min(td, cloud_d-z);
+		const images::Image region =
+			source.MakeRegion(0, x, y, z, rw, rh, rd);
+		const GLubyte* p = region.Data<GLubyte>();
+
+		GLsizei mismatches = 0;
+		for(GLsizei k=0; k!=rd; ++k)
+		for(GLsizei j=0; j!=rh; ++j)
+		for(GLsizei i=0; i!=rw; ++i)
+		{
+			const std::size_t n = std::size_t(
+				((z+k)*cloud_h+(y+j))*cloud_w+(x+i)
+			);
+			if(p[(k*rh+j)*rw+i] != whole[n]) ++mismatches;
+		}
+		BOOST_CHECK_EQUAL(mismatches, 0);
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
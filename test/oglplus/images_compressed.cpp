@@ -0,0 +1,497 @@
+/**
+ *  .file test/oglplus/images_compressed.cpp
+ *  .brief Test case for the BCn block compression encoder.
+ *
+ *  .author Matus Chochlik
+ *
+ *  Copyright 2011-2015 Matus Chochlik. Distributed under the Boost
+ *  Software License, Version 1.0. (See accompanying file
+ *  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE OGLPLUS_images_Compressed
+#include <boost/test/unit_test.hpp>
+
+#include <oglplus/gl.hpp>
+#include <oglplus/images/compressed.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(images_Compressed)
+
+// The reference decoders below follow the S3TC, RGTC and BPTC
+// specifications, the decoded components are in the [0, 255]
+// (or [-127, 127] for signed BC4/BC5) range
+
+static void unpack_565(unsigned v, float c[3])
+{
+	const unsigned r = (v >> 11) & 0x1F;
+	const unsigned g = (v >>  5) & 0x3F;
+	const unsigned b = (v >>  0) & 0x1F;
+	c[0] = float((r << 3) | (r >> 2));
+	c[1] = float((g << 2) | (g >> 4));
+	c[2] = float((b << 3) | (b >> 2));
+}
+
+static void decode_bc1(const unsigned char* b, float px[16][4])
+{
+	const unsigned c0 = unsigned(b[0] | (b[1] << 8));
+	const unsigned c1 = unsigned(b[2] | (b[3] << 8));
+	float pal[4][4];
+	unpack_565(c0, pal[0]);
+	unpack_565(c1, pal[1]);
+	for(int c=0; c!=3; ++c)
+	{
+		if(c0 > c1)
+		{
+			pal[2][c] = (2*pal[0][c]+pal[1][c])/3.0f;
+			pal[3][c] = (pal[0][c]+2*pal[1][c])/3.0f;
+		}
+		else
+		{
+			pal[2][c] = (pal[0][c]+pal[1][c])/2.0f;
+			pal[3][c] = 0.0f;
+		}
+	}
+	pal[0][3] = pal[1][3] = pal[2][3] = 255.0f;
+	pal[3][3] = (c0 > c1)?255.0f:0.0f;
+
+	const std::uint32_t bits = std::uint32_t(b[4])|
+		(std::uint32_t(b[5]) <<  8)|
+		(std::uint32_t(b[6]) << 16)|
+		(std::uint32_t(b[7]) << 24);
+	for(int i=0; i!=16; ++i)
+	{
+		const unsigned idx = (bits >> (2*i)) & 0x3;
+		for(int c=0; c!=4; ++c) px[i][c] = pal[idx][c];
+	}
+}
+
+static void decode_bc4(
+	const unsigned char* b,
+	bool snorm,
+	float px[16][4],
+	int channel
+)
+{
+	float e0 = snorm?float(std::int8_t(b[0])):float(b[0]);
+	float e1 = snorm?float(std::int8_t(b[1])):float(b[1]);
+	if(e0 < -127.0f) e0 = -127.0f;
+	if(e1 < -127.0f) e1 = -127.0f;
+	float pal[8] = {e0, e1};
+	if(e0 > e1)
+	{
+		for(int i=1; i!=7; ++i) pal[i+1] = ((7-i)*e0+i*e1)/7.0f;
+	}
+	else
+	{
+		for(int i=1; i!=5; ++i) pal[i+1] = ((5-i)*e0+i*e1)/5.0f;
+		pal[6] = snorm?-127.0f:0.0f;
+		pal[7] = snorm?+127.0f:255.0f;
+	}
+	std::uint64_t bits = 0;
+	for(int k=0; k!=6; ++k)
+	{
+		bits |= std::uint64_t(b[2+k]) << (8*k);
+	}
+	for(int i=0; i!=16; ++i)
+	{
+		px[i][channel] = pal[(bits >> (3*i)) & 0x7];
+	}
+}
+
+// Only mode 6 is decoded, which is the mode written by the encoder
+static void decode_bc7(const unsigned char* b, float px[16][4])
+{
+	unsigned pos = 0;
+	auto get = [b, &pos](unsigned n) -> unsigned
+	{
+		unsigned v = 0;
+		for(unsigned i=0; i!=n; ++i, ++pos)
+		{
+			v |= unsigned((b[pos >> 3] >> (pos & 7)) & 1) << i;
+		}
+		return v;
+	};
+	BOOST_REQUIRE_EQUAL(get(7), 1u << 6);
+
+	unsigned e[2][4];
+	for(int c=0; c!=4; ++c)
+	{
+		e[0][c] = get(7) << 1;
+		e[1][c] = get(7) << 1;
+	}
+	const unsigned p0 = get(1), p1 = get(1);
+	for(int c=0; c!=4; ++c)
+	{
+		e[0][c] |= p0;
+		e[1][c] |= p1;
+	}
+	static const unsigned weights[16] = {
+		0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64
+	};
+	for(int i=0; i!=16; ++i)
+	{
+		const unsigned w = weights[get(i == 0?3:4)];
+		for(int c=0; c!=4; ++c)
+		{
+			px[i][c] = float(((64-w)*e[0][c]+w*e[1][c]+32) >> 6);
+		}
+	}
+	BOOST_CHECK_EQUAL(pos, 128u);
+}
+
+// Decodes the whole compressed image into RGBA pixels
+static std::vector<float> decode(
+	const oglplus::images::CompressedImage& image,
+	bool snorm = false
+)
+{
+	using oglplus::images::BlockCompression;
+	using oglplus::images::CompressedImage;
+	const GLsizei w = GLsizei(image.Width());
+	const GLsizei h = GLsizei(image.Height());
+	const GLsizei bw = (w+3)/4, bh = (h+3)/4;
+	const std::size_t bs = CompressedImage::BlockSize(image.Format());
+	BOOST_REQUIRE_EQUAL(
+		std::size_t(GLsizei(image.DataSize())),
+		std::size_t(bw*bh)*bs
+	);
+
+	std::vector<float> result(std::size_t(w*h*4));
+	const unsigned char* data =
+		static_cast<const unsigned char*>(image.RawData());
+	for(GLsizei by=0; by!=bh; ++by)
+	for(GLsizei bx=0; bx!=bw; ++bx)
+	{
+		const unsigned char* b = data + std::size_t(by*bw+bx)*bs;
+		float px[16][4] = {{0.0f}};
+		switch(image.Format())
+		{
+			case BlockCompression::BC1:
+				decode_bc1(b, px);
+				break;
+			case BlockCompression::BC3:
+				decode_bc1(b+8, px);
+				decode_bc4(b, false, px, 3);
+				break;
+			case BlockCompression::BC4:
+				decode_bc4(b, snorm, px, 0);
+				break;
+			case BlockCompression::BC5:
+				decode_bc4(b, snorm, px, 0);
+				decode_bc4(b+8, snorm, px, 1);
+				break;
+			case BlockCompression::BC7:
+				decode_bc7(b, px);
+				break;
+		}
+		for(GLsizei j=0; j!=4; ++j)
+		for(GLsizei i=0; i!=4; ++i)
+		{
+			const GLsizei x = bx*4+i, y = by*4+j;
+			if((x >= w) || (y >= h)) continue;
+			for(int c=0; c!=4; ++c)
+			{
+				result[std::size_t((y*w+x)*4+c)] = px[j*4+i][c];
+			}
+		}
+	}
+	return result;
+}
+
+// The number of channels stored by each format
+static int format_channels(oglplus::images::BlockCompression format)
+{
+	using oglplus::images::BlockCompression;
+	switch(format)
+	{
+		case BlockCompression::BC1: return 3;
+		case BlockCompression::BC4: return 1;
+		case BlockCompression::BC5: return 2;
+		default:;
+	}
+	return 4;
+}
+
+static const oglplus::images::BlockCompression all_formats[] = {
+	oglplus::images::BlockCompression::BC1,
+	oglplus::images::BlockCompression::BC3,
+	oglplus::images::BlockCompression::BC4,
+	oglplus::images::BlockCompression::BC5,
+	oglplus::images::BlockCompression::BC7
+};
+
+// RGBA test images with 8-bit components
+class TestImage
+{
+public:
+	GLsizei width, height;
+	std::vector<GLubyte> data;
+
+	TestImage(GLsizei w, GLsizei h)
+	 : width(w)
+	 , height(h)
+	 , data(std::size_t(w*h*4))
+	{ }
+
+	GLubyte& At(GLsizei x, GLsizei y, int c)
+	{
+		return data[std::size_t((y*width+x)*4+c)];
+	}
+
+	oglplus::images::ImageView View(void) const
+	{
+		return oglplus::images::ImageView(
+			width, height, 1, 4,
+			data.data(),
+			oglplus::PixelDataFormat::RGBA,
+			oglplus::PixelDataInternalFormat::RGBA8
+		);
+	}
+};
+
+static std::uint32_t test_rng(std::uint32_t& state)
+{
+	state = state*1664525u+1013904223u;
+	return state >> 8;
+}
+
+// every 4x4 block has a different solid color
+static TestImage solid_image(void)
+{
+	TestImage image(16, 16);
+	std::uint32_t state = 17;
+	for(GLsizei by=0; by!=4; ++by)
+	for(GLsizei bx=0; bx!=4; ++bx)
+	{
+		GLubyte color[4];
+		for(int c=0; c!=4; ++c) color[c] = GLubyte(test_rng(state));
+		for(GLsizei y=by*4; y!=by*4+4; ++y)
+		for(GLsizei x=bx*4; x!=bx*4+4; ++x)
+		for(int c=0; c!=4; ++c)
+		{
+			image.At(x, y, c) = color[c];
+		}
+	}
+	return image;
+}
+
+// the colors of each block lie on a line in the color space
+static TestImage gradient_image(void)
+{
+	TestImage image(16, 16);
+	for(GLsizei y=0; y!=16; ++y)
+	for(GLsizei x=0; x!=16; ++x)
+	{
+		const GLsizei t = y*16+x;
+		image.At(x, y, 0) = GLubyte(t);
+		image.At(x, y, 1) = GLubyte(255-t);
+		image.At(x, y, 2) = GLubyte(t/2);
+		image.At(x, y, 3) = GLubyte(64+t/2);
+	}
+	return image;
+}
+
+static TestImage random_image(void)
+{
+	TestImage image(16, 16);
+	std::uint32_t state = 42;
+	for(GLubyte& v : image.data) v = GLubyte(test_rng(state));
+	return image;
+}
+
+// Returns the root mean square error of the stored channels
+static double rms_error(
+	const TestImage& image,
+	const oglplus::images::BlockCompressionParams& params
+)
+{
+	const oglplus::images::CompressedImage compressed(image.View(), params);
+	BOOST_CHECK(compressed.Format() == params.format);
+	BOOST_CHECK_EQUAL(GLsizei(compressed.Width()), image.width);
+	BOOST_CHECK_EQUAL(GLsizei(compressed.Height()), image.height);
+
+	const std::vector<float> decoded = decode(compressed);
+	const int channels = format_channels(params.format);
+	double sum = 0.0;
+	for(std::size_t p=0; p!=image.data.size()/4; ++p)
+	for(int c=0; c!=channels; ++c)
+	{
+		const double d = decoded[p*4+c]-image.data[p*4+c];
+		sum += d*d;
+	}
+	return std::sqrt(sum/double(image.data.size()/4*channels));
+}
+
+// Returns the maximal absolute error of the stored channels
+static float max_error(
+	const TestImage& image,
+	oglplus::images::BlockCompression format
+)
+{
+	const oglplus::images::CompressedImage compressed(image.View(), format);
+	const std::vector<float> decoded = decode(compressed);
+	const int channels = format_channels(format);
+	float result = 0.0f;
+	for(std::size_t p=0; p!=image.data.size()/4; ++p)
+	for(int c=0; c!=channels; ++c)
+	{
+		const float d = std::fabs(decoded[p*4+c]-image.data[p*4+c]);
+		if(result < d) result = d;
+	}
+	return result;
+}
+
+static void check_rms_error(
+	const TestImage& image,
+	const double bounds[5]
+)
+{
+	using namespace oglplus::images;
+	for(int f=0; f!=5; ++f)
+	{
+		BlockCompressionParams params(all_formats[f]);
+		const double fast = rms_error(image, params);
+		params.high_quality = true;
+		const double hq = rms_error(image, params);
+		BOOST_CHECK_LE(fast, bounds[f]);
+		BOOST_CHECK_LE(hq, fast+1e-6);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(images_Compressed_solid)
+{
+	// BC1 and BC3 quantize the colors to 5:6:5 bits
+	// and BC7 the color of a solid block to 7 bits and a p-bit
+	const double bounds[5] = {3.0, 3.0, 0.0, 0.0, 1.0};
+	check_rms_error(solid_image(), bounds);
+}
+
+BOOST_AUTO_TEST_CASE(images_Compressed_gradient)
+{
+	const double bounds[5] = {3.0, 3.0, 3.0, 3.0, 1.5};
+	check_rms_error(gradient_image(), bounds);
+}
+
+BOOST_AUTO_TEST_CASE(images_Compressed_random)
+{
+	const double bounds[5] = {60.0, 55.0, 12.0, 12.0, 60.0};
+	check_rms_error(random_image(), bounds);
+}
+
+BOOST_AUTO_TEST_CASE(images_Compressed_exact)
+{
+	using namespace oglplus::images;
+	// the colors are exactly representable in 5:6:5 bits
+	// and all their components have the same parity (the p-bit of BC7)
+	const GLubyte colors[4][4] = {
+		{  0,   0,   0,   0},
+		{255, 255, 255, 255},
+		{ 33,  69,  99, 201},
+		{206, 130, 148,  16}
+	};
+
+	// solid blocks
+	TestImage solid(8, 8);
+	for(GLsizei y=0; y!=8; ++y)
+	for(GLsizei x=0; x!=8; ++x)
+	for(int c=0; c!=4; ++c)
+	{
+		solid.At(x, y, c) = colors[(y/4)*2+x/4][c];
+	}
+	for(BlockCompression format : all_formats)
+	{
+		BOOST_CHECK_EQUAL(max_error(solid, format), 0.0f);
+	}
+
+	// blocks with two colors
+	TestImage two(8, 8);
+	for(GLsizei y=0; y!=8; ++y)
+	for(GLsizei x=0; x!=8; ++x)
+	for(int c=0; c!=4; ++c)
+	{
+		const int b = (y/4)*2+x/4;
+		two.At(x, y, c) = colors[((x+y)%2 == 0)?b:(b+1)%4][c];
+	}
+	BOOST_CHECK_EQUAL(max_error(two, BlockCompression::BC1), 0.0f);
+	BOOST_CHECK_EQUAL(max_error(two, BlockCompression::BC4), 0.0f);
+	BOOST_CHECK_EQUAL(max_error(two, BlockCompression::BC5), 0.0f);
+}
+
+BOOST_AUTO_TEST_CASE(images_Compressed_snorm)
+{
+	using namespace oglplus;
+	using namespace oglplus::images;
+	// signed values are stored as integers in the [-127, 127] range,
+	// blocks with two values in each channel are encoded exactly
+	std::vector<GLfloat> data(8*4*2);
+	for(std::size_t p=0; p!=data.size()/2; ++p)
+	{
+		data[p*2+0] = ((p%2 == 0)?-90.0f:60.0f)/127.0f;
+		data[p*2+1] = ((p%3 == 0)?-127.0f:127.0f)/127.0f;
+	}
+	const ImageView view(
+		8, 4, 1, 2,
+		data.data(),
+		PixelDataFormat::RG,
+		PixelDataInternalFormat::RG32F
+	);
+	BlockCompressionParams params(BlockCompression::BC5);
+	params.snorm = true;
+	const CompressedImage compressed(view, params);
+	BOOST_CHECK(
+		compressed.InternalFormat() ==
+		PixelDataInternalFormat(GL_COMPRESSED_SIGNED_RG_RGTC2)
+	);
+	const std::vector<float> decoded = decode(compressed, true);
+	for(std::size_t p=0; p!=data.size()/2; ++p)
+	for(std::size_t c=0; c!=2; ++c)
+	{
+		BOOST_CHECK_EQUAL(
+			decoded[p*4+c],
+			std::floor(data[p*2+c]*127.0f+0.5f)
+		);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(images_Compressed_size)
+{
+	using namespace oglplus::images;
+	// the blocks on the right and bottom edges are padded
+	// by repeating the edge pixels, which does not add new values
+	// to the two-valued red channel
+	TestImage image(6, 5);
+	std::uint32_t state = 7;
+	for(GLubyte& v : image.data) v = GLubyte(test_rng(state));
+	for(GLsizei y=0; y!=5; ++y)
+	for(GLsizei x=0; x!=6; ++x)
+	{
+		image.At(x, y, 0) = GLubyte(((x == 5) || (y == 4))?250:10);
+	}
+	for(BlockCompression format : all_formats)
+	{
+		const CompressedImage compressed(image.View(), format);
+		BOOST_CHECK_EQUAL(
+			std::size_t(GLsizei(compressed.DataSize())),
+			4*CompressedImage::BlockSize(format)
+		);
+	}
+	BOOST_CHECK_EQUAL(max_error(image, BlockCompression::BC4), 0.0f);
+
+	std::vector<GLubyte> data(4*4*2*4);
+	BOOST_CHECK_THROW(
+		CompressedImage(ImageView(
+			4, 4, 2, 4,
+			data.data(),
+			oglplus::PixelDataFormat::RGBA,
+			oglplus::PixelDataInternalFormat::RGBA8
+		)),
+		std::runtime_error
+	);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,641 @@
+/**
+ *  .file test/oglplus/images_container.cpp
+ *  .brief Test case for the KTX and DDS texture container reader.
+ *
+ *  .author Matus Chochlik
+ *
+ *  Copyright 2011-2015 Matus Chochlik. Distributed under the Boost
+ *  Software License, Version 1.0. (See accompanying file
+ *  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE OGLPLUS_images_Container
+#include <boost/test/unit_test.hpp>
+
+#include <oglplus/gl.hpp>
+#include <oglplus/images/container.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(images_Container)
+
+// Builds the contents of a container file in memory
+struct ContainerBytes
+{
+	std::vector<unsigned char> data;
+	bool big_endian;
+
+	ContainerBytes(bool be = false)
+	 : big_endian(be)
+	{ }
+
+	void u8(unsigned v)
+	{
+		data.push_back((unsigned char)(v));
+	}
+
+	void u16(unsigned v)
+	{
+		if(big_endian)
+		{
+			u8(v >> 8); u8(v);
+		}
+		else
+		{
+			u8(v); u8(v >> 8);
+		}
+	}
+
+	void u32(GLuint v)
+	{
+		if(big_endian)
+		{
+			u8(v >> 24); u8(v >> 16); u8(v >> 8); u8(v);
+		}
+		else
+		{
+			u8(v); u8(v >> 8); u8(v >> 16); u8(v >> 24);
+		}
+	}
+
+	void put32(std::size_t offs, GLuint v)
+	{
+		data[offs+0] = (unsigned char)(v);
+		data[offs+1] = (unsigned char)(v >> 8);
+		data[offs+2] = (unsigned char)(v >> 16);
+		data[offs+3] = (unsigned char)(v >> 24);
+	}
+
+	void pad(std::size_t align, unsigned char fill = 0xEE)
+	{
+		while(data.size() % align) u8(fill);
+	}
+
+	void save(const char* path, std::size_t size = 0) const
+	{
+		std::ofstream file(path, std::ios::binary);
+		file.write(
+			reinterpret_cast<const char*>(data.data()),
+			std::streamsize(size?size:data.size())
+		);
+	}
+};
+
+static void ktx_header(
+	ContainerBytes& b,
+	GLenum gl_type,
+	GLuint type_size,
+	GLenum format,
+	GLenum internal,
+	GLenum base,
+	GLuint width,
+	GLuint height,
+	GLuint layers,
+	GLuint faces,
+	GLuint levels,
+	GLuint kv_bytes = 0
+)
+{
+	const unsigned char ktx_id[12] = {
+		0xAB, 0x4B, 0x54, 0x58, 0x20, 0x31,
+		0x31, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A
+	};
+	b.data.assign(ktx_id, ktx_id+12);
+	b.u32(0x04030201);
+	b.u32(gl_type);
+	b.u32(type_size);
+	b.u32(format);
+	b.u32(internal);
+	b.u32(base);
+	b.u32(width);
+	b.u32(height);
+	b.u32(0);
+	b.u32(layers);
+	b.u32(faces);
+	b.u32(levels);
+	b.u32(kv_bytes);
+	for(GLuint i=0; i!=kv_bytes; ++i) b.u8(0x55);
+}
+
+static void dds_header(
+	ContainerBytes& b,
+	GLuint width,
+	GLuint height,
+	GLuint levels,
+	GLuint pf_flags,
+	GLuint fourcc,
+	GLuint bits,
+	GLuint rmask,
+	GLuint amask,
+	GLuint caps2
+)
+{
+	b.data.assign(128, 0);
+	b.data[0] = 'D'; b.data[1] = 'D'; b.data[2] = 'S'; b.data[3] = ' ';
+	b.put32(4, 124);
+	b.put32(12, height);
+	b.put32(16, width);
+	b.put32(28, levels);
+	b.put32(76, 32);
+	b.put32(80, pf_flags);
+	b.put32(84, fourcc);
+	b.put32(88, bits);
+	b.put32(92, rmask);
+	b.put32(104, amask);
+	b.put32(112, caps2);
+}
+
+static GLuint fourcc(const char* s)
+{
+	return	GLuint(GLubyte(s[0])) | (GLuint(GLubyte(s[1])) << 8) |
+		(GLuint(GLubyte(s[2])) << 16) | (GLuint(GLubyte(s[3])) << 24);
+}
+
+static std::ptrdiff_t offset_of(
+	const oglplus::images::TextureContainer& tc,
+	GLsizei level,
+	GLsizei layer,
+	GLsizei face
+)
+{
+	return	static_cast<const unsigned char*>(tc.RawData(level, layer, face))-
+		static_cast<const unsigned char*>(tc.RawData(0, 0, 0));
+}
+
+static GLsizei load_container(const char* path)
+{
+	return oglplus::images::TextureContainer(path).Levels();
+}
+
+static const char* ktx_path = "test-images_container.ktx";
+static const char* dds_path = "test-images_container.dds";
+
+static unsigned rgb_value(unsigned level, unsigned x, unsigned y, unsigned c)
+{
+	return level*64+y*16+x*3+c;
+}
+
+BOOST_AUTO_TEST_CASE(images_Container_ktx_levels)
+{
+	using namespace oglplus;
+
+	ContainerBytes b;
+	ktx_header(b,
+		GL_UNSIGNED_BYTE, 1,
+		GL_RGB, GL_RGB8, GL_RGB,
+		5, 3, 0, 1, 3,
+		8
+	);
+	const unsigned w[3] = {5, 2, 1};
+	const unsigned h[3] = {3, 1, 1};
+	const unsigned row[3] = {16, 8, 4};
+	for(unsigned l=0; l!=3; ++l)
+	{
+		b.u32(row[l]*h[l]);
+		for(unsigned y=0; y!=h[l]; ++y)
+		{
+			for(unsigned x=0; x!=w[l]; ++x)
+			for(unsigned c=0; c!=3; ++c)
+			{
+				b.u8(rgb_value(l, x, y, c));
+			}
+			b.pad(4);
+		}
+	}
+	b.save(ktx_path);
+	{
+		images::TextureContainer tc(ktx_path);
+
+		BOOST_CHECK_EQUAL(tc.Levels(), 3);
+		BOOST_CHECK_EQUAL(tc.Layers(), 1);
+		BOOST_CHECK_EQUAL(tc.Faces(), 1);
+		BOOST_CHECK(!tc.IsArray());
+		BOOST_CHECK(!tc.IsCubeMap());
+		BOOST_CHECK(!tc.IsCompressed());
+		BOOST_CHECK_EQUAL(tc.RowAlignment(), 4);
+		BOOST_CHECK_EQUAL(GLsizei(tc.Channels()), 3);
+		BOOST_CHECK(tc.Type() == PixelDataType::UnsignedByte);
+		BOOST_CHECK(tc.Format() == PixelDataFormat::RGB);
+
+		// each level is preceded by its 4-byte imageSize
+		BOOST_CHECK_EQUAL(offset_of(tc, 1, 0, 0), 48+4);
+		BOOST_CHECK_EQUAL(offset_of(tc, 2, 0, 0), 48+4+8+4);
+
+		for(unsigned l=0; l!=3; ++l)
+		{
+			const GLsizei level = GLsizei(l);
+			BOOST_CHECK_EQUAL(GLsizei(tc.Width(level)), GLsizei(w[l]));
+			BOOST_CHECK_EQUAL(GLsizei(tc.Height(level)), GLsizei(h[l]));
+			BOOST_CHECK_EQUAL(GLsizei(tc.Depth(level)), 1);
+			BOOST_CHECK_EQUAL(
+				GLsizei(tc.DataSize(level)),
+				GLsizei(row[l]*h[l])
+			);
+			BOOST_CHECK_EQUAL(
+				GLsizei(tc.LevelDataSize(level)),
+				GLsizei(row[l]*h[l])
+			);
+
+			images::ImageView view = tc.View(level);
+			BOOST_CHECK_EQUAL(view.RowStride(), std::ptrdiff_t(row[l]));
+			for(unsigned y=0; y!=h[l]; ++y)
+			for(unsigned x=0; x!=w[l]; ++x)
+			for(unsigned c=0; c!=3; ++c)
+			{
+				BOOST_CHECK_EQUAL(
+					unsigned(view.ComponentAs<GLubyte>(
+						GLsizei(x), GLsizei(y), 0, GLsizei(c)
+					)),
+					rgb_value(l, x, y, c)
+				);
+			}
+		}
+	}
+	std::remove(ktx_path);
+}
+
+BOOST_AUTO_TEST_CASE(images_Container_ktx_array)
+{
+	using namespace oglplus;
+
+	ContainerBytes b;
+	ktx_header(b,
+		GL_UNSIGNED_BYTE, 1,
+		GL_RGBA, GL_RGBA8, GL_RGBA,
+		2, 2, 3, 1, 2
+	);
+	// the imageSize of arrays covers all layers of a level
+	const unsigned size[2] = {16, 4};
+	for(unsigned l=0; l!=2; ++l)
+	{
+		b.u32(size[l]*3);
+		for(unsigned layer=0; layer!=3; ++layer)
+		for(unsigned i=0; i!=size[l]; ++i)
+		{
+			b.u8(l*100+layer*20+i);
+		}
+	}
+	b.save(ktx_path);
+	{
+		images::TextureContainer tc(ktx_path);
+
+		BOOST_CHECK(tc.IsArray());
+		BOOST_CHECK_EQUAL(tc.Layers(), 3);
+		BOOST_CHECK_EQUAL(tc.Levels(), 2);
+		BOOST_CHECK_EQUAL(GLsizei(tc.LevelDataSize(0)), 48);
+		BOOST_CHECK_EQUAL(GLsizei(tc.LevelDataSize(1)), 12);
+
+		for(unsigned l=0; l!=2; ++l)
+		for(unsigned layer=0; layer!=3; ++layer)
+		{
+			const GLsizei level = GLsizei(l);
+			const GLsizei lr = GLsizei(layer);
+			BOOST_CHECK_EQUAL(
+				GLsizei(tc.DataSize(level, lr)),
+				GLsizei(size[l])
+			);
+			BOOST_CHECK_EQUAL(
+				offset_of(tc, level, lr, 0),
+				std::ptrdiff_t(l*(48+4)+layer*size[l])
+			);
+			const GLubyte* p = static_cast<const GLubyte*>(
+				tc.RawData(level, lr)
+			);
+			BOOST_CHECK_EQUAL(unsigned(p[0]), l*100+layer*20);
+			BOOST_CHECK_EQUAL(
+				unsigned(p[size[l]-1]),
+				l*100+layer*20+size[l]-1
+			);
+		}
+	}
+	std::remove(ktx_path);
+}
+
+BOOST_AUTO_TEST_CASE(images_Container_ktx_cube_map)
+{
+	using namespace oglplus;
+
+	ContainerBytes b;
+	ktx_header(b,
+		GL_UNSIGNED_BYTE, 1,
+		GL_RGB, GL_RGB8, GL_RGB,
+		1, 1, 0, 6, 1
+	);
+	// the imageSize of non-array cube maps is that of a single face
+	b.u32(4);
+	for(unsigned face=0; face!=6; ++face)
+	{
+		b.u8(face*10+0);
+		b.u8(face*10+1);
+		b.u8(face*10+2);
+		b.pad(4);
+	}
+	b.save(ktx_path);
+	{
+		images::TextureContainer tc(ktx_path);
+
+		BOOST_CHECK(tc.IsCubeMap());
+		BOOST_CHECK(!tc.IsArray());
+		BOOST_CHECK_EQUAL(tc.Faces(), 6);
+		BOOST_CHECK_EQUAL(GLsizei(tc.LevelDataSize(0)), 6*4);
+
+		for(unsigned face=0; face!=6; ++face)
+		{
+			const GLsizei f = GLsizei(face);
+			BOOST_CHECK_EQUAL(GLsizei(tc.DataSize(0, 0, f)), 4);
+			BOOST_CHECK_EQUAL(
+				offset_of(tc, 0, 0, f),
+				std::ptrdiff_t(face*4)
+			);
+			images::ImageView view = tc.View(0, 0, f);
+			for(unsigned c=0; c!=3; ++c)
+			{
+				BOOST_CHECK_EQUAL(
+					unsigned(view.ComponentAs<GLubyte>(
+						0, 0, 0, GLsizei(c)
+					)),
+					face*10+c
+				);
+			}
+		}
+	}
+	std::remove(ktx_path);
+}
+
+BOOST_AUTO_TEST_CASE(images_Container_ktx_big_endian)
+{
+	using namespace oglplus;
+
+	ContainerBytes b(true);
+	ktx_header(b,
+		GL_UNSIGNED_SHORT, 2,
+		GL_RED, GL_R16, GL_RED,
+		3, 2, 0, 1, 1
+	);
+	b.u32(2*8);
+	for(unsigned y=0; y!=2; ++y)
+	{
+		for(unsigned x=0; x!=3; ++x)
+		{
+			b.u16(0x1234+y*0x1000+x*0x0101);
+		}
+		b.pad(4);
+	}
+	b.save(ktx_path);
+	{
+		images::TextureContainer tc(ktx_path);
+
+		BOOST_CHECK_EQUAL(GLsizei(tc.Width()), 3);
+		BOOST_CHECK_EQUAL(GLsizei(tc.Height()), 2);
+		BOOST_CHECK_EQUAL(GLsizei(tc.DataSize(0)), 16);
+		BOOST_CHECK(tc.Type() == PixelDataType::UnsignedShort);
+
+		images::ImageView view = tc.View(0);
+		BOOST_CHECK_EQUAL(view.RowStride(), 8);
+		for(unsigned y=0; y!=2; ++y)
+		for(unsigned x=0; x!=3; ++x)
+		{
+			BOOST_CHECK_EQUAL(
+				unsigned(view.ComponentAs<GLushort>(
+					GLsizei(x), GLsizei(y), 0, 0
+				)),
+				0x1234+y*0x1000+x*0x0101
+			);
+		}
+	}
+	std::remove(ktx_path);
+}
+
+BOOST_AUTO_TEST_CASE(images_Container_ktx_compressed)
+{
+	using namespace oglplus;
+
+	ContainerBytes b;
+	ktx_header(b,
+		0, 1,
+		0, GL_COMPRESSED_RGBA_S3TC_DXT1_EXT, GL_RGBA,
+		8, 8, 0, 1, 2
+	);
+	b.u32(4*8);
+	for(unsigned i=0; i!=4*8; ++i) b.u8(i);
+	b.u32(8);
+	for(unsigned i=0; i!=8; ++i) b.u8(200+i);
+	b.save(ktx_path);
+	{
+		images::TextureContainer tc(ktx_path);
+
+		BOOST_CHECK(tc.IsCompressed());
+		BOOST_CHECK(
+			tc.InternalFormat() ==
+			PixelDataInternalFormat(GL_COMPRESSED_RGBA_S3TC_DXT1_EXT)
+		);
+		BOOST_CHECK_EQUAL(GLsizei(tc.DataSize(0)), 32);
+		BOOST_CHECK_EQUAL(GLsizei(tc.DataSize(1)), 8);
+		BOOST_CHECK_EQUAL(offset_of(tc, 1, 0, 0), 32+4);
+		BOOST_CHECK_EQUAL(
+			unsigned(static_cast<const GLubyte*>(tc.RawData(1))[0]),
+			200u
+		);
+		BOOST_CHECK_THROW(tc.View(0), std::runtime_error);
+	}
+	std::remove(ktx_path);
+}
+
+BOOST_AUTO_TEST_CASE(images_Container_dds_levels)
+{
+	using namespace oglplus;
+
+	ContainerBytes b;
+	dds_header(b, 3, 2, 2, 0x41, 0, 32, 0x000000FF, 0xFF000000, 0);
+	const unsigned w[2] = {3, 1};
+	const unsigned h[2] = {2, 1};
+	for(unsigned l=0; l!=2; ++l)
+	{
+		for(unsigned y=0; y!=h[l]; ++y)
+		for(unsigned x=0; x!=w[l]; ++x)
+		for(unsigned c=0; c!=4; ++c)
+		{
+			b.u8(l*64+y*16+x*4+c);
+		}
+	}
+	b.save(dds_path);
+	{
+		images::TextureContainer tc(dds_path);
+
+		BOOST_CHECK_EQUAL(tc.Levels(), 2);
+		BOOST_CHECK(!tc.IsCompressed());
+		BOOST_CHECK_EQUAL(tc.RowAlignment(), 1);
+		BOOST_CHECK_EQUAL(GLsizei(tc.Channels()), 4);
+		BOOST_CHECK(tc.Format() == PixelDataFormat::RGBA);
+		BOOST_CHECK(tc.InternalFormat() == PixelDataInternalFormat::RGBA8);
+
+		BOOST_CHECK_EQUAL(GLsizei(tc.DataSize(0)), 24);
+		BOOST_CHECK_EQUAL(GLsizei(tc.DataSize(1)), 4);
+		BOOST_CHECK_EQUAL(offset_of(tc, 1, 0, 0), 24);
+
+		for(unsigned l=0; l!=2; ++l)
+		{
+			images::ImageView view = tc.View(GLsizei(l));
+			// the rows of DDS images are tightly packed
+			BOOST_CHECK_EQUAL(view.RowStride(), std::ptrdiff_t(w[l]*4));
+			for(unsigned y=0; y!=h[l]; ++y)
+			for(unsigned x=0; x!=w[l]; ++x)
+			for(unsigned c=0; c!=4; ++c)
+			{
+				BOOST_CHECK_EQUAL(
+					unsigned(view.ComponentAs<GLubyte>(
+						GLsizei(x), GLsizei(y), 0, GLsizei(c)
+					)),
+					l*64+y*16+x*4+c
+				);
+			}
+		}
+	}
+	std::remove(dds_path);
+}
+
+BOOST_AUTO_TEST_CASE(images_Container_dds_cube_map)
+{
+	using namespace oglplus;
+
+	ContainerBytes b;
+	dds_header(b, 4, 4, 2, 0x4, fourcc("DXT1"), 0, 0, 0, 0xFE00);
+	// the images are stored face by face, each with all its levels
+	for(unsigned face=0; face!=6; ++face)
+	for(unsigned l=0; l!=2; ++l)
+	for(unsigned i=0; i!=8; ++i)
+	{
+		b.u8(face*16+l*8+i);
+	}
+	b.save(dds_path);
+	{
+		images::TextureContainer tc(dds_path);
+
+		BOOST_CHECK(tc.IsCompressed());
+		BOOST_CHECK(tc.IsCubeMap());
+		BOOST_CHECK(!tc.IsArray());
+		BOOST_CHECK_EQUAL(tc.Levels(), 2);
+		BOOST_CHECK_EQUAL(GLsizei(tc.LevelDataSize(0)), 6*8);
+
+		for(unsigned face=0; face!=6; ++face)
+		for(unsigned l=0; l!=2; ++l)
+		{
+			const GLsizei f = GLsizei(face);
+			const GLsizei level = GLsizei(l);
+			BOOST_CHECK_EQUAL(GLsizei(tc.DataSize(level, 0, f)), 8);
+			BOOST_CHECK_EQUAL(
+				offset_of(tc, level, 0, f),
+				std::ptrdiff_t(face*16+l*8)
+			);
+			BOOST_CHECK_EQUAL(
+				unsigned(static_cast<const GLubyte*>(
+					tc.RawData(level, 0, f)
+				)[0]),
+				face*16+l*8
+			);
+		}
+		BOOST_CHECK_THROW(tc.View(0), std::runtime_error);
+	}
+	std::remove(dds_path);
+}
+
+BOOST_AUTO_TEST_CASE(images_Container_dds_dx10_array)
+{
+	using namespace oglplus;
+
+	ContainerBytes b;
+	dds_header(b, 2, 2, 2, 0x4, fourcc("DX10"), 0, 0, 0, 0);
+	b.u32(61); // DXGI_FORMAT_R8_UNORM
+	b.u32(3);  // texture 2D
+	b.u32(0);
+	b.u32(2);
+	b.u32(0);
+	for(unsigned layer=0; layer!=2; ++layer)
+	{
+		for(unsigned i=0; i!=4; ++i) b.u8(layer*50+i);
+		b.u8(layer*50+40);
+	}
+	b.save(dds_path);
+	{
+		images::TextureContainer tc(dds_path);
+
+		BOOST_CHECK(tc.IsArray());
+		BOOST_CHECK_EQUAL(tc.Layers(), 2);
+		BOOST_CHECK_EQUAL(GLsizei(tc.Channels()), 1);
+		BOOST_CHECK(tc.Format() == PixelDataFormat::Red);
+
+		for(unsigned layer=0; layer!=2; ++layer)
+		{
+			const GLsizei lr = GLsizei(layer);
+			BOOST_CHECK_EQUAL(offset_of(tc, 0, lr, 0), layer*5);
+			BOOST_CHECK_EQUAL(offset_of(tc, 1, lr, 0), layer*5+4);
+
+			images::ImageView view = tc.View(0, lr);
+			BOOST_CHECK_EQUAL(
+				unsigned(view.ComponentAs<GLubyte>(1, 1, 0, 0)),
+				layer*50+3
+			);
+			BOOST_CHECK_EQUAL(
+				unsigned(tc.View(1, lr).ComponentAs<GLubyte>(0, 0, 0, 0)),
+				layer*50+40
+			);
+		}
+	}
+	std::remove(dds_path);
+}
+
+BOOST_AUTO_TEST_CASE(images_Container_errors)
+{
+	using namespace oglplus;
+
+	BOOST_CHECK_THROW(
+		load_container("test-images_container.none"),
+		std::runtime_error
+	);
+
+	ContainerBytes b;
+	ktx_header(b,
+		GL_UNSIGNED_BYTE, 1,
+		GL_RGBA, GL_RGBA8, GL_RGBA,
+		2, 2, 0, 1, 1
+	);
+	b.u32(16);
+	for(unsigned i=0; i!=16; ++i) b.u8(i);
+
+	// the data or the header of the only level is cut off
+	b.save(ktx_path, b.data.size()-1);
+	BOOST_CHECK_THROW(load_container(ktx_path), std::runtime_error);
+	b.save(ktx_path, 12+13*4+2);
+	BOOST_CHECK_THROW(load_container(ktx_path), std::runtime_error);
+	b.save(ktx_path, 40);
+	BOOST_CHECK_THROW(load_container(ktx_path), std::runtime_error);
+
+	// only 1 or 6 faces are supported
+	b.put32(12+10*4, 2);
+	b.save(ktx_path);
+	BOOST_CHECK_THROW(load_container(ktx_path), std::runtime_error);
+
+	// unknown magic
+	b.data[1] = 'X';
+	b.save(ktx_path);
+	BOOST_CHECK_THROW(load_container(ktx_path), std::runtime_error);
+	std::remove(ktx_path);
+
+	dds_header(b, 4, 4, 1, 0x4, fourcc("DXT1"), 0, 0, 0, 0);
+	for(unsigned i=0; i!=8; ++i) b.u8(i);
+	b.save(dds_path, b.data.size()-1);
+	BOOST_CHECK_THROW(load_container(dds_path), std::runtime_error);
+	b.save(dds_path, 100);
+	BOOST_CHECK_THROW(load_container(dds_path), std::runtime_error);
+
+	// unsupported pixel format
+	b.put32(84, fourcc("ABCD"));
+	b.save(dds_path);
+	BOOST_CHECK_THROW(load_container(dds_path), std::runtime_error);
+	std::remove(dds_path);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
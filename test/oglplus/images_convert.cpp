@@ -0,0 +1,321 @@
+/**
+ *  .file test/oglplus/images_convert.cpp
+ *  .brief Test case for the images::Convert function.
+ *
+ *  .author Matus Chochlik
+ *
+ *  Copyright 2011-2015 Matus Chochlik. Distributed under the Boost
+ *  Software License, Version 1.0. (See accompanying file
+ *  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE OGLPLUS_images_Convert
+#include <boost/test/unit_test.hpp>
+
+#include <oglplus/gl.hpp>
+#include <oglplus/images/convert.hpp>
+#include <oglplus/detail/half_float.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(images_Convert)
+
+static std::uint32_t next_random(std::uint32_t& state)
+{
+	state = state*1664525u+1013904223u;
+	return state;
+}
+
+// random positive floats with exponents in [min_exp, max_exp)
+static std::vector<GLfloat> random_floats(
+	std::size_t count,
+	int min_exp,
+	int max_exp
+)
+{
+	std::uint32_t state = 12345;
+	std::vector<GLfloat> result(count);
+	for(GLfloat& value : result)
+	{
+		const std::uint32_t r = next_random(state);
+		const float mantissa = 1.0f+float(r >> 9)/float(1 << 23);
+		const int exponent = min_exp+int((r >> 3) % unsigned(max_exp-min_exp));
+		value = std::ldexp(mantissa, exponent);
+	}
+	return result;
+}
+
+template <typename T>
+static oglplus::images::Image make_image(
+	const std::vector<T>& data,
+	GLsizei channels,
+	oglplus::PixelDataFormat format,
+	oglplus::PixelDataInternalFormat internal
+)
+{
+	return oglplus::images::Image(
+		GLsizei(data.size())/channels, 1, 1,
+		channels,
+		data.data(),
+		format,
+		internal
+	);
+}
+
+// converts the image both with and without the SIMD kernels
+static oglplus::images::Image convert_both(
+	const oglplus::images::ImageView& image,
+	oglplus::PixelDataType type,
+	oglplus::PixelDataFormat format,
+	oglplus::PixelDataInternalFormat internal
+)
+{
+	using namespace oglplus;
+	images::ConvertParams scalar;
+	scalar.vectorized = false;
+	images::Image a = images::Convert(image, type, format, internal);
+	images::Image b = images::Convert(image, type, format, internal, scalar);
+
+	BOOST_CHECK(a.Type() == type);
+	BOOST_CHECK_EQUAL(a.DataSize(), b.DataSize());
+	BOOST_CHECK(std::memcmp(a.RawData(), b.RawData(), a.DataSize()) == 0);
+	return a;
+}
+
+BOOST_AUTO_TEST_CASE(images_Convert_half)
+{
+	using namespace oglplus;
+	std::vector<GLfloat> values = random_floats(4099, -26, 17);
+	for(GLfloat& value : values)
+	{
+		if(&value-values.data() < 1024) value = -value;
+	}
+	const GLfloat special[] = {
+		0.0f, -0.0f, 1.0f, 65504.0f, 65519.0f, 65520.0f, 1e9f,
+		// halfway between two halves, rounded to the even one
+		1.0f+std::ldexp(1.0f, -11),
+		1.0f+3*std::ldexp(1.0f, -11),
+		// denormal halves
+		std::ldexp(1.0f, -24), 3*std::ldexp(1.0f, -25), 6e-5f
+	};
+	values.insert(values.end(), std::begin(special), std::end(special));
+
+	const images::Image half = convert_both(
+		make_image(values, 1, PixelDataFormat::Red, PixelDataInternalFormat::R32F),
+		PixelDataType::HalfFloat,
+		PixelDataFormat::Red,
+		PixelDataInternalFormat::R16F
+	);
+	const GLushort* h = static_cast<const GLushort*>(half.RawData());
+	for(std::size_t i=0; i!=values.size(); ++i)
+	{
+		BOOST_CHECK_EQUAL(h[i], oglplus::aux::FloatToHalf(values[i]));
+	}
+	const std::size_t n = values.size()-sizeof(special)/sizeof(special[0]);
+	BOOST_CHECK_EQUAL(h[n+0], 0x0000);
+	BOOST_CHECK_EQUAL(h[n+1], 0x8000);
+	BOOST_CHECK_EQUAL(h[n+2], 0x3C00);
+	BOOST_CHECK_EQUAL(h[n+3], 0x7BFF);
+	BOOST_CHECK_EQUAL(h[n+4], 0x7BFF);
+	BOOST_CHECK_EQUAL(h[n+5], 0x7C00);
+	BOOST_CHECK_EQUAL(h[n+6], 0x7C00);
+	BOOST_CHECK_EQUAL(h[n+7], 0x3C00);
+	BOOST_CHECK_EQUAL(h[n+8], 0x3C02);
+	BOOST_CHECK_EQUAL(h[n+9], 0x0001);
+	BOOST_CHECK_EQUAL(h[n+10], 0x0002);
+
+	// all finite halves survive the round trip
+	std::vector<GLushort> halves;
+	for(unsigned bits=0; bits!=0x10000; ++bits)
+	{
+		if((bits & 0x7C00) != 0x7C00) halves.push_back(GLushort(bits));
+	}
+	aux::AlignedPODArray storage(
+		static_cast<const GLushort*>(nullptr),
+		halves.size()
+	);
+	std::copy(halves.begin(), halves.end(), (GLushort*)storage.begin());
+	const images::Image source(
+		GLsizei(halves.size()), 1, 1, 1,
+		PixelDataType::HalfFloat,
+		std::move(storage),
+		PixelDataFormat::Red,
+		PixelDataInternalFormat::R16F
+	);
+	const images::Image floats = convert_both(
+		source,
+		PixelDataType::Float,
+		PixelDataFormat::Red,
+		PixelDataInternalFormat::R32F
+	);
+	const images::Image back = convert_both(
+		floats,
+		PixelDataType::HalfFloat,
+		PixelDataFormat::Red,
+		PixelDataInternalFormat::R16F
+	);
+	BOOST_CHECK(std::equal(
+		halves.begin(),
+		halves.end(),
+		static_cast<const GLushort*>(back.RawData())
+	));
+}
+
+BOOST_AUTO_TEST_CASE(images_Convert_rgb9e5)
+{
+	using namespace oglplus;
+	const std::vector<GLfloat> values = random_floats(3*1001, -12, 15);
+
+	const images::Image packed = convert_both(
+		make_image(values, 3, PixelDataFormat::RGB, PixelDataInternalFormat::RGB32F),
+		PixelDataType::UnsignedInt_5_9_9_9_Rev,
+		PixelDataFormat::RGB,
+		PixelDataInternalFormat::RGB9E5
+	);
+	const images::Image floats = convert_both(
+		packed,
+		PixelDataType::Float,
+		PixelDataFormat::RGB,
+		PixelDataInternalFormat::RGB32F
+	);
+	const GLfloat* f = floats.Data<GLfloat>();
+	for(std::size_t i=0; i!=values.size(); i+=3)
+	{
+		// the components share the exponent of the largest one
+		const float max = std::max(values[i], std::max(values[i+1], values[i+2]));
+		for(std::size_t c=0; c!=3; ++c)
+		{
+			BOOST_CHECK(std::fabs(f[i+c]-values[i+c]) <= max/256.0f);
+		}
+	}
+	// converting the unpacked values again gives the same bits
+	const images::Image again = convert_both(
+		floats,
+		PixelDataType::UnsignedInt_5_9_9_9_Rev,
+		PixelDataFormat::RGB,
+		PixelDataInternalFormat::RGB9E5
+	);
+	BOOST_CHECK(std::memcmp(
+		again.RawData(),
+		packed.RawData(),
+		packed.DataSize()
+	) == 0);
+}
+
+BOOST_AUTO_TEST_CASE(images_Convert_ufloat)
+{
+	using namespace oglplus;
+	// the normal range of the packed floats
+	const std::vector<GLfloat> values = random_floats(3*1001, -14, 15);
+
+	const images::Image packed = convert_both(
+		make_image(values, 3, PixelDataFormat::RGB, PixelDataInternalFormat::RGB32F),
+		PixelDataType::UnsignedInt_10f_11f_11f_Rev,
+		PixelDataFormat::RGB,
+		PixelDataInternalFormat::R11FG11FB10F
+	);
+	const images::Image floats = convert_both(
+		packed,
+		PixelDataType::Float,
+		PixelDataFormat::RGB,
+		PixelDataInternalFormat::RGB32F
+	);
+	const GLfloat* f = floats.Data<GLfloat>();
+	for(std::size_t i=0; i!=values.size(); ++i)
+	{
+		// 6 bits of mantissa for red and green, 5 for blue
+		const float tolerance = ((i%3 == 2)?std::ldexp(1.0f, -6):std::ldexp(1.0f, -7));
+		BOOST_CHECK(std::fabs(f[i]-values[i]) <= values[i]*tolerance);
+	}
+	const images::Image again = convert_both(
+		floats,
+		PixelDataType::UnsignedInt_10f_11f_11f_Rev,
+		PixelDataFormat::RGB,
+		PixelDataInternalFormat::R11FG11FB10F
+	);
+	BOOST_CHECK(std::memcmp(
+		again.RawData(),
+		packed.RawData(),
+		packed.DataSize()
+	) == 0);
+}
+
+BOOST_AUTO_TEST_CASE(images_Convert_rgb10a2)
+{
+	using namespace oglplus;
+	std::vector<GLubyte> values(4*256*3);
+	for(std::size_t i=0; i!=values.size(); ++i)
+	{
+		values[i] = GLubyte((i*7+i/4)%256);
+	}
+	const images::Image packed = convert_both(
+		make_image(values, 4, PixelDataFormat::RGBA, PixelDataInternalFormat::RGBA8),
+		PixelDataType::UnsignedInt_2_10_10_10_Rev,
+		PixelDataFormat::RGBA,
+		PixelDataInternalFormat::RGB10A2
+	);
+	const GLuint* p = static_cast<const GLuint*>(packed.RawData());
+	for(std::size_t i=0; i!=values.size()/4; ++i)
+	{
+		// the 10-bit components are exact multiples of the 8-bit ones
+		BOOST_CHECK_EQUAL((p[i] >>  0) & 0x3FF, (GLuint(values[i*4+0])*1023+127)/255);
+		BOOST_CHECK_EQUAL((p[i] >> 10) & 0x3FF, (GLuint(values[i*4+1])*1023+127)/255);
+		BOOST_CHECK_EQUAL((p[i] >> 20) & 0x3FF, (GLuint(values[i*4+2])*1023+127)/255);
+	}
+	const images::Image back = convert_both(
+		packed,
+		PixelDataType::UnsignedByte,
+		PixelDataFormat::RGBA,
+		PixelDataInternalFormat::RGBA8
+	);
+	const GLubyte* b = back.Data<GLubyte>();
+	for(std::size_t i=0; i!=values.size(); ++i)
+	{
+		if(i%4 == 3)
+		{
+			// 2-bit alpha
+			BOOST_CHECK_EQUAL(b[i], GLubyte(((values[i]*3+127)/255)*85));
+		}
+		else BOOST_CHECK_EQUAL(b[i], values[i]);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(images_Convert_srgb)
+{
+	using namespace oglplus;
+	std::vector<GLubyte> values(4*256);
+	for(std::size_t i=0; i!=values.size(); ++i)
+	{
+		values[i] = GLubyte(i/4);
+	}
+	const images::Image linear = convert_both(
+		make_image(values, 4, PixelDataFormat::RGBA, PixelDataInternalFormat::SRGB8Alpha8),
+		PixelDataType::Float,
+		PixelDataFormat::RGBA,
+		PixelDataInternalFormat::RGBA32F
+	);
+	const GLfloat* f = linear.Data<GLfloat>();
+	for(std::size_t i=0; i!=values.size(); ++i)
+	{
+		const double s = values[i]/255.0;
+		double expected = s;
+		if(i%4 != 3)
+		{
+			expected = (s <= 0.04045)?s/12.92:std::pow((s+0.055)/1.055, 2.4);
+		}
+		BOOST_CHECK(std::fabs(f[i]-expected) <= 1e-5);
+	}
+	const images::Image back = convert_both(
+		linear,
+		PixelDataType::UnsignedByte,
+		PixelDataFormat::RGBA,
+		PixelDataInternalFormat::SRGB8Alpha8
+	);
+	BOOST_CHECK(std::equal(values.begin(), values.end(), back.Data<GLubyte>()));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
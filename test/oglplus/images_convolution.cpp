@@ -0,0 +1,168 @@
+/**
+ *  .file test/oglplus/images_convolution.cpp
+ *  .brief Test case for the SeparableConvolution image filter.
+ *
+ *  .author Matus Chochlik
+ *
+ *  Copyright 2011-2015 Matus Chochlik. Distributed under the Boost
+ *  Software License, Version 1.0. (See accompanying file
+ *  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE OGLPLUS_images_Convolution
+#include <boost/test/unit_test.hpp>
+
+#include <oglplus/gl.hpp>
+#include <oglplus/images/convolution.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(images_Convolution)
+
+static oglplus::images::Image make_input(
+	GLsizei w,
+	GLsizei h,
+	GLsizei d,
+	GLsizei c
+)
+{
+	using namespace oglplus;
+	std::vector<GLfloat> data(std::size_t(w*h*d*c));
+	for(std::size_t i=0; i!=data.size(); ++i)
+	{
+		data[i] = GLfloat((i*7919+13)%101)/100.0f;
+	}
+	const PixelDataFormat format = (c == 1)?
+		PixelDataFormat::Red:
+		PixelDataFormat::RGB;
+	const PixelDataInternalFormat internal = (c == 1)?
+		PixelDataInternalFormat::R32F:
+		PixelDataInternalFormat::RGB32F;
+	return images::Image(w, h, d, c, data.data(), format, internal);
+}
+
+static std::ptrdiff_t edge(std::ptrdiff_t pos, std::ptrdiff_t size, bool repeat)
+{
+	if(repeat) return ((pos % size)+size) % size;
+	if(pos < 0) return 0;
+	if(pos >= size) return size-1;
+	return pos;
+}
+
+// convolves the data along one axis in double precision
+static void naive_axis(
+	std::vector<double>& data,
+	const std::ptrdiff_t dims[4],
+	int axis,
+	const std::vector<GLfloat>& weights,
+	bool repeat
+)
+{
+	const std::ptrdiff_t r = std::ptrdiff_t(weights.size()/2);
+	const std::vector<double> src(data);
+	std::ptrdiff_t p[3];
+	for(p[2]=0; p[2]!=dims[2]; ++p[2])
+	for(p[1]=0; p[1]!=dims[1]; ++p[1])
+	for(p[0]=0; p[0]!=dims[0]; ++p[0])
+	for(std::ptrdiff_t c=0; c!=dims[3]; ++c)
+	{
+		double sum = 0.0;
+		for(std::ptrdiff_t k=-r; k<=r; ++k)
+		{
+			std::ptrdiff_t q[3] = {p[0], p[1], p[2]};
+			q[axis] = edge(p[axis]+k, dims[axis], repeat);
+			const std::ptrdiff_t i = ((q[2]*dims[1]+q[1])*dims[0]+q[0])*dims[3]+c;
+			sum += weights[std::size_t(k+r)]*src[std::size_t(i)];
+		}
+		data[std::size_t(((p[2]*dims[1]+p[1])*dims[0]+p[0])*dims[3]+c)] = sum;
+	}
+}
+
+static void check_convolution(
+	GLsizei w,
+	GLsizei h,
+	GLsizei d,
+	GLsizei c,
+	const oglplus::images::ConvolutionKernel& kx,
+	const oglplus::images::ConvolutionKernel& ky,
+	const oglplus::images::ConvolutionKernel& kz
+)
+{
+	using namespace oglplus;
+	const images::Image input = make_input(w, h, d, c);
+	const std::ptrdiff_t dims[4] = {w, h, d, c};
+
+	for(int repeat=0; repeat!=2; ++repeat)
+	{
+		std::vector<double> expected(
+			input.Data<GLfloat>(),
+			input.Data<GLfloat>()+w*h*d*c
+		);
+		naive_axis(expected, dims, 0, kx.Weights(), repeat != 0);
+		naive_axis(expected, dims, 1, ky.Weights(), repeat != 0);
+		if(d > 1) naive_axis(expected, dims, 2, kz.Weights(), repeat != 0);
+
+		for(int vectorized=0; vectorized!=2; ++vectorized)
+		{
+			images::ConvolutionParams params;
+			params.repeat = (repeat != 0);
+			params.vectorized = (vectorized != 0);
+			const images::SeparableConvolution result(input, kx, ky, kz, params);
+
+			BOOST_CHECK_EQUAL(GLsizei(result.Width()), w);
+			BOOST_CHECK_EQUAL(GLsizei(result.Height()), h);
+			BOOST_CHECK_EQUAL(GLsizei(result.Depth()), d);
+			BOOST_CHECK_EQUAL(GLsizei(result.Channels()), c);
+
+			const GLfloat* data = result.Data<GLfloat>();
+			double max_error = 0.0;
+			for(std::size_t i=0; i!=expected.size(); ++i)
+			{
+				max_error = std::max(
+					max_error,
+					std::fabs(data[i]-expected[i])
+				);
+			}
+			BOOST_CHECK(max_error < 1e-5);
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(images_Convolution_gaussian)
+{
+	using namespace oglplus;
+	const images::ConvolutionKernel k = images::ConvolutionKernel::Gaussian(1.5f);
+	check_convolution(37, 23, 1, 3, k, k, k);
+	check_convolution(13, 11, 9, 1, k, k, k);
+}
+
+BOOST_AUTO_TEST_CASE(images_Convolution_box)
+{
+	using namespace oglplus;
+	// the small boxes are evaluated directly, the large by a running sum
+	const images::ConvolutionKernel small = images::ConvolutionKernel::Box(1);
+	const images::ConvolutionKernel large = images::ConvolutionKernel::Box(4);
+	check_convolution(37, 23, 1, 3, large, small, large);
+	check_convolution(13, 11, 9, 1, small, large, large);
+}
+
+BOOST_AUTO_TEST_CASE(images_Convolution_asymmetric)
+{
+	using namespace oglplus;
+	std::vector<GLfloat> weights;
+	weights.push_back(0.10f);
+	weights.push_back(0.20f);
+	weights.push_back(0.30f);
+	weights.push_back(0.25f);
+	weights.push_back(0.15f);
+	const images::ConvolutionKernel k(weights);
+	const images::ConvolutionKernel id = images::ConvolutionKernel::Identity();
+	check_convolution(37, 23, 1, 3, k, id, id);
+	check_convolution(13, 11, 9, 1, id, k, k);
+	// a kernel wider than the image
+	check_convolution(3, 2, 1, 1, images::ConvolutionKernel::Gaussian(2.0f), k, id);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
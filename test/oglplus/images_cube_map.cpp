@@ -0,0 +1,171 @@
+/**
+ *  .file test/oglplus/images_cube_map.cpp
+ *  .brief Test case for the cube map image generators.
+ *
+ *  .author Matus Chochlik
+ *
+ *  Copyright 2011-2015 Matus Chochlik. Distributed under the Boost
+ *  Software License, Version 1.0. (See accompanying file
+ *  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE OGLPLUS_images_CubeMap
+#include <boost/test/unit_test.hpp>
+
+#include <oglplus/gl.hpp>
+#include <oglplus/images/cube_map.hpp>
+#include <oglplus/images/convert.hpp>
+
+#include <cstring>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(images_CubeMap)
+
+static oglplus::images::Image make_cube_map(GLsizei size)
+{
+	using namespace oglplus;
+	aux::AlignedPODArray storage(
+		static_cast<const GLfloat*>(nullptr),
+		std::size_t(size*size*6*4)
+	);
+	GLfloat* data = static_cast<GLfloat*>(storage.begin());
+	for(std::size_t i=0; i!=storage.size()/sizeof(GLfloat); ++i)
+	{
+		data[i] = GLfloat((i*37+11)%97)/96.0f;
+	}
+	return images::Image(
+		size, size, 6, 4,
+		PixelDataType::Float,
+		std::move(storage),
+		PixelDataFormat::RGBA,
+		PixelDataInternalFormat::RGBA32F
+	);
+}
+
+static oglplus::images::Image make_panorama(GLsizei width, GLsizei height)
+{
+	using namespace oglplus;
+	std::vector<GLfloat> data(std::size_t(width*height*4));
+	for(std::size_t i=0; i!=data.size(); ++i)
+	{
+		data[i] = GLfloat((i*7919+13)%101)/50.0f;
+	}
+	return images::Image(
+		width, height, 1, 4,
+		data.data(),
+		PixelDataFormat::RGBA,
+		PixelDataInternalFormat::RGBA32F
+	);
+}
+
+static void check_same(
+	const oglplus::images::Image& a,
+	const oglplus::images::Image& b
+)
+{
+	BOOST_CHECK_EQUAL(GLsizei(a.Width()), GLsizei(b.Width()));
+	BOOST_CHECK_EQUAL(GLsizei(a.Height()), GLsizei(b.Height()));
+	BOOST_CHECK_EQUAL(GLsizei(a.Depth()), GLsizei(b.Depth()));
+	BOOST_CHECK_EQUAL(a.DataSize(), b.DataSize());
+	BOOST_CHECK(std::memcmp(a.RawData(), b.RawData(), a.DataSize()) == 0);
+}
+
+BOOST_AUTO_TEST_CASE(images_CubeMap_from_equirect_vectorized)
+{
+	using namespace oglplus;
+	const images::Image panorama = make_panorama(64, 32);
+	const images::Image rgb = images::Convert(
+		panorama,
+		PixelDataType::UnsignedByte,
+		PixelDataFormat::RGB
+	);
+
+	for(int sampling=0; sampling!=2; ++sampling)
+	{
+		images::CubeMapParams params;
+		params.sampling = (sampling == 0)?
+			images::CubeMapSampling::Bilinear:
+			images::CubeMapSampling::Bicubic;
+		images::CubeMapParams scalar(params);
+		scalar.vectorized = false;
+
+		// the face size is not a multiple of the SIMD lanes
+		const images::CubeMapFromEquirect a(panorama, 13, params);
+		const images::CubeMapFromEquirect b(panorama, 13, scalar);
+		BOOST_CHECK_EQUAL(GLsizei(a.Depth()), 6);
+		check_same(a, b);
+
+		check_same(
+			images::CubeMapFromEquirect(rgb, 16, params),
+			images::CubeMapFromEquirect(rgb, 16, scalar)
+		);
+		check_same(
+			images::EquirectFromCubeMap(a, 30, 15, params),
+			images::EquirectFromCubeMap(a, 30, 15, scalar)
+		);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(images_CubeMap_prefiltered_half_cache)
+{
+	using namespace oglplus;
+	const images::Image cube_map = images::Convert(
+		make_cube_map(16),
+		PixelDataType::HalfFloat,
+		PixelDataFormat::RGBA,
+		PixelDataInternalFormat::RGBA16F
+	);
+	images::CubeMapParams params;
+	params.samples = 8;
+	params.max_levels = 3;
+
+	const images::ImageCache cache(".", "test-images_cube_map");
+
+	// the keys under which PrefilteredCubeMap stores its levels
+	images::ImageCacheKey key("oglplus::images::PrefilteredCubeMap");
+	key.Add(cube_map).Add(GLsizei(3)).Add(params.samples);
+	const images::ImageCacheKey key1 = images::ImageCacheKey(key).Add(1);
+	const images::ImageCacheKey key2 = images::ImageCacheKey(key).Add(2);
+	cache.Remove(key1);
+	cache.Remove(key2);
+
+	images::PrefilteredCubeMap first(cube_map, cache, params);
+	BOOST_CHECK_EQUAL(first.Levels(), 3u);
+	BOOST_CHECK(first.Level(1).Type() == PixelDataType::HalfFloat);
+	BOOST_CHECK(cache.Contains(key1));
+	BOOST_CHECK(cache.Contains(key2));
+
+	// replace a cached level to see that it is not computed again
+	const images::Image& level = first.Level(1);
+	oglplus::aux::AlignedPODArray storage(
+		static_cast<const GLushort*>(nullptr),
+		level.DataSize()/sizeof(GLushort)
+	);
+	storage.fill(0x3C);
+	const images::Image marker(
+		level.Width(), level.Height(), level.Depth(), level.Channels(),
+		PixelDataType::HalfFloat,
+		std::move(storage),
+		level.Format(),
+		level.InternalFormat()
+	);
+	BOOST_CHECK(cache.Store(key1, marker));
+
+	images::PrefilteredCubeMap second(cube_map, cache, params);
+	BOOST_CHECK_EQUAL(second.Levels(), 3u);
+	BOOST_CHECK(std::memcmp(
+		second.Level(1).RawData(),
+		marker.RawData(),
+		marker.DataSize()
+	) == 0);
+	BOOST_CHECK(std::memcmp(
+		second.Level(2).RawData(),
+		first.Level(2).RawData(),
+		first.Level(2).DataSize()
+	) == 0);
+
+	BOOST_CHECK(cache.Remove(key1));
+	BOOST_CHECK(cache.Remove(key2));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,155 @@
+/**
+ *  .file test/oglplus/images_distance_field.cpp
+ *  .brief Test case for the DistanceField image generator.
+ *
+ *  .author Matus Chochlik
+ *
+ *  Copyright 2011-2015 Matus Chochlik. Distributed under the Boost
+ *  Software License, Version 1.0. (See accompanying file
+ *  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE OGLPLUS_images_DistanceField
+#include <boost/test/unit_test.hpp>
+
+#include <oglplus/gl.hpp>
+#include <oglplus/images/distance_field.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(images_DistanceField)
+
+// a binary mask with a few shapes
+static std::vector<GLubyte> make_mask(GLsizei w, GLsizei h, GLsizei d)
+{
+	std::vector<GLubyte> mask(std::size_t(w*h*d));
+	for(GLsizei z=0; z!=d; ++z)
+	for(GLsizei y=0; y!=h; ++y)
+	for(GLsizei x=0; x!=w; ++x)
+	{
+		const GLsizei dx = x-w/3, dy = y-h/2-z;
+		const bool disc = dx*dx+dy*dy < (w*w)/25;
+		const bool box = (x > w/2) && (x < w-3) && (y > 2) && (y < h/3+z);
+		mask[std::size_t((z*h+y)*w+x)] = (disc || box)?255:0;
+	}
+	return mask;
+}
+
+// the signed distance of each texel from the nearest texel
+// on the other side of the edge, shifted to the edge
+static std::vector<double> naive_distances(
+	const std::vector<GLubyte>& mask,
+	GLsizei w,
+	GLsizei h,
+	GLsizei d
+)
+{
+	const double max_dist = std::sqrt(double(w*w+h*h));
+	std::vector<double> result(mask.size());
+	for(GLsizei z=0; z!=d; ++z)
+	for(GLsizei y=0; y!=h; ++y)
+	for(GLsizei x=0; x!=w; ++x)
+	{
+		const std::size_t i = std::size_t((z*h+y)*w+x);
+		const bool inside = mask[i] != 0;
+		double min_dist2 = std::numeric_limits<double>::max();
+		for(GLsizei v=0; v!=h; ++v)
+		for(GLsizei u=0; u!=w; ++u)
+		{
+			const std::size_t j = std::size_t((z*h+v)*w+u);
+			if((mask[j] != 0) == inside) continue;
+			const double d2 = double((u-x)*(u-x)+(v-y)*(v-y));
+			if(min_dist2 > d2) min_dist2 = d2;
+		}
+		const double dist = std::min(std::sqrt(min_dist2), max_dist);
+		result[i] = inside?dist-0.5:0.5-dist;
+	}
+	return result;
+}
+
+static void check_distance_field(GLsizei w, GLsizei h, GLsizei d, GLsizei ds)
+{
+	using namespace oglplus;
+	const std::vector<GLubyte> mask = make_mask(w, h, d);
+	const std::vector<double> expected = naive_distances(mask, w, h, d);
+
+	const images::Image input(
+		w, h, d, 1,
+		mask.data(),
+		PixelDataFormat::Red,
+		PixelDataInternalFormat::R8
+	);
+	images::DistanceFieldParams params;
+	params.downsample = ds;
+	params.floating = true;
+	const images::DistanceField field(input, params);
+
+	const GLsizei ow = (w+ds-1)/ds, oh = (h+ds-1)/ds;
+	BOOST_CHECK_EQUAL(GLsizei(field.Width()), ow);
+	BOOST_CHECK_EQUAL(GLsizei(field.Height()), oh);
+	BOOST_CHECK_EQUAL(GLsizei(field.Depth()), d);
+
+	// the distances are averaged over the blocks and scaled
+	const GLfloat* data = field.Data<GLfloat>();
+	for(GLsizei z=0; z!=d; ++z)
+	for(GLsizei oy=0; oy!=oh; ++oy)
+	for(GLsizei ox=0; ox!=ow; ++ox)
+	{
+		double sum = 0.0;
+		GLsizei n = 0;
+		for(GLsizei y=oy*ds; y!=std::min((oy+1)*ds, h); ++y)
+		for(GLsizei x=ox*ds; x!=std::min((ox+1)*ds, w); ++x)
+		{
+			sum += expected[std::size_t((z*h+y)*w+x)];
+			++n;
+		}
+		const double value = sum/double(n*ds);
+		const GLfloat result = data[(z*oh+oy)*ow+ox];
+		BOOST_CHECK(std::fabs(result-value) < 1e-4);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(images_DistanceField_exact)
+{
+	check_distance_field(41, 29, 1, 1);
+	check_distance_field(23, 17, 3, 1);
+}
+
+BOOST_AUTO_TEST_CASE(images_DistanceField_downsampled)
+{
+	check_distance_field(41, 29, 1, 2);
+	check_distance_field(48, 32, 1, 4);
+}
+
+BOOST_AUTO_TEST_CASE(images_DistanceField_bytes)
+{
+	using namespace oglplus;
+	const GLsizei w = 41, h = 29;
+	const std::vector<GLubyte> mask = make_mask(w, h, 1);
+	const std::vector<double> expected = naive_distances(mask, w, h, 1);
+	const images::Image input(
+		w, h, 1, 1,
+		mask.data(),
+		PixelDataFormat::Red,
+		PixelDataInternalFormat::R8
+	);
+	images::DistanceFieldParams params;
+	params.spread = 3.0f;
+	const images::DistanceField field(input, params);
+
+	// the edge is at 0.5 and spread texels map to the range ends
+	const GLubyte* data = field.Data<GLubyte>();
+	for(std::size_t i=0; i!=expected.size(); ++i)
+	{
+		const double value = std::max(0.0, std::min(
+			0.5+expected[i]*0.5/3.0,
+			1.0
+		));
+		BOOST_CHECK(std::fabs(data[i]-value*255.0) <= 0.51);
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
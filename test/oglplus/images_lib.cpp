@@ -0,0 +1,155 @@
+/**
+ *  .file test/oglplus/images_lib.cpp
+ *  .brief Test case for the image functions linked from the library.
+ *
+ *  .author Matus Chochlik
+ *
+ *  Copyright 2011-2015 Matus Chochlik. Distributed under the Boost
+ *  Software License, Version 1.0. (See accompanying file
+ *  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE OGLPLUS_images_Lib
+#include <boost/test/unit_test.hpp>
+
+// this test is built with OGLPLUS_LINK_LIBRARY and pulls objects
+// from all the image related translation units of the library,
+// so that a function implemented in more than one of them makes
+// the linking fail
+#include <oglplus/gl.hpp>
+#include <oglplus/images/xpm.hpp>
+#include <oglplus/images/random.hpp>
+#include <oglplus/images/cache.hpp>
+#include <oglplus/images/convert.hpp>
+#include <oglplus/images/cube_map.hpp>
+#include <oglplus/opt/resources.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#if !(defined(WIN32) || defined(_WIN32) || defined(WIN64) || defined(_WIN64))
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+BOOST_AUTO_TEST_SUITE(images_Lib)
+
+BOOST_AUTO_TEST_CASE(images_Lib_xpm)
+{
+	using namespace oglplus;
+	const std::string xpm =
+		"! XPM2\n"
+		"2 2 2 1\n"
+		"  c #000000\n"
+		". c #FF0000\n"
+		" .\n"
+		". \n";
+	const images::XPMImage image(xpm.data(), xpm.size());
+	BOOST_CHECK_EQUAL(GLsizei(image.Width()), 2);
+	BOOST_CHECK_EQUAL(GLsizei(image.Height()), 2);
+}
+
+BOOST_AUTO_TEST_CASE(images_Lib_cache)
+{
+	using namespace oglplus;
+	const images::ImageCache cache(".", "test-images_lib");
+	const images::ImageCacheKey key = images::ImageCacheKey("RandomRedUByte")
+		.Add(16).Add(8).Add(images::RandomSeed(3));
+	cache.Remove(key);
+
+	const images::RandomRedUByte random(16, 8, 1, images::RandomSeed(3));
+	BOOST_CHECK(cache.Store(key, random));
+	const images::Image cached = cache.Get(
+		key,
+		[](void) -> images::Image
+		{
+			BOOST_ERROR("The image should be loaded from the cache");
+			return images::RandomRedUByte(1);
+		}
+	);
+	BOOST_CHECK_EQUAL(cached.DataSize(), random.DataSize());
+	BOOST_CHECK(std::memcmp(
+		cached.RawData(),
+		random.RawData(),
+		random.DataSize()
+	) == 0);
+	BOOST_CHECK(cache.Remove(key));
+}
+
+BOOST_AUTO_TEST_CASE(images_Lib_cube_map)
+{
+	using namespace oglplus;
+	const images::Image panorama = images::Convert(
+		images::RandomRedUByte(32, 16, 1, images::RandomSeed(5)),
+		PixelDataType::Float,
+		PixelDataFormat::RGBA
+	);
+	const images::CubeMapFromEquirect cube_map(panorama, 8);
+	BOOST_CHECK_EQUAL(GLsizei(cube_map.Width()), 8);
+	BOOST_CHECK_EQUAL(GLsizei(cube_map.Depth()), 6);
+}
+
+BOOST_AUTO_TEST_CASE(images_Lib_resources)
+{
+	using namespace oglplus;
+	// opt.cpp uses AlignedPODArray too
+	std::ifstream file;
+	const char* exts[] = {".none"};
+	BOOST_CHECK_EQUAL(
+		aux::FindResourceFile(file, "images_lib_missing", exts, 1),
+		1u
+	);
+}
+
+#if !(defined(WIN32) || defined(_WIN32) || defined(WIN64) || defined(_WIN64))
+static void remove_resource_test_files(void)
+{
+	::unlink("images_lib_res/sub/loop");
+	::unlink("images_lib_res/sub/a.txt");
+	::unlink("images_lib_res/b.txt");
+	::rmdir("images_lib_res/sub");
+	::rmdir("images_lib_res");
+}
+
+BOOST_AUTO_TEST_CASE(images_Lib_resource_index)
+{
+	using namespace oglplus;
+
+	remove_resource_test_files();
+	BOOST_REQUIRE(::mkdir("images_lib_res", 0755) == 0);
+	BOOST_REQUIRE(::mkdir("images_lib_res/sub", 0755) == 0);
+	std::ofstream("images_lib_res/sub/a.txt") << "a";
+	// a link to a file and a link to a directory forming a cycle
+	BOOST_REQUIRE(::symlink("sub/a.txt", "images_lib_res/b.txt") == 0);
+	BOOST_REQUIRE(::symlink("..", "images_lib_res/sub/loop") == 0);
+
+	std::vector<std::string> files;
+	ResourceIndex::ListFiles("images_lib_res", files);
+	std::sort(files.begin(), files.end());
+	BOOST_REQUIRE_EQUAL(files.size(), 2u);
+	BOOST_CHECK_EQUAL(files[0], "b.txt");
+	BOOST_CHECK_EQUAL(files[1], "sub/a.txt");
+
+	const char* exts[] = {".txt"};
+	std::string found;
+	BOOST_CHECK_EQUAL(
+		FindResourceFile(found, "images_lib_res", "sub/a", exts, 1),
+		0u
+	);
+	// the indexed file is removed, so the stale index entry is ignored
+	::unlink("images_lib_res/sub/a.txt");
+	BOOST_CHECK_EQUAL(
+		FindResourceFile(found, "images_lib_res", "sub/a", exts, 1),
+		1u
+	);
+
+	ResourceIndex::Global().Refresh();
+	remove_resource_test_files();
+}
+#endif
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,312 @@
+/**
+ *  .file test/oglplus/images_mipmap.cpp
+ *  .brief Test case for the mipmap chain generator.
+ *
+ *  .author Matus Chochlik
+ *
+ *  Copyright 2011-2015 Matus Chochlik. Distributed under the Boost
+ *  Software License, Version 1.0. (See accompanying file
+ *  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE OGLPLUS_images_Mipmap
+#include <boost/test/unit_test.hpp>
+
+#include <oglplus/gl.hpp>
+#include <oglplus/images/mipmap.hpp>
+
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(images_Mipmap)
+
+static oglplus::PixelDataFormat mipmap_format(GLsizei channels)
+{
+	using oglplus::PixelDataFormat;
+	switch(channels)
+	{
+		case 1: return PixelDataFormat::Red;
+		case 2: return PixelDataFormat::RG;
+		case 3: return PixelDataFormat::RGB;
+		default:;
+	}
+	return PixelDataFormat::RGBA;
+}
+
+template <typename T>
+static oglplus::images::ImageView make_view(
+	GLsizei width,
+	GLsizei height,
+	GLsizei channels,
+	const std::vector<T>& data
+)
+{
+	BOOST_REQUIRE_EQUAL(data.size(), std::size_t(width*height*channels));
+	return oglplus::images::ImageView(
+		width, height, 1, channels,
+		data.data(),
+		mipmap_format(channels),
+		oglplus::PixelDataInternalFormat(GLenum(mipmap_format(channels)))
+	);
+}
+
+BOOST_AUTO_TEST_CASE(images_Mipmap_level_sizes)
+{
+	using namespace oglplus;
+	using namespace oglplus::images;
+
+	BOOST_CHECK_EQUAL(MipmapChain::FullLevelCount(1, 1), 1u);
+	BOOST_CHECK_EQUAL(MipmapChain::FullLevelCount(16, 16), 5u);
+	BOOST_CHECK_EQUAL(MipmapChain::FullLevelCount(13, 6), 4u);
+	BOOST_CHECK_EQUAL(MipmapChain::FullLevelCount(1, 40), 6u);
+
+	std::vector<GLubyte> data(13*6*3, 0x80);
+	const MipmapChain chain(make_view(13, 6, 3, data));
+	BOOST_REQUIRE_EQUAL(chain.Levels(), 4u);
+	const GLsizei sizes[4][2] = {{13, 6}, {6, 3}, {3, 1}, {1, 1}};
+	for(std::size_t l=0; l!=chain.Levels(); ++l)
+	{
+		const Image& level = chain.Level(l);
+		BOOST_CHECK_EQUAL(GLsizei(level.Width()), sizes[l][0]);
+		BOOST_CHECK_EQUAL(GLsizei(level.Height()), sizes[l][1]);
+		BOOST_CHECK_EQUAL(GLsizei(level.Depth()), 1);
+		BOOST_CHECK_EQUAL(GLsizei(level.Channels()), 3);
+		BOOST_CHECK(level.Type() == PixelDataType::UnsignedByte);
+		BOOST_CHECK(level.Format() == PixelDataFormat::RGB);
+	}
+
+	MipmapParams params;
+	params.max_levels = 2;
+	BOOST_CHECK_EQUAL(MipmapChain(make_view(13, 6, 3, data), params).Levels(), 2u);
+	params.max_levels = 10;
+	BOOST_CHECK_EQUAL(MipmapChain(make_view(13, 6, 3, data), params).Levels(), 4u);
+
+	std::vector<GLfloat> tall(1*40);
+	const MipmapChain tall_chain(make_view(1, 40, 1, tall));
+	BOOST_REQUIRE_EQUAL(tall_chain.Levels(), 6u);
+	BOOST_CHECK_EQUAL(GLsizei(tall_chain.Level(5).Width()), 1);
+	BOOST_CHECK_EQUAL(GLsizei(tall_chain.Level(5).Height()), 1);
+}
+
+BOOST_AUTO_TEST_CASE(images_Mipmap_level_zero)
+{
+	using namespace oglplus;
+	using namespace oglplus::images;
+	// level 0 is a tightly packed copy of a view with padded rows
+	std::vector<GLushort> data(5*4*2);
+	for(std::size_t i=0; i!=data.size(); ++i) data[i] = GLushort(i*997);
+	const ImageView view(
+		2, 4, 1, 4,
+		data.data(),
+		PixelDataFormat::RGBA,
+		PixelDataInternalFormat::RGBA16,
+		std::ptrdiff_t(10*sizeof(GLushort))
+	);
+	const MipmapChain chain(view);
+	const Image& level = chain.Level(0);
+	BOOST_CHECK(level.Type() == PixelDataType::UnsignedShort);
+	const GLushort* p = level.Data<GLushort>();
+	for(std::size_t y=0; y!=4; ++y)
+	for(std::size_t i=0; i!=8; ++i)
+	{
+		BOOST_CHECK_EQUAL(p[y*8+i], data[y*10+i]);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(images_Mipmap_box)
+{
+	using namespace oglplus;
+	using namespace oglplus::images;
+	// the box filter averages 2x2 blocks of pixels
+	std::vector<GLfloat> data(4*4*2);
+	for(std::size_t i=0; i!=data.size(); ++i) data[i] = GLfloat(i*i);
+	const MipmapChain chain(make_view(4, 4, 2, data));
+	BOOST_REQUIRE_EQUAL(chain.Levels(), 3u);
+
+	const GLfloat* l1 = chain.Level(1).Data<GLfloat>();
+	for(std::size_t y=0; y!=2; ++y)
+	for(std::size_t x=0; x!=2; ++x)
+	for(std::size_t c=0; c!=2; ++c)
+	{
+		float sum = 0.0f;
+		for(std::size_t j=0; j!=2; ++j)
+		for(std::size_t i=0; i!=2; ++i)
+		{
+			sum += data[((y*2+j)*4+x*2+i)*2+c];
+		}
+		BOOST_CHECK_CLOSE(l1[(y*2+x)*2+c], sum/4, 1e-4);
+	}
+	const GLfloat* l2 = chain.Level(2).Data<GLfloat>();
+	for(std::size_t c=0; c!=2; ++c)
+	{
+		float sum = 0.0f;
+		for(std::size_t p=0; p!=16; ++p) sum += data[p*2+c];
+		BOOST_CHECK_CLOSE(l2[c], sum/16, 1e-4);
+	}
+
+	// integer values are rounded
+	std::vector<GLubyte> bytes = {10, 11, 20, 200};
+	const MipmapChain byte_chain(make_view(2, 2, 1, bytes));
+	BOOST_CHECK_EQUAL(int(byte_chain.Level(1).Data<GLubyte>()[0]), 60);
+}
+
+BOOST_AUTO_TEST_CASE(images_Mipmap_constant)
+{
+	using namespace oglplus::images;
+	// the weights of all filters are normalized
+	const MipmapFilter filters[] = {
+		MipmapFilter::Box,
+		MipmapFilter::Kaiser,
+		MipmapFilter::Lanczos
+	};
+	std::vector<GLubyte> data(21*10*4);
+	for(std::size_t i=0; i!=data.size(); ++i)
+	{
+		data[i] = GLubyte(40+(i%4)*50);
+	}
+	for(MipmapFilter filter : filters)
+	{
+		MipmapParams params;
+		params.filter = filter;
+		params.max_threads = 2;
+		const MipmapChain chain(make_view(21, 10, 4, data), params);
+		BOOST_REQUIRE_EQUAL(chain.Levels(), 5u);
+		for(std::size_t l=1; l!=chain.Levels(); ++l)
+		{
+			const Image& level = chain.Level(l);
+			const GLubyte* p = level.Data<GLubyte>();
+			for(std::size_t i=0; i!=level.DataSize(); ++i)
+			{
+				BOOST_CHECK_EQUAL(int(p[i]), int(40+(i%4)*50));
+			}
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(images_Mipmap_edge)
+{
+	using namespace oglplus::images;
+	// a step edge between two 2x2 blocks
+	std::vector<GLfloat> data(16*4);
+	for(std::size_t y=0; y!=4; ++y)
+	for(std::size_t x=0; x!=16; ++x)
+	{
+		data[y*16+x] = (x < 8)?0.0f:1.0f;
+	}
+	MipmapParams params;
+	params.max_levels = 2;
+	const MipmapFilter filters[] = {
+		MipmapFilter::Box,
+		MipmapFilter::Kaiser,
+		MipmapFilter::Lanczos
+	};
+	for(int f=0; f!=3; ++f)
+	{
+		params.filter = filters[f];
+		const MipmapChain chain(make_view(16, 4, 1, data), params);
+		const GLfloat* p = chain.Level(1).Data<GLfloat>();
+		// symmetric around the edge and flat far from it
+		BOOST_CHECK_CLOSE(p[3]+p[4], 1.0f, 1e-3);
+		BOOST_CHECK_SMALL(p[0], 0.02f);
+		BOOST_CHECK_CLOSE(p[7], 1.0f, 2.0);
+		// the box filter does not mix the blocks
+		if(filters[f] == MipmapFilter::Box)
+		{
+			BOOST_CHECK_EQUAL(p[3], 0.0f);
+			BOOST_CHECK_EQUAL(p[4], 1.0f);
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(images_Mipmap_srgb)
+{
+	using namespace oglplus::images;
+	// the colors are averaged in linear space, the alpha is linear
+	std::vector<GLubyte> data = {
+		  0,   0,   0,   0,  255, 255, 255, 255,
+		  0,   0,   0,   0,  255, 255, 255, 255
+	};
+	MipmapParams params;
+	params.srgb = true;
+	const MipmapChain chain(make_view(2, 2, 4, data), params);
+	const GLubyte* p = chain.Level(1).Data<GLubyte>();
+	for(int c=0; c!=3; ++c)
+	{
+		// linear 0.5 is encoded as 0.7354 in sRGB
+		BOOST_CHECK_EQUAL(int(p[c]), 188);
+	}
+	BOOST_CHECK_EQUAL(int(p[3]), 128);
+
+	params.srgb = false;
+	const MipmapChain linear(make_view(2, 2, 4, data), params);
+	BOOST_CHECK_EQUAL(int(linear.Level(1).Data<GLubyte>()[0]), 128);
+}
+
+BOOST_AUTO_TEST_CASE(images_Mipmap_normal_map)
+{
+	using namespace oglplus::images;
+	// the averaged normals are renormalized
+	std::vector<GLfloat> data(8*8*3);
+	for(std::size_t i=0; i!=data.size()/3; ++i)
+	{
+		const float a = float(i)*0.7f;
+		data[i*3+0] = std::cos(a)*0.6f;
+		data[i*3+1] = std::sin(a)*0.6f;
+		data[i*3+2] = -0.8f;
+	}
+	MipmapParams params;
+	params.normal_map = true;
+	params.filter = MipmapFilter::Kaiser;
+	const MipmapChain chain(make_view(8, 8, 3, data), params);
+	for(std::size_t l=1; l!=chain.Levels(); ++l)
+	{
+		const Image& level = chain.Level(l);
+		const GLfloat* p = level.Data<GLfloat>();
+		for(std::size_t i=0; i!=level.DataSize()/(3*sizeof(GLfloat)); ++i)
+		{
+			const float* n = p+i*3;
+			BOOST_CHECK_CLOSE(
+				std::sqrt(n[0]*n[0]+n[1]*n[1]+n[2]*n[2]),
+				1.0f,
+				1e-3
+			);
+			BOOST_CHECK_LT(n[2], 0.0f);
+		}
+	}
+
+	// unsigned normals are encoded as n*0.5+0.5
+	std::vector<GLubyte> bytes = {
+		255, 128, 128,  128, 255, 128,
+		255, 128, 128,  128, 255, 128
+	};
+	const MipmapChain byte_chain(make_view(2, 2, 3, bytes), params);
+	const GLubyte* b = byte_chain.Level(1).Data<GLubyte>();
+	const float nx = b[0]/255.0f*2.0f-1.0f;
+	const float ny = b[1]/255.0f*2.0f-1.0f;
+	BOOST_CHECK_CLOSE(nx, ny, 1.0f);
+	BOOST_CHECK_CLOSE(nx, std::sqrt(0.5f), 2.0f);
+}
+
+BOOST_AUTO_TEST_CASE(images_Mipmap_unsupported)
+{
+	using namespace oglplus;
+	using namespace oglplus::images;
+	std::vector<GLint> ints(4*4);
+	BOOST_CHECK_THROW(
+		MipmapChain(make_view(4, 4, 1, ints)),
+		std::runtime_error
+	);
+	std::vector<GLubyte> bytes(4*4*2);
+	BOOST_CHECK_THROW(
+		MipmapChain(ImageView(
+			4, 4, 2, 1,
+			bytes.data(),
+			PixelDataFormat::Red,
+			PixelDataInternalFormat::R8
+		)),
+		std::runtime_error
+	);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
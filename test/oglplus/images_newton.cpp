@@ -0,0 +1,67 @@
+/**
+ *  .file test/oglplus/images_newton.cpp
+ *  .brief Test case for the NewtonFractal image generator.
+ *
+ *  .author Matus Chochlik
+ *
+ *  Copyright 2011-2015 Matus Chochlik. Distributed under the Boost
+ *  Software License, Version 1.0. (See accompanying file
+ *  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE OGLPLUS_images_Newton
+#include <boost/test/unit_test.hpp>
+
+#include <oglplus/gl.hpp>
+// the other image headers declare the oglplus::images::aux namespace
+// which must not hide oglplus::aux in newton.hpp
+#include <oglplus/images/load.hpp>
+#include <oglplus/images/newton.hpp>
+
+BOOST_AUTO_TEST_SUITE(images_Newton)
+
+BOOST_AUTO_TEST_CASE(images_Newton_values)
+{
+	oglplus::images::NewtonFractal image(64, 48);
+
+	BOOST_CHECK_EQUAL(GLsizei(image.Width()), 64);
+	BOOST_CHECK_EQUAL(GLsizei(image.Height()), 48);
+	BOOST_CHECK_EQUAL(GLsizei(image.Channels()), 1);
+
+	const GLfloat* data = image.Data<GLfloat>();
+	for(GLsizei i=0; i!=64*48; ++i)
+	{
+		BOOST_CHECK(data[i] >= 0.0f && data[i] <= 1.0f);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(images_Newton_pan)
+{
+	typedef oglplus::images::NewtonFractal NF;
+	const GLsizei w = 64, h = 48;
+	// a viewport moved by a whole number of pixels
+	const GLfloat dx = 2.0f/w, dy = 2.0f/h;
+	const oglplus::Vec2f lb(-1.0f+5*dx, -1.0f-3*dy);
+	const oglplus::Vec2f rt( 1.0f+5*dx,  1.0f-3*dy);
+
+	NF panned(w, h);
+	panned.Pan(lb, rt);
+
+	// rendered at once, with the same colors as the red image
+	NF direct(
+		w, h,
+		oglplus::Vec3f(0.0f, 0.0f, 0.0f),
+		oglplus::Vec3f(1.0f, 0.0f, 0.0f),
+		lb, rt
+	);
+	for(GLsizei y=0; y!=h; ++y)
+	for(GLsizei x=0; x!=w; ++x)
+	{
+		BOOST_CHECK_EQUAL(
+			panned.Component(x, y, 0, 0),
+			direct.Component(x, y, 0, 0)
+		);
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
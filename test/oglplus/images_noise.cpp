@@ -0,0 +1,91 @@
+/**
+ *  .file test/oglplus/images_noise.cpp
+ *  .brief Test case for the noise image generators.
+ *
+ *  .author Matus Chochlik
+ *
+ *  Copyright 2011-2015 Matus Chochlik. Distributed under the Boost
+ *  Software License, Version 1.0. (See accompanying file
+ *  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE OGLPLUS_images_Noise
+#include <boost/test/unit_test.hpp>
+
+#include <oglplus/gl.hpp>
+#include <oglplus/images/noise.hpp>
+
+#include <cstring>
+
+BOOST_AUTO_TEST_SUITE(images_Noise)
+
+static void check_vectorized(
+	GLsizei w,
+	GLsizei h,
+	GLsizei d,
+	GLsizei c,
+	oglplus::images::NoiseParams params
+)
+{
+	using namespace oglplus;
+	params.vectorized = true;
+	const images::FractalNoise simd(w, h, d, c, images::RandomSeed(7), params);
+	params.vectorized = false;
+	const images::FractalNoise scalar(w, h, d, c, images::RandomSeed(7), params);
+
+	BOOST_CHECK(simd.Type() == params.type);
+	BOOST_CHECK_EQUAL(simd.DataSize(), scalar.DataSize());
+	BOOST_CHECK(std::memcmp(
+		simd.RawData(),
+		scalar.RawData(),
+		simd.DataSize()
+	) == 0);
+}
+
+BOOST_AUTO_TEST_CASE(images_Noise_simplex)
+{
+	using namespace oglplus;
+	images::NoiseParams params;
+	params.scale = 8.0f;
+	params.octaves = 3;
+	// the widths are not multiples of the SIMD lanes
+	check_vectorized(61, 17, 1, 1, params);
+	check_vectorized(29, 13, 11, 4, params);
+	params.type = PixelDataType::HalfFloat;
+	check_vectorized(37, 19, 3, 2, params);
+	params.type = PixelDataType::UnsignedByte;
+	check_vectorized(37, 19, 3, 3, params);
+}
+
+BOOST_AUTO_TEST_CASE(images_Noise_tiling)
+{
+	using namespace oglplus;
+	images::NoiseParams params;
+	params.scale = 6.0f;
+	params.octaves = 4;
+	params.tiling = true;
+	check_vectorized(48, 40, 1, 1, params);
+	check_vectorized(27, 21, 9, 3, params);
+	params.type = PixelDataType::HalfFloat;
+	check_vectorized(33, 33, 1, 4, params);
+}
+
+BOOST_AUTO_TEST_CASE(images_Noise_range)
+{
+	using namespace oglplus;
+	images::NoiseParams params;
+	params.scale = 4.0f;
+	const images::FractalNoise noise(64, 64, 4, 1, images::RandomSeed(3), params);
+	const GLfloat* data = noise.Data<GLfloat>();
+	GLfloat min = data[0], max = data[0];
+	for(GLsizei i=0; i!=64*64*4; ++i)
+	{
+		BOOST_CHECK(data[i] >= -1.0f && data[i] <= 1.0f);
+		if(min > data[i]) min = data[i];
+		if(max < data[i]) max = data[i];
+	}
+	// the noise is not degenerate
+	BOOST_CHECK(max-min > 0.5f);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,426 @@
+/**
+ *  .file test/oglplus/images_png.cpp
+ *  .brief Test case for the PNG decoder and writer.
+ *
+ *  .author Matus Chochlik
+ *
+ *  Copyright 2011-2015 Matus Chochlik. Distributed under the Boost
+ *  Software License, Version 1.0. (See accompanying file
+ *  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE OGLPLUS_images_PNG
+#include <boost/test/unit_test.hpp>
+
+#include <oglplus/gl.hpp>
+#include <oglplus/images/png.hpp>
+#include <oglplus/images/save_png.hpp>
+
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(images_PNG)
+
+// 3x2 RGB, 8 bits, pixel (x, y) = (10*x+y, 100+x, 200+y), y from the top
+static const unsigned char png_rgb8[] = {
+	0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d,
+	0x49, 0x48, 0x44, 0x52, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x02,
+	0x08, 0x02, 0x00, 0x00, 0x00, 0x12, 0x16, 0xf1, 0x4d, 0x00, 0x00, 0x00,
+	0x1c, 0x49, 0x44, 0x41, 0x54, 0x78, 0xda, 0x63, 0x60, 0x48, 0x39, 0xc1,
+	0x95, 0x7a, 0x42, 0x24, 0xed, 0x04, 0x03, 0x63, 0xca, 0x49, 0xee, 0xd4,
+	0x93, 0xa2, 0x69, 0x27, 0x01, 0x44, 0x1e, 0x07, 0x51, 0x82, 0xee, 0xe1,
+	0xc7, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45, 0x4e, 0x44, 0xae, 0x42, 0x60,
+	0x82,
+};
+// 2x2 gray-alpha, 16 bits, pixel number i (row by row from the top)
+// = (0x1234*(1+i), 0xFF00-0x1111*i)
+static const unsigned char png_ga16[] = {
+	0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d,
+	0x49, 0x48, 0x44, 0x52, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x02,
+	0x10, 0x04, 0x00, 0x00, 0x00, 0x88, 0x2f, 0x19, 0xec, 0x00, 0x00, 0x00,
+	0x1b, 0x49, 0x44, 0x41, 0x54, 0x78, 0xda, 0x63, 0x10, 0x32, 0xf9, 0xcf,
+	0xa0, 0x92, 0xf1, 0xf6, 0x3d, 0x83, 0xd9, 0x9c, 0x3b, 0xf7, 0x3c, 0x2e,
+	0x9c, 0x3e, 0x0b, 0x00, 0x43, 0x13, 0x08, 0xea, 0x14, 0x11, 0xf5, 0x38,
+	0x00, 0x00, 0x00, 0x00, 0x49, 0x45, 0x4e, 0x44, 0xae, 0x42, 0x60, 0x82,
+};
+// 4x1 palette, 4 bits, indices 0, 1, 2, 3 of red, green, blue and white
+static const unsigned char png_pal4[] = {
+	0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d,
+	0x49, 0x48, 0x44, 0x52, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x01,
+	0x04, 0x03, 0x00, 0x00, 0x00, 0x0b, 0x12, 0x12, 0xfe, 0x00, 0x00, 0x00,
+	0x0c, 0x50, 0x4c, 0x54, 0x45, 0xff, 0x00, 0x00, 0x00, 0xff, 0x00, 0x00,
+	0x00, 0xff, 0xff, 0xff, 0xff, 0xfb, 0x00, 0x60, 0xf6, 0x00, 0x00, 0x00,
+	0x0b, 0x49, 0x44, 0x41, 0x54, 0x78, 0xda, 0x63, 0x60, 0x54, 0x06, 0x00,
+	0x00, 0x28, 0x00, 0x25, 0xa9, 0x67, 0x62, 0x08, 0x00, 0x00, 0x00, 0x00,
+	0x49, 0x45, 0x4e, 0x44, 0xae, 0x42, 0x60, 0x82,
+};
+
+static std::vector<GLubyte> decode_all(
+	const unsigned char* data,
+	std::size_t size,
+	bool y_is_up = false,
+	bool x_is_right = true
+)
+{
+	oglplus::images::PNGDecoder decoder(data, size);
+	std::vector<GLubyte> result(
+		decoder.RowSize()*std::size_t(GLsizei(decoder.Height()))
+	);
+	decoder.ReadImage(
+		result.data(),
+		std::ptrdiff_t(decoder.RowSize()),
+		y_is_up,
+		x_is_right
+	);
+	return result;
+}
+
+BOOST_AUTO_TEST_CASE(images_PNG_rows_rgb8)
+{
+	using namespace oglplus;
+	images::PNGDecoder decoder(png_rgb8, sizeof(png_rgb8));
+	BOOST_CHECK_EQUAL(GLsizei(decoder.Width()), 3);
+	BOOST_CHECK_EQUAL(GLsizei(decoder.Height()), 2);
+	BOOST_CHECK_EQUAL(GLsizei(decoder.Channels()), 3);
+	BOOST_CHECK(decoder.Format() == PixelDataFormat::RGB);
+	BOOST_CHECK_EQUAL(decoder.RowSize(), 9u);
+
+	GLubyte row[9];
+	for(GLuint y=0; y!=2; ++y)
+	{
+		BOOST_CHECK_EQUAL(decoder.RowsDecoded(), y);
+		BOOST_CHECK(decoder.ReadRow(row));
+		for(GLuint x=0; x!=3; ++x)
+		{
+			BOOST_CHECK_EQUAL(row[x*3+0], 10*x+y);
+			BOOST_CHECK_EQUAL(row[x*3+1], 100+x);
+			BOOST_CHECK_EQUAL(row[x*3+2], 200+y);
+		}
+	}
+	BOOST_CHECK_EQUAL(decoder.RowsDecoded(), 2u);
+	BOOST_CHECK(!decoder.ReadRow(row));
+}
+
+BOOST_AUTO_TEST_CASE(images_PNG_orientation)
+{
+	// y_is_up stores the bottom row first, !x_is_right flips the rows
+	const std::vector<GLubyte> up = decode_all(
+		png_rgb8, sizeof(png_rgb8),
+		true, false
+	);
+	BOOST_REQUIRE_EQUAL(up.size(), 18u);
+	for(GLuint y=0; y!=2; ++y)
+	for(GLuint x=0; x!=3; ++x)
+	{
+		const GLubyte* p = up.data() + (1-y)*9 + (2-x)*3;
+		BOOST_CHECK_EQUAL(p[0], 10*x+y);
+		BOOST_CHECK_EQUAL(p[1], 100+x);
+		BOOST_CHECK_EQUAL(p[2], 200+y);
+	}
+
+	std::vector<GLubyte> rows;
+	oglplus::images::PNGDecoder decoder(png_rgb8, sizeof(png_rgb8));
+	decoder.ReadRows(
+		[&rows](GLuint y, const GLubyte* data)
+		{
+			BOOST_CHECK_EQUAL(y, 1u-GLuint(rows.size()/9));
+			rows.insert(rows.end(), data, data+9);
+		}
+	);
+	BOOST_CHECK_EQUAL(rows.size(), 18u);
+}
+
+BOOST_AUTO_TEST_CASE(images_PNG_strip_16)
+{
+	using namespace oglplus;
+	images::PNGDecoder decoder(png_ga16, sizeof(png_ga16));
+	BOOST_CHECK_EQUAL(GLsizei(decoder.Channels()), 2);
+	BOOST_CHECK(decoder.Format() == PixelDataFormat::RG);
+	BOOST_CHECK_EQUAL(decoder.RowSize(), 4u);
+
+	// 16-bit values are stripped to their high byte
+	const std::vector<GLubyte> data = decode_all(png_ga16, sizeof(png_ga16));
+	BOOST_REQUIRE_EQUAL(data.size(), 8u);
+	for(GLuint i=0; i!=4; ++i)
+	{
+		BOOST_CHECK_EQUAL(data[i*2+0], (0x1234*(1+i)) >> 8);
+		BOOST_CHECK_EQUAL(data[i*2+1], (0xFF00-0x1111*i) >> 8);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(images_PNG_palette)
+{
+	const std::vector<GLubyte> data = decode_all(png_pal4, sizeof(png_pal4));
+	const GLubyte expected[12] = {
+		255,   0,   0,
+		  0, 255,   0,
+		  0,   0, 255,
+		255, 255, 255
+	};
+	BOOST_CHECK_EQUAL_COLLECTIONS(
+		data.begin(), data.end(),
+		expected, expected+12
+	);
+}
+
+BOOST_AUTO_TEST_CASE(images_PNG_image)
+{
+	using namespace oglplus;
+	const std::string str(
+		reinterpret_cast<const char*>(png_rgb8),
+		sizeof(png_rgb8)
+	);
+	std::istringstream input(str);
+	const images::PNGImage image(input);
+	BOOST_CHECK_EQUAL(GLsizei(image.Width()), 3);
+	BOOST_CHECK_EQUAL(GLsizei(image.Height()), 2);
+	BOOST_CHECK_EQUAL(GLsizei(image.Channels()), 3);
+
+	const std::vector<GLubyte> up = decode_all(
+		png_rgb8, sizeof(png_rgb8),
+		true, true
+	);
+	const GLubyte* data = image.Data<GLubyte>();
+	BOOST_CHECK_EQUAL_COLLECTIONS(
+		data, data+image.DataSize(),
+		up.begin(), up.end()
+	);
+}
+
+BOOST_AUTO_TEST_CASE(images_PNG_truncated)
+{
+	// every prefix ending before the IEND chunk is rejected
+	const std::size_t iend = 12;
+	for(std::size_t size=0; size<sizeof(png_rgb8)-iend; ++size)
+	{
+		BOOST_CHECK_THROW(
+			decode_all(png_rgb8, size),
+			std::runtime_error
+		);
+	}
+	const std::string str(
+		reinterpret_cast<const char*>(png_rgb8),
+		sizeof(png_rgb8)/2
+	);
+	std::istringstream input(str);
+	BOOST_CHECK_THROW(
+		oglplus::images::PNGImage image(input),
+		std::runtime_error
+	);
+}
+
+BOOST_AUTO_TEST_CASE(images_PNG_corrupt)
+{
+	// each byte of the signature, the IHDR and the IDAT
+	// chunk is modified, which is detected by the CRC check
+	const std::size_t iend = 12;
+	for(std::size_t pos=0; pos<sizeof(png_rgb8)-iend; ++pos)
+	{
+		unsigned char data[sizeof(png_rgb8)];
+		std::memcpy(data, png_rgb8, sizeof(data));
+		data[pos] ^= 0x20;
+		BOOST_CHECK_THROW(
+			decode_all(data, sizeof(data)),
+			std::runtime_error
+		);
+	}
+}
+
+static oglplus::PixelDataFormat png_format(GLsizei channels)
+{
+	using oglplus::PixelDataFormat;
+	switch(channels)
+	{
+		case 1: return PixelDataFormat::Red;
+		case 2: return PixelDataFormat::RG;
+		case 3: return PixelDataFormat::RGB;
+		default:;
+	}
+	return PixelDataFormat::RGBA;
+}
+
+static GLubyte png_value(GLubyte v) { return v; }
+static GLubyte png_value(GLushort v) { return GLubyte(v >> 8); }
+
+// saves a view of padded rows of T and checks that it is decoded
+// to the same pixels (the high bytes of 16-bit values)
+template <typename T>
+static void check_save_load(
+	GLsizei width,
+	GLsizei height,
+	GLsizei channels,
+	const oglplus::images::PNGSaveParams& params
+)
+{
+	using namespace oglplus;
+	const std::size_t pad = 3;
+	const std::size_t row_len = std::size_t(width*channels)+pad;
+	std::vector<T> data(row_len*std::size_t(height));
+	for(std::size_t i=0; i!=data.size(); ++i)
+	{
+		data[i] = T((i*2654435761u) >> (32-8*sizeof(T)));
+	}
+	const images::ImageView view(
+		width, height, 1, channels,
+		data.data(),
+		png_format(channels),
+		PixelDataInternalFormat(GLenum(png_format(channels))),
+		std::ptrdiff_t(row_len*sizeof(T))
+	);
+
+	std::ostringstream output;
+	images::SavePNG(view, output, params);
+	const std::string png = output.str();
+
+	images::PNGDecoder decoder(png.data(), png.size());
+	BOOST_REQUIRE_EQUAL(GLsizei(decoder.Width()), width);
+	BOOST_REQUIRE_EQUAL(GLsizei(decoder.Height()), height);
+	BOOST_REQUIRE_EQUAL(GLsizei(decoder.Channels()), channels);
+
+	std::vector<GLubyte> decoded(decoder.RowSize()*std::size_t(height));
+	decoder.ReadImage(
+		decoded.data(),
+		std::ptrdiff_t(decoder.RowSize()),
+		params.y_is_up
+	);
+	std::size_t mismatches = 0;
+	for(GLsizei y=0; y!=height; ++y)
+	for(GLsizei x=0; x!=width*channels; ++x)
+	{
+		const T v = data[std::size_t(y)*row_len+std::size_t(x)];
+		const GLubyte d = decoded[std::size_t(y*width*channels+x)];
+		if(d != png_value(v)) ++mismatches;
+	}
+	BOOST_CHECK_EQUAL(mismatches, 0u);
+}
+
+template <typename T>
+static void check_save_load_filters(GLsizei channels)
+{
+	using oglplus::images::PNGRowFilter;
+	const PNGRowFilter filters[] = {
+		PNGRowFilter::None,
+		PNGRowFilter::Sub,
+		PNGRowFilter::Up,
+		PNGRowFilter::Average,
+		PNGRowFilter::Paeth,
+		PNGRowFilter::Adaptive
+	};
+	for(PNGRowFilter filter : filters)
+	{
+		oglplus::images::PNGSaveParams params;
+		params.filter = filter;
+		check_save_load<T>(13, 11, channels, params);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(images_PNG_save_8bit)
+{
+	for(GLsizei channels=1; channels<=4; ++channels)
+	{
+		check_save_load_filters<GLubyte>(channels);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(images_PNG_save_16bit)
+{
+	for(GLsizei channels=1; channels<=4; ++channels)
+	{
+		check_save_load_filters<GLushort>(channels);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(images_PNG_save_params)
+{
+	oglplus::images::PNGSaveParams params;
+	params.y_is_up = false;
+	check_save_load<GLubyte>(1, 1, 3, params);
+	check_save_load<GLubyte>(1, 97, 1, params);
+
+	// the bands are compressed separately and joined
+	const unsigned band_rows[] = {1, 7, 64};
+	const int levels[] = {0, 1, 9};
+	for(unsigned rows : band_rows)
+	for(int level : levels)
+	{
+		params.band_rows = rows;
+		params.compression_level = level;
+		params.y_is_up = (rows%2 != 0);
+		check_save_load<GLubyte>(61, 53, 4, params);
+		check_save_load<GLushort>(61, 53, 2, params);
+		params.max_threads = 1;
+		check_save_load<GLubyte>(61, 53, 3, params);
+		params.max_threads = 0;
+	}
+}
+
+BOOST_AUTO_TEST_CASE(images_PNG_save_unsupported)
+{
+	using namespace oglplus;
+	std::vector<GLfloat> floats(4*4*4);
+	std::vector<GLubyte> bytes(4*4*4*2);
+	std::ostringstream output;
+	BOOST_CHECK_THROW(
+		images::SavePNG(
+			images::ImageView(
+				4, 4, 1, 4, floats.data(),
+				PixelDataFormat::RGBA,
+				PixelDataInternalFormat::RGBA32F
+			), output
+		),
+		std::runtime_error
+	);
+	BOOST_CHECK_THROW(
+		images::SavePNG(
+			images::ImageView(
+				4, 4, 2, 4, bytes.data(),
+				PixelDataFormat::RGBA,
+				PixelDataInternalFormat::RGBA8
+			), output
+		),
+		std::runtime_error
+	);
+}
+
+BOOST_AUTO_TEST_CASE(images_PNG_save_truncated)
+{
+	using namespace oglplus;
+	std::vector<GLubyte> data(32*32*3);
+	for(std::size_t i=0; i!=data.size(); ++i)
+	{
+		data[i] = GLubyte(i*i);
+	}
+	std::ostringstream output;
+	images::SavePNG(
+		images::ImageView(
+			32, 32, 1, 3, data.data(),
+			PixelDataFormat::RGB,
+			PixelDataInternalFormat::RGB8
+		), output
+	);
+	const std::string png = output.str();
+	const std::size_t iend = 12;
+	BOOST_REQUIRE(png.size() > iend);
+	for(std::size_t size=0; size<png.size()-iend; size+=3)
+	{
+		BOOST_CHECK_THROW(
+			decode_all(
+				reinterpret_cast<const unsigned char*>(png.data()),
+				size
+			),
+			std::runtime_error
+		);
+	}
+	BOOST_CHECK_EQUAL(
+		decode_all(
+			reinterpret_cast<const unsigned char*>(png.data()),
+			png.size()
+		).size(),
+		data.size()
+	);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,146 @@
+/**
+ *  .file test/oglplus/images_sparse.cpp
+ *  .brief Test case for the SparseImage class.
+ *
+ *  .author Matus Chochlik
+ *
+ *  Copyright 2011-2015 Matus Chochlik. Distributed under the Boost
+ *  Software License, Version 1.0. (See accompanying file
+ *  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE OGLPLUS_images_Sparse
+#include <boost/test/unit_test.hpp>
+
+#include <oglplus/gl.hpp>
+#include <oglplus/images/sparse.hpp>
+#include <oglplus/images/cloud.hpp>
+
+#include <cstring>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(images_Sparse)
+
+static std::size_t brick_bytes(const oglplus::images::SparseImage& image)
+{
+	const std::size_t s = std::size_t(image.BrickSize());
+	return s*s*s*std::size_t(GLsizei(image.Channels()));
+}
+
+BOOST_AUTO_TEST_CASE(images_Sparse_cloud_size)
+{
+	using namespace oglplus;
+	const images::CloudTileSource source(96, 80, 72, images::RandomSeed(1));
+	const images::SparseImage sparse = source.MakeSparse(0, 16);
+	const images::Image dense = source.MakeRegion(0, 0, 0, 0, 96, 80, 72);
+
+	BOOST_CHECK(sparse.OccupiedCount() > 0);
+	BOOST_CHECK_EQUAL(
+		sparse.DataSize(),
+		sparse.OccupiedCount()*brick_bytes(sparse)
+	);
+	BOOST_CHECK(sparse.DataSize() <= dense.DataSize()+brick_bytes(sparse));
+
+	const images::SparseImage from_dense(dense, 16);
+	BOOST_CHECK_EQUAL(
+		from_dense.DataSize(),
+		from_dense.OccupiedCount()*brick_bytes(from_dense)
+	);
+}
+
+BOOST_AUTO_TEST_CASE(images_Sparse_cloud_contents)
+{
+	using namespace oglplus;
+	// the dimensions are not multiples of the brick size
+	const images::CloudTileSource source(70, 50, 44, images::RandomSeed(5));
+	for(GLint level=0; level!=2; ++level)
+	{
+		const images::Image sparse = source.MakeSparse(level, 16).ToImage();
+		const images::Image dense = source.MakeRegion(
+			level, 0, 0, 0,
+			source.LevelWidth(level),
+			source.LevelHeight(level),
+			source.LevelDepth(level)
+		);
+		BOOST_CHECK_EQUAL(GLsizei(sparse.Width()), GLsizei(dense.Width()));
+		BOOST_CHECK_EQUAL(GLsizei(sparse.Height()), GLsizei(dense.Height()));
+		BOOST_CHECK_EQUAL(GLsizei(sparse.Depth()), GLsizei(dense.Depth()));
+		BOOST_CHECK_EQUAL(sparse.DataSize(), dense.DataSize());
+		BOOST_CHECK(std::memcmp(
+			sparse.RawData(),
+			dense.RawData(),
+			dense.DataSize()
+		) == 0);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(images_Sparse_growth)
+{
+	using namespace oglplus;
+	images::SparseImage image(
+		128, 128, 128, 1,
+		static_cast<const GLubyte*>(nullptr),
+		PixelDataFormat::Red,
+		PixelDataInternalFormat::R8,
+		8
+	);
+	BOOST_CHECK_EQUAL(image.DataSize(), 0u);
+
+	std::vector<GLubyte*> bricks;
+	for(GLsizei i=0; i!=1000; ++i)
+	{
+		GLubyte* brick = image.Brick<GLubyte>(i%16, (i/16)%16, i/256);
+		brick[0] = GLubyte(i%251+1);
+		bricks.push_back(brick);
+
+		// the unused memory is at most the size of the used
+		BOOST_CHECK(
+			image.DataSize() <=
+			2*image.OccupiedCount()*brick_bytes(image)
+		);
+	}
+	// the allocated bricks are not moved
+	for(GLsizei i=0; i!=1000; ++i)
+	{
+		BOOST_CHECK(
+			image.BrickData<GLubyte>(i%16, (i/16)%16, i/256) ==
+			bricks[std::size_t(i)]
+		);
+		BOOST_CHECK_EQUAL(bricks[std::size_t(i)][0], GLubyte(i%251+1));
+	}
+}
+
+BOOST_AUTO_TEST_CASE(images_Sparse_compact)
+{
+	using namespace oglplus;
+	images::SparseImage image(
+		64, 64, 64, 1,
+		static_cast<const GLubyte*>(nullptr),
+		PixelDataFormat::Red,
+		PixelDataInternalFormat::R8,
+		8
+	);
+	image.Reserve(100);
+	BOOST_CHECK_EQUAL(image.DataSize(), 100*brick_bytes(image));
+
+	for(GLsizei i=0; i!=100; ++i)
+	{
+		GLubyte* brick = image.Brick<GLubyte>(i%8, (i/8)%8, i/64);
+		if(i%3 == 0) brick[7] = GLubyte(i+1);
+	}
+	BOOST_CHECK_EQUAL(image.Compact(), 66u);
+	BOOST_CHECK_EQUAL(image.OccupiedCount(), 34u);
+	BOOST_CHECK_EQUAL(image.DataSize(), 34*brick_bytes(image));
+
+	for(GLsizei i=0; i!=100; ++i)
+	{
+		const GLsizei bx = i%8, by = (i/8)%8, bz = i/64;
+		BOOST_CHECK_EQUAL(image.IsOccupied(bx, by, bz), i%3 == 0);
+		BOOST_CHECK_EQUAL(
+			image.Component<GLubyte>(bx*8+7, by*8, bz*8),
+			GLubyte((i%3 == 0)?i+1:0)
+		);
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,272 @@
+/**
+ *  .file test/oglplus/images_xpm.cpp
+ *  .brief Test case for the XPM image loader.
+ *
+ *  .author Matus Chochlik
+ *
+ *  Copyright 2011-2015 Matus Chochlik. Distributed under the Boost
+ *  Software License, Version 1.0. (See accompanying file
+ *  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE OGLPLUS_images_XPM
+#include <boost/test/unit_test.hpp>
+
+#include <oglplus/gl.hpp>
+#include <oglplus/images/xpm.hpp>
+
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+BOOST_AUTO_TEST_SUITE(images_XPM)
+
+static oglplus::images::Image load_xpm(
+	const char* xpm,
+	bool y_is_up = true,
+	bool x_is_right = true
+)
+{
+	return oglplus::images::XPMImage(
+		xpm,
+		std::strlen(xpm),
+		y_is_up,
+		x_is_right
+	);
+}
+
+static const GLubyte* xpm_pixel(
+	const oglplus::images::Image& image,
+	unsigned x,
+	unsigned y,
+	unsigned z
+)
+{
+	const unsigned w = unsigned(GLsizei(image.Width()));
+	const unsigned h = unsigned(GLsizei(image.Height()));
+	const unsigned c = unsigned(GLsizei(image.Channels()));
+	return image.Data<GLubyte>()+((z*h+y)*w+x)*c;
+}
+
+static const char* xpm_3x2 =
+	"! XPM2\n"
+	"3 2 6 1\n"
+	"a c #100000\n"
+	"b c #200000\n"
+	"c c #300000\n"
+	"d c #400000\n"
+	"e c #500000\n"
+	"f c #600000\n"
+	"abc\n"
+	"def\n";
+
+BOOST_AUTO_TEST_CASE(images_XPM_non_square)
+{
+	using namespace oglplus;
+
+	images::Image image = load_xpm(xpm_3x2);
+
+	BOOST_CHECK_EQUAL(GLsizei(image.Width()), 3);
+	BOOST_CHECK_EQUAL(GLsizei(image.Height()), 2);
+	BOOST_CHECK_EQUAL(GLsizei(image.Depth()), 1);
+	BOOST_CHECK_EQUAL(GLsizei(image.Channels()), 3);
+	BOOST_CHECK(image.Format() == PixelDataFormat::RGB);
+
+	// the rows are width (not height) pixels apart
+	for(unsigned y=0; y!=2; ++y)
+	for(unsigned x=0; x!=3; ++x)
+	{
+		const GLubyte* p = xpm_pixel(image, x, y, 0);
+		BOOST_CHECK_EQUAL(unsigned(p[0]), 0x10*(1+y*3+x));
+		BOOST_CHECK_EQUAL(unsigned(p[1]), 0u);
+		BOOST_CHECK_EQUAL(unsigned(p[2]), 0u);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(images_XPM_orientation)
+{
+	using namespace oglplus;
+
+	images::Image down = load_xpm(xpm_3x2, false, true);
+	images::Image left = load_xpm(xpm_3x2, true, false);
+
+	for(unsigned y=0; y!=2; ++y)
+	for(unsigned x=0; x!=3; ++x)
+	{
+		BOOST_CHECK_EQUAL(
+			unsigned(xpm_pixel(down, x, 1-y, 0)[0]),
+			0x10*(1+y*3+x)
+		);
+		BOOST_CHECK_EQUAL(
+			unsigned(xpm_pixel(left, 2-x, y, 0)[0]),
+			0x10*(1+y*3+x)
+		);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(images_XPM_colors)
+{
+	using namespace oglplus;
+
+	images::Image image = load_xpm(
+		"! XPM2\n"
+		"2 2 4 2\n"
+		".. c #FF000080\n"
+		"#. c blue\n"
+		"xy m white c #00FF00\n"
+		"zz m black\n"
+		"..#.\n"
+		"xyzz\n"
+	);
+	BOOST_CHECK_EQUAL(GLsizei(image.Channels()), 4);
+	BOOST_CHECK(image.Format() == PixelDataFormat::RGBA);
+
+	const unsigned expected[4][4] = {
+		{0xFF, 0x00, 0x00, 0x80},
+		{0x00, 0x00, 0xFF, 0xFF},
+		// the 'c' color is preferred to the 'm' color
+		{0x00, 0xFF, 0x00, 0xFF},
+		{0x00, 0x00, 0x00, 0xFF}
+	};
+	for(unsigned i=0; i!=4; ++i)
+	{
+		const GLubyte* p = xpm_pixel(image, i%2, i/2, 0);
+		for(unsigned c=0; c!=4; ++c)
+		{
+			BOOST_CHECK_EQUAL(unsigned(p[c]), expected[i][c]);
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(images_XPM_gray)
+{
+	using namespace oglplus;
+
+	// without the XPM2 header line
+	images::Image image = load_xpm(
+		"2 1 2 1\n"
+		". c #80\n"
+		"o c #FF\n"
+		"o.\n"
+	);
+	BOOST_CHECK_EQUAL(GLsizei(image.Channels()), 1);
+	BOOST_CHECK(image.Format() == PixelDataFormat::Red);
+	BOOST_CHECK_EQUAL(unsigned(xpm_pixel(image, 0, 0, 0)[0]), 0xFFu);
+	BOOST_CHECK_EQUAL(unsigned(xpm_pixel(image, 1, 0, 0)[0]), 0x80u);
+}
+
+BOOST_AUTO_TEST_CASE(images_XPM_long_codes)
+{
+	using namespace oglplus;
+
+	// codes with more than 2 characters use the hash table
+	images::Image image = load_xpm(
+		"! XPM2\n"
+		"4 1 3 3\n"
+		"aaa c #0A0B0C\n"
+		"aab c #1A1B1C\n"
+		"baa c #2A2B2C\n"
+		"baaaabbaaaaa\n"
+	);
+	const unsigned expected[4] = {0x2A, 0x1A, 0x2A, 0x0A};
+	for(unsigned x=0; x!=4; ++x)
+	{
+		const GLubyte* p = xpm_pixel(image, x, 0, 0);
+		BOOST_CHECK_EQUAL(unsigned(p[0]), expected[x]);
+		BOOST_CHECK_EQUAL(unsigned(p[1]), expected[x]+1);
+		BOOST_CHECK_EQUAL(unsigned(p[2]), expected[x]+2);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(images_XPM_3d)
+{
+	using namespace oglplus;
+
+	images::Image image = load_xpm(
+		"! XPM3D\n"
+		"2 1 3 2 1\n"
+		"a c #010203\n"
+		"b c #040506\n"
+		"ab\n"
+		"ba\n"
+		"bb\n"
+	);
+	BOOST_CHECK_EQUAL(GLsizei(image.Width()), 2);
+	BOOST_CHECK_EQUAL(GLsizei(image.Height()), 1);
+	BOOST_CHECK_EQUAL(GLsizei(image.Depth()), 3);
+
+	const char* slices[3] = {"ab", "ba", "bb"};
+	for(unsigned z=0; z!=3; ++z)
+	for(unsigned x=0; x!=2; ++x)
+	{
+		const unsigned first = (slices[z][x] == 'a')?0x01:0x04;
+		BOOST_CHECK_EQUAL(unsigned(xpm_pixel(image, x, 0, z)[0]), first);
+		BOOST_CHECK_EQUAL(unsigned(xpm_pixel(image, x, 0, z)[2]), first+2);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(images_XPM_line_ends)
+{
+	using namespace oglplus;
+
+	const char* xpm =
+		"! XPM2\r\n"
+		"2 2 2 1\r\n"
+		"\r\n"
+		"a c #000000\r\n"
+		"\r\n"
+		"b c #FFFFFF\r\n"
+		"ab\r\n"
+		"ba\r\n";
+
+	images::Image image = load_xpm(xpm);
+	BOOST_CHECK_EQUAL(unsigned(xpm_pixel(image, 0, 0, 0)[0]), 0x00u);
+	BOOST_CHECK_EQUAL(unsigned(xpm_pixel(image, 1, 0, 0)[0]), 0xFFu);
+	BOOST_CHECK_EQUAL(unsigned(xpm_pixel(image, 0, 1, 0)[0]), 0xFFu);
+	BOOST_CHECK_EQUAL(unsigned(xpm_pixel(image, 1, 1, 0)[0]), 0x00u);
+
+	// the stream constructor gives the same result
+	std::istringstream input(xpm);
+	images::XPMImage streamed(input);
+	BOOST_CHECK_EQUAL(GLsizei(streamed.Width()), 2);
+	BOOST_CHECK_EQUAL(GLsizei(streamed.Height()), 2);
+	BOOST_CHECK(
+		std::memcmp(
+			streamed.Data<GLubyte>(),
+			image.Data<GLubyte>(),
+			2*2*3
+		) == 0
+	);
+}
+
+BOOST_AUTO_TEST_CASE(images_XPM_errors)
+{
+	const char* invalid[] = {
+		// empty input
+		"",
+		// invalid header
+		"! XPM\n2 1 1 1\na c #000000\naa\n",
+		// missing dimensions
+		"! XPM2\n",
+		// too many characters per pixel
+		"! XPM2\n1 1 1 9\naaaaaaaaa c #000000\naaaaaaaaa\n",
+		// truncated palette
+		"! XPM2\n1 1 2 1\na c #000000\n",
+		// duplicate palette entry
+		"! XPM2\n1 1 2 1\na c #000000\na c #FFFFFF\na\n",
+		// unknown color name
+		"! XPM2\n1 1 1 1\na c purple\na\n",
+		// invalid hexadecimal digit
+		"! XPM2\n1 1 1 1\na c #GG0000\na\n",
+		// color code not in the palette
+		"! XPM2\n2 1 1 1\na c #000000\nab\n",
+		// truncated pixel data
+		"! XPM2\n2 2 1 1\na c #000000\naa\na\n"
+	};
+	for(std::size_t i=0; i!=sizeof(invalid)/sizeof(invalid[0]); ++i)
+	{
+		BOOST_CHECK_THROW(load_xpm(invalid[i]), std::runtime_error);
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -107,3 +107,12 @@ endfunction()
 function(oglplus_exec_test_no_fixture TEST_NAME)
 	add_oglplus_test(${TEST_NAME} "" FALSE)
 endfunction()
+
+function(oglplus_exec_lib_test_no_fixture TEST_NAME)
+	add_oglplus_test(${TEST_NAME} "oglplus" FALSE)
+	set_property(
+		TARGET ${TEST_NAME}
+		APPEND PROPERTY COMPILE_DEFINITIONS
+		OGLPLUS_LINK_LIBRARY=1
+	)
+endfunction()